@@ -0,0 +1,200 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "XYZ/Graphics/Renderer/RenderQueue.hpp"
+#include "XYZ/Graphics/Renderer/CommandBuffer.hpp"
+#include "XYZ/Graphics/Renderer/CommandExecutor.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace XYZ::Graphics;
+
+/**
+ * A shader program that ignores every uniform. Only its address is used by the
+ * render queue.
+ */
+class NullShaderProgram : public Shader::ShaderProgram {
+public:
+	void activate() override {}
+	void deactivate() override {}
+	void set(const std::string& name, bool b) override {}
+	void set(const std::string& name, float v) override {}
+	void set(const std::string& name, int v) override {}
+	void set(const std::string& name, unsigned int v) override {}
+	void set(const std::string& name, glm::vec2 v) override {}
+	void set(const std::string& name, glm::vec3 v) override {}
+	void set(const std::string& name, glm::vec4 v) override {}
+	void set(const std::string& name, glm::uvec3 v) override {}
+	void set(const std::string& name, glm::mat2 v) override {}
+	void set(const std::string& name, glm::mat3 v) override {}
+	void set(const std::string& name, glm::mat4 v) override {}
+
+	Shader::ShaderBinary getShaderBinary() const override {
+		return {};
+	}
+};
+
+/**
+ * A model without any data, identified only by its material and geometry
+ */
+class NullModel : public Model::Model {
+private:
+	/**
+	 * The material of the model. Models with the same material share it.
+	 */
+	std::size_t material;
+
+	/**
+	 * The geometry of the model. Models with the same geometry can be instanced.
+	 */
+	const void* geometry;
+
+public:
+	NullModel(std::size_t material, const void* geometry) : material(material), geometry(geometry) {}
+
+public:
+	void render(Renderer::Renderer& renderer, const XYZ::Graphics::Model::LevelOfDetail& levelOfDetail) override {}
+
+	void setMaterialShaderUniforms(Renderer::Renderer& renderer, Shader::ShaderProgram& shader,
+								   const XYZ::Graphics::Model::LevelOfDetail& levelOfDetail) override {}
+
+	std::size_t getMaterialHash() const override {
+		return material;
+	}
+
+	bool hasSameMaterial(const Model& other) const override {
+		auto model = dynamic_cast<const NullModel*>(&other);
+		return model != nullptr && model->material == material;
+	}
+
+	const void* getInstancingKey() const override {
+		return geometry;
+	}
+
+	glm::vec3 getSize() override {
+		return glm::vec3(0.0f);
+	}
+};
+
+/**
+ * Records a synthetic frame of geometry and shadow draws through a render queue
+ * and replays it on a NullCommandExecutor, without a graphics context. Reports
+ * the CPU time spent sorting, recording and replaying and fails if the replayed
+ * commands do not match the queue statistics.
+ *
+ * Usage: XYZ.Benchmark.RenderQueue [draws] [frames]
+ */
+int main(int argc, char** argv) {
+	const std::size_t drawCount = argc > 1 ? std::size_t(std::atol(argv[1])) : 20000;
+	const std::size_t frameCount = argc > 2 ? std::size_t(std::atol(argv[2])) : 100;
+
+	const std::size_t geometryCount = 64;
+	const std::size_t materialCount = 16;
+
+	NullShaderProgram geometryShader;
+	NullShaderProgram geometryInstancedShader;
+	NullShaderProgram shadowShader;
+	NullShaderProgram shadowInstancedShader;
+
+	// every combination of geometry and material, the geometry keys only need to be unique
+	std::vector<char> geometries(geometryCount);
+	std::vector<std::unique_ptr<NullModel>> models;
+	for(std::size_t geometry = 0; geometry < geometryCount; geometry++) {
+		for(std::size_t material = 0; material < materialCount; material++) {
+			models.push_back(std::make_unique<NullModel>(material, &geometries[geometry]));
+		}
+	}
+
+	struct Draw {
+		NullModel* model;
+		glm::mat4 modelMatrix;
+		float depth;
+	};
+
+	std::mt19937 random(42);
+	std::uniform_int_distribution<std::size_t> modelDistribution(0, models.size() - 1);
+	std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+
+	std::vector<Draw> draws;
+	draws.reserve(drawCount);
+	for(std::size_t i = 0; i < drawCount; i++) {
+		glm::vec3 position(positionDistribution(random), positionDistribution(random), positionDistribution(random));
+		draws.push_back(Draw{
+				models[modelDistribution(random)].get(),
+				glm::translate(glm::mat4(1.0f), position),
+				glm::length(position)
+		});
+	}
+
+	Renderer::RenderQueue queue;
+	Renderer::CommandBuffer commandBuffer;
+	Renderer::NullCommandExecutor executor;
+	const Model::LevelOfDetail levelOfDetail(glm::vec3(1.0f));
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration pushTime{}, recordTime{}, executeTime{};
+
+	for(std::size_t frame = 0; frame < frameCount; frame++) {
+		auto start = Clock::now();
+		queue.clear();
+		for(const auto& draw : draws) {
+			queue.push(Renderer::RenderPass::GEOMETRY, geometryShader, *draw.model, draw.modelMatrix, draw.depth,
+					   levelOfDetail, &geometryInstancedShader);
+			queue.push(Renderer::RenderPass::SHADOW, shadowShader, *draw.model, draw.modelMatrix, draw.depth,
+					   levelOfDetail, &shadowInstancedShader);
+		}
+		queue.sort();
+
+		auto pushed = Clock::now();
+		commandBuffer.clear();
+		queue.record(commandBuffer);
+
+		auto recorded = Clock::now();
+		executor.reset();
+		commandBuffer.execute(executor);
+
+		auto executed = Clock::now();
+		pushTime += pushed - start;
+		recordTime += recorded - pushed;
+		executeTime += executed - recorded;
+	}
+
+	// the executor must have received exactly what the queue recorded
+	const auto& statistics = queue.getStatistics();
+	bool matches = executor.programBinds == statistics.shaderChanges &&
+				   executor.materialChanges == statistics.materialChanges &&
+				   executor.drawCalls == statistics.drawCalls &&
+				   executor.instancedDrawCalls == statistics.instancedDrawCalls &&
+				   executor.instances == statistics.instances &&
+				   executor.multiDrawCalls == statistics.multiDrawCalls &&
+				   executor.multiDrawModels == statistics.multiDrawItems;
+
+	auto milliseconds = [frameCount](Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count() / double(frameCount);
+	};
+
+	std::cout << "draws:           " << 2 * drawCount << " in " << frameCount << " frames" << std::endl;
+	std::cout << "push + sort:     " << milliseconds(pushTime) << " ms/frame" << std::endl;
+	std::cout << "record:          " << milliseconds(recordTime) << " ms/frame" << std::endl;
+	std::cout << "execute:         " << milliseconds(executeTime) << " ms/frame" << std::endl;
+	std::cout << "program binds:   " << executor.programBinds << std::endl;
+	std::cout << "uniform changes: " << executor.uniformChanges << std::endl;
+	std::cout << "material binds:  " << executor.materialChanges << std::endl;
+	std::cout << "draw calls:      " << executor.drawCalls << " (" << executor.instancedDrawCalls
+			  << " instanced with " << executor.instances << " instances, " << executor.multiDrawCalls
+			  << " multi-draws of " << executor.multiDrawModels << " models)" << std::endl;
+
+	if(!matches) {
+		std::cerr << "the replayed commands do not match the render queue statistics" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
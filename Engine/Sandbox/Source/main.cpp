@@ -123,7 +123,7 @@ int main() {
 
 	Scene::Scene scene;
 
-	auto root = std::make_shared<Scene::Object>();
+	auto root = Scene::makeObject<Scene::Object>();
 	scene.setRootObject(root);
 
 //	// TODO add plane
@@ -131,7 +131,7 @@ int main() {
 //	auto terrainTextureImage = Graphics::Texture::TextureImage(512, 512, texture, true);
 //	auto terrainTexture = renderer.getTextureCompiler().compileTexture(terrainTextureImage);
 
-	camera = std::make_shared<Scene::Camera>();
+	camera = Scene::makeObject<Scene::Camera>();
 	scene.setCamera(camera);
 	camera->setPosition(glm::vec3(0.0f, 2.0f, 0.0f));
 	camera->Yaw = 0.0;
@@ -139,7 +139,7 @@ int main() {
 	camera->updateCameraVectors();
 
 
-	auto spotLight = std::make_shared<Scene::Light::SpotLight>();
+	auto spotLight = Scene::makeObject<Scene::Light::SpotLight>();
 	spotLight->setDiffuse(glm::vec3(1.0f, 1.0f, 1.0f) * 2.0f);
 	spotLight->setSpecular(glm::vec3(1.0f, 1.0f, 1.0f) * 2.0f);
 	spotLight->setConstant(1.0f);
@@ -17,7 +17,7 @@ glm::vec3 reverseProjection(const glm::mat4& transform, const glm::vec3& positio
 }
 
 int main() {
-	auto camera = std::make_shared<Scene::Camera>();
+	auto camera = Scene::makeObject<Scene::Camera>();
 	camera->setPosition(glm::vec3(100.0f, 0.0, 0.0));
 	camera->Yaw = -30.0;
 	camera->updateCameraVectors();
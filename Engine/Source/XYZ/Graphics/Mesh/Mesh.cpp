@@ -7,6 +7,8 @@
 #include <glm/glm.hpp>
 #include <glm/common.hpp>
 
+#include <cmath>
+
 namespace XYZ::Graphics::Mesh {
 
 	Mesh::Mesh(std::vector<unsigned int> indices, std::vector<Vertex> vertices) :
@@ -66,6 +68,34 @@ namespace XYZ::Graphics::Mesh {
 		};
 	}
 
+	Math::BoundingBox Mesh::getBoundingBox() const {
+		Math::BoundingBox boundingBox;
+		for(const auto& vertex : vertices) {
+			boundingBox.merge(vertex.position);
+		}
+		return boundingBox;
+	}
+
+	float Mesh::computeTexCoordDensity() const {
+		// the ratio of the texture coordinate area to the surface area of every triangle
+		float texCoordArea = 0.0f;
+		float surfaceArea = 0.0f;
+		for(unsigned int i = 0; i < getTriangleCount(); i++) {
+			auto triangle = getTriangle(i);
+
+			auto uv1 = triangle[1].texCoords - triangle[0].texCoords;
+			auto uv2 = triangle[2].texCoords - triangle[0].texCoords;
+			texCoordArea += 0.5f * std::abs(uv1.x * uv2.y - uv1.y * uv2.x);
+			surfaceArea += 0.5f * glm::length(glm::cross(triangle[1].position - triangle[0].position,
+														  triangle[2].position - triangle[0].position));
+		}
+
+		if(surfaceArea <= 0.0f) {
+			return 0.0f;
+		}
+		return std::sqrt(texCoordArea / surfaceArea);
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	const std::shared_ptr<Renderer::VertexBuffer>& Mesh::getCompiledMesh() const {
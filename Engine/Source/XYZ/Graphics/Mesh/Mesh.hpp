@@ -9,6 +9,8 @@
 
 #include "XYZ/Graphics/Mesh/Vertex.hpp"
 
+#include "XYZ/Math/BoundingBox.hpp"
+
 #include <vector>
 #include <array>
 
@@ -131,11 +133,19 @@ namespace XYZ::Graphics::Mesh {
 		std::array<Vertex, 3> getTriangle(unsigned int index) const;
 
 		/**
-		 * The mesh bounding box
+		 * Computes the mesh bounding box in model space
 		 *
 		 * @return the mesh bounding box
 		 */
-		std::array<glm::vec3, 4> getBoundingBox() const;
+		Math::BoundingBox getBoundingBox() const;
+
+		/**
+		 * Computes the average texture coordinate density of the mesh, that is,
+		 * the texture coordinate distance per model space unit on its surface
+		 *
+		 * @return the texture coordinate density or 0 if the mesh has no area
+		 */
+		float computeTexCoordDensity() const;
 
 	public:
 		/**
@@ -4,8 +4,52 @@
 
 #include "Model.hpp"
 
+#include <functional>
+
 namespace XYZ::Graphics::Model {
 
+	void Model::renderInstanced(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail,
+								const std::vector<glm::mat4>& modelMatrices) {
+	}
+
+	Renderer::VertexBuffer* Model::compileVertexBuffer(Renderer::Renderer& renderer,
+													   const LevelOfDetail& levelOfDetail) {
+		return nullptr;
+	}
+
+	std::size_t Model::getMaterialHash() const {
+		return std::hash<const Model*>()(this);
+	}
+
+	bool Model::hasSameMaterial(const Model& other) const {
+		return this == &other;
+	}
+
+	const void* Model::getInstancingKey() const {
+		return nullptr;
+	}
+
+	std::uint32_t Model::getShaderFeatures() const {
+		return GENERIC_SHADER_FEATURES;
+	}
+
+	void Model::visitTextures(const std::function<void(const Texture::Texture& texture)>& visitor) const {
+	}
+
+	float Model::getTexCoordDensity() const {
+		return 0.0f;
+	}
+
+	Math::BoundingBox Model::getBoundingBox() const {
+		return Math::BoundingBox::infinite();
+	}
+
+	const Mesh::Mesh* Model::getOccluderMesh() const {
+		return nullptr;
+	}
 
+	bool Model::shouldCastShadows() const {
+		return true;
+	}
 
 }
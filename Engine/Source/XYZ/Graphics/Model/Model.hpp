@@ -11,10 +11,22 @@
 #include "XYZ/Graphics/Mesh/Mesh.hpp"
 #include "XYZ/Graphics/Material/Material.hpp"
 
+#include "XYZ/Math/BoundingBox.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
 namespace XYZ::Graphics::Renderer {
 	class Renderer;
 }
 
+namespace XYZ::Graphics::Texture {
+	class Texture;
+}
+
 namespace XYZ::Graphics::Model {
 
 	class AbstractModel {
@@ -33,6 +45,24 @@ namespace XYZ::Graphics::Model {
 	 */
 	class Model : public AbstractModel,
 				  public Resource::Resource<Model> {
+	public:
+		/**
+		 * The optional material features a model can use. Renderers may compile a
+		 * specialized shader for each combination of features.
+		 */
+		enum ShaderFeature : std::uint32_t {
+			/**
+			 * The model perturbs its normals with a normal map
+			 */
+			SHADER_FEATURE_NORMAL_MAP = 1 << 0
+		};
+
+		/**
+		 * The features of a model that does not describe them. Those models are
+		 * always rendered with the renderer's generic shader.
+		 */
+		static constexpr std::uint32_t GENERIC_SHADER_FEATURES = 0xFFFFFFFF;
+
 	public:
 		/**
 		 * Renders the model.
@@ -43,6 +73,41 @@ namespace XYZ::Graphics::Model {
 		 */
 		virtual void render(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail) = 0;
 
+		/**
+		 * Renders several instances of the model with a single draw call.
+		 *
+		 * The model matrices are passed to the shader as per-instance vertex
+		 * attributes. This method is only called for models that return a
+		 * non-null <tt>getInstancingKey()</tt>, the default implementation does
+		 * nothing.
+		 *
+		 * This method can only be called from a renderer context.
+		 *
+		 * @param renderer the renderer context
+		 * @param levelOfDetail the level of detail used by every instance
+		 * @param modelMatrices the model matrix of every instance
+		 */
+		virtual void renderInstanced(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail,
+									 const std::vector<glm::mat4>& modelMatrices);
+
+		/**
+		 * Compiles the model geometry, if not compiled yet, and returns its vertex
+		 * buffer. Renderers use it to submit the draws of several models with a
+		 * single call.
+		 *
+		 * The default implementation returns <tt>nullptr</tt>: the model can only
+		 * be drawn by <tt>render</tt> and <tt>renderInstanced</tt>.
+		 *
+		 * This method can only be called from a renderer context.
+		 *
+		 * @param renderer the renderer context
+		 * @param levelOfDetail the model level of detail
+		 *
+		 * @return the model vertex buffer or <tt>nullptr</tt> if the model has no single vertex buffer
+		 */
+		virtual Renderer::VertexBuffer* compileVertexBuffer(Renderer::Renderer& renderer,
+															const LevelOfDetail& levelOfDetail);
+
 		/**
 		 * Sets the shader uniform variables for the model material
 		 *
@@ -51,9 +116,108 @@ namespace XYZ::Graphics::Model {
 		virtual void setMaterialShaderUniforms(Renderer::Renderer& renderer, Shader::ShaderProgram& shader,
 											   const LevelOfDetail& levelOfDetail) = 0;
 
+		/**
+		 * Computes a hash of the model material state.
+		 *
+		 * Models with equal materials must return the same hash. The renderer uses it
+		 * to group draws that share a material so that the material uniforms and
+		 * textures are bound only once per group.
+		 *
+		 * The default implementation considers every model to have an unique material.
+		 *
+		 * @return the material hash
+		 */
+		virtual std::size_t getMaterialHash() const;
+
+		/**
+		 * Checks if <tt>other</tt> can be rendered with the material state set by this
+		 * model's <tt>setMaterialShaderUniforms</tt> call.
+		 *
+		 * @param other the model to compare against
+		 *
+		 * @return true if both models share the same material state
+		 */
+		virtual bool hasSameMaterial(const Model& other) const;
+
+		/**
+		 * Identifies the geometry drawn by the model. Models that return the same
+		 * non-null key draw the exact same geometry and, if they also share the
+		 * same material, can be rendered together with <tt>renderInstanced</tt>.
+		 *
+		 * The default implementation returns <tt>nullptr</tt>: the model is never
+		 * instanced.
+		 *
+		 * @return the instancing key or <tt>nullptr</tt> if the model cannot be instanced
+		 */
+		virtual const void* getInstancingKey() const;
+
+		/**
+		 * The material features used by the model, a combination of <tt>ShaderFeature</tt>
+		 * flags. Must match what <tt>setMaterialShaderUniforms</tt> sets.
+		 *
+		 * The default implementation returns <tt>GENERIC_SHADER_FEATURES</tt>.
+		 *
+		 * @return the model shader features
+		 */
+		virtual std::uint32_t getShaderFeatures() const;
+
+		/**
+		 * Calls <tt>visitor</tt> for every texture sampled by the model material.
+		 * Renderers that stream textures use it to find out which textures are
+		 * visible.
+		 *
+		 * The default implementation visits no texture.
+		 *
+		 * @param visitor the texture visitor
+		 */
+		virtual void visitTextures(const std::function<void(const Texture::Texture& texture)>& visitor) const;
+
+		/**
+		 * The texture coordinate distance per model space unit on the model
+		 * surface. Renderers that stream textures use it to estimate how many
+		 * texels of each texture cover a pixel.
+		 *
+		 * The default implementation returns 0: the density is unknown and the
+		 * textures are assumed to cover the model once.
+		 *
+		 * @return the model texture coordinate density
+		 */
+		virtual float getTexCoordDensity() const;
+
 	public:
 		virtual glm::vec3 getSize() = 0;
 
+		/**
+		 * The model bounding box in model space, used for visibility culling.
+		 *
+		 * The default implementation returns a infinite bounding box, which means
+		 * the model is never culled.
+		 *
+		 * @return the model bounding box
+		 */
+		virtual Math::BoundingBox getBoundingBox() const;
+
+		/**
+		 * The mesh rasterized by the CPU occlusion culling stage to hide the objects
+		 * behind this model. It should be a simplified, watertight version of the
+		 * model geometry that never extends past the rendered geometry.
+		 *
+		 * The default implementation returns <tt>nullptr</tt>: the model does not
+		 * occlude other objects.
+		 *
+		 * @return the model occluder mesh or <tt>nullptr</tt> if the model is not a occluder
+		 */
+		virtual const Mesh::Mesh* getOccluderMesh() const;
+
+		/**
+		 * Checks if the model is rendered into shadow maps.
+		 *
+		 * The default implementation returns true: every model casts shadows.
+		 *
+		 * @return true if the model casts shadows
+		 */
+		virtual bool shouldCastShadows() const;
+
 	};
 
 }
@@ -6,6 +6,8 @@
 
 #include "XYZ/Graphics/Renderer/Renderer.hpp"
 
+#include <functional>
+
 namespace XYZ::Graphics::Model {
 
 	StaticModel::StaticModel(Mesh::Mesh::Ptr mesh,
@@ -20,17 +22,31 @@ namespace XYZ::Graphics::Model {
 			shininess(shininess),
 			normalMap(std::move(normalMap)),
 			castShadows(castShadows) {
+		if(StaticModel::mesh != nullptr) {
+			boundingBox = StaticModel::mesh->getBoundingBox();
+			texCoordDensity = StaticModel::mesh->computeTexCoordDensity();
+		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void StaticModel::render(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail) {
-		if(vertexBuffer == nullptr) {
-			vertexBuffer = renderer.getMeshCompiler().compileMesh(*mesh);
-		}
+		compile(renderer);
 		vertexBuffer->draw();
 	}
 
+	void StaticModel::renderInstanced(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail,
+									  const std::vector<glm::mat4>& modelMatrices) {
+		compile(renderer);
+		vertexBuffer->drawInstanced(modelMatrices);
+	}
+
+	Renderer::VertexBuffer* StaticModel::compileVertexBuffer(Renderer::Renderer& renderer,
+															 const LevelOfDetail& levelOfDetail) {
+		compile(renderer);
+		return vertexBuffer.get();
+	}
+
 	void StaticModel::setMaterialShaderUniforms(Renderer::Renderer& renderer, Shader::ShaderProgram& shader,
 												const LevelOfDetail& levelOfDetail) {
 		shader.set("material.shininess", shininess);
@@ -57,10 +73,73 @@ namespace XYZ::Graphics::Model {
 		}
 	}
 
+	std::size_t StaticModel::getMaterialHash() const {
+		std::size_t hash = 0;
+		auto combine = [&hash](std::size_t value) {
+			hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		};
+
+		combine(std::hash<const Texture::Texture*>()(diffuseTexture.get()));
+		combine(std::hash<const Texture::Texture*>()(specularTexture.get()));
+		combine(std::hash<const Texture::Texture*>()(normalMap.get()));
+		combine(std::hash<float>()(shininess));
+		for(int i = 0; i < 3; i++) {
+			combine(std::hash<float>()(diffuseColor[i]));
+			combine(std::hash<float>()(specularColor[i]));
+		}
+
+		return hash;
+	}
+
+	const void* StaticModel::getInstancingKey() const {
+		if(mesh != nullptr) {
+			return mesh.get();
+		}
+		return vertexBuffer.get();
+	}
+
+	std::uint32_t StaticModel::getShaderFeatures() const {
+		return normalMap != nullptr ? SHADER_FEATURE_NORMAL_MAP : 0;
+	}
+
+	bool StaticModel::hasSameMaterial(const Model& other) const {
+		if(this == &other) {
+			return true;
+		}
+
+		auto staticModel = dynamic_cast<const StaticModel*>(&other);
+		if(staticModel == nullptr) {
+			return false;
+		}
+
+		return diffuseTexture == staticModel->diffuseTexture &&
+			   specularTexture == staticModel->specularTexture &&
+			   normalMap == staticModel->normalMap &&
+			   shininess == staticModel->shininess &&
+			   diffuseColor == staticModel->diffuseColor &&
+			   specularColor == staticModel->specularColor;
+	}
+
+	void StaticModel::visitTextures(const std::function<void(const Texture::Texture& texture)>& visitor) const {
+		for(const auto* texture : {diffuseTexture.get(), specularTexture.get(), normalMap.get()}) {
+			if(texture != nullptr) {
+				visitor(*texture);
+			}
+		}
+	}
+
+	float StaticModel::getTexCoordDensity() const {
+		return texCoordDensity;
+	}
+
 	glm::vec3 StaticModel::getSize() {
 		return glm::vec3(0.0);
 	}
 
+	Math::BoundingBox StaticModel::getBoundingBox() const {
+		return boundingBox;
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	const Mesh::Mesh::Ptr& StaticModel::getMesh() const {
@@ -69,6 +148,10 @@ namespace XYZ::Graphics::Model {
 
 	void StaticModel::setMesh(const Mesh::Mesh::Ptr& mesh) {
 		StaticModel::mesh = mesh;
+		if(mesh != nullptr) {
+			boundingBox = mesh->getBoundingBox();
+			texCoordDensity = mesh->computeTexCoordDensity();
+		}
 	}
 
 	const Renderer::VertexBuffer::Ptr& StaticModel::getVertexBuffer() const {
@@ -135,6 +218,29 @@ namespace XYZ::Graphics::Model {
 		StaticModel::castShadows = castShadows;
 	}
 
+	const Mesh::Mesh* StaticModel::getOccluderMesh() const {
+		return occluderMesh.get();
+	}
+
+	void StaticModel::setOccluderMesh(const Mesh::Mesh::Ptr& occluderMesh) {
+		StaticModel::occluderMesh = occluderMesh;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void StaticModel::compile(Renderer::Renderer& renderer) {
+		if(vertexBuffer != nullptr) {
+			return;
+		}
+
+		// models sharing a mesh also share its vertex buffer
+		vertexBuffer = mesh->getCompiledMesh();
+		if(vertexBuffer == nullptr) {
+			vertexBuffer = renderer.getMeshCompiler().compileMesh(*mesh);
+			mesh->setCompiledMesh(vertexBuffer);
+		}
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	bool StaticModel::didReceiveMemoryWarning() {
@@ -26,6 +26,16 @@ namespace XYZ::Graphics::Model {
 		 */
 		Renderer::VertexBuffer::Ptr vertexBuffer;
 
+		/**
+		 * The mesh bounding box. It is kept even if the mesh is released.
+		 */
+		Math::BoundingBox boundingBox;
+
+		/**
+		 * The mesh texture coordinate density. It is kept even if the mesh is released.
+		 */
+		float texCoordDensity = 0.0f;
+
 	private: // Phong material properties
 		/**
 		 * The model's diffuse color
@@ -63,6 +73,13 @@ namespace XYZ::Graphics::Model {
 		 */
 		bool castShadows = true;
 
+	private: // Occlusion
+		/**
+		 * The mesh used to occlude other objects. If <tt>nullptr</tt>, the model
+		 * does not occlude other objects.
+		 */
+		Mesh::Mesh::Ptr occluderMesh;
+
 	public:
 		/**
 		 * Create a new static model with a mesh object
@@ -91,6 +108,29 @@ namespace XYZ::Graphics::Model {
 		 */
 		void render(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail) final;
 
+		/**
+		 * Renders several instances of the model with a single draw call.
+		 *
+		 * This method can only be called from a renderer context.
+		 *
+		 * @param renderer the renderer context
+		 * @param levelOfDetail the level of detail used by every instance
+		 * @param modelMatrices the model matrix of every instance
+		 */
+		void renderInstanced(Renderer::Renderer& renderer, const LevelOfDetail& levelOfDetail,
+							 const std::vector<glm::mat4>& modelMatrices) final;
+
+		/**
+		 * Compiles the model mesh, if not compiled yet
+		 *
+		 * @param renderer the renderer context
+		 * @param levelOfDetail the model level of detail
+		 *
+		 * @return the model's compiled vertex buffer
+		 */
+		Renderer::VertexBuffer* compileVertexBuffer(Renderer::Renderer& renderer,
+													const LevelOfDetail& levelOfDetail) final;
+
 		/**
 		 * Sets the shader uniform variables for the model material
 		 *
@@ -99,9 +139,55 @@ namespace XYZ::Graphics::Model {
 		void setMaterialShaderUniforms(Renderer::Renderer& renderer, Shader::ShaderProgram& shader,
 									   const LevelOfDetail& levelOfDetail) final;
 
+		/**
+		 * Computes a hash of the model textures, colors and shininess.
+		 *
+		 * @return the material hash
+		 */
+		std::size_t getMaterialHash() const final;
+
+		/**
+		 * Static models that share the same mesh object can be instanced
+		 *
+		 * @return the model mesh, or its vertex buffer if the mesh was released
+		 */
+		const void* getInstancingKey() const final;
+
+		/**
+		 * @return <tt>SHADER_FEATURE_NORMAL_MAP</tt> if the model has a normal map
+		 */
+		std::uint32_t getShaderFeatures() const final;
+
+		/**
+		 * Checks if <tt>other</tt> is a static model with the same textures, colors
+		 * and shininess.
+		 *
+		 * @param other the model to compare against
+		 *
+		 * @return true if both models share the same material state
+		 */
+		bool hasSameMaterial(const Model& other) const final;
+
+		/**
+		 * Visits the diffuse, specular and normal map textures, if set
+		 *
+		 * @param visitor the texture visitor
+		 */
+		void visitTextures(const std::function<void(const Texture::Texture& texture)>& visitor) const final;
+
+		/**
+		 * @return the mesh texture coordinate density
+		 */
+		float getTexCoordDensity() const final;
+
 	public:
 		virtual glm::vec3 getSize() final override;
 
+		/**
+		 * @return the model's mesh bounding box
+		 */
+		Math::BoundingBox getBoundingBox() const final;
+
 	public:
 		/**
 		 * @return the model's mesh object
@@ -186,13 +272,24 @@ namespace XYZ::Graphics::Model {
 		/**
 		 * @return a boolean flag indicating if a model should cast shadows
 		 */
-		bool shouldCastShadows() const;
+		bool shouldCastShadows() const override;
 
 		/**
 		 * @param castShadows a boolean flag indicating if a model should cast shadows
 		 */
 		void setCastShadows(bool castShadows);
 
+		/**
+		 * @return the mesh used to occlude other objects
+		 */
+		const Mesh::Mesh* getOccluderMesh() const final;
+
+		/**
+		 * @param occluderMesh the mesh used to occlude other objects. If <tt>nullptr</tt>,
+		 * the model does not occlude other objects.
+		 */
+		void setOccluderMesh(const Mesh::Mesh::Ptr& occluderMesh);
+
 	public:
 		/**
 		 * A event called whenever the engine is running low on memory.
@@ -205,6 +302,14 @@ namespace XYZ::Graphics::Model {
 		 */
 		bool didReceiveMemoryWarning() override;
 
+	private:
+		/**
+		 * Compiles the model mesh into a vertex buffer, if not compiled yet
+		 *
+		 * @param renderer the renderer context
+		 */
+		void compile(Renderer::Renderer& renderer);
+
 	};
 
 }
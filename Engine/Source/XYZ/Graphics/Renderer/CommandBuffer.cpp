@@ -0,0 +1,122 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "CommandBuffer.hpp"
+#include "CommandExecutor.hpp"
+
+namespace XYZ::Graphics::Renderer {
+
+	void CommandBuffer::clear() {
+		commands.clear();
+		matrices.clear();
+		vectors.clear();
+		levelsOfDetail.clear();
+		models.clear();
+	}
+
+	void CommandBuffer::bindProgram(Shader::ShaderProgram& program) {
+		commands.push_back(Command{CommandType::BIND_PROGRAM, 0, 0, 0, 0, nullptr, &program, nullptr});
+	}
+
+	void CommandBuffer::setUniform(const char* name, const glm::mat4& v) {
+		commands.push_back(Command{
+				CommandType::SET_UNIFORM_MAT4, 0, std::uint32_t(matrices.size()), 0, 0, name, nullptr, nullptr
+		});
+		matrices.push_back(v);
+	}
+
+	void CommandBuffer::setUniform(const char* name, const glm::vec3& v) {
+		commands.push_back(Command{
+				CommandType::SET_UNIFORM_VEC3, 0, std::uint32_t(vectors.size()), 0, 0, name, nullptr, nullptr
+		});
+		vectors.push_back(v);
+	}
+
+	void CommandBuffer::setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		commands.push_back(Command{
+				CommandType::SET_MATERIAL, 0, 0, 0, std::uint32_t(levelsOfDetail.size()), nullptr, nullptr, &model
+		});
+		levelsOfDetail.push_back(levelOfDetail);
+	}
+
+	void CommandBuffer::draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		commands.push_back(Command{
+				CommandType::DRAW, 1, 0, 0, std::uint32_t(levelsOfDetail.size()), nullptr, nullptr, &model
+		});
+		levelsOfDetail.push_back(levelOfDetail);
+	}
+
+	void CommandBuffer::drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+									  const std::vector<glm::mat4>& modelMatrices) {
+		commands.push_back(Command{
+				CommandType::DRAW_INSTANCED, std::uint32_t(modelMatrices.size()), std::uint32_t(matrices.size()), 0,
+				std::uint32_t(levelsOfDetail.size()), nullptr, nullptr, &model
+		});
+		matrices.insert(matrices.end(), modelMatrices.begin(), modelMatrices.end());
+		levelsOfDetail.push_back(levelOfDetail);
+	}
+
+	void CommandBuffer::drawMulti(const std::vector<Model::Model*>& models, const Model::LevelOfDetail& levelOfDetail,
+								  const std::vector<glm::mat4>& modelMatrices) {
+		commands.push_back(Command{
+				CommandType::DRAW_MULTI, std::uint32_t(models.size()), std::uint32_t(matrices.size()),
+				std::uint32_t(CommandBuffer::models.size()), std::uint32_t(levelsOfDetail.size()), nullptr, nullptr,
+				nullptr
+		});
+		matrices.insert(matrices.end(), modelMatrices.begin(), modelMatrices.end());
+		CommandBuffer::models.insert(CommandBuffer::models.end(), models.begin(), models.end());
+		levelsOfDetail.push_back(levelOfDetail);
+	}
+
+	void CommandBuffer::execute(CommandExecutor& executor) const {
+		for(const auto& command : commands) {
+			switch(command.type) {
+				case CommandType::BIND_PROGRAM:
+					executor.bindProgram(*command.program);
+					break;
+
+				case CommandType::SET_UNIFORM_MAT4:
+					executor.setUniform(command.name, matrices[command.data]);
+					break;
+
+				case CommandType::SET_UNIFORM_VEC3:
+					executor.setUniform(command.name, vectors[command.data]);
+					break;
+
+				case CommandType::SET_MATERIAL:
+					executor.setMaterial(*command.model, levelsOfDetail[command.levelOfDetail]);
+					break;
+
+				case CommandType::DRAW:
+					executor.draw(*command.model, levelsOfDetail[command.levelOfDetail]);
+					break;
+
+				case CommandType::DRAW_INSTANCED:
+					executor.drawInstanced(*command.model, levelsOfDetail[command.levelOfDetail],
+										   &matrices[command.data], command.count);
+					break;
+
+				case CommandType::DRAW_MULTI:
+					executor.drawMulti(&models[command.models], levelsOfDetail[command.levelOfDetail],
+									   &matrices[command.data], command.count);
+					break;
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::size_t CommandBuffer::size() const {
+		return commands.size();
+	}
+
+	bool CommandBuffer::empty() const {
+		return commands.empty();
+	}
+
+	const std::vector<CommandBuffer::Command>& CommandBuffer::getCommands() const {
+		return commands;
+	}
+
+}
@@ -0,0 +1,242 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Model/Model.hpp"
+#include "XYZ/Graphics/Model/LevelOfDetail.hpp"
+#include "XYZ/Graphics/Shader/ShaderProgram.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	class CommandExecutor;
+
+	/**
+	 * The type of a recorded command
+	 */
+	enum class CommandType : std::uint8_t {
+		/**
+		 * Makes a shader program the active program
+		 */
+		BIND_PROGRAM,
+
+		/**
+		 * Sets a mat4 uniform on the active program
+		 */
+		SET_UNIFORM_MAT4,
+
+		/**
+		 * Sets a vec3 uniform on the active program
+		 */
+		SET_UNIFORM_VEC3,
+
+		/**
+		 * Binds the material textures and uniforms of a model on the active program
+		 */
+		SET_MATERIAL,
+
+		/**
+		 * Draws a model
+		 */
+		DRAW,
+
+		/**
+		 * Draws several instances of a model
+		 */
+		DRAW_INSTANCED,
+
+		/**
+		 * Draws several models that share the same material with a single call
+		 */
+		DRAW_MULTI
+	};
+
+	/**
+	 * A command buffer records rendering commands without calling the graphics
+	 * API, so that it can be filled from any thread.
+	 *
+	 * Commands only hold pointers to the programs and models they use, which must
+	 * outlive the buffer. Uniform values, instance matrices and levels of detail
+	 * are copied into arenas owned by the buffer. A buffer is replayed by a
+	 * <tt>CommandExecutor</tt>, usually on the thread that owns the graphics
+	 * context.
+	 *
+	 * Recording into a buffer is not thread-safe, every thread must record into
+	 * its own buffer. Clearing a buffer keeps its memory, so that buffers reused
+	 * every frame stop allocating after the first few frames.
+	 */
+	class CommandBuffer {
+	public:
+		/**
+		 * A single recorded command
+		 */
+		struct Command {
+			/**
+			 * The command type
+			 */
+			CommandType type;
+
+			/**
+			 * The number of instances of a <tt>DRAW_INSTANCED</tt> command and the
+			 * number of models of a <tt>DRAW_MULTI</tt> command
+			 */
+			std::uint32_t count;
+
+			/**
+			 * The index of the command value in its arena: the uniform value for
+			 * <tt>SET_UNIFORM_*</tt> commands and the first model matrix for
+			 * <tt>DRAW_INSTANCED</tt> and <tt>DRAW_MULTI</tt> commands
+			 */
+			std::uint32_t data;
+
+			/**
+			 * The index of the first model of a <tt>DRAW_MULTI</tt> command
+			 */
+			std::uint32_t models;
+
+			/**
+			 * The index of the level of detail of <tt>SET_MATERIAL</tt> and <tt>DRAW*</tt> commands
+			 */
+			std::uint32_t levelOfDetail;
+
+			/**
+			 * The uniform name of <tt>SET_UNIFORM_*</tt> commands
+			 */
+			const char* name;
+
+			/**
+			 * The program of <tt>BIND_PROGRAM</tt> commands
+			 */
+			Shader::ShaderProgram* program;
+
+			/**
+			 * The model of <tt>SET_MATERIAL</tt>, <tt>DRAW</tt> and <tt>DRAW_INSTANCED</tt> commands
+			 */
+			Model::Model* model;
+		};
+
+	private:
+		/**
+		 * The recorded commands
+		 */
+		std::vector<Command> commands;
+
+		/**
+		 * The mat4 uniform values and instance matrices
+		 */
+		std::vector<glm::mat4> matrices;
+
+		/**
+		 * The vec3 uniform values
+		 */
+		std::vector<glm::vec3> vectors;
+
+		/**
+		 * The levels of detail of the material and draw commands
+		 */
+		std::vector<Model::LevelOfDetail> levelsOfDetail;
+
+		/**
+		 * The models of the multi-draw commands
+		 */
+		std::vector<Model::Model*> models;
+
+	public:
+		/**
+		 * Removes all commands from the buffer. Allocated memory is kept for the
+		 * next frame.
+		 */
+		void clear();
+
+		/**
+		 * Records a program bind
+		 *
+		 * @param program the program to bind
+		 */
+		void bindProgram(Shader::ShaderProgram& program);
+
+		/**
+		 * Records a mat4 uniform change on the bound program
+		 *
+		 * @param name the uniform name. Must be a string literal, only the pointer is kept.
+		 * @param v the uniform value
+		 */
+		void setUniform(const char* name, const glm::mat4& v);
+
+		/**
+		 * Records a vec3 uniform change on the bound program
+		 *
+		 * @param name the uniform name. Must be a string literal, only the pointer is kept.
+		 * @param v the uniform value
+		 */
+		void setUniform(const char* name, const glm::vec3& v);
+
+		/**
+		 * Records a material bind on the bound program
+		 *
+		 * @param model the model whose material is bound
+		 * @param levelOfDetail the model level of detail
+		 */
+		void setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail);
+
+		/**
+		 * Records a draw
+		 *
+		 * @param model the model to draw
+		 * @param levelOfDetail the model level of detail
+		 */
+		void draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail);
+
+		/**
+		 * Records a instanced draw
+		 *
+		 * @param model the model to draw
+		 * @param levelOfDetail the level of detail used by every instance
+		 * @param modelMatrices the model matrix of every instance
+		 */
+		void drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+						   const std::vector<glm::mat4>& modelMatrices);
+
+		/**
+		 * Records a multi-draw of several models that share the same material
+		 *
+		 * @param models the models to draw
+		 * @param levelOfDetail the level of detail used by every model
+		 * @param modelMatrices the model matrix of every model
+		 */
+		void drawMulti(const std::vector<Model::Model*>& models, const Model::LevelOfDetail& levelOfDetail,
+					   const std::vector<glm::mat4>& modelMatrices);
+
+		/**
+		 * Replays the recorded commands in order
+		 *
+		 * @param executor the executor to replay the commands on
+		 */
+		void execute(CommandExecutor& executor) const;
+
+	public:
+		/**
+		 * @return the number of recorded commands
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @return true if no command was recorded
+		 */
+		bool empty() const;
+
+		/**
+		 * @return the recorded commands
+		 */
+		const std::vector<Command>& getCommands() const;
+
+	};
+
+}
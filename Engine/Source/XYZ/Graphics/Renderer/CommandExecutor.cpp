@@ -0,0 +1,98 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "CommandExecutor.hpp"
+
+#include "XYZ/Graphics/Renderer/Renderer.hpp"
+
+namespace XYZ::Graphics::Renderer {
+
+	RendererCommandExecutor::RendererCommandExecutor(Renderer& renderer) : renderer(renderer) {
+
+	}
+
+	void RendererCommandExecutor::bindProgram(Shader::ShaderProgram& program) {
+		program.activate();
+		RendererCommandExecutor::program = &program;
+	}
+
+	void RendererCommandExecutor::setUniform(const char* name, const glm::mat4& v) {
+		program->set(name, v);
+	}
+
+	void RendererCommandExecutor::setUniform(const char* name, const glm::vec3& v) {
+		program->set(name, v);
+	}
+
+	void RendererCommandExecutor::setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		model.setMaterialShaderUniforms(renderer, *program, levelOfDetail);
+	}
+
+	void RendererCommandExecutor::draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		model.render(renderer, levelOfDetail);
+	}
+
+	void RendererCommandExecutor::drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+												const glm::mat4* modelMatrices, std::size_t count) {
+		instanceMatrices.assign(modelMatrices, modelMatrices + count);
+		model.renderInstanced(renderer, levelOfDetail, instanceMatrices);
+	}
+
+	void RendererCommandExecutor::drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+											const glm::mat4* modelMatrices, std::size_t count) {
+		// the bound program is a instanced one, so even single models are drawn as instances
+		for(std::size_t i = 0; i < count;) {
+			auto key = models[i]->getInstancingKey();
+
+			std::size_t instances = 1;
+			while(i + instances < count && models[i + instances]->getInstancingKey() == key) {
+				instances++;
+			}
+
+			drawInstanced(*models[i], levelOfDetail, &modelMatrices[i], instances);
+			i += instances;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void NullCommandExecutor::reset() {
+		*this = NullCommandExecutor();
+	}
+
+	void NullCommandExecutor::bindProgram(Shader::ShaderProgram& program) {
+		programBinds++;
+	}
+
+	void NullCommandExecutor::setUniform(const char* name, const glm::mat4& v) {
+		uniformChanges++;
+	}
+
+	void NullCommandExecutor::setUniform(const char* name, const glm::vec3& v) {
+		uniformChanges++;
+	}
+
+	void NullCommandExecutor::setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		materialChanges++;
+	}
+
+	void NullCommandExecutor::draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) {
+		drawCalls++;
+	}
+
+	void NullCommandExecutor::drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+											const glm::mat4* modelMatrices, std::size_t count) {
+		drawCalls++;
+		instancedDrawCalls++;
+		instances += count;
+	}
+
+	void NullCommandExecutor::drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+										const glm::mat4* modelMatrices, std::size_t count) {
+		drawCalls++;
+		multiDrawCalls++;
+		multiDrawModels += count;
+	}
+
+}
@@ -0,0 +1,209 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Model/Model.hpp"
+#include "XYZ/Graphics/Model/LevelOfDetail.hpp"
+#include "XYZ/Graphics/Shader/ShaderProgram.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	class Renderer;
+
+	/**
+	 * A command executor replays the commands recorded on a <tt>CommandBuffer</tt>
+	 * against a rendering backend.
+	 */
+	class CommandExecutor {
+	public:
+		/**
+		 * Virtual destructor.
+		 */
+		virtual ~CommandExecutor() = default;
+
+	public:
+		/**
+		 * Makes a shader program the active program
+		 *
+		 * @param program the program to bind
+		 */
+		virtual void bindProgram(Shader::ShaderProgram& program) = 0;
+
+		/**
+		 * Sets a mat4 uniform on the active program
+		 *
+		 * @param name the uniform name
+		 * @param v the uniform value
+		 */
+		virtual void setUniform(const char* name, const glm::mat4& v) = 0;
+
+		/**
+		 * Sets a vec3 uniform on the active program
+		 *
+		 * @param name the uniform name
+		 * @param v the uniform value
+		 */
+		virtual void setUniform(const char* name, const glm::vec3& v) = 0;
+
+		/**
+		 * Binds the material of a model on the active program
+		 *
+		 * @param model the model whose material is bound
+		 * @param levelOfDetail the model level of detail
+		 */
+		virtual void setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) = 0;
+
+		/**
+		 * Draws a model
+		 *
+		 * @param model the model to draw
+		 * @param levelOfDetail the model level of detail
+		 */
+		virtual void draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) = 0;
+
+		/**
+		 * Draws several instances of a model
+		 *
+		 * @param model the model to draw
+		 * @param levelOfDetail the level of detail used by every instance
+		 * @param modelMatrices the model matrix of every instance
+		 * @param count the number of instances
+		 */
+		virtual void drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+								   const glm::mat4* modelMatrices, std::size_t count) = 0;
+
+		/**
+		 * Draws several models that share the same material
+		 *
+		 * @param models the models to draw
+		 * @param levelOfDetail the level of detail used by every model
+		 * @param modelMatrices the model matrix of every model
+		 * @param count the number of models
+		 */
+		virtual void drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+							   const glm::mat4* modelMatrices, std::size_t count) = 0;
+	};
+
+	/**
+	 * A command executor that replays commands through a renderer, its shader
+	 * programs and its models. Must be used on the thread that owns the renderer
+	 * context.
+	 *
+	 * Multi-draws are split into one instanced draw per run of models that share
+	 * the same geometry. Backends that can submit them with a single call
+	 * override <tt>drawMulti</tt>.
+	 */
+	class RendererCommandExecutor : public CommandExecutor {
+	protected:
+		/**
+		 * The renderer context
+		 */
+		Renderer& renderer;
+
+	private:
+		/**
+		 * The active program
+		 */
+		Shader::ShaderProgram* program = nullptr;
+
+		/**
+		 * The model matrices of the instanced draw being replayed
+		 */
+		std::vector<glm::mat4> instanceMatrices;
+
+	public:
+		/**
+		 * Creates a new executor
+		 *
+		 * @param renderer the renderer context
+		 */
+		explicit RendererCommandExecutor(Renderer& renderer);
+
+	public:
+		void bindProgram(Shader::ShaderProgram& program) final;
+		void setUniform(const char* name, const glm::mat4& v) final;
+		void setUniform(const char* name, const glm::vec3& v) final;
+		void setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) final;
+		void draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) final;
+		void drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+						   const glm::mat4* modelMatrices, std::size_t count) final;
+		void drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+					   const glm::mat4* modelMatrices, std::size_t count) override;
+
+	};
+
+	/**
+	 * A command executor that does not render anything and only counts the
+	 * commands it receives. Used to test and benchmark the renderer CPU side
+	 * without a graphics context.
+	 */
+	class NullCommandExecutor final : public CommandExecutor {
+	public:
+		/**
+		 * The number of programs bound
+		 */
+		unsigned int programBinds = 0;
+
+		/**
+		 * The number of uniforms set
+		 */
+		unsigned int uniformChanges = 0;
+
+		/**
+		 * The number of materials bound
+		 */
+		unsigned int materialChanges = 0;
+
+		/**
+		 * The number of draw calls, including instanced ones
+		 */
+		unsigned int drawCalls = 0;
+
+		/**
+		 * The number of instanced draw calls
+		 */
+		unsigned int instancedDrawCalls = 0;
+
+		/**
+		 * The number of instances drawn by instanced draw calls
+		 */
+		unsigned int instances = 0;
+
+		/**
+		 * The number of multi-draw calls. Included in <tt>drawCalls</tt>.
+		 */
+		unsigned int multiDrawCalls = 0;
+
+		/**
+		 * The number of models drawn by multi-draw calls
+		 */
+		unsigned int multiDrawModels = 0;
+
+	public:
+		/**
+		 * Resets all counters
+		 */
+		void reset();
+
+	public:
+		void bindProgram(Shader::ShaderProgram& program) final;
+		void setUniform(const char* name, const glm::mat4& v) final;
+		void setUniform(const char* name, const glm::vec3& v) final;
+		void setMaterial(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) final;
+		void draw(Model::Model& model, const Model::LevelOfDetail& levelOfDetail) final;
+		void drawInstanced(Model::Model& model, const Model::LevelOfDetail& levelOfDetail,
+						   const glm::mat4* modelMatrices, std::size_t count) final;
+		void drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+					   const glm::mat4* modelMatrices, std::size_t count) final;
+
+	};
+
+}
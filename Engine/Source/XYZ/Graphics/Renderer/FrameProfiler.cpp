@@ -0,0 +1,214 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "FrameProfiler.hpp"
+
+namespace XYZ::Graphics::Renderer {
+
+	static double toMilliseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	static double toMilliseconds(std::uint64_t start, std::uint64_t end) {
+		return end < start ? 0.0 : double(end - start) / 1000000.0;
+	}
+
+	static void writeJSONString(std::ostream& stream, const std::string& string) {
+		stream << '"';
+		for(auto c : string) {
+			if(c == '"' || c == '\\') {
+				stream << '\\';
+			}
+			stream << c;
+		}
+		stream << '"';
+	}
+
+	static void writeTime(std::ostream& stream, double time, const char* unavailable) {
+		if(time < 0.0) {
+			stream << unavailable;
+		} else {
+			stream << time;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	FrameProfiler::Scope::Scope(FrameProfiler& profiler, const char* name) :
+			profiler(profiler), index(profiler.beginScope(name)) {
+
+	}
+
+	FrameProfiler::Scope::~Scope() {
+		profiler.endScope(index);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	FrameProfiler::FrameProfiler(std::size_t historySize) : historySize(historySize) {
+
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void FrameProfiler::beginFrame() {
+		if(!enabled) {
+			return;
+		}
+
+		auto slot = std::size_t(frameCount % FRAMES_IN_FLIGHT);
+		if(frames[slot].pending) {
+			resolve(slot);
+		}
+
+		auto& frame = frames[slot];
+		frame.timing = FrameTiming();
+		frame.timing.index = frameCount++;
+		frame.scopeStarts.clear();
+
+		currentFrame = slot;
+		depth = 0;
+
+		writeGPUTimestamp(slot, 0);
+		frame.start = Clock::now();
+	}
+
+	void FrameProfiler::endFrame() {
+		if(currentFrame == FRAMES_IN_FLIGHT) {
+			return;
+		}
+
+		auto& frame = frames[currentFrame];
+		frame.timing.cpuTime = toMilliseconds(Clock::now() - frame.start);
+		writeGPUTimestamp(currentFrame, 1);
+
+		frame.pending = true;
+		currentFrame = FRAMES_IN_FLIGHT;
+	}
+
+	std::size_t FrameProfiler::beginScope(const char* name) {
+		if(currentFrame == FRAMES_IN_FLIGHT) {
+			return INVALID_SCOPE;
+		}
+
+		auto& frame = frames[currentFrame];
+		auto index = frame.timing.scopes.size();
+		frame.timing.scopes.push_back(ScopeTiming{name, depth++, 0.0, -1.0});
+
+		writeGPUTimestamp(currentFrame, 2 * index + 2);
+		frame.scopeStarts.push_back(Clock::now());
+		return index;
+	}
+
+	void FrameProfiler::endScope(std::size_t scope) {
+		if(currentFrame == FRAMES_IN_FLIGHT || scope == INVALID_SCOPE) {
+			return;
+		}
+
+		auto& frame = frames[currentFrame];
+		frame.timing.scopes[scope].cpuTime = toMilliseconds(Clock::now() - frame.scopeStarts[scope]);
+		writeGPUTimestamp(currentFrame, 2 * scope + 3);
+		depth--;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool FrameProfiler::isEnabled() const {
+		return enabled;
+	}
+
+	void FrameProfiler::setEnabled(bool enabled) {
+		FrameProfiler::enabled = enabled;
+	}
+
+	const FrameProfiler::FrameTiming* FrameProfiler::getLastFrame() const {
+		return history.empty() ? nullptr : &history.back();
+	}
+
+	const std::deque<FrameProfiler::FrameTiming>& FrameProfiler::getHistory() const {
+		return history;
+	}
+
+	void FrameProfiler::clearHistory() {
+		history.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void FrameProfiler::exportCSV(std::ostream& stream) const {
+		stream << "frame,scope,depth,cpu_ms,gpu_ms\n";
+		for(const auto& frame : history) {
+			stream << frame.index << ",frame,," << frame.cpuTime << ",";
+			writeTime(stream, frame.gpuTime, "");
+			stream << "\n";
+
+			for(const auto& scope : frame.scopes) {
+				stream << frame.index << "," << scope.name << "," << scope.depth << "," << scope.cpuTime << ",";
+				writeTime(stream, scope.gpuTime, "");
+				stream << "\n";
+			}
+		}
+	}
+
+	void FrameProfiler::exportJSON(std::ostream& stream) const {
+		stream << "{\"frames\":[";
+		for(std::size_t i = 0; i < history.size(); i++) {
+			const auto& frame = history[i];
+			if(i != 0) {
+				stream << ",";
+			}
+
+			stream << "{\"index\":" << frame.index << ",\"cpuTime\":" << frame.cpuTime << ",\"gpuTime\":";
+			writeTime(stream, frame.gpuTime, "null");
+			stream << ",\"scopes\":[";
+
+			for(std::size_t j = 0; j < frame.scopes.size(); j++) {
+				const auto& scope = frame.scopes[j];
+				if(j != 0) {
+					stream << ",";
+				}
+
+				stream << "{\"name\":";
+				writeJSONString(stream, scope.name);
+				stream << ",\"depth\":" << scope.depth << ",\"cpuTime\":" << scope.cpuTime << ",\"gpuTime\":";
+				writeTime(stream, scope.gpuTime, "null");
+				stream << "}";
+			}
+			stream << "]}";
+		}
+		stream << "]}\n";
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void FrameProfiler::writeGPUTimestamp(std::size_t frame, std::size_t query) {
+
+	}
+
+	bool FrameProfiler::readGPUTimestamps(std::size_t frame, std::size_t count, std::vector<std::uint64_t>& timestamps) {
+		return false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void FrameProfiler::resolve(std::size_t frame) {
+		auto& pending = frames[frame];
+		auto& timing = pending.timing;
+
+		auto count = 2 * timing.scopes.size() + 2;
+		if(readGPUTimestamps(frame, count, timestamps)) {
+			timing.gpuTime = toMilliseconds(timestamps[0], timestamps[1]);
+			for(std::size_t i = 0; i < timing.scopes.size(); i++) {
+				timing.scopes[i].gpuTime = toMilliseconds(timestamps[2 * i + 2], timestamps[2 * i + 3]);
+			}
+		}
+
+		history.push_back(std::move(timing));
+		while(history.size() > historySize) {
+			history.pop_front();
+		}
+		pending.pending = false;
+	}
+
+}
@@ -0,0 +1,332 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * A frame profiler measures the CPU and GPU time of named scopes of every
+	 * frame, such as the passes of a rendering technique.
+	 *
+	 * CPU times are measured with a steady clock. GPU times are measured with
+	 * timestamps written by the backend into the command stream at the start
+	 * and end of every scope. To never stall waiting for the GPU, the timestamps
+	 * of a frame are only read <tt>FRAMES_IN_FLIGHT</tt> frames later: a frame
+	 * becomes available on <tt>getLastFrame</tt> and on the history once its
+	 * timestamps are read. If the GPU is still behind at that point, the frame
+	 * is kept without GPU times.
+	 *
+	 * The base class only measures CPU times. Backends implement
+	 * <tt>writeGPUTimestamp</tt> and <tt>readGPUTimestamps</tt> to add GPU times.
+	 *
+	 * Scopes can be nested. A profiler must only be used from the rendering thread.
+	 */
+	class FrameProfiler {
+	public:
+		/**
+		 * The number of frames recorded before the timestamps of a frame are read
+		 */
+		static constexpr std::size_t FRAMES_IN_FLIGHT = 3;
+
+		/**
+		 * A invalid scope index, returned when the profiler is disabled
+		 */
+		static constexpr std::size_t INVALID_SCOPE = ~std::size_t(0);
+
+		/**
+		 * The time spent in a scope
+		 */
+		struct ScopeTiming {
+			/**
+			 * The scope name
+			 */
+			std::string name;
+
+			/**
+			 * The number of scopes this scope is nested in
+			 */
+			unsigned int depth;
+
+			/**
+			 * The CPU time, in milliseconds
+			 */
+			double cpuTime;
+
+			/**
+			 * The GPU time, in milliseconds. Negative if not available.
+			 */
+			double gpuTime;
+		};
+
+		/**
+		 * The time spent in a frame
+		 */
+		struct FrameTiming {
+			/**
+			 * The frame number
+			 */
+			std::uint64_t index = 0;
+
+			/**
+			 * The CPU time between <tt>beginFrame</tt> and <tt>endFrame</tt>, in milliseconds
+			 */
+			double cpuTime = 0.0;
+
+			/**
+			 * The GPU time between <tt>beginFrame</tt> and <tt>endFrame</tt>, in
+			 * milliseconds. Negative if not available.
+			 */
+			double gpuTime = -1.0;
+
+			/**
+			 * The scopes of the frame, in the order they were started
+			 */
+			std::vector<ScopeTiming> scopes;
+		};
+
+		/**
+		 * Measures a scope for as long as the object lives
+		 */
+		class Scope {
+		private:
+			/**
+			 * The profiler measuring the scope
+			 */
+			FrameProfiler& profiler;
+
+			/**
+			 * The scope index
+			 */
+			std::size_t index;
+
+		public:
+			/**
+			 * Starts measuring a scope
+			 *
+			 * @param profiler the profiler measuring the scope
+			 * @param name the scope name
+			 */
+			Scope(FrameProfiler& profiler, const char* name);
+
+			/**
+			 * Deleted copy constructor.
+			 *
+			 * @param other the instance to copy from
+			 */
+			Scope(const Scope& other) = delete;
+
+			/**
+			 * Deleted copy assignment operator.
+			 *
+			 * @param other the instance to copy from
+			 *
+			 * @return *this
+			 */
+			Scope& operator=(const Scope& other) = delete;
+
+			/**
+			 * Stops measuring the scope
+			 */
+			~Scope();
+		};
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * A frame being recorded or waiting for its GPU timestamps
+		 */
+		struct PendingFrame {
+			/**
+			 * The frame timing, without GPU times
+			 */
+			FrameTiming timing;
+
+			/**
+			 * The start time of every scope of the frame
+			 */
+			std::vector<Clock::time_point> scopeStarts;
+
+			/**
+			 * The start time of the frame
+			 */
+			Clock::time_point start;
+
+			/**
+			 * If true, the frame was recorded and its timestamps were not read yet
+			 */
+			bool pending = false;
+		};
+
+	private:
+		/**
+		 * If false, nothing is measured
+		 */
+		bool enabled = true;
+
+		/**
+		 * The number of frames started so far
+		 */
+		std::uint64_t frameCount = 0;
+
+		/**
+		 * The frames being recorded or waiting for their GPU timestamps
+		 */
+		std::array<PendingFrame, FRAMES_IN_FLIGHT> frames;
+
+		/**
+		 * The index of the frame being recorded in <tt>frames</tt>, or
+		 * <tt>FRAMES_IN_FLIGHT</tt> if no frame is being recorded
+		 */
+		std::size_t currentFrame = FRAMES_IN_FLIGHT;
+
+		/**
+		 * The nesting depth of the next scope
+		 */
+		unsigned int depth = 0;
+
+		/**
+		 * The maximum number of frames kept on the history
+		 */
+		std::size_t historySize;
+
+		/**
+		 * The most recent frames whose timestamps were read, oldest first
+		 */
+		std::deque<FrameTiming> history;
+
+		/**
+		 * A scratch buffer for the timestamps of a frame
+		 */
+		std::vector<std::uint64_t> timestamps;
+
+	public:
+		/**
+		 * Creates a new frame profiler
+		 *
+		 * @param historySize the maximum number of frames kept on the history
+		 */
+		explicit FrameProfiler(std::size_t historySize = 240);
+
+		/**
+		 * Virtual destructor.
+		 */
+		virtual ~FrameProfiler() = default;
+
+	public:
+		/**
+		 * Starts recording a frame. Reads the timestamps of the frame recorded
+		 * <tt>FRAMES_IN_FLIGHT</tt> frames ago and moves it to the history.
+		 */
+		void beginFrame();
+
+		/**
+		 * Stops recording the current frame
+		 */
+		void endFrame();
+
+		/**
+		 * Starts measuring a scope. Prefer the <tt>Scope</tt> class.
+		 *
+		 * @param name the scope name
+		 *
+		 * @return the scope index, to be passed to <tt>endScope</tt>
+		 */
+		std::size_t beginScope(const char* name);
+
+		/**
+		 * Stops measuring a scope
+		 *
+		 * @param scope the scope index returned by <tt>beginScope</tt>
+		 */
+		void endScope(std::size_t scope);
+
+	public:
+		/**
+		 * @return true if the profiler is measuring frames
+		 */
+		bool isEnabled() const;
+
+		/**
+		 * Enables or disables the profiler. Takes effect on the next frame.
+		 *
+		 * @param enabled true to enable the profiler
+		 */
+		void setEnabled(bool enabled);
+
+		/**
+		 * @return the most recent frame whose timestamps were read or <tt>nullptr</tt>
+		 * if no frame is available yet
+		 */
+		const FrameTiming* getLastFrame() const;
+
+		/**
+		 * @return the most recent frames whose timestamps were read, oldest first
+		 */
+		const std::deque<FrameTiming>& getHistory() const;
+
+		/**
+		 * Removes every frame from the history
+		 */
+		void clearHistory();
+
+	public:
+		/**
+		 * Writes the history as CSV, one row per scope and one row named "frame",
+		 * without depth, per frame. GPU times that are not available are left empty.
+		 *
+		 * @param stream the stream to write to
+		 */
+		void exportCSV(std::ostream& stream) const;
+
+		/**
+		 * Writes the history as a JSON document. GPU times that are not available
+		 * are written as <tt>null</tt>.
+		 *
+		 * @param stream the stream to write to
+		 */
+		void exportJSON(std::ostream& stream) const;
+
+	protected:
+		/**
+		 * Writes a GPU timestamp. The default implementation does nothing.
+		 *
+		 * @param frame the index of the frame being recorded, in [0, FRAMES_IN_FLIGHT)
+		 * @param query the timestamp index within the frame. 0 and 1 are the frame
+		 * start and end, 2 * i + 2 and 2 * i + 3 are the start and end of the scope i.
+		 */
+		virtual void writeGPUTimestamp(std::size_t frame, std::size_t query);
+
+		/**
+		 * Reads the GPU timestamps of a frame, without waiting for the GPU. The
+		 * default implementation always fails.
+		 *
+		 * @param frame the frame index, in [0, FRAMES_IN_FLIGHT)
+		 * @param count the number of timestamps written on the frame
+		 * @param timestamps the vector to read the timestamps, in nanoseconds, into
+		 *
+		 * @return true if all timestamps were read
+		 */
+		virtual bool readGPUTimestamps(std::size_t frame, std::size_t count, std::vector<std::uint64_t>& timestamps);
+
+	private:
+		/**
+		 * Reads the timestamps of a pending frame and moves it to the history
+		 *
+		 * @param frame the frame index, in [0, FRAMES_IN_FLIGHT)
+		 */
+		void resolve(std::size_t frame);
+
+	};
+
+}
@@ -0,0 +1,353 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "LightClusters.hpp"
+
+#include "XYZ/Scene/Light/PointLight.hpp"
+#include "XYZ/Scene/Light/SpotLight.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * Tests a sphere against 4 consecutive cluster bounding boxes
+	 *
+	 * @return a 4-bit mask with a bit set for every intersecting cluster
+	 */
+	static int testSphere(const float* minX, const float* minY, const float* minZ,
+						  const float* maxX, const float* maxY, const float* maxZ,
+						  const glm::vec3& center, float sphereRadius) {
+#if defined(__SSE2__)
+		const __m128 zero = _mm_setzero_ps();
+
+		// distance from the sphere center to the closest point of each box, per axis
+		__m128 cx = _mm_set1_ps(center.x);
+		__m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minX), cx), zero),
+							   _mm_max_ps(_mm_sub_ps(cx, _mm_loadu_ps(maxX)), zero));
+
+		__m128 cy = _mm_set1_ps(center.y);
+		__m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minY), cy), zero),
+							   _mm_max_ps(_mm_sub_ps(cy, _mm_loadu_ps(maxY)), zero));
+
+		__m128 cz = _mm_set1_ps(center.z);
+		__m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minZ), cz), zero),
+							   _mm_max_ps(_mm_sub_ps(cz, _mm_loadu_ps(maxZ)), zero));
+
+		__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		return _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_set1_ps(sphereRadius * sphereRadius)));
+#else
+		int mask = 0;
+		for(int lane = 0; lane < 4; lane++) {
+			float dx = std::fmax(minX[lane] - center.x, 0.0f) + std::fmax(center.x - maxX[lane], 0.0f);
+			float dy = std::fmax(minY[lane] - center.y, 0.0f) + std::fmax(center.y - maxY[lane], 0.0f);
+			float dz = std::fmax(minZ[lane] - center.z, 0.0f) + std::fmax(center.z - maxZ[lane], 0.0f);
+			if(dx * dx + dy * dy + dz * dz <= sphereRadius * sphereRadius) {
+				mask |= 1 << lane;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	/**
+	 * Tests a cone against 4 consecutive cluster bounding spheres. See "Cull that
+	 * cone!" by Bart Wronski.
+	 *
+	 * @return a 4-bit mask with a bit set for every intersecting cluster
+	 */
+	static int testCone(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+						const glm::vec3& origin, const glm::vec3& direction, float cosAngle, float sinAngle,
+						float range) {
+#if defined(__SSE2__)
+		__m128 vx = _mm_sub_ps(_mm_loadu_ps(centerX), _mm_set1_ps(origin.x));
+		__m128 vy = _mm_sub_ps(_mm_loadu_ps(centerY), _mm_set1_ps(origin.y));
+		__m128 vz = _mm_sub_ps(_mm_loadu_ps(centerZ), _mm_set1_ps(origin.z));
+		__m128 r = _mm_loadu_ps(radius);
+
+		__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+		__m128 axial = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(direction.x)),
+											 _mm_mul_ps(vy, _mm_set1_ps(direction.y))),
+								  _mm_mul_ps(vz, _mm_set1_ps(direction.z)));
+		__m128 radial = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lengthSquared, _mm_mul_ps(axial, axial)), _mm_setzero_ps()));
+
+		__m128 closest = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(cosAngle), radial), _mm_mul_ps(axial, _mm_set1_ps(sinAngle)));
+
+		__m128 angleCull = _mm_cmpgt_ps(closest, r);
+		__m128 frontCull = _mm_cmpgt_ps(axial, _mm_add_ps(r, _mm_set1_ps(range)));
+		__m128 backCull = _mm_cmplt_ps(axial, _mm_sub_ps(_mm_setzero_ps(), r));
+
+		return ~_mm_movemask_ps(_mm_or_ps(_mm_or_ps(angleCull, frontCull), backCull)) & 0xF;
+#else
+		int mask = 0;
+		for(int lane = 0; lane < 4; lane++) {
+			glm::vec3 v = glm::vec3(centerX[lane], centerY[lane], centerZ[lane]) - origin;
+			float axial = glm::dot(v, direction);
+			float radial = std::sqrt(std::fmax(glm::dot(v, v) - axial * axial, 0.0f));
+			float closest = cosAngle * radial - axial * sinAngle;
+
+			bool culled = closest > radius[lane] || axial > radius[lane] + range || axial < -radius[lane];
+			if(!culled) {
+				mask |= 1 << lane;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	LightClusters::LightClusters(unsigned int tilesX, unsigned int tilesY, unsigned int slices) :
+			tilesX(tilesX), tilesY(tilesY), slices(slices) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void LightClusters::setProjection(const glm::mat4& projection, float zNear, float zFar) {
+		if(LightClusters::projection == projection && LightClusters::zNear == zNear && LightClusters::zFar == zFar) {
+			return;
+		}
+
+		LightClusters::projection = projection;
+		LightClusters::zNear = zNear;
+		LightClusters::zFar = zFar;
+
+		computeClusterBounds();
+	}
+
+	void LightClusters::assign(const glm::mat4& view,
+							   const std::vector<std::shared_ptr<Scene::Light::Light>>& lights) {
+		lightData.clear();
+		intersections.clear();
+
+		const unsigned int tileCount = tilesX * tilesY;
+
+		for(const auto& light : lights) {
+			auto type = light->getLightType();
+			if(type != Scene::Light::LightType::POINT && type != Scene::Light::LightType::SPOT) {
+				continue;
+			}
+
+			float lightRadius = light->getInfluenceRadius();
+			if(!(lightRadius > 0.0f)) {
+				continue;
+			}
+			if(!std::isfinite(lightRadius)) {
+				lightRadius = zFar;
+			}
+
+			auto position = glm::vec3(view * glm::vec4(light->getPosition(), 1.0f));
+			float depth = -position.z;
+			if(depth + lightRadius < zNear || depth - lightRadius > zFar) {
+				continue;
+			}
+
+			int firstSlice = glm::max(getSlice(depth - lightRadius), 0);
+			int lastSlice = glm::min(getSlice(depth + lightRadius), int(slices) - 1);
+
+			// spot light cone parameters, in view space
+			bool isSpot = type == Scene::Light::LightType::SPOT;
+			glm::vec3 direction(0.0f);
+			glm::vec3 viewDirection(0.0f);
+			glm::vec2 cutOff(0.0f);
+			float cosAngle = 0.0f, sinAngle = 0.0f;
+			if(isSpot) {
+				auto& spotLight = static_cast<const Scene::Light::SpotLight&>(*light);
+				direction = spotLight.getDirection();
+				viewDirection = glm::normalize(glm::vec3(view * glm::vec4(direction, 0.0f)));
+				cutOff = glm::vec2(glm::cos(glm::radians(spotLight.getCutOff())),
+								   glm::cos(glm::radians(spotLight.getOuterCutOff())));
+
+				float angle = glm::radians(spotLight.getOuterCutOff());
+				cosAngle = std::cos(angle);
+				sinAngle = std::sin(angle);
+			}
+
+			auto lightIndex = std::uint32_t(lightData.size() / TEXELS_PER_LIGHT);
+			lightData.emplace_back(light->getPosition(), lightRadius);
+			lightData.emplace_back(light->getDiffuse(), isSpot ? 1.0f : 0.0f);
+			if(isSpot) {
+				auto& spotLight = static_cast<const Scene::Light::SpotLight&>(*light);
+				lightData.emplace_back(light->getSpecular(), spotLight.getConstant());
+				lightData.emplace_back(light->getAmbient(), spotLight.getLinear());
+				lightData.emplace_back(direction, spotLight.getQuadratic());
+			} else {
+				auto& pointLight = static_cast<const Scene::Light::PointLight&>(*light);
+				lightData.emplace_back(light->getSpecular(), pointLight.getConstant());
+				lightData.emplace_back(light->getAmbient(), pointLight.getLinear());
+				lightData.emplace_back(direction, pointLight.getQuadratic());
+			}
+			lightData.emplace_back(cutOff.x, cutOff.y, 0.0f, 0.0f);
+
+			for(int slice = firstSlice; slice <= lastSlice; slice++) {
+				std::size_t base = std::size_t(slice) * tileStride;
+				for(unsigned int tile = 0; tile < tileStride; tile += 4) {
+					auto i = base + tile;
+					int mask = testSphere(&minimumX[i], &minimumY[i], &minimumZ[i],
+										  &maximumX[i], &maximumY[i], &maximumZ[i],
+										  position, lightRadius);
+					if(mask != 0 && isSpot) {
+						mask &= testCone(&centerX[i], &centerY[i], &centerZ[i], &radius[i],
+										 position, viewDirection, cosAngle, sinAngle, lightRadius);
+					}
+
+					while(mask != 0) {
+						int lane = 0;
+						while(((mask >> lane) & 1) == 0) {
+							lane++;
+						}
+						mask &= ~(1 << lane);
+
+						// padding clusters never intersect, but be safe
+						if(tile + lane < tileCount) {
+							intersections.emplace_back(slice * tileCount + tile + lane, lightIndex);
+						}
+					}
+				}
+			}
+		}
+
+		// counting sort the intersections by cluster
+		clusterData.assign(std::size_t(tileCount) * slices, glm::uvec2(0));
+		for(const auto& intersection : intersections) {
+			clusterData[intersection.first].y++;
+		}
+
+		std::uint32_t offset = 0;
+		for(auto& cluster : clusterData) {
+			cluster.x = offset;
+			offset += cluster.y;
+			cluster.y = 0;
+		}
+
+		lightIndices.resize(intersections.size());
+		for(const auto& intersection : intersections) {
+			auto& cluster = clusterData[intersection.first];
+			lightIndices[cluster.x + cluster.y++] = intersection.second;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int LightClusters::getTilesX() const {
+		return tilesX;
+	}
+
+	unsigned int LightClusters::getTilesY() const {
+		return tilesY;
+	}
+
+	unsigned int LightClusters::getSlices() const {
+		return slices;
+	}
+
+	float LightClusters::getZNear() const {
+		return zNear;
+	}
+
+	float LightClusters::getZFar() const {
+		return zFar;
+	}
+
+	std::size_t LightClusters::getLightCount() const {
+		return lightData.size() / TEXELS_PER_LIGHT;
+	}
+
+	const std::vector<glm::vec4>& LightClusters::getLightData() const {
+		return lightData;
+	}
+
+	const std::vector<glm::uvec2>& LightClusters::getClusterData() const {
+		return clusterData;
+	}
+
+	const std::vector<std::uint32_t>& LightClusters::getLightIndices() const {
+		return lightIndices;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void LightClusters::computeClusterBounds() {
+		const unsigned int tileCount = tilesX * tilesY;
+		tileStride = (tileCount + 3) & ~3u;
+
+		// padding entries get empty boxes and negative radii so they never intersect
+		auto size = std::size_t(tileStride) * slices;
+		minimumX.assign(size, std::numeric_limits<float>::max());
+		minimumY.assign(size, std::numeric_limits<float>::max());
+		minimumZ.assign(size, std::numeric_limits<float>::max());
+		maximumX.assign(size, std::numeric_limits<float>::lowest());
+		maximumY.assign(size, std::numeric_limits<float>::lowest());
+		maximumZ.assign(size, std::numeric_limits<float>::lowest());
+		centerX.assign(size, 0.0f);
+		centerY.assign(size, 0.0f);
+		centerZ.assign(size, 0.0f);
+		radius.assign(size, -1.0f);
+
+		// unprojects a NDC point on the near plane into view space
+		auto inverseProjection = glm::inverse(projection);
+		auto unproject = [&inverseProjection](float x, float y) {
+			auto point = inverseProjection * glm::vec4(x, y, -1.0f, 1.0f);
+			return glm::vec3(point) / point.w;
+		};
+
+		for(unsigned int slice = 0; slice < slices; slice++) {
+			float sliceNear = zNear * std::pow(zFar / zNear, float(slice) / float(slices));
+			float sliceFar = zNear * std::pow(zFar / zNear, float(slice + 1) / float(slices));
+
+			for(unsigned int y = 0; y < tilesY; y++) {
+				for(unsigned int x = 0; x < tilesX; x++) {
+					auto tileMinimum = unproject(-1.0f + 2.0f * float(x) / float(tilesX),
+												 -1.0f + 2.0f * float(y) / float(tilesY));
+					auto tileMaximum = unproject(-1.0f + 2.0f * float(x + 1) / float(tilesX),
+												 -1.0f + 2.0f * float(y + 1) / float(tilesY));
+
+					// intersect the rays from the eye through the tile corners with the slice planes
+					glm::vec3 corners[4] = {
+							tileMinimum * (sliceNear / -tileMinimum.z),
+							tileMinimum * (sliceFar / -tileMinimum.z),
+							tileMaximum * (sliceNear / -tileMaximum.z),
+							tileMaximum * (sliceFar / -tileMaximum.z)
+					};
+
+					glm::vec3 minimum = corners[0];
+					glm::vec3 maximum = corners[0];
+					for(const auto& corner : corners) {
+						minimum = glm::min(minimum, corner);
+						maximum = glm::max(maximum, corner);
+					}
+
+					auto i = std::size_t(slice) * tileStride + x + tilesX * y;
+					minimumX[i] = minimum.x;
+					minimumY[i] = minimum.y;
+					minimumZ[i] = minimum.z;
+					maximumX[i] = maximum.x;
+					maximumY[i] = maximum.y;
+					maximumZ[i] = maximum.z;
+
+					auto center = (minimum + maximum) * 0.5f;
+					centerX[i] = center.x;
+					centerY[i] = center.y;
+					centerZ[i] = center.z;
+					radius[i] = glm::length(maximum - minimum) * 0.5f;
+				}
+			}
+		}
+	}
+
+	int LightClusters::getSlice(float depth) const {
+		if(depth <= zNear) {
+			return -1;
+		}
+		return int(std::floor(std::log(depth / zNear) / std::log(zFar / zNear) * float(slices)));
+	}
+
+}
@@ -0,0 +1,214 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Light/Light.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * Assigns point and spot lights to a 3D grid of clusters that subdivides the
+	 * camera view frustum.
+	 *
+	 * The frustum is divided in <tt>tilesX</tt> x <tt>tilesY</tt> screen tiles and
+	 * <tt>slices</tt> depth slices. Slices are spaced exponentially between the near
+	 * and far planes so that clusters have roughly cubic shapes. Every light is
+	 * tested against the clusters it may touch using its influence radius, four
+	 * clusters at a time with SSE.
+	 *
+	 * The result is three flat arrays meant to be uploaded to the GPU:
+	 *  - the light data, <tt>TEXELS_PER_LIGHT</tt> vec4s per light;
+	 *  - the cluster data, a (offset, count) pair per cluster into the light index list;
+	 *  - the light index list.
+	 *
+	 * Clusters are indexed as <tt>x + tilesX * (y + tilesY * z)</tt>, with tile (0, 0)
+	 * on the bottom-left corner of the screen.
+	 */
+	class LightClusters {
+	public:
+		/**
+		 * The number of vec4s used to store a single light:
+		 *  0: position (xyz), influence radius (w)
+		 *  1: diffuse (rgb), type (w: 0 for point lights, 1 for spot lights)
+		 *  2: specular (rgb), constant attenuation (w)
+		 *  3: ambient (rgb), linear attenuation (w)
+		 *  4: direction (xyz), quadratic attenuation (w)
+		 *  5: cosine of cut-off (x), cosine of outer cut-off (y)
+		 */
+		static constexpr unsigned int TEXELS_PER_LIGHT = 6;
+
+	private:
+		/**
+		 * The number of horizontal screen tiles
+		 */
+		unsigned int tilesX;
+
+		/**
+		 * The number of vertical screen tiles
+		 */
+		unsigned int tilesY;
+
+		/**
+		 * The number of depth slices
+		 */
+		unsigned int slices;
+
+		/**
+		 * The near plane distance
+		 */
+		float zNear = 0.0f;
+
+		/**
+		 * The far plane distance
+		 */
+		float zFar = 0.0f;
+
+		/**
+		 * The projection the cluster bounds were computed for
+		 */
+		glm::mat4 projection = glm::mat4(0.0f);
+
+	private:
+		/**
+		 * The number of tiles of a slice, rounded up to a multiple of 4 so that
+		 * every slice can be tested in groups of 4 clusters
+		 */
+		unsigned int tileStride = 0;
+
+		/**
+		 * The view-space cluster bounding boxes, stored as structure of arrays with
+		 * <tt>tileStride</tt> entries per slice
+		 */
+		std::vector<float> minimumX, minimumY, minimumZ;
+		std::vector<float> maximumX, maximumY, maximumZ;
+
+		/**
+		 * The view-space cluster bounding spheres, used by the spot light cone test
+		 */
+		std::vector<float> centerX, centerY, centerZ, radius;
+
+	private:
+		/**
+		 * The packed light data
+		 */
+		std::vector<glm::vec4> lightData;
+
+		/**
+		 * The (offset, count) pair of each cluster
+		 */
+		std::vector<glm::uvec2> clusterData;
+
+		/**
+		 * The light indices referenced by the clusters
+		 */
+		std::vector<std::uint32_t> lightIndices;
+
+		/**
+		 * A (cluster, light) pair for every intersection found. Kept as a member to
+		 * avoid reallocating every frame.
+		 */
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> intersections;
+
+	public:
+		/**
+		 * Creates a new light cluster grid
+		 *
+		 * @param tilesX the number of horizontal screen tiles
+		 * @param tilesY the number of vertical screen tiles
+		 * @param slices the number of depth slices
+		 */
+		explicit LightClusters(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24);
+
+	public:
+		/**
+		 * Sets the camera projection. The cluster bounds are only recomputed if the
+		 * projection has changed.
+		 *
+		 * @param projection the camera projection matrix
+		 * @param zNear the near plane distance
+		 * @param zFar the far plane distance
+		 */
+		void setProjection(const glm::mat4& projection, float zNear, float zFar);
+
+		/**
+		 * Assigns the lights to the clusters.
+		 *
+		 * Only point and spot lights are assigned, other light types are ignored.
+		 *
+		 * @param view the camera view matrix
+		 * @param lights the lights to be assigned
+		 */
+		void assign(const glm::mat4& view, const std::vector<std::shared_ptr<Scene::Light::Light>>& lights);
+
+	public:
+		/**
+		 * @return the number of horizontal screen tiles
+		 */
+		unsigned int getTilesX() const;
+
+		/**
+		 * @return the number of vertical screen tiles
+		 */
+		unsigned int getTilesY() const;
+
+		/**
+		 * @return the number of depth slices
+		 */
+		unsigned int getSlices() const;
+
+		/**
+		 * @return the near plane distance
+		 */
+		float getZNear() const;
+
+		/**
+		 * @return the far plane distance
+		 */
+		float getZFar() const;
+
+		/**
+		 * @return the number of lights assigned on the last call to <tt>assign</tt>
+		 */
+		std::size_t getLightCount() const;
+
+		/**
+		 * @return the packed light data
+		 */
+		const std::vector<glm::vec4>& getLightData() const;
+
+		/**
+		 * @return the (offset, count) pair of each cluster
+		 */
+		const std::vector<glm::uvec2>& getClusterData() const;
+
+		/**
+		 * @return the light indices referenced by the clusters
+		 */
+		const std::vector<std::uint32_t>& getLightIndices() const;
+
+	private:
+		/**
+		 * Computes the view-space bounds of every cluster
+		 */
+		void computeClusterBounds();
+
+		/**
+		 * @param depth the positive view-space depth
+		 *
+		 * @return the slice that contains <tt>depth</tt>, possibly out of range
+		 */
+		int getSlice(float depth) const;
+
+	};
+
+}
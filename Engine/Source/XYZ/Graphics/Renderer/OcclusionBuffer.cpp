@@ -0,0 +1,277 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "OcclusionBuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace XYZ::Graphics::Renderer {
+
+	OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height) :
+			width((std::max(width, 4u) + 3) & ~3u),
+			height(std::max(height, 1u)),
+			depth(OcclusionBuffer::width * OcclusionBuffer::height, 1.0f) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OcclusionBuffer::clear(const glm::mat4& viewProjection) {
+		OcclusionBuffer::viewProjection = viewProjection;
+		std::fill(depth.begin(), depth.end(), 1.0f);
+		rasterizedTriangles = 0;
+	}
+
+	void OcclusionBuffer::rasterize(const Mesh::Mesh& mesh, const glm::mat4& modelMatrix) {
+		const auto& vertices = mesh.getVertices();
+		const auto& indices = mesh.getIndices();
+
+		auto MVP = viewProjection * modelMatrix;
+		clipVertices.resize(vertices.size());
+		for(std::size_t i = 0; i < vertices.size(); i++) {
+			clipVertices[i] = MVP * glm::vec4(vertices[i].position, 1.0f);
+		}
+
+		for(std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+			rasterizeTriangle(clipVertices[indices[i + 0]],
+							  clipVertices[indices[i + 1]],
+							  clipVertices[indices[i + 2]]);
+		}
+	}
+
+	bool OcclusionBuffer::isVisible(const Math::BoundingBox& bounds) const {
+		if(bounds.isEmpty() || bounds.isInfinite()) {
+			return true;
+		}
+
+		float minimumX = std::numeric_limits<float>::max();
+		float minimumY = std::numeric_limits<float>::max();
+		float maximumX = std::numeric_limits<float>::lowest();
+		float maximumY = std::numeric_limits<float>::lowest();
+		float minimumZ = std::numeric_limits<float>::max();
+
+		for(unsigned int i = 0; i < 8; i++) {
+			auto corner = viewProjection * glm::vec4(
+					(i & 1) ? bounds.maximum.x : bounds.minimum.x,
+					(i & 2) ? bounds.maximum.y : bounds.minimum.y,
+					(i & 4) ? bounds.maximum.z : bounds.minimum.z,
+					1.0f
+			);
+
+			// boxes crossing the near plane cannot be projected
+			if(corner.z < -corner.w) {
+				return true;
+			}
+
+			float x = (corner.x / corner.w * 0.5f + 0.5f) * float(width);
+			float y = (corner.y / corner.w * 0.5f + 0.5f) * float(height);
+			minimumX = std::min(minimumX, x);
+			maximumX = std::max(maximumX, x);
+			minimumY = std::min(minimumY, y);
+			maximumY = std::max(maximumY, y);
+			minimumZ = std::min(minimumZ, corner.z / corner.w * 0.5f + 0.5f);
+		}
+
+		// every pixel touched by the projected box is tested
+		int x0 = std::max(int(std::floor(minimumX)), 0);
+		int x1 = std::min(int(std::floor(maximumX)), int(width) - 1);
+		int y0 = std::max(int(std::floor(minimumY)), 0);
+		int y1 = std::min(int(std::floor(maximumY)), int(height) - 1);
+		if(x0 > x1 || y0 > y1) {
+			return false;
+		}
+
+#if defined(__SSE2__)
+		const __m128 boxDepth = _mm_set1_ps(minimumZ);
+		const __m128i laneOffsets = _mm_set_epi32(3, 2, 1, 0);
+		const __m128i first = _mm_set1_epi32(x0 - 1);
+		const __m128i last = _mm_set1_epi32(x1 + 1);
+
+		for(int y = y0; y <= y1; y++) {
+			const float* row = depth.data() + std::size_t(y) * width;
+			for(int x = x0 & ~3; x <= x1; x += 4) {
+				__m128i lanes = _mm_add_epi32(_mm_set1_epi32(x), laneOffsets);
+				__m128 inside = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(lanes, first),
+															   _mm_cmplt_epi32(lanes, last)));
+				__m128 visible = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth), inside);
+				if(_mm_movemask_ps(visible) != 0) {
+					return true;
+				}
+			}
+		}
+#else
+		for(int y = y0; y <= y1; y++) {
+			const float* row = depth.data() + std::size_t(y) * width;
+			for(int x = x0; x <= x1; x++) {
+				if(row[x] >= minimumZ) {
+					return true;
+				}
+			}
+		}
+#endif
+		return false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int OcclusionBuffer::getWidth() const {
+		return width;
+	}
+
+	unsigned int OcclusionBuffer::getHeight() const {
+		return height;
+	}
+
+	const std::vector<float>& OcclusionBuffer::getDepth() const {
+		return depth;
+	}
+
+	unsigned int OcclusionBuffer::getRasterizedTriangles() const {
+		return rasterizedTriangles;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OcclusionBuffer::rasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+		// trivially reject triangles entirely outside one of the frustum planes
+		if((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+		   (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+		   (a.z > a.w && b.z > b.w && c.z > c.w)) {
+			return;
+		}
+
+		// signed distances to the near plane
+		std::array<const glm::vec4*, 3> vertices = {&a, &b, &c};
+		std::array<float, 3> distances = {a.z + a.w, b.z + b.w, c.z + c.w};
+
+		if(distances[0] >= 0.0f && distances[1] >= 0.0f && distances[2] >= 0.0f) {
+			rasterizeClippedTriangle(a, b, c);
+			return;
+		}
+		if(distances[0] < 0.0f && distances[1] < 0.0f && distances[2] < 0.0f) {
+			return;
+		}
+
+		// clipping a triangle against a single plane yields at most 4 vertices
+		std::array<glm::vec4, 4> polygon;
+		unsigned int count = 0;
+		for(unsigned int i = 0; i < 3; i++) {
+			unsigned int j = (i + 1) % 3;
+			if(distances[i] >= 0.0f) {
+				polygon[count++] = *vertices[i];
+			}
+			if((distances[i] >= 0.0f) != (distances[j] >= 0.0f)) {
+				float t = distances[i] / (distances[i] - distances[j]);
+				polygon[count++] = *vertices[i] + (*vertices[j] - *vertices[i]) * t;
+			}
+		}
+
+		for(unsigned int i = 1; i + 1 < count; i++) {
+			rasterizeClippedTriangle(polygon[0], polygon[i], polygon[i + 1]);
+		}
+	}
+
+	void OcclusionBuffer::rasterizeClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+		auto toWindow = [this](const glm::vec4& vertex) {
+			return glm::vec3(
+					(vertex.x / vertex.w * 0.5f + 0.5f) * float(width),
+					(vertex.y / vertex.w * 0.5f + 0.5f) * float(height),
+					vertex.z / vertex.w * 0.5f + 0.5f
+			);
+		};
+
+		auto p0 = toWindow(a);
+		auto p1 = toWindow(b);
+		auto p2 = toWindow(c);
+
+		// occluders are not back-face culled: make every triangle counter-clockwise
+		float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+		if(area < 0.0f) {
+			std::swap(p1, p2);
+			area = -area;
+		}
+		if(area < 1e-6f) {
+			return;
+		}
+
+		// the pixels whose centers are inside the triangle bounds
+		int minX = std::max(int(std::ceil(std::min({p0.x, p1.x, p2.x}) - 0.5f)), 0);
+		int maxX = std::min(int(std::floor(std::max({p0.x, p1.x, p2.x}) - 0.5f)), int(width) - 1);
+		int minY = std::max(int(std::ceil(std::min({p0.y, p1.y, p2.y}) - 0.5f)), 0);
+		int maxY = std::min(int(std::floor(std::max({p0.y, p1.y, p2.y}) - 0.5f)), int(height) - 1);
+		if(minX > maxX || minY > maxY) {
+			return;
+		}
+		rasterizedTriangles++;
+
+		// edge functions e = A * x + B * y + C, positive inside the triangle. Each
+		// edge is opposite to the vertex it weights.
+		float A0 = p1.y - p2.y, B0 = p2.x - p1.x, C0 = -(A0 * p1.x + B0 * p1.y);
+		float A1 = p2.y - p0.y, B1 = p0.x - p2.x, C1 = -(A1 * p2.x + B1 * p2.y);
+		float A2 = p0.y - p1.y, B2 = p1.x - p0.x, C2 = -(A2 * p0.x + B2 * p0.y);
+
+		// depth plane z = zA * x + zB * y + zC, moved away from the viewer by the
+		// largest change within half a pixel
+		float zA = (A0 * p0.z + A1 * p1.z + A2 * p2.z) / area;
+		float zB = (B0 * p0.z + B1 * p1.z + B2 * p2.z) / area;
+		float zC = (C0 * p0.z + C1 * p1.z + C2 * p2.z) / area + 0.5f * (std::abs(zA) + std::abs(zB));
+		float zMax = std::max({p0.z, p1.z, p2.z});
+
+#if defined(__SSE2__)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 pixelOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+		const __m128 vA0 = _mm_set1_ps(A0), vA1 = _mm_set1_ps(A1), vA2 = _mm_set1_ps(A2);
+		const __m128 vzA = _mm_set1_ps(zA);
+		const __m128 vzMax = _mm_set1_ps(zMax);
+
+		for(int y = minY; y <= maxY; y++) {
+			float py = float(y) + 0.5f;
+			const __m128 row0 = _mm_set1_ps(B0 * py + C0);
+			const __m128 row1 = _mm_set1_ps(B1 * py + C1);
+			const __m128 row2 = _mm_set1_ps(B2 * py + C2);
+			const __m128 rowZ = _mm_set1_ps(zB * py + zC);
+
+			float* row = depth.data() + std::size_t(y) * width;
+			for(int x = minX & ~3; x <= maxX; x += 4) {
+				__m128 px = _mm_add_ps(_mm_set1_ps(float(x)), pixelOffsets);
+
+				__m128 inside = _mm_and_ps(
+						_mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(vA0, px), row0), zero),
+								   _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(vA1, px), row1), zero)),
+						_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(vA2, px), row2), zero)
+				);
+				if(_mm_movemask_ps(inside) == 0) {
+					continue;
+				}
+
+				__m128 z = _mm_min_ps(_mm_add_ps(_mm_mul_ps(vzA, px), rowZ), vzMax);
+				__m128 current = _mm_loadu_ps(row + x);
+				__m128 updated = _mm_min_ps(current, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, updated), _mm_andnot_ps(inside, current)));
+			}
+		}
+#else
+		for(int y = minY; y <= maxY; y++) {
+			float py = float(y) + 0.5f;
+			float* row = depth.data() + std::size_t(y) * width;
+			for(int x = minX; x <= maxX; x++) {
+				float px = float(x) + 0.5f;
+				if(A0 * px + B0 * py + C0 < 0.0f ||
+				   A1 * px + B1 * py + C1 < 0.0f ||
+				   A2 * px + B2 * py + C2 < 0.0f) {
+					continue;
+				}
+				row[x] = std::min(row[x], std::min(zA * px + zB * py + zC, zMax));
+			}
+		}
+#endif
+	}
+
+}
@@ -0,0 +1,145 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Mesh/Mesh.hpp"
+#include "XYZ/Math/BoundingBox.hpp"
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * A low resolution depth buffer used to cull objects hidden behind occluders on
+	 * the CPU, before any draw is issued.
+	 *
+	 * A view is culled in two steps: first the occluder meshes are rasterized into
+	 * the buffer with <tt>rasterize</tt>, then the bounds of every other object are
+	 * tested with <tt>isVisible</tt>. Triangles are rasterized and bounds are tested
+	 * four pixels at a time with SSE.
+	 *
+	 * Depth is stored as the window-space depth in the [0, 1] range. Occluder depth is
+	 * rounded away from the viewer over each pixel footprint so that a object is only
+	 * reported as hidden if it is behind the occluder on the whole pixel.
+	 *
+	 * The buffer does not depend on the GPU and can be used headless.
+	 */
+	class OcclusionBuffer {
+	private:
+		/**
+		 * The buffer width, in pixels. Always a multiple of 4.
+		 */
+		unsigned int width;
+
+		/**
+		 * The buffer height, in pixels
+		 */
+		unsigned int height;
+
+		/**
+		 * The buffer depth values, row by row, starting at the bottom row
+		 */
+		std::vector<float> depth;
+
+		/**
+		 * The view-projection matrix of the view being culled
+		 */
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+
+		/**
+		 * The clip space vertex positions of the mesh being rasterized. Kept as a
+		 * member to avoid reallocating on every mesh.
+		 */
+		std::vector<glm::vec4> clipVertices;
+
+		/**
+		 * The number of occluder triangles rasterized since the last <tt>clear</tt>
+		 */
+		unsigned int rasterizedTriangles = 0;
+
+	public:
+		/**
+		 * Creates a new occlusion buffer
+		 *
+		 * @param width the buffer width, in pixels. Rounded up to a multiple of 4.
+		 * @param height the buffer height, in pixels
+		 */
+		explicit OcclusionBuffer(unsigned int width = 256, unsigned int height = 128);
+
+	public:
+		/**
+		 * Clears the buffer and prepares it to cull a new view
+		 *
+		 * @param viewProjection the view-projection matrix of the view
+		 */
+		void clear(const glm::mat4& viewProjection);
+
+		/**
+		 * Rasterizes a occluder mesh into the buffer. Occluder meshes should be
+		 * simplified versions of the models they represent, every triangle of the
+		 * mesh is transformed and rasterized.
+		 *
+		 * Triangles are not back-face culled and are clipped against the near plane.
+		 *
+		 * @param mesh the occluder mesh
+		 * @param modelMatrix the occluder model matrix
+		 */
+		void rasterize(const Mesh::Mesh& mesh, const glm::mat4& modelMatrix);
+
+		/**
+		 * Tests if a box is not hidden by the occluders rasterized so far
+		 *
+		 * @param bounds the world space box to be tested
+		 *
+		 * @return false if the box is certainly hidden
+		 */
+		bool isVisible(const Math::BoundingBox& bounds) const;
+
+	public:
+		/**
+		 * @return the buffer width, in pixels
+		 */
+		unsigned int getWidth() const;
+
+		/**
+		 * @return the buffer height, in pixels
+		 */
+		unsigned int getHeight() const;
+
+		/**
+		 * @return the buffer depth values, row by row, starting at the bottom row
+		 */
+		const std::vector<float>& getDepth() const;
+
+		/**
+		 * @return the number of occluder triangles rasterized since the last <tt>clear</tt>
+		 */
+		unsigned int getRasterizedTriangles() const;
+
+	private:
+		/**
+		 * Clips a triangle against the near plane and rasterizes the resulting polygon
+		 *
+		 * @param a the first vertex, in clip space
+		 * @param b the second vertex, in clip space
+		 * @param c the third vertex, in clip space
+		 */
+		void rasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+		/**
+		 * Rasterizes a triangle that is entirely in front of the near plane
+		 *
+		 * @param a the first vertex, in clip space
+		 * @param b the second vertex, in clip space
+		 * @param c the third vertex, in clip space
+		 */
+		void rasterizeClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+	};
+
+}
@@ -0,0 +1,53 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLCommandExecutor.hpp"
+
+#include "OpenGLRenderer.hpp"
+#include "OpenGLVertexBuffer.hpp"
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	OpenGLCommandExecutor::OpenGLCommandExecutor(OpenGLRenderer& renderer) :
+			RendererCommandExecutor(renderer),
+			meshBuffer(renderer.getMeshBuffer()) {
+
+	}
+
+	void OpenGLCommandExecutor::drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+										  const glm::mat4* modelMatrices, std::size_t count) {
+		if(!meshBuffer.isValid()) {
+			return RendererCommandExecutor::drawMulti(models, levelOfDetail, modelMatrices, count);
+		}
+
+		drawCommands.clear();
+		for(std::size_t i = 0; i < count; i++) {
+			// every vertex buffer is compiled by the OpenGL compiler
+			auto vertexBuffer = static_cast<OpenGLVertexBuffer*>(models[i]->compileVertexBuffer(renderer,
+																								 levelOfDetail));
+			if(vertexBuffer == nullptr || vertexBuffer->meshBuffer != &meshBuffer) {
+				return RendererCommandExecutor::drawMulti(models, levelOfDetail, modelMatrices, count);
+			}
+
+			// consecutive draws of the same mesh become instances of a single command
+			const auto& range = vertexBuffer->range;
+			if(!drawCommands.empty()) {
+				auto& previous = drawCommands.back();
+				if(previous.firstIndex == range.firstIndex && previous.baseVertex == GLint(range.firstVertex)) {
+					previous.instanceCount++;
+					continue;
+				}
+			}
+
+			drawCommands.push_back(OpenGLMeshBuffer::DrawCommand{
+					range.indexCount, 1, range.firstIndex, GLint(range.firstVertex), GLuint(i)
+			});
+		}
+
+		if(!meshBuffer.drawMulti(drawCommands, modelMatrices, count)) {
+			RendererCommandExecutor::drawMulti(models, levelOfDetail, modelMatrices, count);
+		}
+	}
+
+}
@@ -0,0 +1,48 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Renderer/CommandExecutor.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLMeshBuffer.hpp"
+
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	class OpenGLRenderer;
+
+	/**
+	 * A command executor that submits multi-draws with a single
+	 * <tt>glMultiDrawElementsIndirect</tt> call when every model lives in the
+	 * renderer mesh buffer. Otherwise, it falls back to one instanced draw per
+	 * geometry.
+	 */
+	class OpenGLCommandExecutor final : public RendererCommandExecutor {
+	private:
+		/**
+		 * The mesh buffer multi-draws are submitted from
+		 */
+		OpenGLMeshBuffer& meshBuffer;
+
+		/**
+		 * The indirect commands of the multi-draw being replayed
+		 */
+		std::vector<OpenGLMeshBuffer::DrawCommand> drawCommands;
+
+	public:
+		/**
+		 * Creates a new executor
+		 *
+		 * @param renderer the renderer context
+		 */
+		explicit OpenGLCommandExecutor(OpenGLRenderer& renderer);
+
+	public:
+		void drawMulti(Model::Model* const* models, const Model::LevelOfDetail& levelOfDetail,
+					   const glm::mat4* modelMatrices, std::size_t count) final;
+
+	};
+
+}
@@ -9,6 +9,8 @@
 #include "OpenGLShader.hpp"
 #include "OpenGLTexture.hpp"
 #include "OpenGLVertexBuffer.hpp"
+#include "OpenGLStateCache.hpp"
+#include "OpenGLTextureStreamer.hpp"
 
 #include <iostream>
 #include <XYZ/Graphics/Material/PhongMaterial.hpp>
@@ -59,19 +61,34 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			return textureImage.getCompiledTexture();
 		}
 
-		auto compiled = std::make_shared<OpenGLTexture>(
-				textureImage
-		);
+		Texture::Texture::Ptr compiled;
+		if(textureStreamer != nullptr) {
+			// only the coarsest levels are uploaded, the rest is streamed in once visible
+			compiled = textureStreamer->add(textureImage);
+		} else {
+			compiled = std::make_shared<OpenGLTexture>(
+					textureImage
+			);
+		}
 
 		const_cast<Texture::TextureImage&>(textureImage).setCompiledTexture(compiled);
 		return compiled;
 	}
 
+	void OpenGLCompiler::setTextureStreamer(OpenGLTextureStreamer* textureStreamer) {
+		OpenGLCompiler::textureStreamer = textureStreamer;
+	}
+
 	std::shared_ptr<VertexBuffer> OpenGLCompiler::compileMesh(
 			const Mesh::Mesh& mesh) {
+		if(meshBuffer != nullptr) {
+			// all meshes share the same buffers, so they can be drawn together
+			return std::make_shared<OpenGLVertexBuffer>(*meshBuffer, meshBuffer->allocate(mesh));
+		}
+
 		GLuint vertexArrayID;
 		glGenVertexArrays(1, &vertexArrayID);
-		glBindVertexArray(vertexArrayID);
+		OpenGLStateCache::get().bindVertexArray(vertexArrayID);
 
 		// The indices buffer
 		auto& indices = mesh.getIndices();
@@ -126,7 +143,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 				(void*) offsetof(Mesh::Vertex, tangent)     // array buffer offset
 		);
 
-		glBindVertexArray(0);
+		OpenGLStateCache::get().bindVertexArray(0);
 
 		// create a vertex buffer object and return it
 		return std::make_shared<OpenGLVertexBuffer>(
@@ -135,6 +152,10 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	}
 
+	void OpenGLCompiler::setMeshBuffer(OpenGLMeshBuffer* meshBuffer) {
+		OpenGLCompiler::meshBuffer = meshBuffer;
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	Material::PhongMaterial::Ptr OpenGLCompiler::createPhongMaterial() {
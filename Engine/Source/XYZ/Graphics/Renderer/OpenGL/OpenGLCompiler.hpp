@@ -11,10 +11,24 @@
 
 namespace XYZ::Graphics::Renderer::OpenGL {
 
+	class OpenGLMeshBuffer;
+	class OpenGLTextureStreamer;
+
 	class OpenGLCompiler : public ShaderCompiler,
 						   public TextureCompiler,
 						   public MeshCompiler,
 						   public Material::MaterialFactory {
+	private:
+		/**
+		 * The mesh buffer meshes are compiled into. If null, every mesh gets its own buffers.
+		 */
+		OpenGLMeshBuffer* meshBuffer = nullptr;
+
+		/**
+		 * The streamer textures are compiled into. If null, textures are uploaded at full resolution.
+		 */
+		OpenGLTextureStreamer* textureStreamer = nullptr;
+
 	public:
 		/**
          * Compiles a vertex shader
@@ -63,6 +77,13 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		Texture::Texture::Ptr compileTexture(
 				const Texture::TextureImage& textureImage) override;
 
+		/**
+		 * Sets the streamer textures are compiled into
+		 *
+		 * @param textureStreamer the texture streamer, or null to upload textures at full resolution
+		 */
+		void setTextureStreamer(OpenGLTextureStreamer* textureStreamer);
+
 	public:
 		/**
 		 * Compiles a mesh
@@ -72,6 +93,13 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		std::shared_ptr<VertexBuffer> compileMesh(
 				const Mesh::Mesh& mesh) override;
 
+		/**
+		 * Sets the mesh buffer meshes are compiled into
+		 *
+		 * @param meshBuffer the mesh buffer, or null to give every mesh its own buffers
+		 */
+		void setMeshBuffer(OpenGLMeshBuffer* meshBuffer);
+
 	public:
 		/**
 		 * Create a new Phong shading material
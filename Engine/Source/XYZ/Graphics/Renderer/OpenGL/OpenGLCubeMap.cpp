@@ -3,6 +3,7 @@
 //
 
 #include "OpenGLCubeMap.hpp"
+#include "OpenGLStateCache.hpp"
 #include "OpenGLException.hpp"
 
 namespace XYZ::Graphics::Renderer::OpenGL {
@@ -10,13 +11,8 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	template<typename Executor>
 	auto wrap(GLuint textureID, Executor&& executor) {
-		glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-		struct Cleanup {
-			~Cleanup() {
-				glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-			}
-		} cleanup;
+		// the texture is left bound, the state cache skips the bind if it is modified again
+		OpenGLStateCache::get().bindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 		return executor();
 	}
 
@@ -34,10 +30,11 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 									   (GLuint) width, (GLuint) height, 0,
 									   format, type, nullptr);
 			}
-
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		});
+
+		auto& state = OpenGLStateCache::get();
+		state.setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	}
 
 	OpenGLCubeMap::OpenGLCubeMap(GLuint textureID) :
@@ -45,20 +42,18 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	OpenGLCubeMap::~OpenGLCubeMap() {
 		if(textureID != 0) {
-			glDeleteTextures(1, &textureID);
+			OpenGLStateCache::get().deleteTexture(textureID);
 		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void OpenGLCubeMap::activate(unsigned int slot) {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_CUBE_MAP, textureID);
 	}
 
 	void OpenGLCubeMap::deactivate(unsigned int slot) {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_CUBE_MAP, 0);
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
@@ -93,19 +88,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLCubeMap::setWrapModeS(Graphics::Texture::TextureWrap mode) {
 		for(auto& map : TextureWrapMapping) {
 			if(map.wrap == mode) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_S,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureWrap OpenGLCubeMap::getWrapModeS() const {
-		GLenum mode;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, (GLint*) &mode);
-		});
+		auto mode = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_S));
 
 		for(auto& map : TextureWrapMapping) {
 			if(map.gl == mode) {
@@ -119,19 +109,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLCubeMap::setWrapModeT(Graphics::Texture::TextureWrap mode) {
 		for(auto& map : TextureWrapMapping) {
 			if(map.wrap == mode) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_T,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureWrap OpenGLCubeMap::getWrapModeT() const {
-		GLenum mode;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, (GLint*) &mode);
-		});
+		auto mode = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_T));
 
 		for(auto& map : TextureWrapMapping) {
 			if(map.gl == mode) {
@@ -145,19 +130,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLCubeMap::setWrapModeR(Graphics::Texture::TextureWrap mode) {
 		for(auto& map : TextureWrapMapping) {
 			if(map.wrap == mode) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_R,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureWrap OpenGLCubeMap::getWrapModeR() const {
-		GLenum mode;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, (GLint*) &mode);
-		});
+		auto mode = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_WRAP_R));
 
 		for(auto& map : TextureWrapMapping) {
 			if(map.gl == mode) {
@@ -197,20 +177,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLCubeMap::setMagnificationFilter(Graphics::Texture::TextureMagnification filter) {
 		for(auto& map : TextureMagnitificationMapping) {
 			if(map.wrap == filter) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MAG_FILTER,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureMagnification OpenGLCubeMap::getMagnificationFilter() const {
-		GLenum filter;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER,
-								   (GLint*) &filter);
-		});
+		auto filter = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MAG_FILTER));
 
 		for(auto& map : TextureMagnitificationMapping) {
 			if(map.gl == filter) {
@@ -236,20 +210,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLCubeMap::setMinificationFilter(Graphics::Texture::TextureMinification filter) {
 		for(auto& map : TextureMinificationMapping) {
 			if(map.wrap == filter) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MIN_FILTER,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureMinification OpenGLCubeMap::getMinificationFilter() const {
-		GLenum filter;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
-								   (GLint*) &filter);
-		});
+		auto filter = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_CUBE_MAP, textureID, GL_TEXTURE_MIN_FILTER));
 
 		for(auto& map : TextureMinificationMapping) {
 			if(map.gl == filter) {
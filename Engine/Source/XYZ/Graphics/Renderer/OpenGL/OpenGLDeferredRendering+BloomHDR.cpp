@@ -10,6 +10,8 @@
 namespace XYZ::Graphics::Renderer::OpenGL {
 
 	void OpenGLDeferredRendering::renderBloomPass() {
+		FrameProfiler::Scope scope(profiler, "bloom");
+
 		static unsigned int quadVAO = 0;
 		static unsigned int quadVBO;
 		if(quadVAO == 0) {
@@ -24,7 +26,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			// setup plane VAO
 			glGenVertexArrays(1, &quadVAO);
 			glGenBuffers(1, &quadVBO);
-			glBindVertexArray(quadVAO);
+			stateCache.bindVertexArray(quadVAO);
 			glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
 			glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
 			glEnableVertexAttribArray(0);
@@ -32,24 +34,17 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			glEnableVertexAttribArray(1);
 			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
 		}
-		glBindVertexArray(quadVAO);
-
-		bloomVerticalBlurFramebuffer.activate();
-		bloomVerticalBlurFramebuffer.clear();
-
-		bloomHorizontalBlurFramebuffer.activate();
-		bloomHorizontalBlurFramebuffer.clear();
+		stateCache.bindVertexArray(quadVAO);
 
-		if(!bloom) {
-			return;
-		}
+		auto& horizontalBlurTexture = getRenderTarget(renderTargets.bloomHorizontalBlur);
+		auto& verticalBlurTexture = getRenderTarget(renderTargets.bloomVerticalBlur);
 
 		// extract the "over-exposed" fragments
 		bloomExposureMappingShaderProgram.activate();
 		bloomExposureMappingShaderProgram.set("scene", 0);
-		lightingTexture.activate(0);
+		getRenderTarget(renderTargets.scene).activate(0);
 
-		bloomVerticalBlurFramebuffer.activate();
+		bloomVerticalBlurFramebuffer->activate();
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 		int amount = 10;
@@ -57,20 +52,22 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		bloomBlurShaderProgram.set("scene", 0);
 
 		for(unsigned int i = 0; i < amount; i++) {
-			bloomHorizontalBlurFramebuffer.activate();
+			bloomHorizontalBlurFramebuffer->activate();
 			bloomBlurShaderProgram.set("horizontal", true);
-			bloomVerticalBlurTexture.activate(0);
+			verticalBlurTexture.activate(0);
 
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-			bloomVerticalBlurFramebuffer.activate();
+			bloomVerticalBlurFramebuffer->activate();
 			bloomBlurShaderProgram.set("horizontal", false);
-			bloomHorizontalBlurTexture.activate(0);
+			horizontalBlurTexture.activate(0);
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 		}
 	}
 
 	void OpenGLDeferredRendering::renderHDRPass() {
+		FrameProfiler::Scope scope(profiler, "hdr");
+
 		static unsigned int quadVAO = 0;
 		static unsigned int quadVBO;
 		if(quadVAO == 0) {
@@ -85,7 +82,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			// setup plane VAO
 			glGenVertexArrays(1, &quadVAO);
 			glGenBuffers(1, &quadVBO);
-			glBindVertexArray(quadVAO);
+			stateCache.bindVertexArray(quadVAO);
 			glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
 			glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
 			glEnableVertexAttribArray(0);
@@ -93,7 +90,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			glEnableVertexAttribArray(1);
 			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
 		}
-		glBindVertexArray(quadVAO);
+		stateCache.bindVertexArray(quadVAO);
 
 		renderer.getDefaultFramebuffer().activate();
 		renderer.getDefaultFramebuffer().clear();
@@ -103,9 +100,12 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		hdrShaderProgram.set("scene", 0);
 		hdrShaderProgram.set("bloom", 1);
 		hdrShaderProgram.set("hdr", hdr);
+		hdrShaderProgram.set("hasBloom", bloom);
 
-		lightingTexture.activate(0);
-		bloomVerticalBlurTexture.activate(1);
+		getRenderTarget(renderTargets.scene).activate(0);
+		if(bloom) {
+			getRenderTarget(renderTargets.bloomVerticalBlur).activate(1);
+		}
 
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	}
@@ -51,14 +51,90 @@ void main() {
 
     TBN = mat3(T, B, N);
 }
+)";
+
+	const Shader::ShaderSource InstancedGeometryVertexShaderSource = R"(
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in vec3 aNormal;
+layout(location = 3) in vec3 aTangent;
+layout(location = 4) in vec3 aBinormal;
+layout(location = 5) in mat4 aModel;
+
+out vec3 FragPos;
+out vec2 TexCoords;
+out vec3 Normal;
+out mat3 TBN;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform struct {
+	vec3 position;
+} camera;
+
+void main() {
+    mat3 normalMatrix = transpose(inverse(mat3(aModel)));
+
+    vec4 worldPos = aModel * vec4(aPos, 1.0);
+    FragPos = worldPos.xyz;
+    TexCoords = aTexCoords;
+    Normal = normalMatrix * aNormal;
+    gl_Position = projection * view * worldPos;
+
+    vec3 T = normalize(normalMatrix * aTangent);
+    vec3 N = normalize(normalMatrix * aNormal);
+    T = normalize(T - dot(T, N) * N);
+    vec3 B = cross(N, T);
+
+    TBN = mat3(T, B, N);
+}
+)";
+
+	const Shader::ShaderSource CompactGeometryBufferShaderSource = R"(
+// the largest shininess stored by the compact geometry buffer is 2^SHININESS_BITS
+const float SHININESS_BITS = 11.0;
+
+// maps a normal to the [0,1] square with an octahedral projection
+vec2 EncodeNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    if(n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return n.xy * 0.5 + 0.5;
+}
+
+// the inverse of EncodeNormal
+vec3 DecodeNormal(vec2 encoded) {
+    encoded = encoded * 2.0 - 1.0;
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// unprojects a depth buffer sample back to the world space position of the fragment
+vec3 ReconstructPosition(vec2 texCoords, float depth, mat4 inverseViewProjection) {
+    vec4 position = inverseViewProjection * vec4(vec3(texCoords, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
 )";
 
 	const Shader::ShaderSource GeometryFragmentShaderSource = R"(
 #version 330 core
 
+#ifdef COMPACT_GEOMETRY_BUFFER
+// the position is reconstructed from depth by the lighting shaders
+layout (location = 0) out vec2 gNormal;
+layout (location = 1) out vec4 gAlbedoSpec;
+layout (location = 2) out float gShininess;
+#else
 layout (location = 0) out vec4 gPosition;
 layout (location = 1) out vec4 gNormal;
 layout (location = 2) out vec4 gAlbedoSpec;
+#endif
 
 in vec2 TexCoords;
 in vec3 FragPos;
@@ -87,23 +163,40 @@ uniform PhongMaterial material;
 const float gamma = 2.2;
 
 void main() {
+#ifndef COMPACT_GEOMETRY_BUFFER
     // store the fragment position vector in the first gbuffer texture
     gPosition.xyz = FragPos;
     gPosition.w = 0.0;
+#endif
+
+    // variants know at compile time if the material has a normal map
+#if defined(SHADER_VARIANT) && defined(NORMAL_MAP)
+	const bool hasNormalMap = true;
+#elif defined(SHADER_VARIANT)
+	const bool hasNormalMap = false;
+#else
+	bool hasNormalMap = material.hasNormalMap;
+#endif
 
     // also store the per-fragment normals into the gbuffer
-	if(material.hasNormalMap) {
-		vec3 normal = texture(material.normal, TexCoords).xyz * 2.0 - 1.0;
+	vec3 normal = Normal;
+	if(hasNormalMap) {
+		vec3 tangentNormal = texture(material.normal, TexCoords).xyz * 2.0 - 1.0;
 		if(gl_FrontFacing == false) {
-			normal = -normal;
+			tangentNormal = -tangentNormal;
 		}
-		gNormal.rgb = normalize(Normal + TBN * normal);
-	} else {
-		gNormal.rgb = Normal;
+		normal = normalize(Normal + TBN * tangentNormal);
 	}
+#ifdef COMPACT_GEOMETRY_BUFFER
+	gNormal = EncodeNormal(normal);
+	gShininess = log2(max(material.shininess, 1.0)) / SHININESS_BITS;
+#else
+	gNormal.rgb = normal;
     gNormal.a = material.shininess;
+#endif
 
-    // and the diffuse per-fragment color
+    // and the diffuse per-fragment color. The compact layout stores it in a
+    // normalized target, which clamps it to 1.
     gAlbedoSpec.rgb = pow(texture(material.diffuse, TexCoords).rgb, vec3(gamma)) + material.diffuseColor;
 
     // store specular intensity in gAlbedoSpec's alpha component
@@ -133,9 +226,17 @@ void main() {
 out vec4 FragColor;
 in vec2 TexCoords;
 
+#ifdef COMPACT_GEOMETRY_BUFFER
+uniform sampler2D gDepth;
+uniform sampler2D gShininess;
+uniform mat4 inverseViewProjection;
+#else
 uniform sampler2D gPosition;
+#endif
 uniform sampler2D gNormal;
 uniform sampler2D gAlbedoSpec;
+// the shadow map of every cascade, one per layer
+uniform sampler2DArray shadowCascades;
 
 //layout(std140) uniform ViewProjection {
 //    mat4 projection;
@@ -163,20 +264,34 @@ struct DirectionalLight {
 
 uniform DirectionalLight light;
 
+// the number of cascades, or 0 if the light casts no shadows
+uniform int cascadeCount;
+// the view distance every cascade ends at
+uniform vec4 cascadeSplits;
+// the size of a shadow map texel of every cascade, in world units
+uniform vec4 cascadeTexelSizes;
+uniform mat4 cascadeMatrices[4];
+
 // function prototypes
-mat3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, float shininess);
+mat3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess);
+float ShadowCalculation(vec3 fragPos, vec3 normal, vec3 lightDir, float shadowOcclusionStrength);
 
 void main() {
     // retrieve data from gbuffer
+#ifdef COMPACT_GEOMETRY_BUFFER
+    vec3 FragPos = ReconstructPosition(TexCoords, texture(gDepth, TexCoords).r, inverseViewProjection);
+    vec3 Normal = DecodeNormal(texture(gNormal, TexCoords).rg);
+    float Shininess = exp2(texture(gShininess, TexCoords).r * SHININESS_BITS);
+#else
     vec3 FragPos = texture(gPosition, TexCoords).rgb;
-    float Depth = texture(gPosition, TexCoords).a;
     vec3 Normal = texture(gNormal, TexCoords).rgb;
     float Shininess = texture(gNormal, TexCoords).a;
+#endif
     vec3 Diffuse = texture(gAlbedoSpec, TexCoords).rgb;
     float Specular = texture(gAlbedoSpec, TexCoords).a;
 
     vec3 viewDir = normalize(camera.position - FragPos);
-    mat3 result = CalcDirectionalLight(light, Normal, viewDir, Shininess);
+    mat3 result = CalcDirectionalLight(light, Normal, FragPos, viewDir, Shininess);
 
     vec3 materialDiffuse = Diffuse;
     vec3 materialSpecular = vec3(Specular);
@@ -186,7 +301,7 @@ void main() {
 }
 
 // calculates the color when using a directional light.
-mat3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, float shininess) {
+mat3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess) {
     vec3 lightDir = normalize(-light.direction);
 
     // diffuse shading
@@ -196,36 +311,86 @@ mat3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, flo
     vec3 halfwayDir = normalize(lightDir + viewDir);
     float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
 
+	// shadows
+	float visibility = ShadowCalculation(fragPos, normal, lightDir, light.shadowOcclusionStrength);
+
     // combine results
     return mat3(
         light.ambient,
-        light.diffuse * diff,
-        light.specular * spec
+        light.diffuse * diff * visibility,
+        light.specular * spec * visibility
     );
 }
+
+float ShadowCalculation(vec3 fragPos, vec3 normal, vec3 lightDir, float shadowOcclusionStrength) {
+	// pick the first cascade that covers the fragment
+	float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+	int cascade = 0;
+	while(cascade < cascadeCount && viewDepth > cascadeSplits[cascade])
+		cascade++;
+
+	// past the last cascade nothing is shadowed
+	if(cascade >= cascadeCount)
+		return 1.0;
+
+	// offset the lookup along the normal by a cascade texel, so that the bias
+	// follows the cascade resolution
+	vec3 offsetPos = fragPos + normal * (1.5 * cascadeTexelSizes[cascade]);
+	vec4 fragPosLightSpace = cascadeMatrices[cascade] * vec4(offsetPos, 1.0);
+
+	// transform to [0,1] range
+	vec3 projCoords = (fragPosLightSpace.xyz / fragPosLightSpace.w) * 0.5 + 0.5;
+	if(projCoords.z > 1.0)
+		return 1.0;
+
+	float currentDepth = projCoords.z;
+	float bias = max(0.0005 * (1.0 - dot(normal, lightDir)), 0.00005);
+
+	// apply a PCF filter to get a bit smoother shadows
+	const int smoothing = 1;
+	float shadow = 0.0;
+	vec2 texelSize = 1.0 / vec2(textureSize(shadowCascades, 0).xy);
+	for(int x = -smoothing; x <= smoothing; ++x) {
+		for(int y = -smoothing; y <= smoothing; ++y) {
+			float pcfDepth = texture(shadowCascades, vec3(projCoords.xy + vec2(x, y) * texelSize, float(cascade))).r;
+			shadow += currentDepth - bias > pcfDepth ? (1.0 - shadowOcclusionStrength) : 1.0;
+		}
+	}
+	shadow /= pow(2.0 * float(smoothing) + 1.0, 2);
+
+	return shadow;
+}
 )";
 
-	const Shader::ShaderSource PointLightFragmentShaderSource = R"(
+	const Shader::ShaderSource ClusteredLightFragmentShaderSource = R"(
 #version 330 core
 
 out vec4 FragColor;
 in vec2 TexCoords;
 
+#ifdef COMPACT_GEOMETRY_BUFFER
+uniform sampler2D gDepth;
+uniform sampler2D gShininess;
+uniform mat4 inverseViewProjection;
+#else
 uniform sampler2D gPosition;
+#endif
 uniform sampler2D gNormal;
 uniform sampler2D gAlbedoSpec;
-uniform float farPlane;
 
-uniform bool hasShadowMap;
-uniform samplerCube shadowMap;
+// the light data, see LightClusters::TEXELS_PER_LIGHT for the layout
+uniform samplerBuffer lightData;
 
-//layout(std140) uniform ViewProjection {
-//    mat4 projection;
-//    mat4 view;
-//    struct {
-//        vec3 position;
-//    } camera;
-//};
+// a (offset, count) pair per cluster into the light index list
+uniform usamplerBuffer clusterData;
+
+// the light indices referenced by the clusters
+uniform usamplerBuffer lightIndices;
+
+uniform uvec3 clusterCount;
+uniform vec2 screenSize;
+uniform float zNear;
+uniform float zFar;
 
 uniform mat4 projection;
 uniform mat4 view;
@@ -233,52 +398,67 @@ uniform struct {
 	vec3 position;
 } camera;
 
-struct PointLight {
-    vec3 position;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-	float shadowOcclusionStrength;
-};
-
-uniform PointLight light[LIGHT_COUNT];
+const int TEXELS_PER_LIGHT = 6;
 
 // function prototypes
-mat3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess);
-float ShadowCalculation(vec3 fragPos, vec3 lightPos, vec3 viewPos, float shadowOcclusionStrength);
+mat3 CalcPointLight(int index, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess);
+mat3 CalcSpotLight(int index, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess);
 
 void main() {
     // retrieve data from gbuffer
+#ifdef COMPACT_GEOMETRY_BUFFER
+    vec3 FragPos = ReconstructPosition(TexCoords, texture(gDepth, TexCoords).r, inverseViewProjection);
+    vec3 Normal = DecodeNormal(texture(gNormal, TexCoords).rg);
+    float Shininess = exp2(texture(gShininess, TexCoords).r * SHININESS_BITS);
+#else
     vec3 FragPos = texture(gPosition, TexCoords).rgb;
-    float Depth = texture(gPosition, TexCoords).a;
     vec3 Normal = texture(gNormal, TexCoords).rgb;
     float Shininess = texture(gNormal, TexCoords).a;
+#endif
     vec3 Diffuse = texture(gAlbedoSpec, TexCoords).rgb;
     float Specular = texture(gAlbedoSpec, TexCoords).a;
 
-    vec3 viewDir = normalize(camera.position - FragPos);
-	mat3 result = mat3(0.0);
+    // locate the cluster of the fragment
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    if(depth < zNear || depth > zFar) {
+        discard;
+    }
 
-	for(int i = 0; i<LIGHT_COUNT; i++) {
-    	result += CalcPointLight(light[i], Normal, FragPos, viewDir, Shininess);
+    uint slice = min(uint(log(depth / zNear) / log(zFar / zNear) * float(clusterCount.z)), clusterCount.z - 1u);
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / screenSize * vec2(clusterCount.xy)), clusterCount.xy - uvec2(1u));
+    int cluster = int(tile.x + clusterCount.x * (tile.y + clusterCount.y * slice));
+
+    uvec2 range = texelFetch(clusterData, cluster).xy;
+
+    vec3 viewDir = normalize(camera.position - FragPos);
+	mat3 pointResult = mat3(0.0);
+	mat3 spotResult = mat3(0.0);
+
+	for(uint i = 0u; i < range.y; i++) {
+		int index = int(texelFetch(lightIndices, int(range.x + i)).r);
+		if(texelFetch(lightData, index * TEXELS_PER_LIGHT + 1).w == 0.0) {
+			pointResult += CalcPointLight(index, Normal, FragPos, viewDir, Shininess);
+		} else {
+			spotResult += CalcSpotLight(index, Normal, FragPos, viewDir, Shininess);
+		}
 	}
 
-    vec3 materialDiffuse = Diffuse;
-    vec3 materialSpecular = materialDiffuse * vec3(Specular);
-    vec3 color = (result[0] + result[1]) * materialDiffuse + result[2] * materialSpecular;
+    vec3 color = (pointResult[0] + pointResult[1]) * Diffuse + pointResult[2] * Diffuse * vec3(Specular) +
+                 (spotResult[0] + spotResult[1]) * Diffuse + spotResult[2] * vec3(Specular);
 
     FragColor = vec4(color, 1.0);
 }
 
 // calculates the color when using a point light.
-mat3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess) {
-    vec3 lightPos = light.position;
+mat3 CalcPointLight(int index, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess) {
+    int base = index * TEXELS_PER_LIGHT;
+    vec4 positionRadius = texelFetch(lightData, base + 0);
+    vec4 diffuseType = texelFetch(lightData, base + 1);
+    vec4 specularConstant = texelFetch(lightData, base + 2);
+    vec4 ambientLinear = texelFetch(lightData, base + 3);
+    float quadratic = texelFetch(lightData, base + 4).w;
+
+    vec3 lightPos = positionRadius.xyz;
     vec3 lightDir = normalize(lightPos - fragPos);
 
     // diffuse shading
@@ -290,60 +470,51 @@ mat3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, f
 
     // attenuation
     float distance = length(lightPos - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * pow(distance, 2));
-
-	// compute the shadow visibility factor
-	float visibility = 1.0;
-	if(hasShadowMap) {
-		visibility = ShadowCalculation(fragPos, lightPos, camera.position, light.shadowOcclusionStrength);
-	}
+    float attenuation = 1.0 / (specularConstant.w + ambientLinear.w * distance + quadratic * (distance * distance));
 
     // combine results
     return mat3(
-        light.ambient * attenuation,
-        light.diffuse * diff * attenuation * visibility,
-        light.specular * spec * attenuation * visibility
+        ambientLinear.rgb * attenuation,
+        diffuseType.rgb * diff * attenuation,
+        specularConstant.rgb * spec * attenuation
     );
 }
 
-vec3 sampleOffsetDirections[20] = vec3[](
-   vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1),
-   vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
-   vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
-   vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
-   vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
-);
-
-float ShadowCalculation(vec3 fragPos, vec3 lightPos, vec3 viewPos, float shadowOcclusionStrength) {
-    // get vector between fragment position and light position
-    vec3 fragToLight = fragPos - lightPos;
-
-	// ise the fragment to light vector to sample from the depth map
-    float closestDepth = texture(shadowMap, fragToLight).r;
-
-    // it is currently in linear range between [0,1], let's re-transform it back to original depth value
-    closestDepth *= farPlane;
-
-    // now get current linear depth as the length between the fragment and light position
-    float currentDepth = length(fragToLight);
-
-    // test for shadows
-	const float bias = 0.005 * 2;
-    float shadow = currentDepth - bias > closestDepth ? (1.0 - shadowOcclusionStrength) : 1.0;
-
-//	float shadow = 0.0;
-//	const float bias   = 0.15;
-//	const int samples  = 2;
-//	float viewDistance = length(viewPos - fragPos);
-//	const float diskRadius = 0.05;
-//	int i = 0;
-////	for(int i = 0; i < 2; i++) {
-//		float closestDepth = texture(shadowMap, fragToLight + sampleOffsetDirections[i] * diskRadius).r * farPlane;
-//		shadow += currentDepth - bias > closestDepth ? 0.0 : 1.0;
-////	}
-//	shadow /= float(samples);
+// calculates the color when using a spot light.
+mat3 CalcSpotLight(int index, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess) {
+    int base = index * TEXELS_PER_LIGHT;
+    vec4 positionRadius = texelFetch(lightData, base + 0);
+    vec4 diffuseType = texelFetch(lightData, base + 1);
+    vec4 specularConstant = texelFetch(lightData, base + 2);
+    vec4 ambientLinear = texelFetch(lightData, base + 3);
+    vec4 directionQuadratic = texelFetch(lightData, base + 4);
+    vec2 cutOff = texelFetch(lightData, base + 5).xy;
+
+    vec3 lightPos = positionRadius.xyz;
+	vec3 lightDir = normalize(lightPos - fragPos);
 
-	return shadow;
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+
+    // attenuation
+    float distance = length(lightPos - fragPos);
+    float attenuation = 1.0 / (specularConstant.w + ambientLinear.w * distance + directionQuadratic.w * (distance * distance));
+
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-directionQuadratic.xyz));
+    float epsilon = cutOff.x - cutOff.y;
+    float intensity = clamp((theta - cutOff.y) / epsilon, 0.0, 1.0);
+
+    // combine results
+    return mat3(
+        ambientLinear.rgb * attenuation * intensity,
+        diffuseType.rgb * diff * attenuation * intensity,
+        specularConstant.rgb * spec * attenuation * intensity
+    );
 }
 )";
 
@@ -353,61 +524,73 @@ float ShadowCalculation(vec3 fragPos, vec3 lightPos, vec3 viewPos, float shadowO
 out vec4 FragColor;
 in vec2 TexCoords;
 
+#ifdef COMPACT_GEOMETRY_BUFFER
+uniform sampler2D gDepth;
+uniform sampler2D gShininess;
+uniform mat4 inverseViewProjection;
+#else
 uniform sampler2D gPosition;
+#endif
 uniform sampler2D gNormal;
 uniform sampler2D gAlbedoSpec;
+// the shadow maps of every shadow casting spot light, each on its own tile
 uniform sampler2D shadowMap;
 
-uniform mat4 lightSpaceMatrix;
-
-//layout(std140) uniform ViewProjection {
-//    mat4 projection;
-//    mat4 view;
-//    struct {
-//        vec3 position;
-//    } camera;
-//};
-
-uniform mat4 projection;
-uniform mat4 view;
 uniform struct {
 	vec3 position;
 } camera;
 
 struct SpotLight {
 	vec3 position;
-	vec3 direction;
 	float cutOff;
+
+	vec3 direction;
 	float outerCutOff;
 
+	vec3 ambient;
 	float constant;
-	float linear;
-	float quadratic;
 
-	vec3 ambient;
 	vec3 diffuse;
+	float linear;
+
 	vec3 specular;
+	float quadratic;
 
+	mat4 lightSpaceMatrix;
 	float shadowOcclusionStrength;
+
+	// the light tile on the shadow map: the origin and the size, in texture coordinates
+	vec4 shadowMapTile;
 };
 
-uniform SpotLight light;
+// the parameters of every shadow casting spot light of the frame, must match OpenGLSpotLights
+layout(std140) uniform SpotLights {
+	SpotLight spotLights[32];
+};
+
+// the index of the light being shaded
+uniform int lightIndex;
 
 // function prototypes
 mat3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shininess);
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, float shadowOcclusionStrength);
+float ShadowCalculation(vec4 fragPosLightSpace, vec4 tile, vec3 normal, vec3 lightDir, float shadowOcclusionStrength);
 
 void main() {
     // retrieve data from gbuffer
+#ifdef COMPACT_GEOMETRY_BUFFER
+    vec3 FragPos = ReconstructPosition(TexCoords, texture(gDepth, TexCoords).r, inverseViewProjection);
+    vec3 Normal = DecodeNormal(texture(gNormal, TexCoords).rg);
+    float Shininess = exp2(texture(gShininess, TexCoords).r * SHININESS_BITS);
+#else
     vec3 FragPos = texture(gPosition, TexCoords).rgb;
-    float Depth = texture(gPosition, TexCoords).a;
     vec3 Normal = texture(gNormal, TexCoords).rgb;
     float Shininess = texture(gNormal, TexCoords).a;
+#endif
     vec3 Diffuse = texture(gAlbedoSpec, TexCoords).rgb;
     float Specular = texture(gAlbedoSpec, TexCoords).a;
 
     vec3 viewDir = normalize(camera.position - FragPos);
-    mat3 result = CalcSpotLight(light, Normal, FragPos, viewDir, Shininess);
+    mat3 result = CalcSpotLight(spotLights[lightIndex], Normal, FragPos, viewDir, Shininess);
 
     vec3 materialDiffuse = Diffuse;
     vec3 materialSpecular = vec3(Specular);
@@ -437,7 +620,7 @@ mat3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, flo
     float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
 
 	// shadows
-	float visibility = ShadowCalculation(lightSpaceMatrix * vec4(fragPos, 1.0), normal, lightDir, light.shadowOcclusionStrength);
+	float visibility = ShadowCalculation(light.lightSpaceMatrix * vec4(fragPos, 1.0), light.shadowMapTile, normal, lightDir, light.shadowOcclusionStrength);
 
     // combine results
     return mat3(
@@ -447,7 +630,7 @@ mat3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, flo
     );
 }
 
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, float shadowOcclusionStrength) {
+float ShadowCalculation(vec4 fragPosLightSpace, vec4 tile, vec3 normal, vec3 lightDir, float shadowOcclusionStrength) {
     // perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
 
@@ -458,8 +641,9 @@ float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, floa
     // transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
 
-    // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
+	// outside of the light tile there is nothing to cast a shadow
+	if(any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0))))
+		return 1.0;
 
     // get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
@@ -472,9 +656,14 @@ float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, floa
 	const int smoothing = 2;
 	float shadow = 0.0;
 	vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+
+	// keep the filter inside of the tile, the neighbouring tiles belong to other lights
+	vec2 tileCoords = tile.xy + projCoords.xy * tile.zw;
+	vec2 tileMin = tile.xy + 0.5 * texelSize;
+	vec2 tileMax = tile.xy + tile.zw - 0.5 * texelSize;
 	for(int x = -smoothing; x <= smoothing; ++x) {
 		for(int y = -smoothing; y <= smoothing; ++y) {
-			float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+			float pcfDepth = texture(shadowMap, clamp(tileCoords + vec2(x, y) * texelSize, tileMin, tileMax)).r;
 			shadow += currentDepth - bias > pcfDepth ? (1.0 - shadowOcclusionStrength) : 1.0;
 		}
 	}
@@ -495,6 +684,18 @@ uniform mat4 model;
 void main() {
     gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
 }
+)";
+
+	const Shader::ShaderSource InstancedShadowMapVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 5) in mat4 aModel;
+
+uniform mat4 lightSpaceMatrix;
+
+void main() {
+    gl_Position = lightSpaceMatrix * aModel * vec4(aPos, 1.0);
+}
 )";
 
 	const Shader::ShaderSource DirectionalLightShadowMapFragmentShaderSource = R"(
@@ -659,6 +860,7 @@ uniform sampler2D scene;
 uniform sampler2D bloom;
 
 uniform bool hdr = true;
+uniform bool hasBloom = false;
 
 void main() {
     const float gamma = 2.2;
@@ -666,7 +868,9 @@ void main() {
 	// fetch the scene color
 	vec3 hdrColor = vec3(0.0);
 	hdrColor += texture(scene, TexCoords).rgb;
-	hdrColor += texture(bloom, TexCoords).rgb;
+	if(hasBloom) {
+		hdrColor += texture(bloom, TexCoords).rgb;
+	}
 
 	if(hdr) {
 		// tone mapping
@@ -7,6 +7,10 @@
 #include "XYZ/Scene/Light/DirectionalLight.hpp"
 #include "XYZ/Scene/Light/PointLight.hpp"
 #include "XYZ/Scene/Light/SpotLight.hpp"
+#include "XYZ/Scene/Prefab/PrefabInstance.hpp"
+#include "XYZ/Scene/HLOD/HLODGroup.hpp"
+
+#include "XYZ/Math/Transform.hpp"
 
 #include "OpenGLVertexBuffer.hpp"
 #include "OpenGLShaderBuffers.hpp"
@@ -15,87 +19,104 @@
 
 #include <glm/ext.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace XYZ::Graphics::Renderer::OpenGL {
 
 	enum OpenGLUniformBufferIndex : GLuint {
-		VIEW_PROJECT_UNIFORM_BUFFER_INDEX = 0
+		VIEW_PROJECT_UNIFORM_BUFFER_INDEX = 0,
+		SPOT_LIGHTS_UNIFORM_BUFFER_INDEX = 1
 	};
 
-	OpenGLDeferredRendering::OpenGLDeferredRendering(OpenGLRenderer& renderer) :
+	/**
+	 * The size of the spot light shadow atlas and of its largest and smallest tiles
+	 */
+	static constexpr unsigned int SHADOW_ATLAS_SIZE = 4096;
+	static constexpr unsigned int SHADOW_ATLAS_MAX_TILE_SIZE = 1024;
+	static constexpr unsigned int SHADOW_ATLAS_MIN_TILE_SIZE = 128;
+
+	OpenGLDeferredRendering::OpenGLDeferredRendering(OpenGLRenderer& renderer, std::string shaderCacheDirectory) :
 			renderer(renderer),
-			geometryBuffer(1024, 768),
-			geometryBufferShader(
-					OpenGLVertexShader(GeometryVertexShaderSource),
-					OpenGLFragmentShader(GeometryFragmentShaderSource)
-			),
-
-			shadowMap(1024, 1024, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT, GL_FLOAT),
-			shadowMapFBO(1024, 1024),
-			shadowMapShader(
-					OpenGLVertexShader(DirectionalLightShadowMapVertexShaderSource),
-					OpenGLFragmentShader(DirectionalLightShadowMapFragmentShaderSource)
-			),
+			stateCache(OpenGLStateCache::get()),
+			shaderCache(std::make_unique<OpenGLShaderCache>(std::move(shaderCacheDirectory))),
+			commandExecutor(renderer),
+			jobSystem(std::make_unique<Utility::JobSystem>()),
+
+			shadowAtlas(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_MAX_TILE_SIZE, SHADOW_ATLAS_MIN_TILE_SIZE),
+			shadowAtlasTexture(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT, GL_FLOAT),
+			shadowAtlasFramebuffer(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE),
+			staticShadowAtlasTexture(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT,
+									 GL_FLOAT),
+			staticShadowAtlasFramebuffer(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE),
+			shadowCascadeTexture(shadowCascades.getResolution(), shadowCascades.getResolution(),
+								 ShadowCascades::MAX_CASCADES, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT, GL_FLOAT),
+			shadowCascadeFramebuffer(shadowCascades.getResolution(), shadowCascades.getResolution()),
+			shadowMapShader(shaderCache->load(
+					DirectionalLightShadowMapVertexShaderSource,
+					DirectionalLightShadowMapFragmentShaderSource
+			)),
+			shadowMapInstancedShader(shaderCache->load(
+					InstancedShadowMapVertexShaderSource,
+					DirectionalLightShadowMapFragmentShaderSource
+			)),
 
 			shadowCubeMap(1024, 1024, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT, GL_FLOAT),
 			shadowCubeMapFBO(1024, 1024),
-			shadowCubeMapShader(
-					OpenGLVertexShader(PointLightShadowMapVertexShaderSource),
-					OpenGLFragmentShader(PointLightShadowMapFragmentShaderSource)
-//					, OpenGLGeometryShader(PointLightShadowMapGeometryShaderSource)
-			),
-
-			lightingFramebuffer(1024, 768),
-			lightingTexture(1024, 768, GL_RGBA16F, GL_RGBA, GL_FLOAT),
-
-			directionalLightShader(
-					OpenGLVertexShader(LightingVertexShaderSource),
-					OpenGLFragmentShader(DirectionalLightFragmentShaderSource)
-			),
-//			pointLightShader(
-//					OpenGLVertexShader(LightingVertexShaderSource),
-//					OpenGLFragmentShader(PointLightFragmentShaderSource)
-//			),
-			spotLightShader(
-					OpenGLVertexShader(LightingVertexShaderSource),
-					OpenGLFragmentShader(SpotLightFragmentShaderSource)
-			),
-
-			bloomHorizontalBlurFramebuffer(1024, 768),
-			bloomHorizontalBlurTexture(1024, 768, GL_RGBA16F, GL_RGBA, GL_FLOAT),
-
-			bloomVerticalBlurFramebuffer(1024, 768),
-			bloomVerticalBlurTexture(1024, 768, GL_RGBA16F, GL_RGBA, GL_FLOAT),
-
-			bloomExposureMappingShaderProgram(
-					OpenGLVertexShader(BloomExposureMappingVertexShaderSource),
-					OpenGLFragmentShader(BloomExposureMappingFragmentShaderSource)
-			),
-			bloomBlurShaderProgram(
-					OpenGLVertexShader(BloomBlurVertexShaderSource),
-					OpenGLFragmentShader(BloomBlurFragmentShaderSource)
-			),
-
-			hdrShaderProgram(
-					OpenGLVertexShader(HDRVertexShaderSource),
-					OpenGLFragmentShader(HDRFragmentShaderSource)
-			) {
+			shadowCubeMapShader(shaderCache->load(
+					PointLightShadowMapVertexShaderSource,
+					PointLightShadowMapFragmentShaderSource
+//					, &PointLightShadowMapGeometryShaderSource
+			)),
+
+			clusterLightBuffer(GL_RGBA32F),
+			clusterGridBuffer(GL_RG32UI),
+			clusterIndexBuffer(GL_R32UI),
+
+			bloomExposureMappingShaderProgram(shaderCache->load(
+					BloomExposureMappingVertexShaderSource,
+					BloomExposureMappingFragmentShaderSource
+			)),
+			bloomBlurShaderProgram(shaderCache->load(
+					BloomBlurVertexShaderSource,
+					BloomBlurFragmentShaderSource
+			)),
+
+			hdrShaderProgram(shaderCache->load(
+					HDRVertexShaderSource,
+					HDRFragmentShaderSource
+			)) {
 		viewProjection.init();
+		renderGraph.setSize(1024, 768);
 
 //		geometryBufferShader.set("ViewProjection", VIEW_PROJECT_UNIFORM_BUFFER_INDEX, viewProjection);
 
 		// -------------------------------------------------------------------------------------------------------------
 
-		shadowMap.setWrapMode(Texture::TextureWrap::CLAMP_TO_BORDER, Texture::TextureWrap::CLAMP_TO_BORDER);
-		shadowMap.setBorderColor(glm::vec4(1.0, 1.0, 1.0, 1.0));
+		// the shadow lookups are clamped to the tile of each light, samples outside
+		// of the light frustum are handled by the lighting shader
+		for(auto* atlas : {&shadowAtlasTexture, &staticShadowAtlasTexture}) {
+			atlas->setWrapMode(Texture::TextureWrap::CLAMP_TO_EDGE, Texture::TextureWrap::CLAMP_TO_EDGE);
+		}
+
+		for(auto entry : {std::make_pair(&shadowAtlasFramebuffer, &shadowAtlasTexture),
+						  std::make_pair(&staticShadowAtlasFramebuffer, &staticShadowAtlasTexture)}) {
+			entry.first->activate();
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
+								   entry.second->textureID, 0);
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+			entry.first->clear();
+			entry.first->deactivate();
+		}
 
-		shadowMapFBO.activate();
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
-							   shadowMap.textureID, 0);
+		// the layer being rendered is attached by renderShadowMap
+		shadowCascadeFramebuffer.activate();
+		shadowCascadeTexture.attach(GL_DEPTH_ATTACHMENT, 0);
 		glDrawBuffer(GL_NONE);
 		glReadBuffer(GL_NONE);
-		shadowMapFBO.deactivate();
+		shadowCascadeFramebuffer.deactivate();
 
 		// -------------------------------------------------------------------------------------------------------------
 
@@ -112,118 +133,435 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 		// -------------------------------------------------------------------------------------------------------------
 
-		lightingTexture.setWrapMode(Texture::TextureWrap::CLAMP_TO_EDGE, Texture::TextureWrap::CLAMP_TO_EDGE);
+		spotLights.init();
+		loadGeometryBufferShaders();
 
-		lightingFramebuffer.activate();
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-							   lightingTexture.textureID, 0);
-		lightingFramebuffer.deactivate();
+		// -------------------------------------------------------------------------------------------------------------
+
+		hdrShaderProgram.activate();
+		hdrShaderProgram.set("scene", 0);
+		hdrShaderProgram.set("bloom", 1);
+	}
+
+	OpenGLDeferredRendering::~OpenGLDeferredRendering() = default;
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLDeferredRendering::render(Scene::Scene& scene) {
+		profiler.beginFrame();
+		if(renderGraphDirty) {
+			buildRenderGraph();
+		}
+
+		// Cull the scene for every view in parallel
+		{
+			FrameProfiler::Scope scope(profiler, "cull");
+			buildRenderQueues(scene);
+		}
+
+		// Stream in the texture levels requested by the visible objects
+		{
+			FrameProfiler::Scope scope(profiler, "textureStreaming");
+			renderer.getTextureStreamer().update();
+		}
+
+		// Render the passes that were not culled from the render graph
+		currentScene = &scene;
+		renderGraph.execute();
+		currentScene = nullptr;
+
+		// protect the per-draw data streamed this frame until the GPU consumes it
+		renderer.getDrawDataBuffer().fence();
+
+		profiler.endFrame();
+	}
+
+	void OpenGLDeferredRendering::resize(unsigned int width, unsigned height) {
+		renderer.getDefaultFramebuffer().resize(width, height);
+
+		renderGraph.setSize(width, height);
+		buildRenderGraph();
+	}
+
+	void OpenGLDeferredRendering::setLighting(bool lighting) {
+		if(OpenGLDeferredRendering::lighting != lighting) {
+			OpenGLDeferredRendering::lighting = lighting;
+			renderGraphDirty = true;
+		}
+	}
+
+	void OpenGLDeferredRendering::setBloom(bool bloom) {
+		if(OpenGLDeferredRendering::bloom != bloom) {
+			OpenGLDeferredRendering::bloom = bloom;
+			renderGraphDirty = true;
+		}
+	}
+
+	void OpenGLDeferredRendering::setCompactGeometryBuffer(bool compactGeometryBuffer) {
+		if(OpenGLDeferredRendering::compactGeometryBuffer != compactGeometryBuffer) {
+			OpenGLDeferredRendering::compactGeometryBuffer = compactGeometryBuffer;
+			loadGeometryBufferShaders();
+			renderGraphDirty = true;
+		}
+	}
+
+	bool OpenGLDeferredRendering::isCompactGeometryBuffer() const {
+		return compactGeometryBuffer;
+	}
+
+	const RenderGraph& OpenGLDeferredRendering::getRenderGraph() const {
+		return renderGraph;
+	}
+
+	FrameProfiler& OpenGLDeferredRendering::getProfiler() {
+		return profiler;
+	}
+
+	ShadowCascades& OpenGLDeferredRendering::getShadowCascades() {
+		return shadowCascades;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	/**
+	 * Adds the define and the shared functions of the compact geometry buffer
+	 * layout to a shader source
+	 *
+	 * @param source the shader source
+	 * @param compactGeometryBuffer true if the geometry buffer uses the compact layout
+	 *
+	 * @return the shader source for the geometry buffer layout
+	 */
+	static Shader::ShaderSource withGeometryBufferLayout(const Shader::ShaderSource& source,
+														  bool compactGeometryBuffer) {
+		if(!compactGeometryBuffer) {
+			return source;
+		}
+
+		// the define must come right after the #version directive
+		auto layout = "#define COMPACT_GEOMETRY_BUFFER\n" + CompactGeometryBufferShaderSource.getSource();
+		const auto& text = source.getSource();
+		auto position = text.find('\n', text.find("#version"));
+		if(position == std::string::npos) {
+			return Shader::ShaderSource(layout + text);
+		}
+		return Shader::ShaderSource(text.substr(0, position + 1) + layout + text.substr(position + 1));
+	}
+
+	/**
+	 * Sets the sampler units of the geometry buffer targets on a lighting shader
+	 * program, see <tt>OpenGLDeferredRendering::activateGeometryBuffer</tt>. The
+	 * program must be active.
+	 *
+	 * @param shader the lighting shader program
+	 * @param compactGeometryBuffer true if the geometry buffer uses the compact layout
+	 */
+	static void setGeometryBufferSamplers(OpenGLShaderProgram& shader, bool compactGeometryBuffer) {
+		if(compactGeometryBuffer) {
+			shader.set("gDepth", 0);
+			shader.set("gShininess", 6);
+		} else {
+			shader.set("gPosition", 0);
+		}
+		shader.set("gNormal", 1);
+		shader.set("gAlbedoSpec", 2);
+	}
+
+	void OpenGLDeferredRendering::loadGeometryBufferShaders() {
+		// the queues still reference the programs of the previous layout
+		geometryRenderQueue.clear();
+		geometryCommands.clear();
+
+		geometryBufferShaders = std::make_unique<OpenGLShaderVariants>(
+				*shaderCache,
+				GeometryVertexShaderSource,
+				withGeometryBufferLayout(GeometryFragmentShaderSource, compactGeometryBuffer),
+				std::vector<std::string>{"NORMAL_MAP"}
+		);
+		geometryBufferInstancedShaders = std::make_unique<OpenGLShaderVariants>(
+				*shaderCache,
+				InstancedGeometryVertexShaderSource,
+				withGeometryBufferLayout(GeometryFragmentShaderSource, compactGeometryBuffer),
+				std::vector<std::string>{"NORMAL_MAP"}
+		);
+
+		// compile the geometry variants used by static models up front, any other
+		// variant is compiled in the background the first time it is needed
+		for(auto features : {0u, std::uint32_t(Model::Model::SHADER_FEATURE_NORMAL_MAP)}) {
+			geometryBufferShaders->warmUp(features);
+			geometryBufferInstancedShaders->warmUp(features);
+		}
+
+		directionalLightShader = shaderCache->load(
+				LightingVertexShaderSource,
+				withGeometryBufferLayout(DirectionalLightFragmentShaderSource, compactGeometryBuffer)
+		);
+		clusteredLightShader = shaderCache->load(
+				LightingVertexShaderSource,
+				withGeometryBufferLayout(ClusteredLightFragmentShaderSource, compactGeometryBuffer)
+		);
+		spotLightShader = shaderCache->load(
+				LightingVertexShaderSource,
+				withGeometryBufferLayout(SpotLightFragmentShaderSource, compactGeometryBuffer)
+		);
 
 		// -------------------------------------------------------------------------------------------------------------
 
 //		directionalLightShader.set("ViewProjection", VIEW_PROJECT_UNIFORM_BUFFER_INDEX, viewProjection);
 
 		directionalLightShader.activate();
-		directionalLightShader.set("gPosition", 0);
-		directionalLightShader.set("gNormal", 1);
-		directionalLightShader.set("gAlbedoSpec", 2);
-		directionalLightShader.set("shadowMap", 3);
+		setGeometryBufferSamplers(directionalLightShader, compactGeometryBuffer);
+		directionalLightShader.set("shadowCascades", 3);
+
+		directionalLightUniforms.direction = directionalLightShader.getUniform<glm::vec3>("light.direction");
+		directionalLightUniforms.ambient = directionalLightShader.getUniform<glm::vec3>("light.ambient");
+		directionalLightUniforms.diffuse = directionalLightShader.getUniform<glm::vec3>("light.diffuse");
+		directionalLightUniforms.specular = directionalLightShader.getUniform<glm::vec3>("light.specular");
+		directionalLightUniforms.shadowOcclusionStrength =
+				directionalLightShader.getUniform<float>("light.shadowOcclusionStrength");
+		directionalLightUniforms.cameraPosition = directionalLightShader.getUniform<glm::vec3>("camera.position");
+		directionalLightUniforms.view = directionalLightShader.getUniform<glm::mat4>("view");
+		directionalLightUniforms.inverseViewProjection =
+				directionalLightShader.getUniform<glm::mat4>("inverseViewProjection");
+		directionalLightUniforms.cascadeCount = directionalLightShader.getUniform<int>("cascadeCount");
+		directionalLightUniforms.cascadeSplits = directionalLightShader.getUniform<glm::vec4>("cascadeSplits");
+		directionalLightUniforms.cascadeTexelSizes = directionalLightShader.getUniform<glm::vec4>("cascadeTexelSizes");
+		for(unsigned int i = 0; i < ShadowCascades::MAX_CASCADES; i++) {
+			directionalLightUniforms.cascadeMatrices[i] = directionalLightShader.getUniform<glm::mat4>(
+					"cascadeMatrices[" + std::to_string(i) + "]"
+			);
+		}
 
 		// -------------------------------------------------------------------------------------------------------------
 
-//		pointLightShader.set("ViewProjection", VIEW_PROJECT_UNIFORM_BUFFER_INDEX, viewProjection);
-
-//		pointLightShader.activate();
-//		pointLightShader.set("gPosition", 0);
-//		pointLightShader.set("gNormal", 1);
-//		pointLightShader.set("gAlbedoSpec", 2);
-//		pointLightShader.set("shadowMap", 3);
+		clusteredLightShader.activate();
+		setGeometryBufferSamplers(clusteredLightShader, compactGeometryBuffer);
+		clusteredLightShader.set("lightData", 3);
+		clusteredLightShader.set("clusterData", 4);
+		clusteredLightShader.set("lightIndices", 5);
+
+		clusteredLightUniforms.clusterCount = clusteredLightShader.getUniform<glm::uvec3>("clusterCount");
+		clusteredLightUniforms.screenSize = clusteredLightShader.getUniform<glm::vec2>("screenSize");
+		clusteredLightUniforms.zNear = clusteredLightShader.getUniform<float>("zNear");
+		clusteredLightUniforms.zFar = clusteredLightShader.getUniform<float>("zFar");
+		clusteredLightUniforms.view = clusteredLightShader.getUniform<glm::mat4>("view");
+		clusteredLightUniforms.cameraPosition = clusteredLightShader.getUniform<glm::vec3>("camera.position");
+		clusteredLightUniforms.inverseViewProjection =
+				clusteredLightShader.getUniform<glm::mat4>("inverseViewProjection");
 
 		// -------------------------------------------------------------------------------------------------------------
 
 //		spotLightShader.set("ViewProjection", VIEW_PROJECT_UNIFORM_BUFFER_INDEX, viewProjection);
 
 		spotLightShader.activate();
-		spotLightShader.set("gPosition", 0);
-		spotLightShader.set("gNormal", 1);
-		spotLightShader.set("gAlbedoSpec", 2);
+		setGeometryBufferSamplers(spotLightShader, compactGeometryBuffer);
 		spotLightShader.set("shadowMap", 3);
 
-		// -------------------------------------------------------------------------------------------------------------
+		spotLightUniforms.lightIndex = spotLightShader.getUniform<int>("lightIndex");
+		spotLightUniforms.cameraPosition = spotLightShader.getUniform<glm::vec3>("camera.position");
+		spotLightUniforms.inverseViewProjection = spotLightShader.getUniform<glm::mat4>("inverseViewProjection");
 
-		bloomHorizontalBlurFramebuffer.activate();
-		bloomHorizontalBlurTexture.setMagnificationMinificationFilter(Texture::TextureMagnification::LINEAR,
-																	  Texture::TextureMinification::LINEAR);
-		bloomHorizontalBlurTexture.setWrapMode(Texture::TextureWrap::CLAMP_TO_EDGE,
-											   Texture::TextureWrap::CLAMP_TO_EDGE);
-		glFramebufferTexture2D(
-				GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bloomHorizontalBlurTexture.textureID, 0
-		);
+		spotLightShader.set("SpotLights", SPOT_LIGHTS_UNIFORM_BUFFER_INDEX, spotLights);
+	}
 
-		// -------------------------------------------------------------------------------------------------------------
+	void OpenGLDeferredRendering::activateGeometryBuffer() {
+		if(compactGeometryBuffer) {
+			getRenderTarget(renderTargets.depth).activate(0);
+			getRenderTarget(renderTargets.shininess).activate(6);
+		} else {
+			getRenderTarget(renderTargets.positionDepth).activate(0);
+		}
+		getRenderTarget(renderTargets.normalShininess).activate(1);
+		getRenderTarget(renderTargets.albedoSpecular).activate(2);
+	}
 
-		bloomVerticalBlurFramebuffer.activate();
-		bloomVerticalBlurTexture.setMagnificationMinificationFilter(Texture::TextureMagnification::LINEAR,
-																	Texture::TextureMinification::LINEAR);
-		bloomVerticalBlurTexture.setWrapMode(Texture::TextureWrap::CLAMP_TO_EDGE,
-											 Texture::TextureWrap::CLAMP_TO_EDGE);
-		glFramebufferTexture2D(
-				GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bloomVerticalBlurTexture.textureID, 0
-		);
+	// -----------------------------------------------------------------------------------------------------------------
 
-		// -------------------------------------------------------------------------------------------------------------
+	static std::unique_ptr<OpenGLTexture> createRenderTargetTexture(const RenderTargetDescription& description,
+																	unsigned int width, unsigned int height) {
+		std::unique_ptr<OpenGLTexture> texture;
+		switch(description.format) {
+			case RenderTargetFormat::RGBA8:
+				texture = std::make_unique<OpenGLTexture>(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+				break;
+
+			case RenderTargetFormat::RGBA16F:
+				texture = std::make_unique<OpenGLTexture>(width, height, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+				break;
+
+			case RenderTargetFormat::R8:
+				texture = std::make_unique<OpenGLTexture>(width, height, GL_R8, GL_RED, GL_UNSIGNED_BYTE);
+				break;
+
+			case RenderTargetFormat::RG16:
+				texture = std::make_unique<OpenGLTexture>(width, height, GL_RG16, GL_RG, GL_UNSIGNED_SHORT);
+				break;
+
+			case RenderTargetFormat::DEPTH24:
+				texture = std::make_unique<OpenGLTexture>(width, height, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT,
+														  GL_FLOAT);
+				break;
+		}
 
-		hdrShaderProgram.activate();
-		hdrShaderProgram.set("scene", 0);
-		hdrShaderProgram.set("bloom", 1);
+		// a physical target is shared by targets that are sampled differently. The
+		// fullscreen passes sample at texel centers, where linear filtering returns
+		// the same values as nearest filtering, so linear suits all of them.
+		if(description.format != RenderTargetFormat::DEPTH24) {
+			texture->setMagnificationMinificationFilter(Texture::TextureMagnification::LINEAR,
+														Texture::TextureMinification::LINEAR);
+		}
+		texture->setWrapMode(Texture::TextureWrap::CLAMP_TO_EDGE, Texture::TextureWrap::CLAMP_TO_EDGE);
+		return texture;
 	}
 
-	OpenGLDeferredRendering::OpenGLDeferredRendering(OpenGLDeferredRendering&& other) = default;
+	void OpenGLDeferredRendering::buildRenderGraph() {
+		renderGraph.clear();
 
-	OpenGLDeferredRendering::~OpenGLDeferredRendering() = default;
+		const RenderTargetDescription color{RenderTargetFormat::RGBA16F};
+		if(compactGeometryBuffer) {
+			// the position is reconstructed from the depth target by the lighting pass
+			renderTargets.positionDepth = RenderGraph::INVALID;
+			renderTargets.normalShininess = renderGraph.createTarget(
+					"normal", RenderTargetDescription{RenderTargetFormat::RG16}
+			);
+			renderTargets.albedoSpecular = renderGraph.createTarget(
+					"albedoSpecular", RenderTargetDescription{RenderTargetFormat::RGBA8}
+			);
+			renderTargets.shininess = renderGraph.createTarget(
+					"shininess", RenderTargetDescription{RenderTargetFormat::R8}
+			);
+		} else {
+			renderTargets.positionDepth = renderGraph.createTarget("positionDepth", color);
+			renderTargets.normalShininess = renderGraph.createTarget("normalShininess", color);
+			renderTargets.albedoSpecular = renderGraph.createTarget("albedoSpecular", color);
+			renderTargets.shininess = RenderGraph::INVALID;
+		}
+		renderTargets.depth = renderGraph.createTarget("depth", RenderTargetDescription{RenderTargetFormat::DEPTH24});
+		renderTargets.lighting = renderGraph.createTarget("lighting", color);
+		renderTargets.bloomHorizontalBlur = renderGraph.createTarget("bloomHorizontalBlur", color);
+		renderTargets.bloomVerticalBlur = renderGraph.createTarget("bloomVerticalBlur", color);
+		renderTargets.screen = renderGraph.importTarget("screen");
+
+		// without lighting the albedo is composed directly, which culls the lighting pass
+		renderTargets.scene = lighting ? renderTargets.lighting : renderTargets.albedoSpecular;
+
+		auto geometryPass = renderGraph.addPass("geometry", [this]() { renderGeometryBufferPass(*currentScene); });
+		auto lightingPass = renderGraph.addPass("lighting", [this]() { renderLightingPass(*currentScene); });
+		if(compactGeometryBuffer) {
+			geometryPass
+					.write(renderTargets.normalShininess)
+					.write(renderTargets.albedoSpecular)
+					.write(renderTargets.shininess)
+					.write(renderTargets.depth);
+			lightingPass
+					.read(renderTargets.depth)
+					.read(renderTargets.normalShininess)
+					.read(renderTargets.albedoSpecular)
+					.read(renderTargets.shininess);
+		} else {
+			geometryPass
+					.write(renderTargets.positionDepth)
+					.write(renderTargets.normalShininess)
+					.write(renderTargets.albedoSpecular)
+					.write(renderTargets.depth);
+			lightingPass
+					.read(renderTargets.positionDepth)
+					.read(renderTargets.normalShininess)
+					.read(renderTargets.albedoSpecular);
+		}
+		lightingPass.write(renderTargets.lighting);
 
-	// -----------------------------------------------------------------------------------------------------------------
+		renderGraph.addPass("bloom", [this]() { renderBloomPass(); })
+				.read(renderTargets.scene)
+				.write(renderTargets.bloomHorizontalBlur)
+				.write(renderTargets.bloomVerticalBlur);
 
-	void OpenGLDeferredRendering::render(Scene::Scene& scene) {
-		// Render the geometry pass
-		renderGeometryBufferPass(scene);
-		renderLightingPass(scene);
-		renderBloomPass();
-		renderHDRPass();
-	}
+		auto hdrPass = renderGraph.addPass("hdr", [this]() { renderHDRPass(); });
+		hdrPass.read(renderTargets.scene).write(renderTargets.screen);
+		if(bloom) {
+			hdrPass.read(renderTargets.bloomVerticalBlur);
+		}
 
-	void OpenGLDeferredRendering::resize(unsigned int width, unsigned height) {
-		geometryBuffer.resize(width, height);
-		renderer.getDefaultFramebuffer().resize(width, height);
+		renderGraph.compile();
 
-		lightingFramebuffer.resize(width, height);
-		lightingTexture.resize(width, height);
+		// the framebuffers must be released before the textures attached to them
+		geometryFramebuffer = nullptr;
+		lightingFramebuffer = nullptr;
+		bloomHorizontalBlurFramebuffer = nullptr;
+		bloomVerticalBlurFramebuffer = nullptr;
+
+		renderTargetTextures.clear();
+		for(std::uint32_t i = 0; i < renderGraph.getPhysicalTargetCount(); i++) {
+			const auto& description = renderGraph.getPhysicalTargetDescription(i);
+			renderTargetTextures.push_back(createRenderTargetTexture(
+					description, renderGraph.getTargetWidth(description), renderGraph.getTargetHeight(description)
+			));
+		}
 
-		bloomHorizontalBlurFramebuffer.resize(width, height);
-		bloomHorizontalBlurTexture.resize(width, height);
+		if(compactGeometryBuffer) {
+			geometryFramebuffer = createFramebuffer({
+					renderTargets.normalShininess, renderTargets.albedoSpecular, renderTargets.shininess
+			}, renderTargets.depth);
+		} else {
+			geometryFramebuffer = createFramebuffer({
+					renderTargets.positionDepth, renderTargets.normalShininess, renderTargets.albedoSpecular
+			}, renderTargets.depth);
+		}
+		lightingFramebuffer = createFramebuffer({renderTargets.lighting});
+		bloomHorizontalBlurFramebuffer = createFramebuffer({renderTargets.bloomHorizontalBlur});
+		bloomVerticalBlurFramebuffer = createFramebuffer({renderTargets.bloomVerticalBlur});
 
-		bloomVerticalBlurFramebuffer.resize(width, height);
-		bloomVerticalBlurTexture.resize(width, height);
+		renderGraphDirty = false;
 	}
 
-	// -----------------------------------------------------------------------------------------------------------------
+	std::unique_ptr<OpenGLFramebuffer> OpenGLDeferredRendering::createFramebuffer(
+			std::initializer_list<RenderGraph::ResourceID> colors, RenderGraph::ResourceID depth) {
+		for(auto resource : colors) {
+			if(renderGraph.getPhysicalTarget(resource) == RenderGraph::INVALID) {
+				return nullptr;
+			}
+		}
 
-	void OpenGLDeferredRendering::renderGeometryBufferPass(Scene::Scene& scene) {
-		geometryBuffer.activate();
-		geometryBuffer.framebuffer.faceCulling(false);
+		const auto& description = renderGraph.getPhysicalTargetDescription(
+				renderGraph.getPhysicalTarget(*colors.begin())
+		);
+		auto framebuffer = std::make_unique<OpenGLFramebuffer>(
+				renderGraph.getTargetWidth(description), renderGraph.getTargetHeight(description)
+		);
 
-		geometryBuffer.framebuffer.clear();
-//		glClear(GL_DEPTH_BUFFER_BIT);
+		framebuffer->activate();
 
-		geometryBufferShader.activate();
+		std::vector<GLenum> attachments;
+		for(auto resource : colors) {
+			auto attachment = GLenum(GL_COLOR_ATTACHMENT0 + attachments.size());
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, getRenderTarget(resource).textureID, 0);
+			attachments.push_back(attachment);
+		}
+		glDrawBuffers(GLsizei(attachments.size()), attachments.data());
 
+		if(depth != RenderGraph::INVALID) {
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
+								   getRenderTarget(depth).textureID, 0);
+		}
+
+		framebuffer->deactivate();
+		return framebuffer;
+	}
+
+	OpenGLTexture& OpenGLDeferredRendering::getRenderTarget(RenderGraph::ResourceID resource) {
+		return *renderTargetTextures[renderGraph.getPhysicalTarget(resource)];
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLDeferredRendering::buildRenderQueues(Scene::Scene& scene) {
 		// Update the camera, view and projection uniform buffer
 		const auto& camera = scene.getCamera();
 		auto positionWithZoom = camera->getPosition() - camera->Front * camera->Zoom;
 
 		viewProjection->camera.position = positionWithZoom;
 		viewProjection->projection = glm::perspective(
-				camera->getFieldOfView(), float(geometryBuffer.width) / float(geometryBuffer.height),
+				camera->getFieldOfView(), float(renderGraph.getWidth()) / float(renderGraph.getHeight()),
 				camera->getZNear(), camera->getZFar());
 //		float near_plane = 0.0f, far_plane = 1000.0f;
 //		viewProjection->projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, near_plane, far_plane);
@@ -231,37 +569,243 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		viewProjection->view = glm::lookAt(positionWithZoom, positionWithZoom + camera->getFront(), camera->getUp());
 //		viewProjection.update();
 
-		geometryBufferShader.set("projection", viewProjection->projection);
-		geometryBufferShader.set("view", viewProjection->view);
-		geometryBufferShader.set("camera.position", viewProjection->camera.position);
+		proxyViewPosition = positionWithZoom;
+		cameraFieldOfView = camera->getFieldOfView();
 
 		auto VP = viewProjection->projection * viewProjection->view;
 
-		// render the root object
-		renderGeometryBufferObject(*scene.getRootObject(), glm::mat4(1.0), VP);
+		// Skip the parts of the scene the scene manager knows cannot be seen
+		sceneManager = scene.getSceneManager().get();
+		if(const auto& manager = scene.getSceneManager()) {
+			manager->update(VP, positionWithZoom);
+		}
+
+		visibleLights.clear();
+		for(const auto& light : scene.getLights()) {
+			if(sceneManager == nullptr || sceneManager->isVisible(*light)) {
+				visibleLights.push_back(light);
+			}
+		}
+
+		// collect the geometry variants compiled since the last frame. Variants
+		// requested by this frame are only used once they are ready.
+		geometryBufferShaders->update();
+		geometryBufferInstancedShaders->update();
+
+		const auto& rootObject = *scene.getRootObject();
+		std::vector<std::future<void>> jobs;
+
+		jobs.push_back(jobSystem->schedule([this, &rootObject, VP]() {
+			Math::Frustum frustum(VP);
+
+			geometryOcclusionBuffer.clear(VP);
+			rasterizeOccluders(rootObject, glm::mat4(1.0), frustum, geometryOcclusionBuffer);
+
+			geometryRenderQueue.clear();
+			cullObject(rootObject, glm::mat4(1.0), CullingView{VP, frustum, geometryOcclusionBuffer},
+					   RenderPass::GEOMETRY, geometryBufferShaders->getGeneric(),
+					   geometryBufferInstancedShaders->getGeneric(), geometryRenderQueue);
+			geometryRenderQueue.sort();
+
+			// the per-frame uniforms are shared by every program of both families
+			geometryCommands.clear();
+			for(auto* variants : {geometryBufferShaders.get(), geometryBufferInstancedShaders.get()}) {
+				for(auto* shader : variants->getPrograms()) {
+					geometryCommands.bindProgram(*shader);
+					geometryCommands.setUniform("projection", viewProjection->projection);
+					geometryCommands.setUniform("view", viewProjection->view);
+					geometryCommands.setUniform("camera.position", viewProjection->camera.position);
+				}
+			}
+			geometryRenderQueue.record(geometryCommands);
+		}));
+
+		// Size the shadow map of every shadow casting spot light by how much of the
+		// screen it covers. Lights that do not fit in the spot light uniform buffer
+		// or in the shadow atlas are shaded without shadows.
+		std::vector<ShadowAtlas::Request> shadowRequests;
+		for(const auto& light : visibleLights) {
+			if(light->getLightType() != Scene::Light::LightType::SPOT || !light->hasShadows()) {
+				continue;
+			}
+			shadowRequests.push_back(ShadowAtlas::Request{light.get(), ShadowAtlas::computeImportance(
+					light->getPosition(), light->getInfluenceRadius(), positionWithZoom, camera->getFieldOfView()
+			)});
+		}
+
+		std::stable_sort(shadowRequests.begin(), shadowRequests.end(), [](const auto& a, const auto& b) {
+			return a.importance > b.importance;
+		});
+		if(shadowRequests.size() > OpenGLSpotLights::MAX_LIGHTS) {
+			shadowRequests.resize(OpenGLSpotLights::MAX_LIGHTS);
+		}
+		shadowAtlas.update(shadowRequests);
+
+		// Drop the views of lights that were removed from the scene or stopped
+		// casting shadows. The map must not be modified after the jobs are scheduled.
+		std::map<const Scene::Light::Light*, ShadowView> currentShadowViews;
+		for(const auto& request : shadowRequests) {
+			const auto* tile = shadowAtlas.getTile(request.key);
+			if(tile == nullptr) {
+				continue;
+			}
+
+			auto* light = static_cast<const Scene::Light::Light*>(request.key);
+			auto found = shadowViews.find(light);
+			if(found != shadowViews.end()) {
+				currentShadowViews.insert(std::move(*found));
+			}
+			currentShadowViews[light].tile = *tile;
+		}
+		shadowViews = std::move(currentShadowViews);
+
+		for(auto& entry : shadowViews) {
+			auto& light = static_cast<const Scene::Light::SpotLight&>(*entry.first);
+			auto& view = entry.second;
+
+			view.lightSpaceMatrix = computeLightSpaceMatrix(light);
+			auto lightPosition = light.getPosition();
+			auto lightRadius = light.getInfluenceRadius();
+			jobs.push_back(jobSystem->schedule([this, &rootObject, &view, lightPosition, lightRadius]() {
+				Math::Frustum frustum(view.lightSpaceMatrix);
+
+				view.occlusionBuffer.clear(view.lightSpaceMatrix);
+				rasterizeOccluders(rootObject, glm::mat4(1.0), frustum, view.occlusionBuffer);
+
+				// only the casters inside both the light frustum and its influence can
+				// shadow a lit surface
+				view.renderQueue.clear();
+				view.staticRenderQueue.clear();
+				cullObject(rootObject, glm::mat4(1.0),
+						   CullingView{view.lightSpaceMatrix, frustum, view.occlusionBuffer, lightPosition, lightRadius},
+						   RenderPass::SHADOW, shadowMapShader, shadowMapInstancedShader, view.renderQueue,
+						   &view.staticRenderQueue);
+
+				// the static casters are recorded as well, even though they are only
+				// replayed when the cached static shadow map is rendered again
+				view.staticCasters = view.staticRenderQueue.computeHash();
+				for(auto queue : {std::make_pair(&view.renderQueue, &view.commands),
+								  std::make_pair(&view.staticRenderQueue, &view.staticCommands)}) {
+					queue.first->sort();
+
+					auto& commands = *queue.second;
+					commands.clear();
+					commands.bindProgram(shadowMapInstancedShader);
+					commands.setUniform("lightSpaceMatrix", view.lightSpaceMatrix);
+					commands.bindProgram(shadowMapShader);
+					commands.setUniform("lightSpaceMatrix", view.lightSpaceMatrix);
+					queue.first->record(commands);
+				}
+			}));
+		}
+
+		// Split the camera frustum between the cascades of the first shadow casting
+		// directional light. Every cascade is culled by its own job against its own
+		// light frustum, so each one only pays for the casters it covers.
+		shadowedDirectionalLight = nullptr;
+		for(const auto& light : visibleLights) {
+			if(light->getLightType() == Scene::Light::LightType::DIRECTIONAL && light->hasShadows()) {
+				shadowedDirectionalLight = static_cast<Scene::Light::DirectionalLight*>(light.get());
+				break;
+			}
+		}
 
-		geometryBufferShader.deactivate();
-		geometryBuffer.deactivate();
+		if(shadowedDirectionalLight != nullptr) {
+			shadowCascades.update(viewProjection->view, camera->getFieldOfView(),
+								  float(renderGraph.getWidth()) / float(renderGraph.getHeight()),
+								  camera->getZNear(), camera->getZFar(), shadowedDirectionalLight->getDirection());
+
+			for(unsigned int i = 0; i < shadowCascades.getCascadeCount(); i++) {
+				const auto& cascade = shadowCascades.getCascade(i);
+				auto& view = cascadeViews[i];
+				jobs.push_back(jobSystem->schedule([this, &rootObject, &cascade, &view]() {
+					Math::Frustum frustum(cascade.lightSpaceMatrix);
+
+					view.occlusionBuffer.clear(cascade.lightSpaceMatrix);
+					rasterizeOccluders(rootObject, glm::mat4(1.0), frustum, view.occlusionBuffer);
+
+					// casters smaller than a couple of texels would not show up on the cascade
+					CullingView cullingView{cascade.lightSpaceMatrix, frustum, view.occlusionBuffer};
+					cullingView.minimumSize = 2.0f * cascade.texelSize;
+
+					view.renderQueue.clear();
+					cullObject(rootObject, glm::mat4(1.0), cullingView, RenderPass::SHADOW, shadowMapShader,
+							   shadowMapInstancedShader, view.renderQueue);
+					view.renderQueue.sort();
+
+					view.commands.clear();
+					view.commands.bindProgram(shadowMapInstancedShader);
+					view.commands.setUniform("lightSpaceMatrix", cascade.lightSpaceMatrix);
+					view.commands.bindProgram(shadowMapShader);
+					view.commands.setUniform("lightSpaceMatrix", cascade.lightSpaceMatrix);
+					view.renderQueue.record(view.commands);
+				}));
+			}
+		}
+
+		// Assign the point lights and the spot lights without shadows to the view clusters
+		std::vector<std::shared_ptr<Scene::Light::Light>> clusteredLights;
+		for(const auto& light : visibleLights) {
+			if(light->getLightType() == Scene::Light::LightType::POINT ||
+			   (light->getLightType() == Scene::Light::LightType::SPOT && shadowViews.count(light.get()) == 0)) {
+				clusteredLights.push_back(light);
+			}
+		}
+
+		lightClusters.setProjection(viewProjection->projection, camera->getZNear(), camera->getZFar());
+		auto view = viewProjection->view;
+		jobs.push_back(jobSystem->schedule([this, &clusteredLights, view]() {
+			lightClusters.assign(view, clusteredLights);
+		}));
+
+		Utility::JobSystem::wait(jobs);
 	}
 
-	void OpenGLDeferredRendering::renderLightingPass(Scene::Scene& scene) {
-		auto& framebuffer = lightingFramebuffer;
+	void OpenGLDeferredRendering::renderGeometryBufferPass(Scene::Scene& scene) {
+		FrameProfiler::Scope scope(profiler, "geometry");
+
+		auto& framebuffer = *geometryFramebuffer;
 
 		framebuffer.activate();
+		framebuffer.faceCulling(false);
+
 		framebuffer.clear();
+//		glClear(GL_DEPTH_BUFFER_BIT);
 
-		if(!lighting) {
-			geometryBuffer.framebuffer.activate();
-			glReadBuffer(GL_COLOR_ATTACHMENT2);
-			geometryBuffer.framebuffer.copy(framebuffer);
-			return;
+		// the commands were recorded by buildRenderQueues
+		geometryCommands.execute(commandExecutor);
+
+		stateCache.useProgram(0);
+		framebuffer.deactivate();
+	}
+
+	void OpenGLDeferredRendering::renderLightingPass(Scene::Scene& scene) {
+		FrameProfiler::Scope scope(profiler, "lighting");
+
+		// Render the shadow maps first, they all live in the shadow atlas or in the cascades
+		if(shadowedDirectionalLight != nullptr) {
+			renderShadowMap(scene, *shadowedDirectionalLight);
 		}
 
+		for(const auto& light : visibleLights) {
+			if(shadowViews.count(light.get()) != 0) {
+				renderShadowMap(scene, static_cast<Scene::Light::SpotLight&>(*light));
+			}
+		}
+
+		// the compact geometry buffer layout reconstructs the fragment position from depth
+		auto inverseViewProjection = glm::inverse(viewProjection->projection * viewProjection->view);
+
+		auto& framebuffer = *lightingFramebuffer;
+
+		framebuffer.activate();
+		framebuffer.clear();
+
 		framebuffer
 				.blending(true)
 				.depthTest(false)
 				.faceCulling(false);
-		glBlendFunc(GL_ONE, GL_ONE); // TODO expose this generically
+		stateCache.setBlendFunction(GL_ONE, GL_ONE); // TODO expose this generically
 
 		static unsigned int quadVAO = 0;
 		static unsigned int quadVBO;
@@ -278,7 +822,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			// setup plane VAO
 			glGenVertexArrays(1, &quadVAO);
 			glGenBuffers(1, &quadVBO);
-			glBindVertexArray(quadVAO);
+			stateCache.bindVertexArray(quadVAO);
 			glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
 			glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
 			glEnableVertexAttribArray(0);
@@ -286,33 +830,49 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			glEnableVertexAttribArray(1);
 			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
 		}
-		glBindVertexArray(quadVAO);
+		stateCache.bindVertexArray(quadVAO);
 
-		unsigned int pointLightsCount = 0;
-
-		std::vector<std::shared_ptr<Scene::Light::Light>> sortedLights = scene.getLights();
-		for(std::shared_ptr<Scene::Light::Light> genericLight : sortedLights) {
+		for(std::shared_ptr<Scene::Light::Light> genericLight : visibleLights) {
 			switch(genericLight->getLightType()) {
 				case Scene::Light::LightType::DIRECTIONAL: {
 					auto light = std::static_pointer_cast<Scene::Light::DirectionalLight>(genericLight);
 
 					directionalLightShader.activate();
 
-					directionalLightShader.set("light.direction", light->getDirection());
-					directionalLightShader.set("light.ambient", light->getAmbient());
-					directionalLightShader.set("light.diffuse", light->getDiffuse());
-					directionalLightShader.set("light.specular", light->getSpecular());
-					directionalLightShader.set("light.shadowOcclusionStrength", light->getShadowOcclusionStrength());
+					directionalLightShader.set(directionalLightUniforms.direction, light->getDirection());
+					directionalLightShader.set(directionalLightUniforms.ambient, light->getAmbient());
+					directionalLightShader.set(directionalLightUniforms.diffuse, light->getDiffuse());
+					directionalLightShader.set(directionalLightUniforms.specular, light->getSpecular());
+					directionalLightShader.set(directionalLightUniforms.shadowOcclusionStrength,
+											   light->getShadowOcclusionStrength());
+					directionalLightShader.set(directionalLightUniforms.cameraPosition,
+											   viewProjection->camera.position);
+					directionalLightShader.set(directionalLightUniforms.view, viewProjection->view);
+					directionalLightShader.set(directionalLightUniforms.inverseViewProjection, inverseViewProjection);
+
+					// only the light the cascades were rendered for is shadowed
+					auto cascadeCount = light.get() == shadowedDirectionalLight ? shadowCascades.getCascadeCount() : 0;
+					glm::vec4 cascadeSplits(0.0f);
+					glm::vec4 cascadeTexelSizes(0.0f);
+					for(unsigned int i = 0; i < cascadeCount; i++) {
+						const auto& cascade = shadowCascades.getCascade(i);
+						cascadeSplits[i] = cascade.farDistance;
+						cascadeTexelSizes[i] = cascade.texelSize;
+						directionalLightShader.set(directionalLightUniforms.cascadeMatrices[i], cascade.lightSpaceMatrix);
+					}
+					directionalLightShader.set(directionalLightUniforms.cascadeCount, int(cascadeCount));
+					directionalLightShader.set(directionalLightUniforms.cascadeSplits, cascadeSplits);
+					directionalLightShader.set(directionalLightUniforms.cascadeTexelSizes, cascadeTexelSizes);
 
-					directionalLightShader.set("projection", viewProjection->projection);
-					directionalLightShader.set("view", viewProjection->view);
-					directionalLightShader.set("camera.position", viewProjection->camera.position);
+					activateGeometryBuffer();
+					shadowCascadeTexture.activate(3);
 
+					glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 					break;
 				}
 
 				case Scene::Light::LightType::POINT: {
-					pointLightsCount++;
+					// shaded by the clustered lighting pass
 					break;
 				}
 //					auto light = std::static_pointer_cast<Scene::Light::PointLight>(genericLight);
@@ -354,209 +914,281 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 //				}
 
 				case Scene::Light::LightType::SPOT: {
-					auto light = std::static_pointer_cast<Scene::Light::SpotLight>(genericLight);
-
-					// render shadow map
-					glm::mat4 lightSpaceMatrix;
-					bool hasShadowMap = true;
+					// shadow casting spot lights are shaded below, all other spot lights
+					// are shaded by the clustered lighting pass
+					break;
+				}
+			}
+		}
 
-					if(light->hasShadows()) {
-						lightSpaceMatrix = renderShadowMap(scene, *light);
-						hasShadowMap = true;
-					}
+		// Pack the parameters of every shadow casting spot light into a single upload
+		shadowedSpotLights.clear();
+		for(const auto& light : visibleLights) {
+			auto found = shadowViews.find(light.get());
+			if(found == shadowViews.end()) {
+				continue;
+			}
 
-					spotLightShader.activate();
+			auto& spotLight = static_cast<Scene::Light::SpotLight&>(*light);
+			auto& data = spotLights->lights[shadowedSpotLights.size()];
 
-					spotLightShader.set("light.position", light->getPosition());
-					spotLightShader.set("light.direction", light->getDirection());
-					spotLightShader.set("light.cutOff", glm::cos(glm::radians(light->getCutOff())));
-					spotLightShader.set("light.outerCutOff", glm::cos(glm::radians(light->getOuterCutOff())));
+			data.position = spotLight.getPosition();
+			data.direction = spotLight.getDirection();
+			data.cutOff = glm::cos(glm::radians(spotLight.getCutOff()));
+			data.outerCutOff = glm::cos(glm::radians(spotLight.getOuterCutOff()));
 
-					spotLightShader.set("light.ambient", light->getAmbient());
-					spotLightShader.set("light.diffuse", light->getDiffuse());
-					spotLightShader.set("light.specular", light->getSpecular());
+			data.ambient = spotLight.getAmbient();
+			data.diffuse = spotLight.getDiffuse();
+			data.specular = spotLight.getSpecular();
 
-					spotLightShader.set("light.constant", light->getConstant());
-					spotLightShader.set("light.linear", light->getLinear());
-					spotLightShader.set("light.quadratic", light->getQuadratic());
+			data.constant = spotLight.getConstant();
+			data.linear = spotLight.getLinear();
+			data.quadratic = spotLight.getQuadratic();
 
-					spotLightShader.set("light.shadowOcclusionStrength", light->getShadowOcclusionStrength());
-					spotLightShader.set("lightSpaceMatrix", lightSpaceMatrix);
-					spotLightShader.set("hasShadowMap", hasShadowMap);
+			data.lightSpaceMatrix = found->second.lightSpaceMatrix;
+			data.shadowOcclusionStrength = spotLight.getShadowOcclusionStrength();
 
-					spotLightShader.set("projection", viewProjection->projection);
-					spotLightShader.set("view", viewProjection->view);
-					spotLightShader.set("camera.position", viewProjection->camera.position);
+			const auto& tile = found->second.tile;
+			data.shadowMapTile = glm::vec4(tile.x, tile.y, tile.size, tile.size) / float(shadowAtlas.getSize());
 
-					shadowMap.activate(3);
+			shadowedSpotLights.push_back(&spotLight);
+		}
 
-					framebuffer.activate();
-					throwOpenGLException();
+		if(!shadowedSpotLights.empty()) {
+			spotLights.update(0, shadowedSpotLights.size() * sizeof(OpenGLSpotLight));
 
-					framebuffer.blending(true)
-							.depthTest(false)
-							.faceCulling(false);
-					glBlendFunc(GL_ONE, GL_ONE);
+			spotLightShader.activate();
+			spotLightShader.set(spotLightUniforms.cameraPosition, viewProjection->camera.position);
+			spotLightShader.set(spotLightUniforms.inverseViewProjection, inverseViewProjection);
 
-					geometryBuffer.positionDepth.activate(0);
-					geometryBuffer.normalShininess.activate(1);
-					geometryBuffer.albedoSpecular.activate(2);
+			activateGeometryBuffer();
+			shadowAtlasTexture.activate(3);
+			throwOpenGLException();
+		}
 
-					glBindVertexArray(quadVAO);
-					glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		for(std::size_t i = 0; i < shadowedSpotLights.size(); i++) {
+			spotLightShader.set(spotLightUniforms.lightIndex, int(i));
 
-					break;
-				}
-			}
+			stateCache.bindVertexArray(quadVAO);
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 		}
 		framebuffer.deactivate();
 
-		if(pointLightsCount == 0) {
+		if(lightClusters.getLightCount() == 0) {
 			return;
 		}
 
-		auto found = pointLightShaders.find(pointLightsCount);
-		if(found == pointLightShaders.end()) {
-			auto originalSource = PointLightFragmentShaderSource.getSource();
-			auto version = originalSource.substr(0, originalSource.find("\n", originalSource.find("#version")));
-			auto cutSource = originalSource.substr(originalSource.find("\n", originalSource.find("#version")));
+		// upload the light assignment computed by buildRenderQueues
+		const auto& lightData = lightClusters.getLightData();
+		const auto& clusterData = lightClusters.getClusterData();
+		const auto& lightIndices = lightClusters.getLightIndices();
 
-			auto source = Shader::ShaderSource(version +
-											   "#define LIGHT_COUNT " + std::to_string(pointLightsCount) + "\n" +
-											   cutSource);
+		clusterLightBuffer.update(lightData.data(), lightData.size() * sizeof(glm::vec4));
+		clusterGridBuffer.update(clusterData.data(), clusterData.size() * sizeof(glm::uvec2));
+		clusterIndexBuffer.update(lightIndices.data(), lightIndices.size() * sizeof(std::uint32_t));
 
-			pointLightShaders[pointLightsCount] = OpenGLShaderProgram(
-					OpenGLVertexShader(LightingVertexShaderSource),
-					OpenGLFragmentShader(source)
-			);
-		}
+		clusteredLightShader.activate();
 
-		auto& pointLightShader = pointLightShaders[pointLightsCount];
+		clusteredLightShader.set(clusteredLightUniforms.view, viewProjection->view);
+		clusteredLightShader.set(clusteredLightUniforms.cameraPosition, viewProjection->camera.position);
+		clusteredLightShader.set(clusteredLightUniforms.inverseViewProjection, inverseViewProjection);
 
-		pointLightShader.activate();
+		clusteredLightShader.set(clusteredLightUniforms.clusterCount, glm::uvec3(
+				lightClusters.getTilesX(), lightClusters.getTilesY(), lightClusters.getSlices()
+		));
+		clusteredLightShader.set(clusteredLightUniforms.screenSize,
+								 glm::vec2(float(renderGraph.getWidth()), float(renderGraph.getHeight())));
+		clusteredLightShader.set(clusteredLightUniforms.zNear, lightClusters.getZNear());
+		clusteredLightShader.set(clusteredLightUniforms.zFar, lightClusters.getZFar());
 
-		pointLightShader.set("gPosition", 0);
-		pointLightShader.set("gNormal", 1);
-		pointLightShader.set("gAlbedoSpec", 2);
-		pointLightShader.set("shadowMap", 3);
+		framebuffer.activate();
 
-		pointLightShader.set("projection", viewProjection->projection);
-		pointLightShader.set("view", viewProjection->view);
-		pointLightShader.set("camera.position", viewProjection->camera.position);
+		framebuffer.blending(true)
+				.depthTest(false)
+				.faceCulling(false);
+		stateCache.setBlendFunction(GL_ONE, GL_ONE);
 
-		pointLightShader.set("farPlane", 1000.0f);
-		pointLightShader.set("hasShadowMap", false);
+		activateGeometryBuffer();
 
-		int lightIndex = 0;
-		for(std::shared_ptr<Scene::Light::Light> genericLight : sortedLights) {
-			switch(genericLight->getLightType()) {
-				case Scene::Light::LightType::POINT: {
-					if(lightIndex == 20) {
-						continue;
-					}
+		clusterLightBuffer.activate(3);
+		clusterGridBuffer.activate(4);
+		clusterIndexBuffer.activate(5);
 
-					auto light = std::static_pointer_cast<Scene::Light::PointLight>(genericLight);
+		stateCache.bindVertexArray(quadVAO);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].position", light->getPosition());
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].ambient", light->getAmbient());
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].diffuse", light->getDiffuse());
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].specular", light->getSpecular());
+		stateCache.bindVertexArray(0);
+	}
 
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].constant", light->getConstant());
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].linear", light->getLinear());
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].quadratic", light->getQuadratic());
+	// -----------------------------------------------------------------------------------------------------------------
 
-					pointLightShader.set("light[" + std::to_string(lightIndex) + "].shadowOcclusionStrength",
-										 light->getShadowOcclusionStrength());
+	void OpenGLDeferredRendering::rasterizeOccluders(const Scene::Object& object, const glm::mat4& parentModelMatrix,
+													const Math::Frustum& frustum, OcclusionBuffer& occlusionBuffer) {
+		if(sceneManager != nullptr && !sceneManager->isVisible(object)) {
+			return;
+		}
 
-//					shadowCubeMap.activate(3);
+		glm::mat4 modelMatrix = computeModelMatrix(object, parentModelMatrix);
 
-					lightIndex++;
+		auto rasterizeModel = [&](const Model::Model::Ptr& model, const glm::mat4& modelMatrix) {
+			const auto* occluderMesh = model->getOccluderMesh();
+			if(occluderMesh != nullptr && frustum.intersects(model->getBoundingBox().transform(modelMatrix))) {
+				occlusionBuffer.rasterize(*occluderMesh, modelMatrix);
+			}
+		};
 
-					break;
-				}
+		if(const auto& model = object.getModel()) {
+			rasterizeModel(model, modelMatrix);
+		}
+
+		if(const auto* instance = dynamic_cast<const Scene::PrefabInstance*>(&object)) {
+			if(!instance->isExpanded() && frustum.intersects(instance->getBoundingBox().transform(modelMatrix))) {
+				instance->visit(modelMatrix, rasterizeModel);
 			}
 		}
 
-		framebuffer.activate();
-//			throwOpenGLException();
+		for(const auto& child : object.getChildren()) {
+			rasterizeOccluders(*child, modelMatrix, frustum, occlusionBuffer);
+		}
+	}
 
-		framebuffer.blending(true)
-				.depthTest(false)
-				.faceCulling(false);
-		glBlendFunc(GL_ONE, GL_ONE);
+	void OpenGLDeferredRendering::cullObject(const Scene::Object& object, const glm::mat4& parentModelMatrix,
+											const CullingView& cullingView, RenderPass pass,
+											OpenGLShaderProgram& shader, OpenGLShaderProgram& instancedShader,
+											RenderQueue& renderQueue, RenderQueue* staticRenderQueue) {
+		// the scene manager only knows what the camera can see. Shadow casters
+		// outside of it can still throw shadows into the visible cells.
+		if(pass == RenderPass::GEOMETRY && sceneManager != nullptr && !sceneManager->isVisible(object)) {
+			return;
+		}
 
-		geometryBuffer.positionDepth.activate(0);
-		geometryBuffer.normalShininess.activate(1);
-		geometryBuffer.albedoSpecular.activate(2);
+		glm::mat4 modelMatrix = computeModelMatrix(object, parentModelMatrix);
 
-		glBindVertexArray(quadVAO);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		// the models of static objects, including the nodes of static prefab instances
+		// and the proxies of static HLOD groups, can be queued separately
+		auto& queue = staticRenderQueue != nullptr && object.isStatic() ? *staticRenderQueue : renderQueue;
 
-		glBindVertexArray(0);
-	}
+		const auto& VP = cullingView.viewProjection;
+		auto isVisible = [&cullingView](const Math::BoundingBox& bounds) {
+			return 2.0f * glm::length(bounds.getHalfSize()) >= cullingView.minimumSize &&
+				   bounds.intersects(cullingView.sphereCenter, cullingView.sphereRadius) &&
+				   cullingView.frustum.intersects(bounds) && cullingView.occlusionBuffer.isVisible(bounds);
+		};
 
-	// -----------------------------------------------------------------------------------------------------------------
+		auto cullModel = [&](const Model::Model::Ptr& model, const glm::mat4& modelMatrix) {
+			if(pass == RenderPass::SHADOW && !model->shouldCastShadows()) {
+				return;
+			}
 
-	void OpenGLDeferredRendering::renderGeometryBufferObject(Scene::Object& object,
-															 const glm::mat4& parentModelMatrix,
-															 const glm::mat4& VP) {
-		auto translation = object.getPosition();
-		auto rotation = object.getRotation();
-		auto scale = object.getScale();
-
-		glm::mat4 modelMatrix = glm::scale(
-				glm::rotate(
-						glm::rotate(
-								glm::rotate(
-										glm::translate(
-												parentModelMatrix,
-												translation
-										),
-										rotation.z,
-										glm::vec3(0.0f, 0.0f, 1.0f)
-								),
-								rotation.y,
-								glm::vec3(0.0f, 1.0f, 0.0f)
-						),
-						rotation.x,
-						glm::vec3(1.0f, 0.0f, 0.0f)
-				),
-				scale
-		);
+			auto bounds = model->getBoundingBox().transform(modelMatrix);
+			if(!isVisible(bounds)) {
+				return;
+			}
 
-		geometryBufferShader.set("model", modelMatrix);
-		geometryBufferShader.set("inversedTransposedModel", glm::transpose(glm::inverse(modelMatrix)));
+			if(pass == RenderPass::GEOMETRY) {
+				requestTextures(*model, modelMatrix, bounds);
+			}
 
-		if(const auto& model = object.getModel()) {
 			Model::LevelOfDetail levelOfDetail{
-					glm::vec3(VP * glm::vec4(model->getSize(), 1.0))
+					glm::vec3(0.0)
 			};
+			if(pass == RenderPass::GEOMETRY) {
+				levelOfDetail = Model::LevelOfDetail{
+						glm::vec3(VP * glm::vec4(model->getSize(), 1.0))
+				};
+			}
 
-			model->setMaterialShaderUniforms(renderer, geometryBufferShader, levelOfDetail);
-			model->render(renderer, levelOfDetail);
+			// the NDC depth of the object origin is monotonic with the view distance and
+			// is good enough to sort objects front-to-back
+			auto clipPosition = VP * modelMatrix[3];
+			auto depth = clipPosition.w > 0.0f ? (clipPosition.z / clipPosition.w) * 0.5f + 0.5f : 0.0f;
+
+			// use the geometry variant specialized for the model features once it is compiled
+			auto features = model->getShaderFeatures();
+			if(pass == RenderPass::GEOMETRY && features != Model::Model::GENERIC_SHADER_FEATURES) {
+				queue.push(pass, geometryBufferShaders->find(features), *model, modelMatrix, depth,
+						   levelOfDetail, &geometryBufferInstancedShaders->find(features));
+				return;
+			}
+
+			queue.push(pass, shader, *model, modelMatrix, depth, levelOfDetail, &instancedShader);
+		};
+
+		// distant HLOD groups are replaced by their proxy
+		if(const auto* group = dynamic_cast<const Scene::HLODGroup*>(&object)) {
+			if(group->shouldUseProxy(modelMatrix, proxyViewPosition)) {
+				cullModel(group->getProxy(), modelMatrix);
+				return;
+			}
 		}
-//
-//		if(const auto& mesh = object.getMesh()) {
-//			auto compiledMesh = std::static_pointer_cast<OpenGLVertexBuffer>(object.getMesh()->getCompiledMesh());
-//			if(compiledMesh == nullptr) {
-//				// compile the mesh
-//				compiledMesh = std::static_pointer_cast<OpenGLVertexBuffer>(renderer.getMeshCompiler().compileMesh(
-//						*object.getMesh()
-//				));
-//				object.getMesh()->setCompiledMesh(compiledMesh);
-//			}
-//
-//			// Draw the triangles
-//			compiledMesh->draw();
-//		}
 
-		// render all children
+		if(const auto& model = object.getModel()) {
+			cullModel(model, modelMatrix);
+		}
+
+		// prefab instances are culled as a whole before their nodes are
+		if(const auto* instance = dynamic_cast<const Scene::PrefabInstance*>(&object)) {
+			auto bounds = instance->getBoundingBox().transform(modelMatrix);
+			if(!instance->isExpanded() && isVisible(bounds)) {
+				instance->visit(modelMatrix, cullModel);
+			}
+		}
+
+		// cull all children
 		for(const auto& child : object.getChildren()) {
-			renderGeometryBufferObject(*child, modelMatrix, VP);
+			cullObject(*child, modelMatrix, cullingView, pass, shader, instancedShader, renderQueue, staticRenderQueue);
+		}
+	}
+
+	void OpenGLDeferredRendering::requestTextures(const Model::Model& model, const glm::mat4& modelMatrix,
+												  const Math::BoundingBox& bounds) {
+		auto radius = glm::length(bounds.getHalfSize());
+
+		// textures whose density is unknown are assumed to cover the model once
+		auto scale = std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+							   glm::length(glm::vec3(modelMatrix[2]))});
+		auto texCoordDensity = model.getTexCoordDensity() / scale;
+		if(!(texCoordDensity > 0.0f)) {
+			texCoordDensity = 1.0f / std::max(2.0f * radius, 1e-4f);
+		}
+
+		// the closest point of the bounds needs the finest level
+		auto distance = std::max(0.0f, glm::distance(bounds.getCenter(), proxyViewPosition) - radius);
+		auto footprint = TextureStreamer::computeFootprint(texCoordDensity, distance, cameraFieldOfView,
+														   float(renderGraph.getHeight()));
+		if(!std::isfinite(footprint)) {
+			footprint = 0.0f;
+		}
+
+		auto& textureStreamer = renderer.getTextureStreamer();
+		model.visitTextures([&textureStreamer, footprint](const Texture::Texture& texture) {
+			textureStreamer.request(texture, footprint);
+		});
+	}
+
+	glm::mat4 OpenGLDeferredRendering::computeModelMatrix(const Scene::Object& object,
+														  const glm::mat4& parentModelMatrix) {
+		return Math::composeTransform(parentModelMatrix, object.getPosition(), object.getRotation(), object.getScale());
+	}
+
+	glm::mat4 OpenGLDeferredRendering::computeLightSpaceMatrix(const Scene::Light::SpotLight& light) {
+		// the square frustum encloses the outer cone
+		auto fieldOfView = glm::clamp(2.0f * light.getOuterCutOff(), 1.0f, 170.0f);
+		auto farPlane = glm::clamp(light.getInfluenceRadius(), 1.0f, 1000.0f);
+		if(!std::isfinite(farPlane)) {
+			farPlane = 1000.0f;
 		}
+
+		glm::mat4 lightProjection = glm::perspective<float>(glm::radians(fieldOfView), 1.0f, 0.1f, farPlane);
+		glm::mat4 lightView = glm::lookAt(
+				light.getPosition(),
+				light.getPosition() + light.getDirection(),
+				glm::vec3(0, 1, 0));
+		return lightProjection * lightView;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------------
+
 	float OpenGLDeferredRendering::renderShadowMap(Scene::Scene& scene, Scene::Light::PointLight& light) {
 		const float farPlane = 1000.0f;
 		glm::mat4 lightProjection = glm::perspective<float>(glm::radians(90.0f), 1.0f, 0.1f, farPlane);
@@ -609,69 +1241,118 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			glReadBuffer(GL_NONE);
 			glClear(GL_DEPTH_BUFFER_BIT);
 
-			renderShadowMapObject(*scene.getRootObject(), shadowCubeMapShader, glm::mat4(1.0));
+			renderShadowMapObject(*scene.getRootObject(), shadowCubeMapShader, glm::mat4(1.0), lightPos,
+								  std::min(farPlane, light.getInfluenceRadius()));
 		}
 
 		return farPlane;
 	}
 
+	void OpenGLDeferredRendering::renderShadowMap(Scene::Scene& scene, Scene::Light::DirectionalLight& light) {
+		FrameProfiler::Scope scope(profiler, "shadowCascades");
+
+		// the shadow casters of every cascade were culled and recorded by buildRenderQueues
+		shadowCascadeFramebuffer.activate();
+
+		// casters between the light and the near plane are flattened onto it instead of being clipped
+		stateCache.setEnabled(GL_DEPTH_CLAMP, true);
+		stateCache.setCullFace(GL_FRONT);
+		for(unsigned int i = 0; i < shadowCascades.getCascadeCount(); i++) {
+			shadowCascadeTexture.attach(GL_DEPTH_ATTACHMENT, i);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			cascadeViews[i].commands.execute(commandExecutor);
+		}
+		stateCache.setCullFace(GL_BACK);
+		stateCache.setEnabled(GL_DEPTH_CLAMP, false);
+
+		shadowCascadeFramebuffer.deactivate();
+	}
+
 	glm::mat4 OpenGLDeferredRendering::renderShadowMap(Scene::Scene& scene, Scene::Light::SpotLight& light) {
-		shadowMapFBO.activate();
-//		shadowMapFBO.clear();
-		glClear(GL_DEPTH_BUFFER_BIT);
+		FrameProfiler::Scope scope(profiler, "shadowMap");
 
-		glm::mat4 lightProjection = glm::perspective<float>(glm::radians(90.0f), 1.0f, 0.1f, 1000.0f);
-		glm::mat4 lightView = glm::lookAt(
-				light.getPosition(),
-				light.getPosition() + light.getDirection(),
-				glm::vec3(0, 1, 0));
-		glm::mat4 lightSpaceMatrix = lightProjection * lightView;
+		// the shadow casters were culled against the light frustum and recorded by buildRenderQueues
+		auto& view = shadowViews.at(&light);
+		auto& cache = view.cache;
+
+		bool staticChanged = !cache.valid || cache.tile != view.tile || cache.lightSpaceMatrix != view.lightSpaceMatrix ||
+							 cache.staticCasters != view.staticCasters;
+		bool dynamicCasters = !view.renderQueue.empty();
+
+		// the tile still holds the shadows of the last frame
+		if(!staticChanged && !dynamicCasters && !cache.dynamicCasters) {
+			return view.lightSpaceMatrix;
+		}
+
+		const auto& tile = view.tile;
+		auto activateTile = [this, &tile](OpenGLFramebuffer& framebuffer) {
+			framebuffer.activate();
+			stateCache.setViewport(GLint(tile.x), GLint(tile.y), GLsizei(tile.size), GLsizei(tile.size));
+		};
 
-		shadowMapShader.activate();
-		shadowMapShader.set("lightSpaceMatrix", lightSpaceMatrix);
+		if(staticChanged) {
+			activateTile(staticShadowAtlasFramebuffer);
+			stateCache.setEnabled(GL_SCISSOR_TEST, true);
+			glScissor(GLint(tile.x), GLint(tile.y), GLsizei(tile.size), GLsizei(tile.size));
+			glClear(GL_DEPTH_BUFFER_BIT);
+			stateCache.setEnabled(GL_SCISSOR_TEST, false);
+
+			stateCache.setCullFace(GL_FRONT);
+			view.staticCommands.execute(commandExecutor);
+			stateCache.setCullFace(GL_BACK);
+
+			cache.valid = true;
+			cache.tile = view.tile;
+			cache.lightSpaceMatrix = view.lightSpaceMatrix;
+			cache.staticCasters = view.staticCasters;
+		}
+
+		// start from the cached static casters and composite the dynamic ones on top
+		stateCache.bindFramebuffer(GL_READ_FRAMEBUFFER, staticShadowAtlasFramebuffer.framebufferID);
+		stateCache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, shadowAtlasFramebuffer.framebufferID);
+		glBlitFramebuffer(GLint(tile.x), GLint(tile.y), GLint(tile.x + tile.size), GLint(tile.y + tile.size),
+						  GLint(tile.x), GLint(tile.y), GLint(tile.x + tile.size), GLint(tile.y + tile.size),
+						  GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 
-		glCullFace(GL_FRONT);
-		renderShadowMapObject(*scene.getRootObject(), shadowMapShader, glm::mat4(1.0));
-		glCullFace(GL_BACK);
+		if(dynamicCasters) {
+			activateTile(shadowAtlasFramebuffer);
 
-		return lightSpaceMatrix;
+			stateCache.setCullFace(GL_FRONT);
+			view.commands.execute(commandExecutor);
+			stateCache.setCullFace(GL_BACK);
+		}
+		cache.dynamicCasters = dynamicCasters;
+
+		stateCache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+		return view.lightSpaceMatrix;
 	}
 
 	void OpenGLDeferredRendering::renderShadowMapObject(Scene::Object& object, OpenGLShaderProgram& shader,
-														const glm::mat4& parentModelMatrix) {
-		auto translation = object.getPosition();
-		auto rotation = object.getRotation();
-		auto scale = object.getScale();
-
-		glm::mat4 modelMatrix = glm::scale(
-				glm::rotate(
-						glm::rotate(
-								glm::rotate(
-										glm::translate(
-												parentModelMatrix,
-												translation
-										),
-										rotation.z,
-										glm::vec3(0.0f, 0.0f, 1.0f)
-								),
-								rotation.y,
-								glm::vec3(0.0f, 1.0f, 0.0f)
-						),
-						rotation.x,
-						glm::vec3(1.0f, 0.0f, 0.0f)
-				),
-				scale
-		);
-
-//		if(object.getModel()->sh) {
+														const glm::mat4& parentModelMatrix,
+														const glm::vec3& lightPosition, float lightRadius) {
+		glm::mat4 modelMatrix = computeModelMatrix(object, parentModelMatrix);
 
 		Model::LevelOfDetail levelOfDetail{
 				glm::vec3(0.0)
 		};
 
-		if(const auto& model = object.getModel()) {
+		auto renderModel = [&](const Model::Model::Ptr& model, const glm::mat4& modelMatrix) {
+			if(!model->shouldCastShadows() ||
+			   !model->getBoundingBox().transform(modelMatrix).intersects(lightPosition, lightRadius)) {
+				return;
+			}
 			shader.set("model", modelMatrix);
-			object.getModel()->render(renderer, levelOfDetail);
+			model->render(renderer, levelOfDetail);
+		};
+
+		if(const auto& model = object.getModel()) {
+			renderModel(model, modelMatrix);
+		}
+
+		if(const auto* instance = dynamic_cast<const Scene::PrefabInstance*>(&object)) {
+			if(instance->getBoundingBox().transform(modelMatrix).intersects(lightPosition, lightRadius)) {
+				instance->visit(modelMatrix, renderModel);
+			}
 		}
 
 //			if(const auto& mesh = object.getMesh()) {
@@ -691,7 +1372,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 		// render all children
 		for(const auto& child : object.getChildren()) {
-			renderShadowMapObject(*child, shader, modelMatrix);
+			renderShadowMapObject(*child, shader, modelMatrix, lightPosition, lightRadius);
 		}
 	}
 
@@ -6,17 +6,39 @@
 
 #include "XYZ/Scene/Scene.hpp"
 
-#include "XYZ/Graphics/Renderer/OpenGL/OpenGLGeometryBuffer.hpp"
 #include "OpenGLFramebuffer.hpp"
 #include "OpenGLShader.hpp"
+#include "OpenGLShaderCache.hpp"
+#include "OpenGLShaderVariants.hpp"
 #include "OpenGLRenderer.hpp"
 #include "OpenGLCubeMap.hpp"
+#include "OpenGLTextureArray.hpp"
+#include "OpenGLTextureBuffer.hpp"
+#include "OpenGLShaderBuffers.hpp"
+#include "OpenGLFrameProfiler.hpp"
+#include "OpenGLCommandExecutor.hpp"
+#include "OpenGLStateCache.hpp"
+
+#include "XYZ/Graphics/Renderer/RenderQueue.hpp"
+#include "XYZ/Graphics/Renderer/RenderGraph.hpp"
+#include "XYZ/Graphics/Renderer/CommandBuffer.hpp"
+#include "XYZ/Graphics/Renderer/CommandExecutor.hpp"
+#include "XYZ/Graphics/Renderer/LightClusters.hpp"
+#include "XYZ/Graphics/Renderer/OcclusionBuffer.hpp"
+#include "XYZ/Graphics/Renderer/ShadowAtlas.hpp"
+#include "XYZ/Graphics/Renderer/ShadowCascades.hpp"
+#include "XYZ/Math/Frustum.hpp"
+#include "XYZ/Utility/JobSystem.hpp"
 
 #include "XYZ/Scene/Light/DirectionalLight.hpp"
 #include "XYZ/Scene/Light/PointLight.hpp"
 #include "XYZ/Scene/Light/SpotLight.hpp"
 
+#include <array>
+#include <limits>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace XYZ::Graphics::Renderer::OpenGL {
 
@@ -24,16 +46,268 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	private:
 		OpenGLRenderer& renderer;
 
+		/**
+		 * The OpenGL state cache every state change goes through
+		 */
+		OpenGLStateCache& stateCache;
+
+		/**
+		 * The cache the shader programs are loaded from. Must be declared before
+		 * every shader program.
+		 */
+		std::unique_ptr<OpenGLShaderCache> shaderCache;
+
 	private:
 		/**
-		 * The OpenGL geometry buffer
+		 * The render graph that orders the passes and assigns their targets
 		 */
-		OpenGLGeometryBuffer geometryBuffer;
+		RenderGraph renderGraph;
 
 		/**
-		 * The geometry shader program
+		 * If true, the render graph is rebuilt before the next frame
+		 */
+		bool renderGraphDirty = true;
+
+		/**
+		 * The render graph targets
+		 */
+		struct {
+			/**
+			 * The geometry buffer targets. With the compact layout there is no
+			 * position target, the normal target only holds the normal and the
+			 * shininess is written to a target of its own.
+			 */
+			RenderGraph::ResourceID positionDepth;
+			RenderGraph::ResourceID normalShininess;
+			RenderGraph::ResourceID albedoSpecular;
+			RenderGraph::ResourceID shininess;
+
+			RenderGraph::ResourceID depth;
+			RenderGraph::ResourceID lighting;
+			RenderGraph::ResourceID bloomHorizontalBlur;
+			RenderGraph::ResourceID bloomVerticalBlur;
+
+			/**
+			 * The target composed on the screen: the lighting target or, with
+			 * lighting disabled, the unlit albedo
+			 */
+			RenderGraph::ResourceID scene;
+
+			/**
+			 * The default framebuffer, imported into the graph
+			 */
+			RenderGraph::ResourceID screen;
+		} renderTargets;
+
+		/**
+		 * The textures of the render graph physical targets
+		 */
+		std::vector<std::unique_ptr<OpenGLTexture>> renderTargetTextures;
+
+		/**
+		 * The framebuffer of the geometry pass. Null if the pass was culled.
+		 */
+		std::unique_ptr<OpenGLFramebuffer> geometryFramebuffer;
+
+		/**
+		 * The scene being rendered, used by the render graph passes
+		 */
+		Scene::Scene* currentScene = nullptr;
+
+		/**
+		 * The geometry shader programs, specialized by model shader features
+		 */
+		std::unique_ptr<OpenGLShaderVariants> geometryBufferShaders;
+
+		/**
+		 * The geometry shader programs used by instanced draws
+		 */
+		std::unique_ptr<OpenGLShaderVariants> geometryBufferInstancedShaders;
+
+		/**
+		 * The queue used to sort the geometry pass draws by shader, material and depth
+		 */
+		RenderQueue geometryRenderQueue;
+
+		/**
+		 * The geometry pass commands, recorded by the geometry culling job and
+		 * replayed by <tt>renderGeometryBufferPass</tt>
+		 */
+		CommandBuffer geometryCommands;
+
+		/**
+		 * The executor that replays the recorded commands on the renderer context
+		 */
+		OpenGLCommandExecutor commandExecutor;
+
+		/**
+		 * The profiler measuring the time spent on every pass
+		 */
+		OpenGLFrameProfiler profiler;
+
+		/**
+		 * The occlusion buffer used to cull the objects hidden from the camera
+		 */
+		OcclusionBuffer geometryOcclusionBuffer;
+
+		/**
+		 * The camera position used to select between the HLOD proxies and the
+		 * detailed objects. The shadow passes use the same position so that the
+		 * shadows match the visible geometry.
+		 */
+		glm::vec3 proxyViewPosition = glm::vec3(0.0f);
+
+		/**
+		 * The camera vertical field of view, in radians. Used to estimate the
+		 * texture levels needed by the visible objects.
+		 */
+		float cameraFieldOfView = 0.0f;
+
+		/**
+		 * The scene manager of the scene being rendered, or null if the scene has none
+		 */
+		const Scene::Manager::SceneManager* sceneManager = nullptr;
+
+		/**
+		 * The lights the scene manager considers visible in the current frame
+		 */
+		std::vector<std::shared_ptr<Scene::Light::Light>> visibleLights;
+
+	private:
+		/**
+		 * The job system used to cull the scene and build the render queues
+		 */
+		std::unique_ptr<Utility::JobSystem> jobSystem;
+
+		/**
+		 * A view the scene is culled against
+		 */
+		struct CullingView {
+			/**
+			 * The view-projection matrix
+			 */
+			glm::mat4 viewProjection;
+
+			/**
+			 * The view frustum
+			 */
+			Math::Frustum frustum;
+
+			/**
+			 * The occlusion buffer with the view occluders
+			 */
+			const OcclusionBuffer& occlusionBuffer;
+
+			/**
+			 * A sphere objects must intersect to be queued. Shadow views use the light
+			 * influence, since objects outside of it cannot shadow anything lit.
+			 */
+			glm::vec3 sphereCenter = glm::vec3(0.0f);
+			float sphereRadius = std::numeric_limits<float>::infinity();
+
+			/**
+			 * The size objects must have to be queued, in world units. Shadow cascades
+			 * skip the casters that would not cover a couple of texels.
+			 */
+			float minimumSize = 0.0f;
+		};
+
+		/**
+		 * A view rendered into a light shadow map
+		 */
+		struct ShadowView {
+			/**
+			 * The light view-projection matrix
+			 */
+			glm::mat4 lightSpaceMatrix;
+
+			/**
+			 * The tile of the shadow atlas the view is rendered into
+			 */
+			ShadowAtlas::Tile tile;
+
+			/**
+			 * The dynamic shadow casters visible from the light
+			 */
+			RenderQueue renderQueue;
+
+			/**
+			 * The dynamic shadow pass commands, recorded by the view culling job
+			 */
+			CommandBuffer commands;
+
+			/**
+			 * The static shadow casters visible from the light
+			 */
+			RenderQueue staticRenderQueue;
+
+			/**
+			 * The static shadow pass commands, recorded by the view culling job
+			 */
+			CommandBuffer staticCommands;
+
+			/**
+			 * The hash of the static shadow casters visible from the light
+			 */
+			std::uint64_t staticCasters = 0;
+
+			/**
+			 * The occlusion buffer used to cull the objects hidden from the light
+			 */
+			OcclusionBuffer occlusionBuffer;
+
+			/**
+			 * The state the cached tile of the static shadow atlas was rendered with.
+			 * The static casters are only rendered again when any of it changes.
+			 */
+			struct {
+				bool valid = false;
+				ShadowAtlas::Tile tile;
+				glm::mat4 lightSpaceMatrix;
+				std::uint64_t staticCasters = 0;
+
+				/**
+				 * If true, the tile of the shadow atlas has dynamic casters composited on it
+				 */
+				bool dynamicCasters = false;
+			} cache;
+		};
+
+		/**
+		 * The shadow views of every shadow casting light in the scene, keyed by light
+		 */
+		std::map<const Scene::Light::Light*, ShadowView> shadowViews;
+
+		/**
+		 * A cascade of the directional light shadow map
+		 */
+		struct CascadeView {
+			/**
+			 * The shadow casters visible from the cascade
+			 */
+			RenderQueue renderQueue;
+
+			/**
+			 * The cascade shadow pass commands, recorded by the cascade culling job
+			 */
+			CommandBuffer commands;
+
+			/**
+			 * The occlusion buffer used to cull the objects hidden from the cascade
+			 */
+			OcclusionBuffer occlusionBuffer;
+		};
+
+		/**
+		 * The cascades of the directional light shadow map
 		 */
-		OpenGLShaderProgram geometryBufferShader;
+		std::array<CascadeView, ShadowCascades::MAX_CASCADES> cascadeViews;
+
+		/**
+		 * The directional light that casts shadows through the cascades, or null
+		 * if no visible directional light casts shadows
+		 */
+		Scene::Light::DirectionalLight* shadowedDirectionalLight = nullptr;
 
 	private:
 		/**
@@ -42,20 +316,63 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		bool lighting = true;
 
 		/**
-		 * A shadow map texture used to render directional lights shadows
+		 * A flag indicating if the geometry buffer uses the compact layout
+		 */
+		bool compactGeometryBuffer = false;
+
+		/**
+		 * Allocates the tiles of the spot light shadow maps
 		 */
-		OpenGLTexture shadowMap;
+		ShadowAtlas shadowAtlas;
 
 		/**
-		 * The OpenGL shadow framebuffer
+		 * The shadow maps of every shadow casting spot light, static and dynamic
+		 * casters included. Sampled by the lighting pass.
 		 */
-		OpenGLFramebuffer shadowMapFBO;
-		
+		OpenGLTexture shadowAtlasTexture;
+
+		/**
+		 * The framebuffer that renders into <tt>shadowAtlasTexture</tt>
+		 */
+		OpenGLFramebuffer shadowAtlasFramebuffer;
+
+		/**
+		 * The cached shadow maps of the static casters, with the same layout as
+		 * <tt>shadowAtlasTexture</tt>. Copied into it before the dynamic casters
+		 * are rendered.
+		 */
+		OpenGLTexture staticShadowAtlasTexture;
+
+		/**
+		 * The framebuffer that renders into <tt>staticShadowAtlasTexture</tt>
+		 */
+		OpenGLFramebuffer staticShadowAtlasFramebuffer;
+
+		/**
+		 * Splits the camera frustum between the directional light shadow cascades
+		 */
+		ShadowCascades shadowCascades;
+
+		/**
+		 * The shadow map of every directional light cascade, one per layer
+		 */
+		OpenGLTextureArray shadowCascadeTexture;
+
+		/**
+		 * The framebuffer that renders into a layer of <tt>shadowCascadeTexture</tt>
+		 */
+		OpenGLFramebuffer shadowCascadeFramebuffer;
+
 		/**
 		 * The geometry shader program
 		 */
 		OpenGLShaderProgram shadowMapShader;
 
+		/**
+		 * The shadow map shader program used by instanced draws
+		 */
+		OpenGLShaderProgram shadowMapInstancedShader;
+
 		/**
 		 * A shadow cube map texture used to render point lights shadows
 		 */
@@ -72,57 +389,111 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		OpenGLShaderProgram shadowCubeMapShader;
 
 		/**
-		 * The framebuffer where lighting computations are done
+		 * The framebuffer where lighting computations are done. Null if the
+		 * lighting pass was culled.
 		 */
-		OpenGLFramebuffer lightingFramebuffer;
+		std::unique_ptr<OpenGLFramebuffer> lightingFramebuffer;
 
 		/**
-		 * A texture where the lighting passes write data to
+		 * The directional light shader program
 		 */
-		OpenGLTexture lightingTexture;
+		OpenGLShaderProgram directionalLightShader;
 
 		/**
-		 * The directional light shader program
+		 * The shader program that shades all point lights and the spot lights without
+		 * shadows in a single pass, looping only over the lights of each cluster
 		 */
-		OpenGLShaderProgram directionalLightShader;
+		OpenGLShaderProgram clusteredLightShader;
+
+		/**
+		 * The CPU light to cluster assignment
+		 */
+		LightClusters lightClusters;
 
 		/**
-		 * The point light shader program
+		 * The packed data of the clustered lights
 		 */
-		OpenGLShaderProgram pointLightShader;
+		OpenGLTextureBuffer clusterLightBuffer;
 
 		/**
-		 * The point light shader program
+		 * The (offset, count) pair of each cluster
 		 */
-		std::map<unsigned int, OpenGLShaderProgram> pointLightShaders;
+		OpenGLTextureBuffer clusterGridBuffer;
+
+		/**
+		 * The light indices referenced by the clusters
+		 */
+		OpenGLTextureBuffer clusterIndexBuffer;
 
 		/**
 		 * The spot light shader program
 		 */
 		OpenGLShaderProgram spotLightShader;
 
-	private:
-		bool bloom = false;
+		/**
+		 * The parameters of the shadow casting spot lights, uploaded once per frame
+		 */
+		OpenGLUniformBuffer<OpenGLSpotLights> spotLights;
 
 		/**
-		 * A framebuffer used to render the horizontal Gaussian blur
+		 * The shadow casting spot lights, in the same order as in <tt>spotLights</tt>
 		 */
-		OpenGLFramebuffer bloomHorizontalBlurFramebuffer;
+		std::vector<Scene::Light::SpotLight*> shadowedSpotLights;
 
 		/**
-		 * A texture to render the horizontal Gaussian blur to
+		 * The directional light shader program uniforms
 		 */
-		OpenGLTexture bloomHorizontalBlurTexture;
+		struct {
+			OpenGLUniform<glm::vec3> direction;
+			OpenGLUniform<glm::vec3> ambient;
+			OpenGLUniform<glm::vec3> diffuse;
+			OpenGLUniform<glm::vec3> specular;
+			OpenGLUniform<float> shadowOcclusionStrength;
+			OpenGLUniform<glm::vec3> cameraPosition;
+			OpenGLUniform<glm::mat4> view;
+			OpenGLUniform<glm::mat4> inverseViewProjection;
+			OpenGLUniform<int> cascadeCount;
+			OpenGLUniform<glm::vec4> cascadeSplits;
+			OpenGLUniform<glm::vec4> cascadeTexelSizes;
+			std::array<OpenGLUniform<glm::mat4>, ShadowCascades::MAX_CASCADES> cascadeMatrices;
+		} directionalLightUniforms;
 
 		/**
-		 * A framebuffer used to render the vertical Gaussian blur
+		 * The clustered light shader program uniforms
 		 */
-		OpenGLFramebuffer bloomVerticalBlurFramebuffer;
+		struct {
+			OpenGLUniform<glm::uvec3> clusterCount;
+			OpenGLUniform<glm::vec2> screenSize;
+			OpenGLUniform<float> zNear;
+			OpenGLUniform<float> zFar;
+			OpenGLUniform<glm::mat4> view;
+			OpenGLUniform<glm::vec3> cameraPosition;
+			OpenGLUniform<glm::mat4> inverseViewProjection;
+		} clusteredLightUniforms;
 
 		/**
-		 * A texture to render the vertical Gaussian blur to
+		 * The spot light shader program uniforms
 		 */
-		OpenGLTexture bloomVerticalBlurTexture;
+		struct {
+			OpenGLUniform<int> lightIndex;
+			OpenGLUniform<glm::vec3> cameraPosition;
+			OpenGLUniform<glm::mat4> inverseViewProjection;
+		} spotLightUniforms;
+
+	private:
+		bool bloom = false;
+
+		/**
+		 * A framebuffer used to render the horizontal Gaussian blur. Null if the
+		 * bloom pass was culled.
+		 */
+		std::unique_ptr<OpenGLFramebuffer> bloomHorizontalBlurFramebuffer;
+
+		/**
+		 * A framebuffer used to render the vertical Gaussian blur. Null if the
+		 * bloom pass was culled.
+		 */
+		std::unique_ptr<OpenGLFramebuffer> bloomVerticalBlurFramebuffer;
 
 		/**
 		 * A shader program that maps "overexposed" areas of the image to be blurred by
@@ -163,8 +534,10 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 * Creates a new deferred rendering technique
 		 *
 		 * @param renderer the OpenGL renderer
+		 * @param shaderCacheDirectory the directory where the linked shader programs are
+		 * cached between runs. If empty, the programs are compiled on every run.
 		 */
-		explicit OpenGLDeferredRendering(OpenGLRenderer& renderer);
+		explicit OpenGLDeferredRendering(OpenGLRenderer& renderer, std::string shaderCacheDirectory = "");
 
 		/**
 		 * Deleted copy constructor.
@@ -183,11 +556,11 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		OpenGLDeferredRendering& operator=(const OpenGLDeferredRendering& other) = delete;
 
 		/**
-		 * Creates a new DeferredRendering technique by moving the contents of another
+		 * Deleted move constructor. The render graph passes refer to this instance.
 		 *
 		 * @param other the instance to move from
 		 */
-		OpenGLDeferredRendering(OpenGLDeferredRendering&& other);
+		OpenGLDeferredRendering(OpenGLDeferredRendering&& other) = delete;
 
 		/**
 		 * Deleted move assignment operator.
@@ -211,9 +584,115 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		void render(Scene::Scene& scene);
 
+		/**
+		 * Resizes every render target
+		 *
+		 * @param width the new width, in pixels
+		 * @param height the new height, in pixels
+		 */
 		void resize(unsigned int width, unsigned height);
 
+		/**
+		 * Enables or disables the lighting pass. With lighting disabled the unlit
+		 * albedo is composed on the screen and the lighting pass is culled.
+		 *
+		 * @param lighting true to enable the lighting pass
+		 */
+		void setLighting(bool lighting);
+
+		/**
+		 * Enables or disables the bloom pass
+		 *
+		 * @param bloom true to enable the bloom pass
+		 */
+		void setBloom(bool bloom);
+
+		/**
+		 * Enables or disables the compact geometry buffer layout. The compact
+		 * layout has no position target, the lighting pass reconstructs the
+		 * position from the depth target. Normals are octahedral encoded in a
+		 * RG16 target and the albedo and specular intensity are stored in a
+		 * RGBA8 target, which roughly halves the geometry buffer bandwidth.
+		 *
+		 * Unlike the default layout, the RGBA8 target clamps the albedo and the
+		 * specular intensity to 1, so materials whose diffuse texture plus
+		 * diffuse color (or specular texture plus specular color) exceed 1
+		 * render darker than with the default layout.
+		 *
+		 * Switching layouts reloads the geometry and lighting shader programs.
+		 *
+		 * @param compactGeometryBuffer true to use the compact geometry buffer layout
+		 */
+		void setCompactGeometryBuffer(bool compactGeometryBuffer);
+
+		/**
+		 * @return true if the geometry buffer uses the compact layout
+		 */
+		bool isCompactGeometryBuffer() const;
+
+		/**
+		 * @return the render graph of the last frame
+		 */
+		const RenderGraph& getRenderGraph() const;
+
+		/**
+		 * @return the profiler measuring the CPU and GPU time of every pass
+		 */
+		FrameProfiler& getProfiler();
+
+		/**
+		 * @return the cascades of the directional light shadow map
+		 */
+		ShadowCascades& getShadowCascades();
+
 	private:
+		/**
+		 * Declares the passes on the render graph, compiles it and allocates the
+		 * textures and framebuffers of the passes that survived culling. This is
+		 * the only place render targets are allocated, it is called on the first
+		 * frame and whenever the size or the enabled passes change.
+		 */
+		void buildRenderGraph();
+
+		/**
+		 * Loads the geometry and lighting shader programs of the geometry buffer
+		 * layout in use and sets their sampler units
+		 */
+		void loadGeometryBufferShaders();
+
+		/**
+		 * Binds the geometry buffer targets to the sampler units read by the
+		 * lighting shader programs
+		 */
+		void activateGeometryBuffer();
+
+		/**
+		 * Creates a framebuffer that renders to render graph targets
+		 *
+		 * @param colors the color targets, attached in order
+		 * @param depth the depth target or <tt>RenderGraph::INVALID</tt>
+		 *
+		 * @return the framebuffer or null if any target was culled
+		 */
+		std::unique_ptr<OpenGLFramebuffer> createFramebuffer(std::initializer_list<RenderGraph::ResourceID> colors,
+															 RenderGraph::ResourceID depth = RenderGraph::INVALID);
+
+		/**
+		 * @param resource the render graph target
+		 *
+		 * @return the texture of a render graph target
+		 */
+		OpenGLTexture& getRenderTarget(RenderGraph::ResourceID resource);
+
+		/**
+		 * Culls the scene against the camera and every shadow casting light and
+		 * fills the render queue of each view.
+		 *
+		 * Each view is culled by a separate job on the job system. The method
+		 * returns once all render queues are ready to be submitted.
+		 */
+		void buildRenderQueues(Scene::Scene& scene);
+
 		/**
 		 * Render the geometry buffer pass
 		 */
@@ -236,18 +715,115 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	private:
 		/**
-		 * Render the object given by <tt>object</tt> into the geometry buffer
+		 * Rasterizes the occluders of <tt>object</tt> and its children that are inside
+		 * the view frustum into a occlusion buffer.
 		 *
-		 * @param object the object to be rendered to the gbuffer
+		 * This method is called from the job system worker threads and must not
+		 * issue any OpenGL call.
+		 *
+		 * @param object the object whose occluders are rasterized
+		 * @param parentModelMatrix the model matrix of the objects parent
+		 * @param frustum the view frustum
+		 * @param occlusionBuffer the occlusion buffer to rasterize into
+		 */
+		void rasterizeOccluders(const Scene::Object& object, const glm::mat4& parentModelMatrix,
+								const Math::Frustum& frustum, OcclusionBuffer& occlusionBuffer);
+
+		/**
+		 * Queues the object given by <tt>object</tt> and its children if they are
+		 * inside the view frustum and sphere and not hidden by a occluder. Models
+		 * that do not cast shadows are never queued for the shadow pass.
+		 *
+		 * This method is called from the job system worker threads and must not
+		 * issue any OpenGL call.
+		 *
+		 * @param object the object to be culled
 		 * @param parentModelMatrix the model matrix of the objects parent
+		 * @param cullingView the view the object is culled against
+		 * @param pass the pass the object is queued for
+		 * @param shader the shader used to render the object
+		 * @param instancedShader the shader used to render the object when instanced
+		 * @param renderQueue the render queue to push the visible objects into
+		 * @param staticRenderQueue if not null, the render queue to push the visible
+		 * static objects into instead of <tt>renderQueue</tt>
+		 */
+		void cullObject(const Scene::Object& object, const glm::mat4& parentModelMatrix,
+						const CullingView& cullingView, RenderPass pass,
+						OpenGLShaderProgram& shader, OpenGLShaderProgram& instancedShader,
+						RenderQueue& renderQueue, RenderQueue* staticRenderQueue = nullptr);
+
+		/**
+		 * Requests the texture levels needed to render a visible model from the
+		 * texture streamer.
+		 *
+		 * This method is called from the geometry culling job and must not issue
+		 * any OpenGL call.
+		 *
+		 * @param model the visible model
+		 * @param modelMatrix the model matrix
+		 * @param bounds the model bounding box in world space
 		 */
-		void renderGeometryBufferObject(Scene::Object& object, const glm::mat4& parentModelMatrix, const glm::mat4& VP);
+		void requestTextures(const Model::Model& model, const glm::mat4& modelMatrix,
+							 const Math::BoundingBox& bounds);
+
+		/**
+		 * Computes the model matrix of <tt>object</tt>
+		 *
+		 * @param object the object
+		 * @param parentModelMatrix the model matrix of the objects parent
+		 *
+		 * @return the object model matrix
+		 */
+		static glm::mat4 computeModelMatrix(const Scene::Object& object, const glm::mat4& parentModelMatrix);
+
+		/**
+		 * Computes the view-projection matrix used to render a spot light shadow map.
+		 * The projection covers the light cone up to its influence radius and nothing
+		 * else, so that the light frustum culls every irrelevant caster.
+		 *
+		 * @param light the spot light
+		 *
+		 * @return the light view-projection matrix
+		 */
+		static glm::mat4 computeLightSpaceMatrix(const Scene::Light::SpotLight& light);
+
+		/**
+		 * Renders the shadow casters of every cascade of a directional light into
+		 * its layer of the cascade shadow map
+		 *
+		 * @param scene the scene being rendered
+		 * @param light the directional light
+		 */
+		void renderShadowMap(Scene::Scene& scene,Scene::Light::DirectionalLight& light);
 
-		glm::mat4 renderShadowMap(Scene::Scene& scene,Scene::Light::DirectionalLight& light);
 		float renderShadowMap(Scene::Scene& scene,Scene::Light::PointLight& light);
+
+		/**
+		 * Renders the shadow map of a spot light into its tile of the shadow atlas.
+		 * The static casters are rendered into the static shadow atlas only when the
+		 * light, the tile or the static casters changed, and copied into the shadow
+		 * atlas before the dynamic casters are rendered on top. Lights without any
+		 * change are skipped entirely.
+		 *
+		 * @param scene the scene being rendered
+		 * @param light the spot light
+		 *
+		 * @return the light view-projection matrix
+		 */
 		glm::mat4 renderShadowMap(Scene::Scene& scene,Scene::Light::SpotLight& light);
 
-		void renderShadowMapObject(Scene::Object& object, OpenGLShaderProgram& shader, const glm::mat4& parentModelMatrix);
+		/**
+		 * Renders the shadow casters of a object and its children that are inside
+		 * a light influence
+		 *
+		 * @param object the object to render
+		 * @param shader the shadow map shader program
+		 * @param parentModelMatrix the model matrix of the objects parent
+		 * @param lightPosition the light position
+		 * @param lightRadius the light influence radius
+		 */
+		void renderShadowMapObject(Scene::Object& object, OpenGLShaderProgram& shader, const glm::mat4& parentModelMatrix,
+								   const glm::vec3& lightPosition, float lightRadius);
 	};
 
 	/**
@@ -255,11 +831,23 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	 */
 	extern const Shader::ShaderSource GeometryVertexShaderSource;
 
+	/**
+	 * The Geometry Vertex shader source used by instanced draws
+	 */
+	extern const Shader::ShaderSource InstancedGeometryVertexShaderSource;
+
 	/**
 	 * The Geometry Fragment shader source
 	 */
 	extern const Shader::ShaderSource GeometryFragmentShaderSource;
 
+	/**
+	 * The functions shared by the geometry and lighting shaders when the
+	 * geometry buffer uses the compact layout. Inserted after the #version
+	 * directive together with the COMPACT_GEOMETRY_BUFFER define.
+	 */
+	extern const Shader::ShaderSource CompactGeometryBufferShaderSource;
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	/**
@@ -295,13 +883,18 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	 * The Geometry Fragment shader source
 	 */
 	extern const Shader::ShaderSource DirectionalLightShadowMapFragmentShaderSource;
+
+	/**
+	 * The shadow map vertex shader source used by instanced draws
+	 */
+	extern const Shader::ShaderSource InstancedShadowMapVertexShaderSource;
 	
 	// -----------------------------------------------------------------------------------------------------------------
 	
 	/**
-	 * The Point Light shader source
+	 * The clustered point and spot light shader source
 	 */
-	extern const Shader::ShaderSource PointLightFragmentShaderSource;
+	extern const Shader::ShaderSource ClusteredLightFragmentShaderSource;
 
 	/**
 	 * The Geometry Vertex shader source
@@ -0,0 +1,61 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLFrameProfiler.hpp"
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	OpenGLFrameProfiler::OpenGLFrameProfiler(std::size_t historySize) : FrameProfiler(historySize) {
+
+	}
+
+	OpenGLFrameProfiler::~OpenGLFrameProfiler() {
+		for(auto& pool : queries) {
+			if(!pool.empty()) {
+				glDeleteQueries(GLsizei(pool.size()), pool.data());
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLFrameProfiler::writeGPUTimestamp(std::size_t frame, std::size_t query) {
+		if(!GLEW_ARB_timer_query) {
+			return;
+		}
+
+		auto& pool = queries[frame];
+		if(query >= pool.size()) {
+			auto size = pool.size();
+			pool.resize(query + 1);
+			glGenQueries(GLsizei(pool.size() - size), pool.data() + size);
+		}
+		glQueryCounter(pool[query], GL_TIMESTAMP);
+	}
+
+	bool OpenGLFrameProfiler::readGPUTimestamps(std::size_t frame, std::size_t count,
+												std::vector<std::uint64_t>& timestamps) {
+		auto& pool = queries[frame];
+		if(!GLEW_ARB_timer_query || count > pool.size()) {
+			return false;
+		}
+
+		// the frame end timestamp is written last, once it is available all the
+		// others are as well
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(pool[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if(available == GL_FALSE) {
+			return false;
+		}
+
+		timestamps.resize(count);
+		for(std::size_t i = 0; i < count; i++) {
+			GLuint64 timestamp = 0;
+			glGetQueryObjectui64v(pool[i], GL_QUERY_RESULT, &timestamp);
+			timestamps[i] = timestamp;
+		}
+		return true;
+	}
+
+}
@@ -0,0 +1,65 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Renderer/FrameProfiler.hpp"
+
+#include <GL/glew.h>
+
+#include <array>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A frame profiler that measures GPU times with <tt>GL_TIMESTAMP</tt> queries.
+	 *
+	 * Every frame in flight has its own pool of query objects, grown on demand,
+	 * so the queries of a frame are only reused once their results were read.
+	 * Without <tt>ARB_timer_query</tt> only CPU times are measured.
+	 */
+	class OpenGLFrameProfiler final : public FrameProfiler {
+	private:
+		/**
+		 * The query objects of every frame in flight
+		 */
+		std::array<std::vector<GLuint>, FRAMES_IN_FLIGHT> queries;
+
+	public:
+		/**
+		 * Creates a new frame profiler
+		 *
+		 * @param historySize the maximum number of frames kept on the history
+		 */
+		explicit OpenGLFrameProfiler(std::size_t historySize = 240);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLFrameProfiler(const OpenGLFrameProfiler& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLFrameProfiler& operator=(const OpenGLFrameProfiler& other) = delete;
+
+		/**
+		 * Destroys the profiler and its query objects
+		 */
+		~OpenGLFrameProfiler() final;
+
+	protected:
+		void writeGPUTimestamp(std::size_t frame, std::size_t query) final;
+		bool readGPUTimestamps(std::size_t frame, std::size_t count, std::vector<std::uint64_t>& timestamps) final;
+
+	};
+
+}
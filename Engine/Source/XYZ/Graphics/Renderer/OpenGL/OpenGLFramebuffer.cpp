@@ -10,6 +10,7 @@
 #include "OpenGLTexture.hpp"
 #include "OpenGLVertexBuffer.hpp"
 #include "OpenGLShaderBuffers.hpp"
+#include "OpenGLStateCache.hpp"
 
 #include "XYZ/Scene/Light/DirectionalLight.hpp"
 #include "XYZ/Scene/Light/PointLight.hpp"
@@ -42,17 +43,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	OpenGLFramebuffer::~OpenGLFramebuffer() {
 		if(framebufferID != 0) {
-			glDeleteFramebuffers(1, &framebufferID);
+			OpenGLStateCache::get().deleteFramebuffer(framebufferID);
 		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	static void enableOrDisable(GLenum name, bool state) {
-		wrap(
-				(state ? glEnable : glDisable),
-				name
-		);
+		OpenGLStateCache::get().setEnabled(name, state);
 	}
 
 	static void updateFramebufferState(OpenGLFramebuffer::Configuration& configuration) {
@@ -62,20 +60,15 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	}
 
 	void OpenGLFramebuffer::activate() {
-		wrap(
-				glViewport,
-				0, 0, width, height
-		);
-		wrap(
-				glBindFramebuffer,
-				GL_FRAMEBUFFER, framebufferID
-		);
+		auto& state = OpenGLStateCache::get();
+		state.setViewport(0, 0, width, height);
+		state.bindFramebuffer(GL_FRAMEBUFFER, framebufferID);
 
 		updateFramebufferState(configuration);
 	}
 
 	void OpenGLFramebuffer::deactivate() {
-		wrap(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+		OpenGLStateCache::get().bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
@@ -88,11 +81,12 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLFramebuffer::copy(Framebuffer& destinationFramebuffer) const {
 		auto& destination = static_cast<OpenGLFramebuffer&>(destinationFramebuffer);
 
-		wrap(glBindFramebuffer, GL_FRAMEBUFFER, framebufferID);
-		wrap(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, destination.framebufferID);
+		auto& state = OpenGLStateCache::get();
+		state.bindFramebuffer(GL_READ_FRAMEBUFFER, framebufferID);
+		state.bindFramebuffer(GL_DRAW_FRAMEBUFFER, destination.framebufferID);
 		wrap(glBlitFramebuffer, 0, 0, width, height, 0, 0, destination.width,
 			 destination.height, GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT, GL_NEAREST);
-		wrap(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+		state.bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	void OpenGLFramebuffer::clear(glm::vec4 color) {
@@ -104,7 +98,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	// -----------------------------------------------------------------------------------------------------------------
 
 	OpenGLFramebuffer& OpenGLFramebuffer::blending(bool state) {
-		configuration.blending = true;
+		configuration.blending = state;
 		enableOrDisable(GL_BLEND, configuration.blending);
 		return *this;
 	}
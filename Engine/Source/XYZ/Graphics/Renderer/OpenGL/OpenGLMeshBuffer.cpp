@@ -0,0 +1,296 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLMeshBuffer.hpp"
+#include "OpenGLVertexBuffer.hpp"
+#include "OpenGLStateCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * The number of vertices and indices the buffer starts with. The buffer
+	 * doubles in size whenever it is full.
+	 */
+	static constexpr GLuint INITIAL_VERTEX_CAPACITY = 1 << 16;
+	static constexpr GLuint INITIAL_INDEX_CAPACITY = 1 << 18;
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool OpenGLMeshBuffer::RangeAllocator::allocate(GLuint count, GLuint& offset) {
+		if(count == 0) {
+			offset = 0;
+			return true;
+		}
+
+		for(auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+			if(it->second < count) {
+				continue;
+			}
+
+			offset = it->first;
+			auto remaining = it->second - count;
+			freeRanges.erase(it);
+			if(remaining > 0) {
+				freeRanges.emplace(offset + count, remaining);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void OpenGLMeshBuffer::RangeAllocator::release(GLuint offset, GLuint count) {
+		if(count == 0) {
+			return;
+		}
+
+		auto it = freeRanges.emplace(offset, count).first;
+
+		auto next = std::next(it);
+		if(next != freeRanges.end() && it->first + it->second == next->first) {
+			it->second += next->second;
+			freeRanges.erase(next);
+		}
+
+		if(it != freeRanges.begin()) {
+			auto previous = std::prev(it);
+			if(previous->first + previous->second == it->first) {
+				previous->second += it->second;
+				freeRanges.erase(it);
+			}
+		}
+	}
+
+	void OpenGLMeshBuffer::RangeAllocator::grow(GLuint capacity) {
+		release(RangeAllocator::capacity, capacity - RangeAllocator::capacity);
+		RangeAllocator::capacity = capacity;
+	}
+
+	GLuint OpenGLMeshBuffer::RangeAllocator::getCapacity() const {
+		return capacity;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLMeshBuffer::OpenGLMeshBuffer(OpenGLRingBuffer& drawData) : drawData(drawData) {
+		if(!isSupported() || drawData.getBufferID() == 0) {
+			return;
+		}
+
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &vertexBuffer);
+		glGenBuffers(1, &indexBuffer);
+
+		OpenGLStateCache::get().bindVertexArray(vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, INITIAL_VERTEX_CAPACITY * sizeof(Mesh::Vertex), nullptr, GL_STATIC_DRAW);
+		bindVertexAttributes();
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, INITIAL_INDEX_CAPACITY * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+		// the model matrices are read from the ring buffer, starting at the base instance of every draw
+		glBindBuffer(GL_ARRAY_BUFFER, drawData.getBufferID());
+		for(GLuint column = 0; column < 4; column++) {
+			auto attribute = OpenGLVertexBuffer::INSTANCE_MODEL_ATTRIBUTE + column;
+			glEnableVertexAttribArray(attribute);
+			glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+								  (void*) (sizeof(glm::vec4) * column));
+			glVertexAttribDivisor(attribute, 1);
+		}
+
+		OpenGLStateCache::get().bindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		vertices.grow(INITIAL_VERTEX_CAPACITY);
+		indices.grow(INITIAL_INDEX_CAPACITY);
+	}
+
+	OpenGLMeshBuffer::~OpenGLMeshBuffer() {
+		if(vao != 0) {
+			OpenGLStateCache::get().deleteVertexArray(vao);
+		}
+		if(vertexBuffer != 0) {
+			glDeleteBuffers(1, &vertexBuffer);
+		}
+		if(indexBuffer != 0) {
+			glDeleteBuffers(1, &indexBuffer);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool OpenGLMeshBuffer::isSupported() {
+		return OpenGLRingBuffer::isSupported() && GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance;
+	}
+
+	bool OpenGLMeshBuffer::isValid() const {
+		return vao != 0;
+	}
+
+	OpenGLMeshBuffer::Range OpenGLMeshBuffer::allocate(const Mesh::Mesh& mesh) {
+		const auto& meshVertices = mesh.getVertices();
+		const auto& meshIndices = mesh.getIndices();
+
+		Range range;
+		range.vertexCount = GLuint(meshVertices.size());
+		range.indexCount = GLuint(meshIndices.size());
+
+		while(!vertices.allocate(range.vertexCount, range.firstVertex)) {
+			auto capacity = vertices.getCapacity();
+			auto newCapacity = std::max(2 * capacity, capacity + range.vertexCount);
+			growBuffer(vertexBuffer, capacity * sizeof(Mesh::Vertex), newCapacity * sizeof(Mesh::Vertex));
+			vertices.grow(newCapacity);
+
+			OpenGLStateCache::get().bindVertexArray(vao);
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+			bindVertexAttributes();
+			OpenGLStateCache::get().bindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+		while(!indices.allocate(range.indexCount, range.firstIndex)) {
+			auto capacity = indices.getCapacity();
+			auto newCapacity = std::max(2 * capacity, capacity + range.indexCount);
+			growBuffer(indexBuffer, capacity * sizeof(GLuint), newCapacity * sizeof(GLuint));
+			indices.grow(newCapacity);
+
+			OpenGLStateCache::get().bindVertexArray(vao);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+			OpenGLStateCache::get().bindVertexArray(0);
+		}
+
+		// the copy targets leave the vertex array object bindings alone
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstVertex * sizeof(Mesh::Vertex),
+						meshVertices.size() * sizeof(Mesh::Vertex), meshVertices.data());
+		glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstIndex * sizeof(GLuint),
+						meshIndices.size() * sizeof(GLuint), meshIndices.data());
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		return range;
+	}
+
+	void OpenGLMeshBuffer::release(const Range& range) {
+		vertices.release(range.firstVertex, range.vertexCount);
+		indices.release(range.firstIndex, range.indexCount);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLMeshBuffer::draw(const Range& range) {
+		OpenGLStateCache::get().bindVertexArray(vao);
+		glDrawElementsBaseVertex(GL_TRIANGLES, GLsizei(range.indexCount), GL_UNSIGNED_INT,
+								 (void*) (std::uintptr_t(range.firstIndex) * sizeof(GLuint)),
+								 GLint(range.firstVertex));
+	}
+
+	void OpenGLMeshBuffer::drawInstanced(const Range& range, const glm::mat4* modelMatrices, std::size_t count) {
+		OpenGLStateCache::get().bindVertexArray(vao);
+
+		// a segment worth of instances never stalls on more than one segment
+		auto maxInstances = std::max<std::size_t>(1, std::size_t(drawData.getSegmentSize()) / sizeof(glm::mat4));
+		for(std::size_t first = 0; first < count; first += maxInstances) {
+			auto instances = std::min(maxInstances, count - first);
+			auto allocation = drawData.allocate(GLsizeiptr(instances * sizeof(glm::mat4)), sizeof(glm::mat4));
+			if(allocation.pointer == nullptr) {
+				break;
+			}
+			std::memcpy(allocation.pointer, modelMatrices + first, instances * sizeof(glm::mat4));
+
+			glDrawElementsInstancedBaseVertexBaseInstance(
+					GL_TRIANGLES, GLsizei(range.indexCount), GL_UNSIGNED_INT,
+					(void*) (std::uintptr_t(range.firstIndex) * sizeof(GLuint)), GLsizei(instances),
+					GLint(range.firstVertex), GLuint(allocation.offset / GLintptr(sizeof(glm::mat4)))
+			);
+		}
+	}
+
+	bool OpenGLMeshBuffer::drawMulti(const std::vector<DrawCommand>& commands, const glm::mat4* modelMatrices,
+									 std::size_t count) {
+		if(commands.empty()) {
+			return true;
+		}
+
+		// the matrices and the commands share a single allocation, the commands
+		// right after the matrices
+		auto matricesSize = GLsizeiptr(count * sizeof(glm::mat4));
+		auto commandsSize = GLsizeiptr(commands.size() * sizeof(DrawCommand));
+		auto allocation = drawData.allocate(matricesSize + commandsSize, sizeof(glm::mat4));
+		if(allocation.pointer == nullptr) {
+			return false;
+		}
+
+		auto* data = static_cast<std::uint8_t*>(allocation.pointer);
+		std::memcpy(data, modelMatrices, std::size_t(matricesSize));
+
+		auto baseInstance = GLuint(allocation.offset / GLintptr(sizeof(glm::mat4)));
+		auto* mappedCommands = reinterpret_cast<DrawCommand*>(data + matricesSize);
+		for(std::size_t i = 0; i < commands.size(); i++) {
+			mappedCommands[i] = commands[i];
+			mappedCommands[i].baseInstance += baseInstance;
+		}
+
+		OpenGLStateCache::get().bindVertexArray(vao);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawData.getBufferID());
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*) (allocation.offset + matricesSize),
+									GLsizei(commands.size()), 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+		statistics.multiDrawCalls++;
+		statistics.drawCommands += commands.size();
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const OpenGLMeshBuffer::Statistics& OpenGLMeshBuffer::getStatistics() const {
+		return statistics;
+	}
+
+	void OpenGLMeshBuffer::resetStatistics() {
+		statistics = Statistics();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLMeshBuffer::bindVertexAttributes() {
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::Vertex),
+							  (void*) offsetof(Mesh::Vertex, position));
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Mesh::Vertex),
+							  (void*) offsetof(Mesh::Vertex, texCoords));
+
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::Vertex),
+							  (void*) offsetof(Mesh::Vertex, normal));
+
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Mesh::Vertex),
+							  (void*) offsetof(Mesh::Vertex, tangent));
+	}
+
+	void OpenGLMeshBuffer::growBuffer(GLuint& buffer, GLsizeiptr size, GLsizeiptr newSize) {
+		GLuint newBuffer;
+		glGenBuffers(1, &newBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		glDeleteBuffers(1, &buffer);
+		buffer = newBuffer;
+	}
+
+}
@@ -0,0 +1,263 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Mesh/Mesh.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLRingBuffer.hpp"
+
+#include <GL/glew.h>
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A vertex and index megabuffer shared by every compiled mesh.
+	 *
+	 * All meshes live on the same vertex array object, so draws of different
+	 * meshes can be submitted together by a single multi-draw indirect call.
+	 * The model matrix of every draw is streamed through a ring buffer and read
+	 * by the instanced shaders as a per-instance attribute: the base instance of
+	 * every draw selects its matrix, acting as a draw index.
+	 */
+	class OpenGLMeshBuffer {
+	public:
+		/**
+		 * The vertices and indices of a mesh in the buffer
+		 */
+		struct Range {
+			GLuint firstVertex = 0;
+			GLuint vertexCount = 0;
+			GLuint firstIndex = 0;
+			GLuint indexCount = 0;
+		};
+
+		/**
+		 * A indirect draw command, laid out as OpenGL expects it
+		 */
+		struct DrawCommand {
+			GLuint count;
+			GLuint instanceCount;
+			GLuint firstIndex;
+			GLint baseVertex;
+			GLuint baseInstance;
+		};
+
+		/**
+		 * A set of counters collected since the last reset
+		 */
+		struct Statistics {
+			/**
+			 * The number of multi-draw calls issued
+			 */
+			unsigned int multiDrawCalls = 0;
+
+			/**
+			 * The number of indirect draw commands submitted by multi-draw calls
+			 */
+			unsigned int drawCommands = 0;
+		};
+
+	private:
+		/**
+		 * Allocates ranges of elements from a buffer
+		 */
+		class RangeAllocator {
+		private:
+			/**
+			 * The size of every free range, keyed by its offset
+			 */
+			std::map<GLuint, GLuint> freeRanges;
+
+			/**
+			 * The number of elements in the buffer
+			 */
+			GLuint capacity = 0;
+
+		public:
+			/**
+			 * Allocates the first free range large enough
+			 *
+			 * @param count the number of elements
+			 * @param offset the offset of the allocated range
+			 *
+			 * @return true if the range was allocated
+			 */
+			bool allocate(GLuint count, GLuint& offset);
+
+			/**
+			 * Releases a range, merging it with its free neighbours
+			 *
+			 * @param offset the range offset
+			 * @param count the number of elements
+			 */
+			void release(GLuint offset, GLuint count);
+
+			/**
+			 * Adds elements at the end of the buffer
+			 *
+			 * @param capacity the new number of elements
+			 */
+			void grow(GLuint capacity);
+
+			/**
+			 * @return the number of elements in the buffer
+			 */
+			GLuint getCapacity() const;
+		};
+
+	private:
+		/**
+		 * The ring buffer the model matrices and draw commands are streamed through
+		 */
+		OpenGLRingBuffer& drawData;
+
+		/**
+		 * The vertex array object of every mesh
+		 */
+		GLuint vao = 0;
+
+		/**
+		 * The vertices of every mesh
+		 */
+		GLuint vertexBuffer = 0;
+
+		/**
+		 * The indices of every mesh, relative to the first vertex of their mesh
+		 */
+		GLuint indexBuffer = 0;
+
+		/**
+		 * The allocated vertices
+		 */
+		RangeAllocator vertices;
+
+		/**
+		 * The allocated indices
+		 */
+		RangeAllocator indices;
+
+		/**
+		 * The counters collected since the last reset
+		 */
+		Statistics statistics;
+
+	public:
+		/**
+		 * Creates a new mesh buffer. Does nothing if multi-draw indirect is not supported.
+		 *
+		 * @param drawData the ring buffer the per-draw data is streamed through
+		 */
+		explicit OpenGLMeshBuffer(OpenGLRingBuffer& drawData);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLMeshBuffer(const OpenGLMeshBuffer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLMeshBuffer& operator=(const OpenGLMeshBuffer& other) = delete;
+
+		/**
+		 * Destroys the buffer
+		 */
+		~OpenGLMeshBuffer();
+
+	public:
+		/**
+		 * @return true if the driver supports everything the buffer needs
+		 */
+		static bool isSupported();
+
+		/**
+		 * @return true if the buffer was created
+		 */
+		bool isValid() const;
+
+		/**
+		 * Uploads a mesh into the buffer, growing it if needed
+		 *
+		 * @param mesh the mesh to upload
+		 *
+		 * @return the range of the mesh in the buffer
+		 */
+		Range allocate(const Mesh::Mesh& mesh);
+
+		/**
+		 * Releases the range of a mesh
+		 *
+		 * @param range the range returned by <tt>allocate</tt>
+		 */
+		void release(const Range& range);
+
+	public:
+		/**
+		 * Draws a mesh
+		 *
+		 * @param range the mesh range
+		 */
+		void draw(const Range& range);
+
+		/**
+		 * Draws several instances of a mesh. Requires a instanced shader program.
+		 *
+		 * @param range the mesh range
+		 * @param modelMatrices the model matrix of every instance
+		 * @param count the number of instances
+		 */
+		void drawInstanced(const Range& range, const glm::mat4* modelMatrices, std::size_t count);
+
+		/**
+		 * Submits several draws with a single call. Requires a instanced shader program.
+		 *
+		 * @param commands the draws. Their base instance is the index, in
+		 * <tt>modelMatrices</tt>, of the model matrix of their first instance.
+		 * @param modelMatrices the model matrix of every instance
+		 * @param count the number of model matrices
+		 *
+		 * @return false if the draws do not fit in the ring buffer, in which case nothing is drawn
+		 */
+		bool drawMulti(const std::vector<DrawCommand>& commands, const glm::mat4* modelMatrices, std::size_t count);
+
+	public:
+		/**
+		 * @return the counters collected since the last reset
+		 */
+		const Statistics& getStatistics() const;
+
+		/**
+		 * Resets the counters
+		 */
+		void resetStatistics();
+
+	private:
+		/**
+		 * Points the vertex attributes of the vertex array object to the vertex buffer
+		 */
+		void bindVertexAttributes();
+
+		/**
+		 * Replaces a buffer by a larger one with the same contents
+		 *
+		 * @param buffer the buffer to grow
+		 * @param size the current size, in bytes
+		 * @param newSize the new size, in bytes
+		 */
+		static void growBuffer(GLuint& buffer, GLsizeiptr size, GLsizeiptr newSize);
+
+	};
+
+}
@@ -11,6 +11,7 @@
 #include "OpenGLFramebuffer.hpp"
 #include "OpenGLVertexBuffer.hpp"
 #include "OpenGLException.hpp"
+#include "OpenGLStateCache.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -18,21 +19,34 @@
 
 namespace XYZ::Graphics::Renderer::OpenGL {
 
-	OpenGLRenderer::OpenGLRenderer() : defaultFramebuffer(0, 1024, 768) {
+	OpenGLRenderer::OpenGLRenderer() :
+			drawDataBuffer(16 * 1024 * 1024),
+			meshBuffer(drawDataBuffer),
+			textureStreamer(512 * 1024 * 1024, 4 * 1024 * 1024),
+			defaultFramebuffer(0, 1024, 768) {
+		if(meshBuffer.isValid()) {
+			compiler.setMeshBuffer(&meshBuffer);
+		}
+		compiler.setTextureStreamer(&textureStreamer);
+
 		// Dark blue background
 		glClearColor(0.0f, 0.0f, 0.4f, 0.0f);
 
 		// Enable depth test
-		glEnable(GL_DEPTH_TEST);
-		glDisable(GL_MULTISAMPLE);
+		auto& state = OpenGLStateCache::get();
+		state.setEnabled(GL_DEPTH_TEST, true);
+		state.setEnabled(GL_MULTISAMPLE, false);
 		// Accept fragment if it closer to the camera than the former one
-		glDepthFunc(GL_LESS);
+		state.setDepthFunction(GL_LESS);
 
 		// Cull triangles which normal is not towards the camera
 //		glEnable(GL_CULL_FACE);
 	}
 
-	OpenGLRenderer::~OpenGLRenderer() {}
+	OpenGLRenderer::~OpenGLRenderer() {
+		// the next renderer may run on a new context, with nothing bound
+		OpenGLStateCache::get().invalidate();
+	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
@@ -58,6 +72,18 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		return defaultFramebuffer;
 	}
 
+	OpenGLRingBuffer& OpenGLRenderer::getDrawDataBuffer() {
+		return drawDataBuffer;
+	}
+
+	OpenGLMeshBuffer& OpenGLRenderer::getMeshBuffer() {
+		return meshBuffer;
+	}
+
+	OpenGLTextureStreamer& OpenGLRenderer::getTextureStreamer() {
+		return textureStreamer;
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	static std::unique_ptr<Framebuffer> _createFramebuffer(OpenGLRenderer& renderer, size_t width, size_t height, GLenum textureKind = GL_RGB, GLenum fragmentType = GL_UNSIGNED_BYTE, GLenum attachment = GL_COLOR_ATTACHMENT0) {
@@ -66,23 +92,24 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		glGenFramebuffers(1, &framebufferID);
 
 		// create depth texture
+		auto& state = OpenGLStateCache::get();
 		GLuint framebufferTextureID;
 		glGenTextures(1, &framebufferTextureID);
-		glBindTexture(GL_TEXTURE_2D, framebufferTextureID);
+		state.bindTexture(GL_TEXTURE_2D, framebufferTextureID);
 		glTexImage2D(GL_TEXTURE_2D, 0, textureKind, static_cast<GLuint>(width), static_cast<GLuint>(height), 0,
 					 textureKind, fragmentType, nullptr);
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		state.setTextureParameter(GL_TEXTURE_2D, framebufferTextureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D, framebufferTextureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D, framebufferTextureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		state.setTextureParameter(GL_TEXTURE_2D, framebufferTextureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
 		// attach depth texture as FBO's depth buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+		state.bindFramebuffer(GL_FRAMEBUFFER, framebufferID);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, framebufferTextureID, 0);
 		glDrawBuffer(GL_NONE);
 		glReadBuffer(GL_NONE);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		state.bindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		return std::make_unique<OpenGLFramebuffer>(
 				framebufferID, static_cast<unsigned int>(width), static_cast<unsigned int>(height),
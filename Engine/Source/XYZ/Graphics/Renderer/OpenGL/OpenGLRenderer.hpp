@@ -10,6 +10,9 @@
 
 #include "XYZ/Graphics/Renderer/OpenGL/OpenGLCompiler.hpp"
 #include "XYZ/Graphics/Renderer/OpenGL/OpenGLFramebuffer.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLRingBuffer.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLMeshBuffer.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLTextureStreamer.hpp"
 
 #include "XYZ/Scene/Object.hpp"
 
@@ -17,6 +20,21 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
     class OpenGLRenderer : public Renderer {
     private:
+		/**
+		 * The ring buffer per-draw data is streamed through
+		 */
+		OpenGLRingBuffer drawDataBuffer;
+
+		/**
+		 * The buffer every mesh is compiled into, if multi-draw indirect is supported
+		 */
+		OpenGLMeshBuffer meshBuffer;
+
+		/**
+		 * The streamer every texture is compiled into
+		 */
+		OpenGLTextureStreamer textureStreamer;
+
 		/**
 		 * The OpenGL compiler
 		 */
@@ -67,6 +85,22 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		OpenGLFramebuffer& getDefaultFramebuffer() final;
 
+		/**
+		 * @return the ring buffer per-draw data is streamed through
+		 */
+		OpenGLRingBuffer& getDrawDataBuffer();
+
+		/**
+		 * @return the buffer every mesh is compiled into. Invalid if multi-draw
+		 * indirect is not supported.
+		 */
+		OpenGLMeshBuffer& getMeshBuffer();
+
+		/**
+		 * @return the streamer every texture is compiled into
+		 */
+		OpenGLTextureStreamer& getTextureStreamer();
+
 	public:
 		/**
 		 * Creates a new framebuffer object.
@@ -0,0 +1,132 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLRingBuffer.hpp"
+
+#include <algorithm>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	OpenGLRingBuffer::OpenGLRingBuffer(GLsizeiptr size, std::size_t segments) :
+			size(size),
+			segmentSize((size + GLsizeiptr(segments) - 1) / GLsizeiptr(segments)),
+			fences(segments, nullptr),
+			pending(segments, false) {
+		if(!isSupported()) {
+			return;
+		}
+
+		// the mapping is coherent, so writes are visible to the commands submitted after them
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &bufferID);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+		mapping = static_cast<std::uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	OpenGLRingBuffer::~OpenGLRingBuffer() {
+		for(auto sync : fences) {
+			if(sync != nullptr) {
+				glDeleteSync(sync);
+			}
+		}
+
+		if(bufferID != 0) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			glDeleteBuffers(1, &bufferID);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool OpenGLRingBuffer::isSupported() {
+		return GLEW_ARB_buffer_storage;
+	}
+
+	OpenGLRingBuffer::Allocation OpenGLRingBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+		if(mapping == nullptr || size > OpenGLRingBuffer::size) {
+			return Allocation();
+		}
+
+		auto offset = (head + alignment - 1) / alignment * alignment;
+		if(offset + size > OpenGLRingBuffer::size) {
+			// every allocation made so far was already consumed, so the segments
+			// being left behind can be fenced right away
+			fence();
+			offset = 0;
+			currentSegment = fences.size();
+		}
+
+		// the segment head is in was waited for when head entered it
+		auto first = std::size_t(offset / segmentSize);
+		auto last = std::size_t((offset + std::max(size, GLsizeiptr(1)) - 1) / segmentSize);
+		for(auto segment = first; segment <= last; segment++) {
+			if(segment != currentSegment) {
+				wait(segment);
+			}
+			pending[segment] = true;
+		}
+		currentSegment = last;
+
+		head = offset + size;
+		return Allocation{mapping + offset, offset};
+	}
+
+	void OpenGLRingBuffer::fence() {
+		for(std::size_t segment = 0; segment < fences.size(); segment++) {
+			if(!pending[segment]) {
+				continue;
+			}
+
+			if(fences[segment] != nullptr) {
+				glDeleteSync(fences[segment]);
+			}
+			fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			pending[segment] = false;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	GLuint OpenGLRingBuffer::getBufferID() const {
+		return bufferID;
+	}
+
+	GLsizeiptr OpenGLRingBuffer::getSize() const {
+		return size;
+	}
+
+	GLsizeiptr OpenGLRingBuffer::getSegmentSize() const {
+		return segmentSize;
+	}
+
+	unsigned int OpenGLRingBuffer::getStallCount() const {
+		return stalls;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLRingBuffer::wait(std::size_t segment) {
+		auto sync = fences[segment];
+		if(sync == nullptr) {
+			return;
+		}
+
+		auto result = glClientWaitSync(sync, 0, 0);
+		if(result == GL_TIMEOUT_EXPIRED) {
+			stalls++;
+			do {
+				result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while(result == GL_TIMEOUT_EXPIRED);
+		}
+
+		glDeleteSync(sync);
+		fences[segment] = nullptr;
+	}
+
+}
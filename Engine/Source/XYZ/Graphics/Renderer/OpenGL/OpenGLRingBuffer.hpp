@@ -0,0 +1,178 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A persistently mapped buffer that streams per-draw data to the GPU.
+	 *
+	 * The buffer is mapped once and written directly by the CPU, without any
+	 * further buffer call. Allocations are made linearly and wrap around when the
+	 * end of the buffer is reached. The buffer is split in segments and every
+	 * segment written is protected by a fence when <tt>fence</tt> is called,
+	 * usually once per frame. A segment is only written again once the GPU has
+	 * passed its fence, so the CPU only waits when it is a whole buffer ahead of
+	 * the GPU.
+	 *
+	 * Every allocation must be consumed by the commands submitted before the next
+	 * allocation is made.
+	 */
+	class OpenGLRingBuffer {
+	public:
+		/**
+		 * A region of the buffer
+		 */
+		struct Allocation {
+			/**
+			 * The mapped memory of the region, or null if the allocation failed
+			 */
+			void* pointer = nullptr;
+
+			/**
+			 * The offset of the region from the start of the buffer, in bytes
+			 */
+			GLintptr offset = 0;
+		};
+
+	private:
+		/**
+		 * The OpenGL buffer handle. 0 if persistent mapping is not supported.
+		 */
+		GLuint bufferID = 0;
+
+		/**
+		 * The mapped memory of the whole buffer
+		 */
+		std::uint8_t* mapping = nullptr;
+
+		/**
+		 * The buffer size, in bytes
+		 */
+		GLsizeiptr size;
+
+		/**
+		 * The size of every segment, in bytes
+		 */
+		GLsizeiptr segmentSize;
+
+		/**
+		 * The offset of the next allocation
+		 */
+		GLsizeiptr head = 0;
+
+		/**
+		 * The segment <tt>head</tt> is in, or <tt>fences.size()</tt> right after wrapping
+		 */
+		std::size_t currentSegment = 0;
+
+		/**
+		 * The fence that protects every segment. Null if the GPU is known to be done with it.
+		 */
+		std::vector<GLsync> fences;
+
+		/**
+		 * The segments written since the last call to <tt>fence</tt>
+		 */
+		std::vector<bool> pending;
+
+		/**
+		 * The number of times the CPU had to wait for the GPU
+		 */
+		unsigned int stalls = 0;
+
+	public:
+		/**
+		 * Creates a new ring buffer. Does nothing if persistent mapping is not supported.
+		 *
+		 * @param size the buffer size, in bytes
+		 * @param segments the number of segments the buffer is split in
+		 */
+		explicit OpenGLRingBuffer(GLsizeiptr size, std::size_t segments = 8);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLRingBuffer(const OpenGLRingBuffer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLRingBuffer& operator=(const OpenGLRingBuffer& other) = delete;
+
+		/**
+		 * Unmaps and destroys the buffer
+		 */
+		~OpenGLRingBuffer();
+
+	public:
+		/**
+		 * @return true if the driver supports persistently mapped buffers
+		 */
+		static bool isSupported();
+
+		/**
+		 * Allocates a region of the buffer, waiting for the GPU if the region is
+		 * still in use
+		 *
+		 * @param size the region size, in bytes
+		 * @param alignment the alignment of the region offset, in bytes
+		 *
+		 * @return the allocated region. The pointer is null if the buffer is not
+		 * supported or smaller than <tt>size</tt>.
+		 */
+		Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+
+		/**
+		 * Protects every segment written since the last call with a fence. Must
+		 * be called after the commands that consume the allocations are submitted.
+		 */
+		void fence();
+
+	public:
+		/**
+		 * @return the OpenGL buffer handle, or 0 if the buffer is not supported
+		 */
+		GLuint getBufferID() const;
+
+		/**
+		 * @return the buffer size, in bytes
+		 */
+		GLsizeiptr getSize() const;
+
+		/**
+		 * @return the size of every segment, in bytes. Allocations up to this
+		 * size never stall on more than one segment.
+		 */
+		GLsizeiptr getSegmentSize() const;
+
+		/**
+		 * @return the number of times the CPU had to wait for the GPU
+		 */
+		unsigned int getStallCount() const;
+
+	private:
+		/**
+		 * Waits until the GPU is done with a segment
+		 *
+		 * @param segment the segment index
+		 */
+		void wait(std::size_t segment);
+
+	};
+
+}
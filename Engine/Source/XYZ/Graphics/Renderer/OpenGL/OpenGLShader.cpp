@@ -5,8 +5,10 @@
 #include "OpenGLShader.hpp"
 
 #include "OpenGLTexture.hpp"
+#include "OpenGLStateCache.hpp"
 
 #include <GL/glew.h>
+#include <algorithm>
 #include <string>
 #include <iostream>
 
@@ -61,6 +63,15 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	template<typename ShaderType>
 	OpenGLShader<ShaderType>& OpenGLShader<ShaderType>::operator=(OpenGLShader&& other) {
+		if(this == &other) {
+			return *this;
+		}
+
+		// release the shader being replaced
+		if(shaderID != 0) {
+			glDeleteShader(shaderID);
+		}
+
 		shaderID = other.shaderID;
 		other.shaderID = 0;
 		return *this;
@@ -106,6 +117,9 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		if(geometryShader.shaderID != 0) {
 			glAttachShader(programID, geometryShader.shaderID);
 		}
+
+		// allow the linked program to be stored on the shader cache
+		glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(programID);
 
 		// Check the program
@@ -127,21 +141,54 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		if(geometryShader.shaderID != 0) {
 			glDetachShader(programID, geometryShader.shaderID);
 		}
+
+		if(result == GL_TRUE) {
+			cacheUniformLocations();
+		}
 	}
 
 	OpenGLShaderProgram::OpenGLShaderProgram(const Shader::ShaderBinary& binary) {
 		programID = glCreateProgram();
-		glProgramBinary(programID, *((GLenum*) binary.getBinary().data()), binary.getBinary().data(),
+		if(binary.getSize() <= sizeof(GLenum)) {
+			return;
+		}
+
+		// the binary format is stored ahead of the driver binary, see getShaderBinary()
+		glProgramBinary(programID, *((GLenum*) binary.getBinary().data()), binary.getBinary().data() + sizeof(GLenum),
 						static_cast<GLint>(binary.getBinary().size() - sizeof(GLenum)));
+
+		GLint result = GL_FALSE;
+		glGetProgramiv(programID, GL_LINK_STATUS, &result);
+		if(result == GL_TRUE) {
+			cacheUniformLocations();
+		}
+	}
+
+	OpenGLShaderProgram::OpenGLShaderProgram(GLuint programID) :
+			programID(programID) {
+		if(isLinked()) {
+			cacheUniformLocations();
+		}
 	}
 
 	OpenGLShaderProgram::OpenGLShaderProgram(OpenGLShaderProgram&& other) {
 		programID = other.programID;
+		uniforms = std::move(other.uniforms);
 		other.programID = 0;
 	}
 
 	OpenGLShaderProgram& OpenGLShaderProgram::operator=(OpenGLShaderProgram&& other) {
+		if(this == &other) {
+			return *this;
+		}
+
+		// release the program being replaced
+		if(programID != 0) {
+			glDeleteProgram(programID);
+		}
+
 		programID = other.programID;
+		uniforms = std::move(other.uniforms);
 		other.programID = 0;
 		return *this;
 	}
@@ -155,88 +202,118 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void OpenGLShaderProgram::activate() {
-		glUseProgram(programID);
+		OpenGLStateCache::get().useProgram(programID);
 	}
 
 	void OpenGLShaderProgram::deactivate() {
-		glUseProgram(0);
+		OpenGLStateCache::get().useProgram(0);
+	}
+
+	bool OpenGLShaderProgram::isLinked() const {
+		if(programID == 0) {
+			return false;
+		}
+
+		GLint result = GL_FALSE;
+		glGetProgramiv(programID, GL_LINK_STATUS, &result);
+		return result == GL_TRUE;
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void OpenGLShaderProgram::set(const std::string& name, bool b) {
-		glUniform1i(
-				getUniformLocation(name),
-				b
-		);
+		setUniform(getUniformLocation(name), b);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, float v) {
-		glUniform1f(
-				getUniformLocation(name),
-				v
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, int i) {
-		glUniform1i(
-				getUniformLocation(name),
-				i
-		);
+		setUniform(getUniformLocation(name), i);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, unsigned int i) {
-		glUniform1i(
-				getUniformLocation(name),
-				i
-		);
+		setUniform(getUniformLocation(name), i);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::vec2 v) {
-		glUniform2f(
-				getUniformLocation(name),
-				v[0], v[1]
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::vec3 v) {
-		glUniform3f(
-				getUniformLocation(name),
-				v[0], v[1], v[2]
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::vec4 v) {
-		glUniform4f(
-				getUniformLocation(name),
-				v[0], v[1], v[2], v[3]
-		);
+		setUniform(getUniformLocation(name), v);
+	}
+
+	void OpenGLShaderProgram::set(const std::string& name, glm::uvec3 v) {
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::mat2 v) {
-		glUniformMatrix2fv(
-				getUniformLocation(name),
-				1, GL_FALSE, &v[0][0]
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::mat3 v) {
-		glUniformMatrix3fv(
-				getUniformLocation(name),
-				1, GL_FALSE, &v[0][0]
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	void OpenGLShaderProgram::set(const std::string& name, glm::mat4 v) {
-		glUniformMatrix4fv(
-				getUniformLocation(name),
-				1, GL_FALSE, &v[0][0]
-		);
+		setUniform(getUniformLocation(name), v);
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
-	GLuint OpenGLShaderProgram::getUniformLocation(const std::string& name) {
+	void OpenGLShaderProgram::setUniform(GLint location, bool v) {
+		glUniform1i(location, v);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, float v) {
+		glUniform1f(location, v);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, int v) {
+		glUniform1i(location, v);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, unsigned int v) {
+		glUniform1i(location, v);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::vec2& v) {
+		glUniform2f(location, v[0], v[1]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::vec3& v) {
+		glUniform3f(location, v[0], v[1], v[2]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::vec4& v) {
+		glUniform4f(location, v[0], v[1], v[2], v[3]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::uvec3& v) {
+		glUniform3ui(location, v[0], v[1], v[2]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::mat2& v) {
+		glUniformMatrix2fv(location, 1, GL_FALSE, &v[0][0]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::mat3& v) {
+		glUniformMatrix3fv(location, 1, GL_FALSE, &v[0][0]);
+	}
+
+	void OpenGLShaderProgram::setUniform(GLint location, const glm::mat4& v) {
+		glUniformMatrix4fv(location, 1, GL_FALSE, &v[0][0]);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	GLint OpenGLShaderProgram::getUniformLocation(const std::string& name) {
 		auto found = uniforms.find(name);
 		if(found == uniforms.end()) {
 			found = uniforms.insert(std::make_pair(name, glGetUniformLocation(programID, name.c_str()))).first;
@@ -244,6 +321,32 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		return found->second;
 	}
 
+	void OpenGLShaderProgram::cacheUniformLocations() {
+		GLint count = 0;
+		GLint maximumLength = 0;
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maximumLength);
+
+		std::string name;
+		for(GLint i = 0; i < count; i++) {
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+
+			name.resize((std::size_t) std::max(maximumLength, 1));
+			glGetActiveUniform(programID, (GLuint) i, maximumLength, &length, &size, &type, &name[0]);
+			name.resize((std::size_t) length);
+
+			GLint location = glGetUniformLocation(programID, name.c_str());
+			uniforms[name] = location;
+
+			// arrays are reported as "name[0]" but are usually set by their plain name
+			if(name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+				uniforms[name.substr(0, name.size() - 3)] = location;
+			}
+		}
+	}
+
 	// -----------------------------------------------------------------------------------------------------------------
 
 	Shader::ShaderBinary OpenGLShaderProgram::getShaderBinary() const {
@@ -104,6 +104,27 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	 */
 	using OpenGLGeometryShader = OpenGLShader<Shader::GeometryShader>;
 
+	/**
+	 * A typed handle to a uniform variable of a shader program.
+	 *
+	 * Handles are resolved once, usually right after the program is created, and
+	 * setting a uniform through a handle does not perform any name lookup.
+	 *
+	 * @tparam T the uniform value type
+	 */
+	template<typename T>
+	struct OpenGLUniform {
+		/**
+		 * The uniform value type
+		 */
+		using Type = T;
+
+		/**
+		 * The uniform location or -1 if the uniform is not active in the program
+		 */
+		GLint location = -1;
+	};
+
 	/**
 	 * A fully compiled and linked OpenGL shader program
 	 */
@@ -115,9 +136,10 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		GLuint programID;
 
 		/**
-		 * A cache of all uniform variables indexes for this shader program
+		 * A cache of all uniform variables indexes for this shader program.
+		 * Filled with every active uniform when the program is linked.
 		 */
-		std::unordered_map<std::string, GLuint> uniforms;
+		std::unordered_map<std::string, GLint> uniforms;
 
 	public:
 		/**
@@ -143,6 +165,13 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		OpenGLShaderProgram(const Shader::ShaderBinary& binary);
 
+		/**
+		 * Takes ownership of a already linked OpenGL program
+		 *
+		 * @param programID the OpenGL program handle
+		 */
+		explicit OpenGLShaderProgram(GLuint programID);
+
 		/**
 		 * Deleted copy constructor
 		 *
@@ -191,6 +220,12 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		virtual void deactivate() override;
 
+		/**
+		 * @return true if the program was successfully linked, either from sources or
+		 * from a shader binary
+		 */
+		bool isLinked() const;
+
 	public:
 		/**
 		 * Sets a boolean uniform variable
@@ -248,6 +283,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		virtual void set(const std::string& name, glm::vec4 v) override;
 
+		/**
+		 * Sets a uvec3 uniform variable
+		 *
+		 * @param name the uniform name
+		 * @param v the uniform value
+		 */
+		virtual void set(const std::string& name, glm::uvec3 v) override;
+
 		/**
 		 * Sets a mat2 uniform variable
 		 *
@@ -283,11 +326,40 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		template<typename T>
 		void set(const std::string& name, unsigned int position, const OpenGLUniformBuffer<T>& uniformBuffer) {
-			unsigned int index = glGetUniformBlockIndex(programID, "ViewProjection");
+			unsigned int index = glGetUniformBlockIndex(programID, name.c_str());
 			glUniformBlockBinding(programID, index, position);
 			glBindBufferRange(GL_UNIFORM_BUFFER, position, uniformBuffer, 0, sizeof(T));
 		}
 
+	public:
+		/**
+		 * Gets a handle to a uniform variable. The handle remains valid for as long
+		 * as the program is not relinked.
+		 *
+		 * @tparam T the uniform value type
+		 *
+		 * @param name the uniform name
+		 *
+		 * @return the uniform handle
+		 */
+		template<typename T>
+		OpenGLUniform<T> getUniform(const std::string& name) {
+			return OpenGLUniform<T>{getUniformLocation(name)};
+		}
+
+		/**
+		 * Sets a uniform variable through a handle. The program must be active.
+		 *
+		 * @tparam T the uniform value type
+		 *
+		 * @param uniform the uniform handle
+		 * @param v the uniform value
+		 */
+		template<typename T>
+		void set(const OpenGLUniform<T>& uniform, const typename OpenGLUniform<T>::Type& v) {
+			setUniform(uniform.location, v);
+		}
+
 	public:
 		/**
 		 * @return the shader binary
@@ -304,7 +376,31 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 * @return the uniform location as returned by
 		 * <tt>glGetUniformLocation</tt>
 		 */
-		GLuint getUniformLocation(const std::string& name);
+		GLint getUniformLocation(const std::string& name);
+
+		/**
+		 * Fills the uniform location cache with every active uniform of the
+		 * linked program
+		 */
+		void cacheUniformLocations();
+
+		/**
+		 * Sets the value of the uniform at <tt>location</tt> on the active program
+		 *
+		 * @param location the uniform location
+		 * @param v the uniform value
+		 */
+		static void setUniform(GLint location, bool v);
+		static void setUniform(GLint location, float v);
+		static void setUniform(GLint location, int v);
+		static void setUniform(GLint location, unsigned int v);
+		static void setUniform(GLint location, const glm::vec2& v);
+		static void setUniform(GLint location, const glm::vec3& v);
+		static void setUniform(GLint location, const glm::vec4& v);
+		static void setUniform(GLint location, const glm::uvec3& v);
+		static void setUniform(GLint location, const glm::mat2& v);
+		static void setUniform(GLint location, const glm::mat3& v);
+		static void setUniform(GLint location, const glm::mat4& v);
 
 	};
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
 
 namespace XYZ::Graphics::Renderer::OpenGL {
@@ -19,5 +20,49 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		OpenGLCamera camera;
 	};
 
+	/**
+	 * The parameters of a shadow casting spot light, laid out as the
+	 * <tt>SpotLight</tt> struct of the std140 <tt>SpotLights</tt> shader block
+	 */
+	struct alignas(16) OpenGLSpotLight {
+		alignas(16) glm::vec3 position;
+		float cutOff;
+
+		alignas(16) glm::vec3 direction;
+		float outerCutOff;
+
+		alignas(16) glm::vec3 ambient;
+		float constant;
+
+		alignas(16) glm::vec3 diffuse;
+		float linear;
+
+		alignas(16) glm::vec3 specular;
+		float quadratic;
+
+		alignas(16) glm::mat4 lightSpaceMatrix;
+		float shadowOcclusionStrength;
+
+		/**
+		 * The light tile on the shadow atlas: the origin and the size, in texture coordinates
+		 */
+		alignas(16) glm::vec4 shadowMapTile;
+	};
+
+	/**
+	 * The std140 <tt>SpotLights</tt> shader block, holding the parameters of every
+	 * shadow casting spot light shaded on a frame
+	 */
+	struct OpenGLSpotLights {
+		/**
+		 * The maximum number of shadow casting spot lights shaded on a single frame
+		 */
+		static constexpr unsigned int MAX_LIGHTS = 32;
+
+		OpenGLSpotLight lights[MAX_LIGHTS];
+	};
+
+	static_assert(sizeof(OpenGLSpotLight) == 176, "OpenGLSpotLight does not match the std140 layout");
+
 }
 
@@ -0,0 +1,226 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLShaderCache.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <sys/stat.h>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * The header written at the start of every cache file
+	 */
+	struct OpenGLShaderCacheHeader {
+		char magic[4];
+		std::uint32_t version;
+		std::uint64_t key;
+		std::uint64_t checksum;
+		std::uint64_t size;
+	};
+
+	static const char SHADER_CACHE_MAGIC[4] = {'X', 'Y', 'Z', 'S'};
+
+	static std::uint64_t hash(std::uint64_t hash, const void* data, std::size_t length) {
+		// 64-bit FNV-1a
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for(std::size_t i = 0; i < length; i++) {
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	static std::uint64_t hash(std::uint64_t value, const std::string& string) {
+		// hash the length too so that the boundary between strings is part of the key
+		std::uint64_t length = string.size();
+		value = hash(value, &length, sizeof(length));
+		return hash(value, string.data(), string.size());
+	}
+
+	static std::uint64_t checksum(std::uint64_t value, const std::string& string) {
+		// a polynomial hash, unrelated to FNV-1a, so that a key collision is
+		// unlikely to also be a checksum collision
+		value = value * 0x9e3779b97f4a7c15ull + string.size();
+		for(auto character : string) {
+			value = value * 0x9e3779b97f4a7c15ull + static_cast<unsigned char>(character) + 1;
+		}
+		return value;
+	}
+
+	static std::string getString(GLenum name) {
+		const auto* string = reinterpret_cast<const char*>(glGetString(name));
+		return string == nullptr ? std::string() : std::string(string);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLShaderCache::OpenGLShaderCache(std::string directory) : directory(std::move(directory)) {
+		if(!OpenGLShaderCache::directory.empty()) {
+			::mkdir(OpenGLShaderCache::directory.c_str(), 0755);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLShaderProgram OpenGLShaderCache::load(const Shader::ShaderSource& vertexSource,
+												const Shader::ShaderSource& fragmentSource,
+												const Shader::ShaderSource* geometrySource) {
+		auto cached = loadBinary(vertexSource, fragmentSource, geometrySource);
+		if(cached.isLinked()) {
+			return cached;
+		}
+
+		OpenGLShaderProgram program(
+				OpenGLVertexShader(vertexSource),
+				OpenGLFragmentShader(fragmentSource),
+				geometrySource != nullptr ? OpenGLGeometryShader(*geometrySource) : OpenGLGeometryShader()
+		);
+		store(vertexSource, fragmentSource, geometrySource, program);
+		return program;
+	}
+
+	OpenGLShaderProgram OpenGLShaderCache::loadBinary(const Shader::ShaderSource& vertexSource,
+													  const Shader::ShaderSource& fragmentSource,
+													  const Shader::ShaderSource* geometrySource) {
+		if(!directory.empty()) {
+			auto key = computeKey(vertexSource, fragmentSource, geometrySource);
+			if(auto binary = read(key, computeChecksum(vertexSource, fragmentSource, geometrySource))) {
+				OpenGLShaderProgram program(binary);
+				if(program.isLinked()) {
+					hitCount++;
+					return program;
+				}
+				// the driver rejected the binary, probably because it was updated
+			}
+		}
+
+		missCount++;
+		return OpenGLShaderProgram();
+	}
+
+	void OpenGLShaderCache::store(const Shader::ShaderSource& vertexSource,
+								  const Shader::ShaderSource& fragmentSource,
+								  const Shader::ShaderSource* geometrySource,
+								  const OpenGLShaderProgram& program) {
+		if(directory.empty() || !program.isLinked()) {
+			return;
+		}
+		write(computeKey(vertexSource, fragmentSource, geometrySource),
+			  computeChecksum(vertexSource, fragmentSource, geometrySource), program.getShaderBinary());
+	}
+
+	std::uint64_t OpenGLShaderCache::computeKey(const Shader::ShaderSource& vertexSource,
+												const Shader::ShaderSource& fragmentSource,
+												const Shader::ShaderSource* geometrySource) {
+		if(driver.empty()) {
+			driver = getString(GL_VENDOR) + "\n" + getString(GL_RENDERER) + "\n" + getString(GL_VERSION);
+		}
+
+		std::uint64_t key = 0xcbf29ce484222325ull;
+		key = hash(key, &VERSION, sizeof(VERSION));
+		key = hash(key, driver);
+		key = hash(key, vertexSource.getSource());
+		key = hash(key, fragmentSource.getSource());
+		key = hash(key, geometrySource != nullptr ? geometrySource->getSource() : std::string());
+		return key;
+	}
+
+	std::uint64_t OpenGLShaderCache::computeChecksum(const Shader::ShaderSource& vertexSource,
+													 const Shader::ShaderSource& fragmentSource,
+													 const Shader::ShaderSource* geometrySource) {
+		// the driver strings were queried by computeKey
+		std::uint64_t value = VERSION;
+		value = checksum(value, driver);
+		value = checksum(value, vertexSource.getSource());
+		value = checksum(value, fragmentSource.getSource());
+		value = checksum(value, geometrySource != nullptr ? geometrySource->getSource() : std::string());
+		return value;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const std::string& OpenGLShaderCache::getDirectory() const {
+		return directory;
+	}
+
+	unsigned int OpenGLShaderCache::getHitCount() const {
+		return hitCount;
+	}
+
+	unsigned int OpenGLShaderCache::getMissCount() const {
+		return missCount;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::string OpenGLShaderCache::getPath(std::uint64_t key) const {
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+		return directory + "/" + name;
+	}
+
+	Shader::ShaderBinary OpenGLShaderCache::read(std::uint64_t key, std::uint64_t checksum) const {
+		std::ifstream stream(getPath(key), std::ios::binary | std::ios::ate);
+		if(!stream) {
+			return {};
+		}
+
+		auto fileSize = std::uint64_t(stream.tellg());
+		stream.seekg(0);
+
+		OpenGLShaderCacheHeader header;
+		if(!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+			return {};
+		}
+
+		// a file from another cache version or from another program whose key
+		// collides is treated as a miss. A size past the end of the file means
+		// the entry is corrupt.
+		if(std::char_traits<char>::compare(header.magic, SHADER_CACHE_MAGIC, sizeof(SHADER_CACHE_MAGIC)) != 0 ||
+		   header.version != VERSION || header.key != key || header.checksum != checksum || header.size == 0 ||
+		   header.size > fileSize - sizeof(header)) {
+			return {};
+		}
+
+		Shader::ShaderBinary::BinaryBuffer binary(header.size);
+		if(!stream.read(binary.data(), std::streamsize(binary.size()))) {
+			return {};
+		}
+		return Shader::ShaderBinary(std::move(binary));
+	}
+
+	void OpenGLShaderCache::write(std::uint64_t key, std::uint64_t checksum,
+								  const Shader::ShaderBinary& binary) const {
+		if(!binary) {
+			return;
+		}
+
+		OpenGLShaderCacheHeader header;
+		std::char_traits<char>::copy(header.magic, SHADER_CACHE_MAGIC, sizeof(SHADER_CACHE_MAGIC));
+		header.version = VERSION;
+		header.key = key;
+		header.checksum = checksum;
+		header.size = binary.getSize();
+
+		// write to a temporary file first so that a interrupted write never leaves
+		// a truncated entry behind
+		auto path = getPath(key);
+		auto temporaryPath = path + ".tmp";
+		{
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(binary.getBinary().data(), std::streamsize(binary.getSize()));
+			if(!stream) {
+				stream.close();
+				std::remove(temporaryPath.c_str());
+				return;
+			}
+		}
+		std::rename(temporaryPath.c_str(), path.c_str());
+	}
+
+}
@@ -0,0 +1,185 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "OpenGLShader.hpp"
+
+#include "XYZ/Graphics/Shader/ShaderSource.hpp"
+#include "XYZ/Graphics/Shader/ShaderBinary.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A persistent cache of linked shader program binaries.
+	 *
+	 * Programs are keyed by a hash of their shader sources and of the OpenGL
+	 * vendor, renderer and version strings, and are stored as one file per program
+	 * in the cache directory. A program found on the cache is loaded with
+	 * <tt>glProgramBinary</tt>. If the binary is missing or the driver rejects it
+	 * the program is compiled from its sources and the cache entry is replaced.
+	 *
+	 * A cache without a directory always compiles from sources.
+	 */
+	class OpenGLShaderCache {
+	public:
+		/**
+		 * The version of the cache file format. Must be increased whenever the
+		 * format or the key computation changes.
+		 */
+		static constexpr std::uint32_t VERSION = 2;
+
+	private:
+		/**
+		 * The directory where the program binaries are stored
+		 */
+		std::string directory;
+
+		/**
+		 * The OpenGL vendor, renderer and version strings. Queried on the first
+		 * program load, once a context is guaranteed to exist.
+		 */
+		std::string driver;
+
+		/**
+		 * The number of programs loaded from the cache
+		 */
+		unsigned int hitCount = 0;
+
+		/**
+		 * The number of programs compiled from sources
+		 */
+		unsigned int missCount = 0;
+
+	public:
+		/**
+		 * Creates a new shader cache
+		 *
+		 * @param directory the directory where the program binaries are stored. It
+		 * is created if it does not exist. If empty, nothing is cached.
+		 */
+		explicit OpenGLShaderCache(std::string directory = "");
+
+	public:
+		/**
+		 * Loads a shader program from the cache or compiles it from its sources.
+		 *
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param geometrySource the geometry shader source or <tt>nullptr</tt> if the
+		 * program has no geometry shader
+		 *
+		 * @return the linked shader program
+		 */
+		OpenGLShaderProgram load(const Shader::ShaderSource& vertexSource,
+								 const Shader::ShaderSource& fragmentSource,
+								 const Shader::ShaderSource* geometrySource = nullptr);
+
+		/**
+		 * Loads a shader program from the cache, without ever compiling it.
+		 *
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param geometrySource the geometry shader source or <tt>nullptr</tt>
+		 *
+		 * @return the cached program or a program that is not linked if the program
+		 * is not on the cache
+		 */
+		OpenGLShaderProgram loadBinary(const Shader::ShaderSource& vertexSource,
+									   const Shader::ShaderSource& fragmentSource,
+									   const Shader::ShaderSource* geometrySource = nullptr);
+
+		/**
+		 * Stores a linked program on the cache. Programs that are not linked are
+		 * ignored.
+		 *
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param geometrySource the geometry shader source or <tt>nullptr</tt>
+		 * @param program the program compiled from the sources
+		 */
+		void store(const Shader::ShaderSource& vertexSource,
+				   const Shader::ShaderSource& fragmentSource,
+				   const Shader::ShaderSource* geometrySource,
+				   const OpenGLShaderProgram& program);
+
+		/**
+		 * Computes the cache key of a program
+		 *
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param geometrySource the geometry shader source or <tt>nullptr</tt>
+		 *
+		 * @return the program cache key
+		 */
+		std::uint64_t computeKey(const Shader::ShaderSource& vertexSource,
+								 const Shader::ShaderSource& fragmentSource,
+								 const Shader::ShaderSource* geometrySource);
+
+		/**
+		 * Computes a checksum of a program, with a hash independent of the one
+		 * used for the key. Stored next to the binary to detect key collisions.
+		 * Must be called after <tt>computeKey</tt>.
+		 *
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param geometrySource the geometry shader source or <tt>nullptr</tt>
+		 *
+		 * @return the program checksum
+		 */
+		std::uint64_t computeChecksum(const Shader::ShaderSource& vertexSource,
+									  const Shader::ShaderSource& fragmentSource,
+									  const Shader::ShaderSource* geometrySource);
+
+	public:
+		/**
+		 * @return the directory where the program binaries are stored
+		 */
+		const std::string& getDirectory() const;
+
+		/**
+		 * @return the number of programs loaded from the cache
+		 */
+		unsigned int getHitCount() const;
+
+		/**
+		 * @return the number of programs compiled from sources
+		 */
+		unsigned int getMissCount() const;
+
+	private:
+		/**
+		 * @param key the program cache key
+		 *
+		 * @return the path of the cache file of the program
+		 */
+		std::string getPath(std::uint64_t key) const;
+
+		/**
+		 * Reads a program binary from the cache
+		 *
+		 * @param key the program cache key
+		 * @param checksum the program checksum
+		 *
+		 * @return the program binary or a invalid binary if the program is not on
+		 * the cache or the cache file is not usable
+		 */
+		Shader::ShaderBinary read(std::uint64_t key, std::uint64_t checksum) const;
+
+		/**
+		 * Writes a program binary to the cache. Failures are ignored, the program
+		 * will simply be compiled again on the next run.
+		 *
+		 * @param key the program cache key
+		 * @param checksum the program checksum
+		 * @param binary the program binary
+		 */
+		void write(std::uint64_t key, std::uint64_t checksum, const Shader::ShaderBinary& binary) const;
+
+	};
+
+}
@@ -0,0 +1,250 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLShaderVariants.hpp"
+
+#include <iostream>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	static std::string addDefines(const std::string& source, const std::string& defines) {
+		// the defines must come right after the #version directive
+		auto position = source.find("#version");
+		if(position == std::string::npos) {
+			return defines + source;
+		}
+
+		position = source.find('\n', position);
+		if(position == std::string::npos) {
+			return source + "\n" + defines;
+		}
+		return source.substr(0, position + 1) + defines + source.substr(position + 1);
+	}
+
+	static bool isParallelCompileSupported() {
+		return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+	}
+
+	static GLuint startCompile(GLenum type, const std::string& source) {
+		GLuint shaderID = glCreateShader(type);
+		const char* sourcePointer = source.c_str();
+		glShaderSource(shaderID, 1, &sourcePointer, nullptr);
+		glCompileShader(shaderID);
+		return shaderID;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLShaderVariants::OpenGLShaderVariants(OpenGLShaderCache& cache,
+											   Shader::ShaderSource vertexSource,
+											   Shader::ShaderSource fragmentSource,
+											   std::vector<std::string> features,
+											   Initializer initializer) :
+			cache(cache),
+			vertexSource(std::move(vertexSource)),
+			fragmentSource(std::move(fragmentSource)),
+			features(std::move(features)),
+			initializer(std::move(initializer)),
+			generic(cache.load(OpenGLShaderVariants::vertexSource, OpenGLShaderVariants::fragmentSource)) {
+		if(OpenGLShaderVariants::initializer) {
+			OpenGLShaderVariants::initializer(generic);
+		}
+		programs.push_back(&generic);
+	}
+
+	OpenGLShaderVariants::~OpenGLShaderVariants() {
+		for(auto& entry : variants) {
+			auto& variant = entry.second;
+			if(variant.state != VariantState::COMPILING) {
+				continue;
+			}
+
+			glDeleteShader(variant.vertexShaderID);
+			glDeleteShader(variant.fragmentShaderID);
+			glDeleteProgram(variant.programID);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLShaderVariants::warmUp(FeatureMask features) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto& variant = variants[features];
+		if(variant.state == VariantState::READY || variant.state == VariantState::FAILED) {
+			return;
+		}
+
+		if(variant.state == VariantState::QUEUED) {
+			prepare(variant, features);
+			finish(variant, cache.load(*variant.vertexSource, *variant.fragmentSource));
+		} else {
+			collect(variant, true);
+		}
+	}
+
+	OpenGLShaderProgram& OpenGLShaderVariants::find(FeatureMask features) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto found = variants.find(features);
+		if(found == variants.end()) {
+			// queued, update() will compile it
+			variants[features];
+			return generic;
+		}
+
+		if(found->second.state == VariantState::READY) {
+			return *found->second.program;
+		}
+		return generic;
+	}
+
+	void OpenGLShaderVariants::update() {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		bool parallel = isParallelCompileSupported();
+		bool compiling = false;
+
+		for(auto& entry : variants) {
+			auto& variant = entry.second;
+			if(variant.state == VariantState::COMPILING) {
+				// without the parallel compile extension, the status query waits for the driver
+				collect(variant, !parallel);
+				compiling = compiling || variant.state == VariantState::COMPILING;
+			}
+		}
+
+		for(auto& entry : variants) {
+			auto& variant = entry.second;
+			if(variant.state != VariantState::QUEUED) {
+				continue;
+			}
+
+			// without the parallel compile extension, start one variant per frame
+			if(!parallel && compiling) {
+				break;
+			}
+
+			prepare(variant, entry.first);
+
+			// a cached binary is loaded right away, it does not need to be compiled
+			auto program = cache.loadBinary(*variant.vertexSource, *variant.fragmentSource);
+			if(program.isLinked()) {
+				finish(variant, std::move(program));
+				continue;
+			}
+
+			start(variant);
+			compiling = true;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLShaderProgram& OpenGLShaderVariants::getGeneric() {
+		return generic;
+	}
+
+	const std::vector<OpenGLShaderProgram*>& OpenGLShaderVariants::getPrograms() const {
+		return programs;
+	}
+
+	std::size_t OpenGLShaderVariants::getPendingCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		std::size_t count = 0;
+		for(const auto& entry : variants) {
+			if(entry.second.state == VariantState::QUEUED || entry.second.state == VariantState::COMPILING) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLShaderVariants::prepare(Variant& variant, FeatureMask mask) const {
+		std::string defines = "#define SHADER_VARIANT\n";
+		for(std::size_t i = 0; i < features.size(); i++) {
+			if(mask & (FeatureMask(1) << i)) {
+				defines += "#define " + features[i] + "\n";
+			}
+		}
+
+		variant.vertexSource = std::make_unique<Shader::ShaderSource>(addDefines(vertexSource.getSource(), defines));
+		variant.fragmentSource = std::make_unique<Shader::ShaderSource>(
+				addDefines(fragmentSource.getSource(), defines)
+		);
+	}
+
+	void OpenGLShaderVariants::finish(Variant& variant, OpenGLShaderProgram program) {
+		if(!program.isLinked()) {
+			variant.state = VariantState::FAILED;
+			return;
+		}
+
+		variant.program = std::make_unique<OpenGLShaderProgram>(std::move(program));
+		variant.state = VariantState::READY;
+
+		if(initializer) {
+			initializer(*variant.program);
+		}
+		programs.push_back(variant.program.get());
+	}
+
+	void OpenGLShaderVariants::start(Variant& variant) {
+		variant.vertexShaderID = startCompile(GL_VERTEX_SHADER, variant.vertexSource->getSource());
+		variant.fragmentShaderID = startCompile(GL_FRAGMENT_SHADER, variant.fragmentSource->getSource());
+
+		variant.programID = glCreateProgram();
+		glAttachShader(variant.programID, variant.vertexShaderID);
+		glAttachShader(variant.programID, variant.fragmentShaderID);
+		glProgramParameteri(variant.programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(variant.programID);
+
+		variant.state = VariantState::COMPILING;
+	}
+
+	bool OpenGLShaderVariants::collect(Variant& variant, bool wait) {
+		if(!wait) {
+			GLint completed = GL_FALSE;
+			glGetProgramiv(variant.programID, GL_COMPLETION_STATUS_KHR, &completed);
+			if(completed == GL_FALSE) {
+				return false;
+			}
+		}
+
+		glDetachShader(variant.programID, variant.vertexShaderID);
+		glDetachShader(variant.programID, variant.fragmentShaderID);
+		glDeleteShader(variant.vertexShaderID);
+		glDeleteShader(variant.fragmentShaderID);
+		variant.vertexShaderID = 0;
+		variant.fragmentShaderID = 0;
+
+		OpenGLShaderProgram program(variant.programID);
+		variant.programID = 0;
+
+		if(!program.isLinked()) {
+			int infoLogLength = 0;
+			glGetProgramiv(program.programID, GL_INFO_LOG_LENGTH, &infoLogLength);
+			if(infoLogLength > 0) {
+				std::string errorMessage;
+				errorMessage.resize((unsigned int) infoLogLength - 1);
+
+				glGetProgramInfoLog(program.programID, infoLogLength, nullptr, &errorMessage[0]);
+				std::cout << errorMessage << std::endl;
+			}
+		} else {
+			cache.store(*variant.vertexSource, *variant.fragmentSource, nullptr, program);
+		}
+
+		finish(variant, std::move(program));
+		return true;
+	}
+
+}
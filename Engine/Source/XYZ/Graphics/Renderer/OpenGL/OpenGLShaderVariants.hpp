@@ -0,0 +1,269 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "OpenGLShader.hpp"
+#include "OpenGLShaderCache.hpp"
+
+#include "XYZ/Graphics/Shader/ShaderSource.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A family of shader programs compiled from the same sources with different
+	 * sets of preprocessor defines.
+	 *
+	 * Every variant is identified by a feature mask: bit <tt>i</tt> set adds a
+	 * <tt>#define</tt> of the i-th feature name to both shaders. Variants are also
+	 * compiled with <tt>SHADER_VARIANT</tt> defined, so that the sources can tell
+	 * them apart from the generic program. The generic program is compiled without
+	 * any define and must handle every feature combination at runtime, usually by
+	 * branching on uniforms.
+	 *
+	 * <tt>find</tt> never compiles anything: if the requested variant is not ready
+	 * it returns the generic program and queues the variant. Queued variants are
+	 * compiled by <tt>update</tt> without waiting for the driver: with
+	 * <tt>KHR_parallel_shader_compile</tt> the driver compiles them on its own
+	 * threads and <tt>update</tt> only polls for completion. Without the extension
+	 * a single variant is started per update and collected on the next one, which
+	 * still lets drivers with threaded compilation hide most of the cost.
+	 *
+	 * Variants known at load time should be compiled with <tt>warmUp</tt>.
+	 */
+	class OpenGLShaderVariants {
+	public:
+		/**
+		 * A bit mask of enabled features
+		 */
+		using FeatureMask = std::uint32_t;
+
+		/**
+		 * A function called for every program that becomes ready. Used to set the
+		 * uniforms that never change, like sampler units.
+		 */
+		using Initializer = std::function<void(OpenGLShaderProgram& program)>;
+
+	private:
+		/**
+		 * The state of a variant
+		 */
+		enum class VariantState {
+			/**
+			 * Requested by <tt>find</tt> and waiting to be compiled
+			 */
+			QUEUED,
+
+			/**
+			 * Being compiled and linked by the driver
+			 */
+			COMPILING,
+
+			/**
+			 * Linked and ready to be used
+			 */
+			READY,
+
+			/**
+			 * Failed to compile or link. The generic program is used instead.
+			 */
+			FAILED
+		};
+
+		/**
+		 * A variant of the program family
+		 */
+		struct Variant {
+			/**
+			 * The variant state
+			 */
+			VariantState state = VariantState::QUEUED;
+
+			/**
+			 * The variant sources, with the feature defines
+			 */
+			std::unique_ptr<Shader::ShaderSource> vertexSource;
+			std::unique_ptr<Shader::ShaderSource> fragmentSource;
+
+			/**
+			 * The shaders and program being compiled while the variant is <tt>COMPILING</tt>
+			 */
+			GLuint vertexShaderID = 0;
+			GLuint fragmentShaderID = 0;
+			GLuint programID = 0;
+
+			/**
+			 * The linked program, once the variant is <tt>READY</tt>
+			 */
+			std::unique_ptr<OpenGLShaderProgram> program;
+		};
+
+	private:
+		/**
+		 * The cache variants are loaded from and stored to
+		 */
+		OpenGLShaderCache& cache;
+
+		/**
+		 * The sources without any define
+		 */
+		Shader::ShaderSource vertexSource;
+		Shader::ShaderSource fragmentSource;
+
+		/**
+		 * The define name of every feature bit
+		 */
+		std::vector<std::string> features;
+
+		/**
+		 * The function called for every program that becomes ready
+		 */
+		Initializer initializer;
+
+		/**
+		 * The generic program, used while a variant is not ready
+		 */
+		OpenGLShaderProgram generic;
+
+		/**
+		 * The variants requested so far, keyed by feature mask
+		 */
+		std::unordered_map<FeatureMask, Variant> variants;
+
+		/**
+		 * The ready programs, including the generic one
+		 */
+		std::vector<OpenGLShaderProgram*> programs;
+
+		/**
+		 * A mutex guarding <tt>variants</tt>, <tt>find</tt> is called from the culling jobs
+		 */
+		mutable std::mutex mutex;
+
+	public:
+		/**
+		 * Creates a new program family and compiles the generic program
+		 *
+		 * @param cache the cache variants are loaded from and stored to
+		 * @param vertexSource the vertex shader source
+		 * @param fragmentSource the fragment shader source
+		 * @param features the define name of every feature bit
+		 * @param initializer a function called for every program that becomes ready
+		 */
+		OpenGLShaderVariants(OpenGLShaderCache& cache,
+							 Shader::ShaderSource vertexSource,
+							 Shader::ShaderSource fragmentSource,
+							 std::vector<std::string> features,
+							 Initializer initializer = nullptr);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLShaderVariants(const OpenGLShaderVariants& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLShaderVariants& operator=(const OpenGLShaderVariants& other) = delete;
+
+		/**
+		 * Destroys the program family and every program still being compiled
+		 */
+		~OpenGLShaderVariants();
+
+	public:
+		/**
+		 * Compiles a variant right away, blocking until it is linked. Meant to be
+		 * called at load time for the variants known to be used.
+		 *
+		 * @param features the variant feature mask
+		 */
+		void warmUp(FeatureMask features);
+
+		/**
+		 * Finds a variant. If the variant is not ready yet, it is queued to be
+		 * compiled by the next <tt>update</tt> and the generic program is returned.
+		 *
+		 * This method does not call OpenGL and can be called from any thread.
+		 *
+		 * @param features the variant feature mask
+		 *
+		 * @return the variant program or the generic program
+		 */
+		OpenGLShaderProgram& find(FeatureMask features);
+
+		/**
+		 * Starts compiling the queued variants and collects the ones the driver has
+		 * finished. Must be called from the rendering thread, once per frame.
+		 */
+		void update();
+
+	public:
+		/**
+		 * @return the generic program
+		 */
+		OpenGLShaderProgram& getGeneric();
+
+		/**
+		 * @return the generic program and every ready variant. Used to set uniforms
+		 * that are shared by the whole family.
+		 */
+		const std::vector<OpenGLShaderProgram*>& getPrograms() const;
+
+		/**
+		 * @return the number of variants queued or being compiled
+		 */
+		std::size_t getPendingCount() const;
+
+	private:
+		/**
+		 * Creates the sources of a variant
+		 *
+		 * @param variant the variant
+		 * @param features the variant feature mask
+		 */
+		void prepare(Variant& variant, FeatureMask features) const;
+
+		/**
+		 * Marks a variant as ready and initializes its program
+		 *
+		 * @param variant the variant
+		 * @param program the variant program
+		 */
+		void finish(Variant& variant, OpenGLShaderProgram program);
+
+		/**
+		 * Starts compiling a variant without waiting for the driver
+		 *
+		 * @param variant the variant
+		 */
+		void start(Variant& variant);
+
+		/**
+		 * Checks if the driver finished compiling a variant and collects it
+		 *
+		 * @param variant the variant
+		 * @param wait if true, waits for the driver to finish
+		 *
+		 * @return true if the variant is no longer compiling
+		 */
+		bool collect(Variant& variant, bool wait);
+
+	};
+
+}
@@ -0,0 +1,335 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLStateCache.hpp"
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * @return the index of a texture target in the per-unit bindings, or -1 if it is not tracked
+	 */
+	static int getTextureTargetIndex(GLenum target) {
+		switch(target) {
+			case GL_TEXTURE_2D:
+				return 0;
+			case GL_TEXTURE_2D_ARRAY:
+				return 1;
+			case GL_TEXTURE_CUBE_MAP:
+				return 2;
+			case GL_TEXTURE_BUFFER:
+				return 3;
+			default:
+				return -1;
+		}
+	}
+
+	/**
+	 * @return the index of a capability in the capability states, or -1 if it is not tracked
+	 */
+	static int getCapabilityIndex(GLenum capability) {
+		switch(capability) {
+			case GL_BLEND:
+				return 0;
+			case GL_CULL_FACE:
+				return 1;
+			case GL_DEPTH_TEST:
+				return 2;
+			case GL_DEPTH_CLAMP:
+				return 3;
+			case GL_SCISSOR_TEST:
+				return 4;
+			case GL_MULTISAMPLE:
+				return 5;
+			default:
+				return -1;
+		}
+	}
+
+	/**
+	 * @return the index of a texture parameter in the texture parameters, or -1 if it is not tracked
+	 */
+	static int getTextureParameterIndex(GLenum name) {
+		switch(name) {
+			case GL_TEXTURE_MIN_FILTER:
+				return 0;
+			case GL_TEXTURE_MAG_FILTER:
+				return 1;
+			case GL_TEXTURE_WRAP_S:
+				return 2;
+			case GL_TEXTURE_WRAP_T:
+				return 3;
+			case GL_TEXTURE_WRAP_R:
+				return 4;
+			default:
+				return -1;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLStateCache::OpenGLStateCache() {
+		invalidate();
+	}
+
+	OpenGLStateCache& OpenGLStateCache::get() {
+		static OpenGLStateCache cache;
+		return cache;
+	}
+
+	void OpenGLStateCache::invalidate() {
+		program = UNKNOWN;
+		vertexArray = UNKNOWN;
+		drawFramebuffer = UNKNOWN;
+		readFramebuffer = UNKNOWN;
+		activeTextureUnit = UNKNOWN;
+		for(auto& unit : textures) {
+			unit.fill(UNKNOWN);
+		}
+
+		capabilities.fill(-1);
+		blendFunction.fill(UNKNOWN);
+		cullFaceMode = UNKNOWN;
+		depthFunction = UNKNOWN;
+		viewportRectangle.fill(-1);
+
+		textureParameters.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLStateCache::useProgram(GLuint program) {
+		if(!track(OpenGLStateCache::program != program)) {
+			return;
+		}
+
+		OpenGLStateCache::program = program;
+		glUseProgram(program);
+	}
+
+	void OpenGLStateCache::bindVertexArray(GLuint vertexArray) {
+		if(!track(OpenGLStateCache::vertexArray != vertexArray)) {
+			return;
+		}
+
+		OpenGLStateCache::vertexArray = vertexArray;
+		glBindVertexArray(vertexArray);
+	}
+
+	void OpenGLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+		switch(target) {
+			case GL_DRAW_FRAMEBUFFER:
+				if(!track(drawFramebuffer != framebuffer)) {
+					return;
+				}
+				drawFramebuffer = framebuffer;
+				break;
+
+			case GL_READ_FRAMEBUFFER:
+				if(!track(readFramebuffer != framebuffer)) {
+					return;
+				}
+				readFramebuffer = framebuffer;
+				break;
+
+			default:
+				if(!track(drawFramebuffer != framebuffer || readFramebuffer != framebuffer)) {
+					return;
+				}
+				drawFramebuffer = framebuffer;
+				readFramebuffer = framebuffer;
+				break;
+		}
+
+		glBindFramebuffer(target, framebuffer);
+	}
+
+	void OpenGLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+		auto index = getTextureTargetIndex(target);
+		if(unit < MAX_TEXTURE_UNITS && index >= 0) {
+			if(!track(textures[unit][index] != texture)) {
+				return;
+			}
+			textures[unit][index] = texture;
+		} else {
+			track(true);
+		}
+
+		setActiveTextureUnit(unit);
+		glBindTexture(target, texture);
+	}
+
+	void OpenGLStateCache::bindTexture(GLenum target, GLuint texture) {
+		// editing a texture does not care about the unit, use whatever unit is active
+		if(activeTextureUnit == UNKNOWN) {
+			setActiveTextureUnit(0);
+		}
+		bindTexture(activeTextureUnit, target, texture);
+	}
+
+	void OpenGLStateCache::setTextureParameter(GLenum target, GLuint texture, GLenum name, GLint value) {
+		auto index = getTextureParameterIndex(name);
+		if(index >= 0) {
+			auto& parameters = getTextureParameters(texture);
+			if(!track(parameters[index] != value)) {
+				return;
+			}
+			parameters[index] = value;
+		} else {
+			track(true);
+		}
+
+		bindTexture(target, texture);
+		glTexParameteri(target, name, value);
+	}
+
+	GLint OpenGLStateCache::getTextureParameter(GLenum target, GLuint texture, GLenum name) {
+		auto index = getTextureParameterIndex(name);
+		if(index >= 0) {
+			auto found = textureParameters.find(texture);
+			if(found != textureParameters.end() && found->second[index] != GLint(UNKNOWN)) {
+				track(false);
+				return found->second[index];
+			}
+		}
+
+		track(true);
+		bindTexture(target, texture);
+
+		GLint value = 0;
+		glGetTexParameteriv(target, name, &value);
+		if(index >= 0) {
+			getTextureParameters(texture)[index] = value;
+		}
+		return value;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLStateCache::setEnabled(GLenum capability, bool enabled) {
+		auto index = getCapabilityIndex(capability);
+		if(index >= 0) {
+			if(!track(capabilities[index] != std::int8_t(enabled))) {
+				return;
+			}
+			capabilities[index] = std::int8_t(enabled);
+		} else {
+			track(true);
+		}
+
+		if(enabled) {
+			glEnable(capability);
+		} else {
+			glDisable(capability);
+		}
+	}
+
+	void OpenGLStateCache::setBlendFunction(GLenum source, GLenum destination) {
+		if(!track(blendFunction[0] != source || blendFunction[1] != destination)) {
+			return;
+		}
+
+		blendFunction = {source, destination};
+		glBlendFunc(source, destination);
+	}
+
+	void OpenGLStateCache::setCullFace(GLenum mode) {
+		if(!track(cullFaceMode != mode)) {
+			return;
+		}
+
+		cullFaceMode = mode;
+		glCullFace(mode);
+	}
+
+	void OpenGLStateCache::setDepthFunction(GLenum function) {
+		if(!track(depthFunction != function)) {
+			return;
+		}
+
+		depthFunction = function;
+		glDepthFunc(function);
+	}
+
+	void OpenGLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+		std::array<GLint, 4> rectangle = {x, y, GLint(width), GLint(height)};
+		if(!track(viewportRectangle != rectangle)) {
+			return;
+		}
+
+		viewportRectangle = rectangle;
+		glViewport(x, y, width, height);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLStateCache::deleteVertexArray(GLuint vertexArray) {
+		if(OpenGLStateCache::vertexArray == vertexArray) {
+			OpenGLStateCache::vertexArray = 0;
+		}
+		glDeleteVertexArrays(1, &vertexArray);
+	}
+
+	void OpenGLStateCache::deleteFramebuffer(GLuint framebuffer) {
+		if(drawFramebuffer == framebuffer) {
+			drawFramebuffer = 0;
+		}
+		if(readFramebuffer == framebuffer) {
+			readFramebuffer = 0;
+		}
+		glDeleteFramebuffers(1, &framebuffer);
+	}
+
+	void OpenGLStateCache::deleteTexture(GLuint texture) {
+		for(auto& unit : textures) {
+			for(auto& binding : unit) {
+				if(binding == texture) {
+					binding = 0;
+				}
+			}
+		}
+		textureParameters.erase(texture);
+		glDeleteTextures(1, &texture);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const OpenGLStateCache::Statistics& OpenGLStateCache::getStatistics() const {
+		return statistics;
+	}
+
+	void OpenGLStateCache::resetStatistics() {
+		statistics = Statistics();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLStateCache::setActiveTextureUnit(GLuint unit) {
+		if(!track(activeTextureUnit != unit)) {
+			return;
+		}
+
+		activeTextureUnit = unit;
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	OpenGLStateCache::TextureParameters& OpenGLStateCache::getTextureParameters(GLuint texture) {
+		auto found = textureParameters.find(texture);
+		if(found == textureParameters.end()) {
+			TextureParameters parameters;
+			parameters.fill(GLint(UNKNOWN));
+			found = textureParameters.emplace(texture, parameters).first;
+		}
+		return found->second;
+	}
+
+	bool OpenGLStateCache::track(bool changes) {
+		if(changes) {
+			statistics.issuedCalls++;
+		} else {
+			statistics.avoidedCalls++;
+		}
+		return changes;
+	}
+
+}
@@ -0,0 +1,345 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A shadow copy of the OpenGL context state that skips calls that would not
+	 * change it.
+	 *
+	 * The cache tracks the bound program, vertex array object, framebuffers and
+	 * textures of every texture unit, the enabled capabilities, the blending,
+	 * depth and culling functions, the viewport and the sampler parameters of
+	 * every texture. The backend must change those only through the cache,
+	 * otherwise it must call <tt>invalidate</tt> before using it again. Objects
+	 * tracked by the cache must be deleted through it as well, since deleting a
+	 * bound object resets its binding.
+	 *
+	 * State that was never set through the cache is unknown and the first call
+	 * that sets it always reaches OpenGL.
+	 */
+	class OpenGLStateCache {
+	public:
+		/**
+		 * The number of calls issued and avoided since the last reset
+		 */
+		struct Statistics {
+			/**
+			 * The number of calls forwarded to OpenGL
+			 */
+			unsigned int issuedCalls = 0;
+
+			/**
+			 * The number of calls skipped because they would not change the state
+			 */
+			unsigned int avoidedCalls = 0;
+		};
+
+		/**
+		 * The number of texture units tracked. Units past it are always bound.
+		 */
+		static constexpr unsigned int MAX_TEXTURE_UNITS = 32;
+
+	private:
+		/**
+		 * The value of a object binding that is not known
+		 */
+		static constexpr GLuint UNKNOWN = ~GLuint(0);
+
+		/**
+		 * The number of texture targets tracked on every unit
+		 */
+		static constexpr std::size_t TEXTURE_TARGET_COUNT = 4;
+
+		/**
+		 * The number of capabilities tracked
+		 */
+		static constexpr std::size_t CAPABILITY_COUNT = 6;
+
+		/**
+		 * The number of texture parameters tracked
+		 */
+		static constexpr std::size_t TEXTURE_PARAMETER_COUNT = 5;
+
+		/**
+		 * The tracked parameters of a texture
+		 */
+		using TextureParameters = std::array<GLint, TEXTURE_PARAMETER_COUNT>;
+
+	private:
+		/**
+		 * The program in use
+		 */
+		GLuint program = UNKNOWN;
+
+		/**
+		 * The bound vertex array object
+		 */
+		GLuint vertexArray = UNKNOWN;
+
+		/**
+		 * The framebuffer bound to <tt>GL_DRAW_FRAMEBUFFER</tt>
+		 */
+		GLuint drawFramebuffer = UNKNOWN;
+
+		/**
+		 * The framebuffer bound to <tt>GL_READ_FRAMEBUFFER</tt>
+		 */
+		GLuint readFramebuffer = UNKNOWN;
+
+		/**
+		 * The active texture unit
+		 */
+		GLuint activeTextureUnit = UNKNOWN;
+
+		/**
+		 * The textures bound to every target of every unit
+		 */
+		std::array<std::array<GLuint, TEXTURE_TARGET_COUNT>, MAX_TEXTURE_UNITS> textures;
+
+		/**
+		 * The state of every capability: 0 if disabled, 1 if enabled and -1 if unknown
+		 */
+		std::array<std::int8_t, CAPABILITY_COUNT> capabilities;
+
+		/**
+		 * The blending source and destination factors
+		 */
+		std::array<GLenum, 2> blendFunction;
+
+		/**
+		 * The culled face
+		 */
+		GLenum cullFaceMode = UNKNOWN;
+
+		/**
+		 * The depth comparison function
+		 */
+		GLenum depthFunction = UNKNOWN;
+
+		/**
+		 * The viewport rectangle
+		 */
+		std::array<GLint, 4> viewportRectangle;
+
+		/**
+		 * The sampler parameters of every texture, keyed by texture handle.
+		 * Unknown parameters are <tt>UNKNOWN</tt>.
+		 */
+		std::unordered_map<GLuint, TextureParameters> textureParameters;
+
+		/**
+		 * The counters collected since the last reset
+		 */
+		Statistics statistics;
+
+	public:
+		/**
+		 * Creates a new cache with a unknown state
+		 */
+		OpenGLStateCache();
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLStateCache(const OpenGLStateCache& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLStateCache& operator=(const OpenGLStateCache& other) = delete;
+
+	public:
+		/**
+		 * The engine renders from a single OpenGL context, so every OpenGL object
+		 * shares the same cache.
+		 *
+		 * @return the state cache of the OpenGL context
+		 */
+		static OpenGLStateCache& get();
+
+		/**
+		 * Forgets the whole state. Must be called whenever the context state is
+		 * changed without going through the cache.
+		 */
+		void invalidate();
+
+	public:
+		/**
+		 * Makes a program the active program
+		 *
+		 * @param program the program handle
+		 */
+		void useProgram(GLuint program);
+
+		/**
+		 * Binds a vertex array object
+		 *
+		 * @param vertexArray the vertex array object handle
+		 */
+		void bindVertexArray(GLuint vertexArray);
+
+		/**
+		 * Binds a framebuffer
+		 *
+		 * @param target <tt>GL_FRAMEBUFFER</tt>, <tt>GL_DRAW_FRAMEBUFFER</tt> or <tt>GL_READ_FRAMEBUFFER</tt>
+		 * @param framebuffer the framebuffer handle
+		 */
+		void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+		/**
+		 * Binds a texture to a texture unit
+		 *
+		 * @param unit the texture unit
+		 * @param target the texture target
+		 * @param texture the texture handle
+		 */
+		void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+		/**
+		 * Binds a texture to the active texture unit, so that it can be modified
+		 *
+		 * @param target the texture target
+		 * @param texture the texture handle
+		 */
+		void bindTexture(GLenum target, GLuint texture);
+
+		/**
+		 * Sets a sampler parameter of a texture, binding it to the active texture
+		 * unit if the parameter changes
+		 *
+		 * @param target the texture target
+		 * @param texture the texture handle
+		 * @param name the parameter name
+		 * @param value the parameter value
+		 */
+		void setTextureParameter(GLenum target, GLuint texture, GLenum name, GLint value);
+
+		/**
+		 * Gets a sampler parameter of a texture, querying OpenGL only if it was
+		 * never set through the cache
+		 *
+		 * @param target the texture target
+		 * @param texture the texture handle
+		 * @param name the parameter name
+		 *
+		 * @return the parameter value
+		 */
+		GLint getTextureParameter(GLenum target, GLuint texture, GLenum name);
+
+	public:
+		/**
+		 * Enables or disables a capability
+		 *
+		 * @param capability the capability
+		 * @param enabled true to enable the capability
+		 */
+		void setEnabled(GLenum capability, bool enabled);
+
+		/**
+		 * Sets the blending factors
+		 *
+		 * @param source the source factor
+		 * @param destination the destination factor
+		 */
+		void setBlendFunction(GLenum source, GLenum destination);
+
+		/**
+		 * Sets the face culled when face culling is enabled
+		 *
+		 * @param mode <tt>GL_FRONT</tt>, <tt>GL_BACK</tt> or <tt>GL_FRONT_AND_BACK</tt>
+		 */
+		void setCullFace(GLenum mode);
+
+		/**
+		 * Sets the depth comparison function
+		 *
+		 * @param function the depth comparison function
+		 */
+		void setDepthFunction(GLenum function);
+
+		/**
+		 * Sets the viewport rectangle
+		 *
+		 * @param x the viewport left edge
+		 * @param y the viewport bottom edge
+		 * @param width the viewport width
+		 * @param height the viewport height
+		 */
+		void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	public:
+		/**
+		 * Deletes a vertex array object, resetting its binding
+		 *
+		 * @param vertexArray the vertex array object handle
+		 */
+		void deleteVertexArray(GLuint vertexArray);
+
+		/**
+		 * Deletes a framebuffer, resetting its bindings
+		 *
+		 * @param framebuffer the framebuffer handle
+		 */
+		void deleteFramebuffer(GLuint framebuffer);
+
+		/**
+		 * Deletes a texture, resetting its bindings and forgetting its parameters
+		 *
+		 * @param texture the texture handle
+		 */
+		void deleteTexture(GLuint texture);
+
+	public:
+		/**
+		 * @return the counters collected since the last reset
+		 */
+		const Statistics& getStatistics() const;
+
+		/**
+		 * Resets the counters
+		 */
+		void resetStatistics();
+
+	private:
+		/**
+		 * Makes a texture unit the active unit
+		 *
+		 * @param unit the texture unit
+		 */
+		void setActiveTextureUnit(GLuint unit);
+
+		/**
+		 * @param texture the texture handle
+		 *
+		 * @return the tracked parameters of a texture, all unknown if the texture was never seen
+		 */
+		TextureParameters& getTextureParameters(GLuint texture);
+
+		/**
+		 * Counts a call and checks if it changes the state
+		 *
+		 * @param changes true if the call changes the state
+		 *
+		 * @return <tt>changes</tt>
+		 */
+		bool track(bool changes);
+
+	};
+
+}
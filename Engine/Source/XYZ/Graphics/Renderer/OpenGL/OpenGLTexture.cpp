@@ -3,6 +3,7 @@
 //
 
 #include "OpenGLTexture.hpp"
+#include "OpenGLStateCache.hpp"
 
 #include <iostream>
 
@@ -10,13 +11,8 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	template<typename Executor>
 	auto wrap(GLuint textureID, Executor&& executor) {
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		struct Cleanup {
-			~Cleanup() {
-				glBindTexture(GL_TEXTURE_2D, 0);
-			}
-		} cleanup;
+		// the texture is left bound, the state cache skips the bind if it is modified again
+		OpenGLStateCache::get().bindTexture(GL_TEXTURE_2D, textureID);
 		return executor();
 	}
 
@@ -35,10 +31,11 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		wrap(textureID, [=, &textureImage]() {
 			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, textureImage.getWidth(), textureImage.getHeight(),
 						 0, format, type, textureImage.getRaw().data());
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		});
+
+		auto& state = OpenGLStateCache::get();
+		state.setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	}
 
 	OpenGLTexture::OpenGLTexture(size_t width, size_t height, GLint internalFormat, GLenum format, GLenum type) :
@@ -46,10 +43,11 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		glGenTextures(1, &textureID);
 		wrap(textureID, [=]() {
 			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, (GLuint) width, (GLuint) height, 0, format, type, nullptr);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		});
+
+		auto& state = OpenGLStateCache::get();
+		state.setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	}
 
 	OpenGLTexture::OpenGLTexture(GLuint textureID) :
@@ -57,20 +55,25 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 
 	OpenGLTexture::~OpenGLTexture() {
 		if(textureID != 0) {
-			glDeleteTextures(1, &textureID);
+			OpenGLStateCache::get().deleteTexture(textureID);
 		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void OpenGLTexture::activate(unsigned int slot) {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, textureID);
+		// a texture still being uploaded leaves the slot empty, so the texture previously bound is not sampled
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_2D, ready ? textureID : 0);
 	}
 
 	void OpenGLTexture::deactivate(unsigned int slot) {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_2D, 0);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool OpenGLTexture::isReady() const {
+		return ready;
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
@@ -86,7 +89,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	// -----------------------------------------------------------------------------------------------------------------
 
 	bool OpenGLTexture::canResize() const {
-		return true;
+		return !streamed;
 	}
 
 	void OpenGLTexture::resize(size_t width, size_t height) {
@@ -96,7 +99,7 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	}
 
 	bool OpenGLTexture::canUpdate() {
-		return true;
+		return !streamed;
 	}
 
 	void OpenGLTexture::update(const Graphics::Texture::TextureImage& textureImage) {
@@ -126,19 +129,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLTexture::setWrapModeS(Graphics::Texture::TextureWrap mode) {
 		for(auto& map : TextureWrapMapping) {
 			if(map.wrap == mode) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_WRAP_S,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureWrap OpenGLTexture::getWrapModeS() const {
-		GLenum mode;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLint*) &mode);
-		});
+		auto mode = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_WRAP_S));
 
 		for(auto& map : TextureWrapMapping) {
 			if(map.gl == mode) {
@@ -152,19 +150,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLTexture::setWrapModeT(Graphics::Texture::TextureWrap mode) {
 		for(auto& map : TextureWrapMapping) {
 			if(map.wrap == mode) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_WRAP_T,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureWrap OpenGLTexture::getWrapModeT() const {
-		GLenum mode;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint*) &mode);
-		});
+		auto mode = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_WRAP_T));
 
 		for(auto& map : TextureWrapMapping) {
 			if(map.gl == mode) {
@@ -204,19 +197,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLTexture::setMagnificationFilter(Graphics::Texture::TextureMagnification filter) {
 		for(auto& map : TextureMagnitificationMapping) {
 			if(map.wrap == filter) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MAG_FILTER,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureMagnification OpenGLTexture::getMagnificationFilter() const {
-		GLenum filter;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLint*) &filter);
-		});
+		auto filter = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MAG_FILTER));
 
 		for(auto& map : TextureMagnitificationMapping) {
 			if(map.gl == filter) {
@@ -242,19 +230,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	void OpenGLTexture::setMinificationFilter(Graphics::Texture::TextureMinification filter) {
 		for(auto& map : TextureMinificationMapping) {
 			if(map.wrap == filter) {
-				return wrap(textureID, [=]() {
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, map.gl);
-				});
+				return OpenGLStateCache::get().setTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MIN_FILTER,
+																   GLint(map.gl));
 			}
 		}
 	}
 
 	Graphics::Texture::TextureMinification OpenGLTexture::getMinificationFilter() const {
-		GLenum filter;
-
-		wrap(textureID, [&]() {
-			glGetTextureParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLint*) &filter);
-		});
+		auto filter = GLenum(OpenGLStateCache::get().getTextureParameter(GL_TEXTURE_2D, textureID, GL_TEXTURE_MIN_FILTER));
 
 		for(auto& map : TextureMinificationMapping) {
 			if(map.gl == filter) {
@@ -266,10 +249,15 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 	}
 
 	bool OpenGLTexture::canGenerateMipmaps() const {
-		return true;
+		return !streamed;
 	}
 
 	void OpenGLTexture::generateMipmaps() {
+		// the streamer uploads every level from the mip chain built when the texture was added
+		if(streamed) {
+			return;
+		}
+
 		wrap(textureID, []() {
 			glGenerateMipmap(GL_TEXTURE_2D);
 		});
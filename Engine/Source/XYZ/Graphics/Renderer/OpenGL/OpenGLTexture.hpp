@@ -16,6 +16,18 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		GLenum format;
 		GLenum type;
 
+		/**
+		 * True if the texture mip levels are streamed in by the texture streamer.
+		 * Streamed textures cannot be resized, updated or have their mipmaps generated.
+		 */
+		bool streamed = false;
+
+		/**
+		 * False while the texture contents are being uploaded. A texture that
+		 * is not ready is never bound.
+		 */
+		bool ready = true;
+
 	public:
 		/**
 		 * Creates a new empty texture
@@ -69,6 +81,12 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		void deactivate(unsigned int slot) final;
 
+	public:
+		/**
+		 * @return true once the texture contents were uploaded
+		 */
+		bool isReady() const final;
+
 	public:
 		/**
 		 * @return the number of channels in each texel
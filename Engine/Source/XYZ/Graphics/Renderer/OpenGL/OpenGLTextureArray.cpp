@@ -0,0 +1,53 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLTextureArray.hpp"
+#include "OpenGLStateCache.hpp"
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	OpenGLTextureArray::OpenGLTextureArray(std::size_t width, std::size_t height, unsigned int layers,
+										   GLint internalFormat, GLenum format, GLenum type) :
+			internalFormat(internalFormat), format(format), type(type), layers(layers) {
+		glGenTextures(1, &textureID);
+
+		auto& state = OpenGLStateCache::get();
+		state.bindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, GLsizei(width), GLsizei(height), GLsizei(layers), 0,
+					 format, type, nullptr);
+
+		state.setTextureParameter(GL_TEXTURE_2D_ARRAY, textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D_ARRAY, textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		state.setTextureParameter(GL_TEXTURE_2D_ARRAY, textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		state.setTextureParameter(GL_TEXTURE_2D_ARRAY, textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	OpenGLTextureArray::~OpenGLTextureArray() {
+		if(textureID != 0) {
+			OpenGLStateCache::get().deleteTexture(textureID);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLTextureArray::activate(unsigned int slot) {
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_2D_ARRAY, textureID);
+	}
+
+	void OpenGLTextureArray::deactivate(unsigned int slot) {
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_2D_ARRAY, 0);
+	}
+
+	void OpenGLTextureArray::attach(GLenum attachment, unsigned int layer) {
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, attachment, textureID, 0, GLint(layer));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int OpenGLTextureArray::getLayerCount() const {
+		return layers;
+	}
+
+}
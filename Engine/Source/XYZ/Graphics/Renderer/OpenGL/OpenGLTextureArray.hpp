@@ -0,0 +1,96 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <GL/glew.h>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A array of 2D textures with the same size and format, sampled as a
+	 * <tt>sampler2DArray</tt> and rendered to one layer at a time
+	 */
+	class OpenGLTextureArray {
+	public:
+		GLuint textureID;
+		GLint internalFormat;
+		GLenum format;
+		GLenum type;
+
+	private:
+		/**
+		 * The number of layers
+		 */
+		unsigned int layers;
+
+	public:
+		/**
+		 * Create a new OpenGL texture array with the given parameter. The layers
+		 * are sampled with nearest filtering and clamped to their edges.
+		 *
+		 * @param width the texture width
+		 * @param height the texture height
+		 * @param layers the number of layers
+		 * @param internalFormat the texture internal format
+		 * @param format the texture content format
+		 * @param type the texture data type
+		 */
+		OpenGLTextureArray(std::size_t width, std::size_t height, unsigned int layers, GLint internalFormat = GL_RGBA,
+						   GLenum format = GL_RGBA, GLenum type = GL_UNSIGNED_BYTE);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLTextureArray(const OpenGLTextureArray& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLTextureArray& operator=(const OpenGLTextureArray& other) = delete;
+
+		/**
+		 * Destroys the texture array.
+		 */
+		~OpenGLTextureArray();
+
+	public:
+		/**
+		 * Activate the texture array
+		 *
+		 * @param slot the texture slot
+		 */
+		void activate(unsigned int slot = 0);
+
+		/**
+		 * Deactivate the texture array
+		 *
+		 * @param slot the texture slot
+		 */
+		void deactivate(unsigned int slot);
+
+		/**
+		 * Attaches a layer to the active framebuffer
+		 *
+		 * @param attachment the framebuffer attachment
+		 * @param layer the layer index
+		 */
+		void attach(GLenum attachment, unsigned int layer);
+
+	public:
+		/**
+		 * @return the number of layers
+		 */
+		unsigned int getLayerCount() const;
+
+	};
+
+}
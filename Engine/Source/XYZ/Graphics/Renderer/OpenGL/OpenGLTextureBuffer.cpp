@@ -0,0 +1,59 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "OpenGLTextureBuffer.hpp"
+#include "OpenGLStateCache.hpp"
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	OpenGLTextureBuffer::OpenGLTextureBuffer(GLenum internalFormat) :
+			internalFormat(internalFormat) {
+		glGenBuffers(1, &bufferID);
+		glGenTextures(1, &textureID);
+	}
+
+	OpenGLTextureBuffer::OpenGLTextureBuffer(OpenGLTextureBuffer&& other) noexcept :
+			bufferID(other.bufferID),
+			textureID(other.textureID),
+			internalFormat(other.internalFormat),
+			capacity(other.capacity) {
+		other.bufferID = 0;
+		other.textureID = 0;
+	}
+
+	OpenGLTextureBuffer::~OpenGLTextureBuffer() {
+		if(textureID != 0) {
+			OpenGLStateCache::get().deleteTexture(textureID);
+		}
+		if(bufferID != 0) {
+			glDeleteBuffers(1, &bufferID);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLTextureBuffer::update(const void* data, std::size_t size) {
+		glBindBuffer(GL_TEXTURE_BUFFER, bufferID);
+
+		// a buffer texture must never be empty, keep at least a single texel around
+		auto required = size > 0 ? size : std::size_t(16);
+		if(required > capacity) {
+			capacity = required;
+		}
+
+		glBufferData(GL_TEXTURE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+		if(size > 0) {
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+		}
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		OpenGLStateCache::get().bindTexture(GL_TEXTURE_BUFFER, textureID);
+		glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, bufferID);
+	}
+
+	void OpenGLTextureBuffer::activate(unsigned int slot) {
+		OpenGLStateCache::get().bindTexture(slot, GL_TEXTURE_BUFFER, textureID);
+	}
+
+}
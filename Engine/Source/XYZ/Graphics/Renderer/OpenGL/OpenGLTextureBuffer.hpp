@@ -0,0 +1,109 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * A buffer texture exposes the contents of a OpenGL buffer object to shaders as
+	 * a one-dimensional array of texels (<tt>samplerBuffer</tt> in GLSL).
+	 *
+	 * Buffer textures are available on every OpenGL 3.3 implementation and are used
+	 * to upload large, variable sized arrays that would not fit in uniforms.
+	 */
+	class OpenGLTextureBuffer {
+	public:
+		/**
+		 * The OpenGL buffer object that holds the data
+		 */
+		GLuint bufferID = 0;
+
+		/**
+		 * The OpenGL texture object that views the buffer
+		 */
+		GLuint textureID = 0;
+
+		/**
+		 * The texel format (i.e. GL_RGBA32F or GL_R32UI)
+		 */
+		GLenum internalFormat;
+
+	private:
+		/**
+		 * The number of bytes allocated on the buffer
+		 */
+		std::size_t capacity = 0;
+
+	public:
+		/**
+		 * Creates a new empty buffer texture
+		 *
+		 * @param internalFormat the texel format
+		 */
+		explicit OpenGLTextureBuffer(GLenum internalFormat);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLTextureBuffer(const OpenGLTextureBuffer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLTextureBuffer& operator=(const OpenGLTextureBuffer& other) = delete;
+
+		/**
+		 * Creates a new buffer texture by moving the contents of another
+		 *
+		 * @param other the instance to move from
+		 */
+		OpenGLTextureBuffer(OpenGLTextureBuffer&& other) noexcept;
+
+		/**
+		 * Deleted move assignment operator.
+		 *
+		 * @param other the instance to move from
+		 *
+		 * @return *this
+		 */
+		OpenGLTextureBuffer& operator=(OpenGLTextureBuffer&& other) = delete;
+
+		/**
+		 * Destroys the buffer texture
+		 */
+		~OpenGLTextureBuffer();
+
+	public:
+		/**
+		 * Replaces the buffer contents.
+		 *
+		 * The storage is orphaned before being written, so the driver does not
+		 * have to wait for draws still reading the previous contents.
+		 *
+		 * @param data the data to upload
+		 * @param size the number of bytes to upload
+		 */
+		void update(const void* data, std::size_t size);
+
+		/**
+		 * Binds the buffer texture to a texture slot
+		 *
+		 * @param slot the texture slot
+		 */
+		void activate(unsigned int slot);
+
+	};
+
+}
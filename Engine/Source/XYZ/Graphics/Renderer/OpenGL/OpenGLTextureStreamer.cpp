@@ -0,0 +1,271 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "OpenGLTextureStreamer.hpp"
+#include "OpenGLStateCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * Builds the next level of a mip chain with a box filter
+	 *
+	 * @param texels the texels of the level
+	 * @param width the level width, in texels
+	 * @param height the level height, in texels
+	 * @param channels the number of channels of every texel
+	 *
+	 * @return the texels of the next level
+	 */
+	static std::vector<char> downsample(const std::vector<char>& texels, unsigned int width, unsigned int height,
+										unsigned int channels) {
+		auto levelWidth = std::max(1u, width / 2);
+		auto levelHeight = std::max(1u, height / 2);
+
+		std::vector<char> level(std::size_t(levelWidth) * levelHeight * channels);
+		auto texel = [&](unsigned int x, unsigned int y, unsigned int channel) {
+			x = std::min(x, width - 1);
+			y = std::min(y, height - 1);
+			return unsigned(static_cast<unsigned char>(texels[(std::size_t(y) * width + x) * channels + channel]));
+		};
+
+		for(unsigned int y = 0; y < levelHeight; y++) {
+			for(unsigned int x = 0; x < levelWidth; x++) {
+				for(unsigned int channel = 0; channel < channels; channel++) {
+					auto sum = texel(2 * x, 2 * y, channel) + texel(2 * x + 1, 2 * y, channel) +
+							   texel(2 * x, 2 * y + 1, channel) + texel(2 * x + 1, 2 * y + 1, channel);
+					level[(std::size_t(y) * levelWidth + x) * channels + channel] = char((sum + 2) / 4);
+				}
+			}
+		}
+		return level;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	OpenGLTextureStreamer::OpenGLTextureStreamer(std::size_t memoryBudget, std::size_t uploadBudget) :
+			streamer(memoryBudget, uploadBudget), memoryBudget(memoryBudget),
+			stagingBuffer(GLsizeiptr(4 * uploadBudget)), loader(1) {}
+
+	OpenGLTextureStreamer::~OpenGLTextureStreamer() {
+		for(auto& entry : textures) {
+			if(entry.second.fence != nullptr) {
+				glDeleteSync(entry.second.fence);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::shared_ptr<OpenGLTexture> OpenGLTextureStreamer::add(const Texture::TextureImage& textureImage) {
+		auto texture = std::make_shared<OpenGLTexture>();
+		glGenTextures(1, &texture->textureID);
+		texture->internalFormat = textureImage.isAlpha() ? GL_RGBA8 : GL_RGB8;
+		texture->format = textureImage.isAlpha() ? GL_RGBA : GL_RGB;
+		texture->type = GL_UNSIGNED_BYTE;
+		texture->streamed = true;
+		texture->ready = false;
+
+		auto& state = OpenGLStateCache::get();
+		state.setTextureParameter(GL_TEXTURE_2D, texture->textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		state.setTextureParameter(GL_TEXTURE_2D, texture->textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		auto key = static_cast<TextureStreamer::Key>(static_cast<const Texture::Texture*>(texture.get()));
+		auto& streamedTexture = textures[key];
+		if(streamedTexture.fence != nullptr) {
+			glDeleteSync(streamedTexture.fence);
+		}
+		streamer.remove(key);
+
+		streamedTexture = StreamedTexture();
+		streamedTexture.texture = texture;
+		streamedTexture.width = std::max(1u, textureImage.getWidth());
+		streamedTexture.height = std::max(1u, textureImage.getHeight());
+		streamedTexture.levels = std::make_shared<std::vector<std::vector<char>>>();
+
+		// the image may be released as soon as this call returns, so the loader gets its own copy
+		auto levelCount = TextureStreamer::getLevelCount(streamedTexture.width, streamedTexture.height);
+		auto channels = textureImage.isAlpha() ? 4u : 3u;
+		streamedTexture.loading = loader.schedule(
+				[levels = streamedTexture.levels, texels = textureImage.getRaw(), width = streamedTexture.width,
+				 height = streamedTexture.height, levelCount, channels]() mutable {
+			levels->reserve(levelCount);
+			levels->push_back(std::move(texels));
+			for(unsigned int level = 1; level < levelCount; level++) {
+				levels->push_back(downsample(
+						levels->back(),
+						std::max(1u, width >> (level - 1)),
+						std::max(1u, height >> (level - 1)),
+						channels
+				));
+			}
+		});
+
+		return texture;
+	}
+
+	void OpenGLTextureStreamer::request(const Texture::Texture& texture, float footprint) {
+		streamer.request(&texture, footprint);
+	}
+
+	void OpenGLTextureStreamer::update() {
+		// forget the textures that were released since the last update
+		for(auto it = textures.begin(); it != textures.end();) {
+			if(it->second.texture.expired()) {
+				if(it->second.fence != nullptr) {
+					glDeleteSync(it->second.fence);
+				}
+				streamer.remove(it->first);
+				it = textures.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for(auto& entry : textures) {
+			auto& streamedTexture = entry.second;
+
+			// the texture is only streamed once its mip chain is built
+			if(streamedTexture.loading.valid() &&
+			   streamedTexture.loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				finishLoading(entry.first, *streamedTexture.texture.lock(), streamedTexture);
+			}
+
+			// and it is sampled once its coarsest levels are uploaded
+			if(streamedTexture.fence != nullptr) {
+				auto result = glClientWaitSync(streamedTexture.fence, 0, 0);
+				if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+					glDeleteSync(streamedTexture.fence);
+					streamedTexture.fence = nullptr;
+					streamedTexture.texture.lock()->ready = true;
+				}
+			}
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		// give video memory back when other allocations are running out of it
+		auto budget = memoryBudget;
+		if(GLEW_NVX_gpu_memory_info) {
+			GLint availableKilobytes = 0;
+			glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKilobytes);
+
+			auto available = std::size_t(availableKilobytes) * 1024;
+			if(available < MIN_AVAILABLE_MEMORY) {
+				auto resident = streamer.getStatistics().residentBytes;
+				auto deficit = MIN_AVAILABLE_MEMORY - available;
+				budget = std::min(budget, resident > deficit ? resident - deficit : 0);
+			}
+		}
+		streamer.setMemoryBudget(budget);
+
+		changes.clear();
+		streamer.update(changes);
+
+		auto& state = OpenGLStateCache::get();
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for(const auto& change : changes) {
+			const auto& streamedTexture = textures[change.key];
+			auto texture = streamedTexture.texture.lock();
+
+			if(change.residentLevel < change.previousLevel) {
+				// coarse-to-fine, the new levels are only sampled once every one is uploaded
+				for(auto level = change.previousLevel; level-- > change.residentLevel;) {
+					upload(*texture, streamedTexture, level);
+				}
+				state.setTextureParameter(GL_TEXTURE_2D, texture->textureID, GL_TEXTURE_BASE_LEVEL,
+										  GLint(change.residentLevel));
+			} else {
+				// stop sampling the evicted levels before releasing their memory
+				state.setTextureParameter(GL_TEXTURE_2D, texture->textureID, GL_TEXTURE_BASE_LEVEL,
+										  GLint(change.residentLevel));
+				state.bindTexture(GL_TEXTURE_2D, texture->textureID);
+				for(auto level = change.previousLevel; level < change.residentLevel; level++) {
+					glTexImage2D(GL_TEXTURE_2D, GLint(level), texture->internalFormat, 0, 0, 0, texture->format,
+								 texture->type, nullptr);
+				}
+			}
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		// the staged levels were consumed by the uploads submitted above
+		stagingBuffer.fence();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::size_t OpenGLTextureStreamer::getMemoryBudget() const {
+		return memoryBudget;
+	}
+
+	void OpenGLTextureStreamer::setMemoryBudget(std::size_t memoryBudget) {
+		OpenGLTextureStreamer::memoryBudget = memoryBudget;
+	}
+
+	std::size_t OpenGLTextureStreamer::getUploadBudget() const {
+		return streamer.getUploadBudget();
+	}
+
+	void OpenGLTextureStreamer::setUploadBudget(std::size_t uploadBudget) {
+		streamer.setUploadBudget(uploadBudget);
+	}
+
+	const TextureStreamer::Statistics& OpenGLTextureStreamer::getStatistics() const {
+		return streamer.getStatistics();
+	}
+
+	std::size_t OpenGLTextureStreamer::getPendingCount() const {
+		return std::size_t(std::count_if(textures.begin(), textures.end(), [](const auto& entry) {
+			return entry.second.loading.valid() || entry.second.fence != nullptr;
+		}));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void OpenGLTextureStreamer::finishLoading(TextureStreamer::Key key, OpenGLTexture& texture,
+											  StreamedTexture& streamedTexture) {
+		streamedTexture.loading.get();
+
+		// drivers usually pad RGB texels to four bytes
+		auto levelCount = GLint(streamedTexture.levels->size());
+		auto tailLevel = streamer.add(key, streamedTexture.width, streamedTexture.height, 4);
+
+		auto& state = OpenGLStateCache::get();
+		state.setTextureParameter(GL_TEXTURE_2D, texture.textureID, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+		state.setTextureParameter(GL_TEXTURE_2D, texture.textureID, GL_TEXTURE_BASE_LEVEL, GLint(tailLevel));
+		for(auto level = unsigned(levelCount); level-- > tailLevel;) {
+			upload(texture, streamedTexture, level);
+		}
+		streamedTexture.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		// the coarsest levels are never evicted, so they are never uploaded again
+		streamedTexture.levels->resize(tailLevel);
+	}
+
+	void OpenGLTextureStreamer::upload(const OpenGLTexture& texture, const StreamedTexture& streamedTexture,
+									   unsigned int level) {
+		const auto& texels = (*streamedTexture.levels)[level];
+		auto width = GLsizei(std::max(1u, streamedTexture.width >> level));
+		auto height = GLsizei(std::max(1u, streamedTexture.height >> level));
+		OpenGLStateCache::get().bindTexture(GL_TEXTURE_2D, texture.textureID);
+
+		auto allocation = stagingBuffer.allocate(GLsizeiptr(texels.size()));
+		if(allocation.pointer == nullptr) {
+			glTexImage2D(GL_TEXTURE_2D, GLint(level), texture.internalFormat, width, height, 0, texture.format,
+						 texture.type, texels.data());
+			return;
+		}
+
+		// the driver copies the staged texels to the texture asynchronously
+		std::memcpy(allocation.pointer, texels.data(), texels.size());
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer.getBufferID());
+		glTexImage2D(GL_TEXTURE_2D, GLint(level), texture.internalFormat, width, height, 0, texture.format,
+					 texture.type, reinterpret_cast<const void*>(allocation.offset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+}
@@ -0,0 +1,230 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Graphics/Renderer/TextureStreamer.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLTexture.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLRingBuffer.hpp"
+#include "XYZ/Graphics/Texture/TextureImage.hpp"
+#include "XYZ/Utility/JobSystem.hpp"
+
+#include <GL/glew.h>
+
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer::OpenGL {
+
+	/**
+	 * Streams the mip levels of the compiled textures in and out of video memory.
+	 *
+	 * The mip chain of every texture is built on a loader thread. Once built,
+	 * only its coarsest levels are uploaded and the texture becomes ready as soon
+	 * as the fence that follows the upload signals. <tt>update</tt> then uploads
+	 * and releases the finer levels as decided by a <tt>TextureStreamer</tt> from
+	 * the requests of the frame. The texture base level is always the finest
+	 * resident level, so a texture never samples a missing level.
+	 *
+	 * Levels are staged through a persistently mapped pixel unpack buffer, so the
+	 * driver copies them to the texture asynchronously instead of blocking the
+	 * render thread. If persistent mapping is not supported, or a level does not
+	 * fit in the staging buffer, the level is uploaded from client memory.
+	 *
+	 * If the driver reports the available video memory, the memory budget is
+	 * lowered whenever it runs low, so that the finest levels are released
+	 * before the driver starts paging.
+	 */
+	class OpenGLTextureStreamer {
+	public:
+		/**
+		 * The video memory that should be kept available, in bytes
+		 */
+		static constexpr std::size_t MIN_AVAILABLE_MEMORY = 64 * 1024 * 1024;
+
+	private:
+		/**
+		 * A streamed texture
+		 */
+		struct StreamedTexture {
+			/**
+			 * The texture. Expires once every user released it.
+			 */
+			std::weak_ptr<OpenGLTexture> texture;
+
+			/**
+			 * The texels of every level that can be streamed in, finest first. The
+			 * levels that are always resident are released once uploaded. Shared
+			 * with the job that builds them.
+			 */
+			std::shared_ptr<std::vector<std::vector<char>>> levels;
+
+			/**
+			 * A future that becomes ready once <tt>levels</tt> was built. Invalid
+			 * once the texture was handed to the streamer.
+			 */
+			std::future<void> loading;
+
+			/**
+			 * The fence that signals once the levels that are always resident were
+			 * uploaded. Null once the texture is ready.
+			 */
+			GLsync fence = nullptr;
+
+			/**
+			 * The size of the finest level, in texels
+			 */
+			unsigned int width;
+			unsigned int height;
+		};
+
+	private:
+		/**
+		 * Decides which levels are resident
+		 */
+		TextureStreamer streamer;
+
+		/**
+		 * The memory budget of the streamer when video memory is not running low
+		 */
+		std::size_t memoryBudget;
+
+		/**
+		 * Every streamed texture
+		 */
+		std::unordered_map<TextureStreamer::Key, StreamedTexture> textures;
+
+		/**
+		 * The changes of the last update. Kept to reuse its memory.
+		 */
+		std::vector<TextureStreamer::Change> changes;
+
+		/**
+		 * The buffer every level is staged in before being copied to its texture
+		 */
+		OpenGLRingBuffer stagingBuffer;
+
+		/**
+		 * The loader thread that builds the mip chains
+		 */
+		Utility::JobSystem loader;
+
+	public:
+		/**
+		 * Creates a new texture streamer
+		 *
+		 * @param memoryBudget the maximum size of the resident levels, in bytes
+		 * @param uploadBudget the maximum size of the levels uploaded every frame, in bytes
+		 */
+		OpenGLTextureStreamer(std::size_t memoryBudget, std::size_t uploadBudget);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		OpenGLTextureStreamer(const OpenGLTextureStreamer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		OpenGLTextureStreamer& operator=(const OpenGLTextureStreamer& other) = delete;
+
+		/**
+		 * Deletes the fences of the textures not ready yet
+		 */
+		~OpenGLTextureStreamer();
+
+	public:
+		/**
+		 * Creates a new streamed texture from a texture image. The texture is not
+		 * ready until its mip chain is built and its coarsest levels are uploaded
+		 * by a later <tt>update</tt>, its sampler parameters can be set right away.
+		 *
+		 * @param textureImage the texture image
+		 *
+		 * @return the newly created texture
+		 */
+		std::shared_ptr<OpenGLTexture> add(const Texture::TextureImage& textureImage);
+
+		/**
+		 * Requests the levels of a texture needed to cover a pixel with a texel.
+		 * Textures that are not streamed are ignored.
+		 *
+		 * This method does not issue any OpenGL call and can be called from a
+		 * culling job, as long as no other thread uses the streamer.
+		 *
+		 * @param texture the texture
+		 * @param footprint the texture coordinate footprint of a screen pixel, see <tt>TextureStreamer::computeFootprint</tt>
+		 */
+		void request(const Texture::Texture& texture, float footprint);
+
+		/**
+		 * Uploads the coarsest levels of the textures whose mip chain was built,
+		 * marks the textures whose upload completed as ready and uploads and
+		 * releases the levels needed by the requests since the last update. Must
+		 * be called once every frame.
+		 */
+		void update();
+
+	public:
+		/**
+		 * @return the maximum size of the resident levels, in bytes
+		 */
+		std::size_t getMemoryBudget() const;
+
+		/**
+		 * @param memoryBudget the maximum size of the resident levels, in bytes
+		 */
+		void setMemoryBudget(std::size_t memoryBudget);
+
+		/**
+		 * @return the maximum size of the levels uploaded every frame, in bytes
+		 */
+		std::size_t getUploadBudget() const;
+
+		/**
+		 * @param uploadBudget the maximum size of the levels uploaded every frame, in bytes
+		 */
+		void setUploadBudget(std::size_t uploadBudget);
+
+		/**
+		 * @return the counters of the last update
+		 */
+		const TextureStreamer::Statistics& getStatistics() const;
+
+		/**
+		 * @return the number of textures that are not ready yet
+		 */
+		std::size_t getPendingCount() const;
+
+	private:
+		/**
+		 * Hands a texture whose mip chain was built to the streamer and uploads
+		 * its coarsest levels
+		 *
+		 * @param key the texture key
+		 * @param texture the texture
+		 * @param streamedTexture the texture levels
+		 */
+		void finishLoading(TextureStreamer::Key key, OpenGLTexture& texture, StreamedTexture& streamedTexture);
+
+		/**
+		 * Uploads a level of a texture through the staging buffer
+		 *
+		 * @param texture the texture
+		 * @param streamedTexture the texture levels
+		 * @param level the level to upload
+		 */
+		void upload(const OpenGLTexture& texture, const StreamedTexture& streamedTexture, unsigned int level);
+
+	};
+
+}
@@ -3,6 +3,9 @@
 //
 
 #include "OpenGLVertexBuffer.hpp"
+#include "OpenGLStateCache.hpp"
+
+#include <algorithm>
 
 namespace XYZ::Graphics::Renderer::OpenGL {
 
@@ -12,26 +15,73 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 			vao(vao),
 			vertexCount(vertexCount) {}
 
+	OpenGLVertexBuffer::OpenGLVertexBuffer(OpenGLMeshBuffer& meshBuffer, const OpenGLMeshBuffer::Range& range) :
+			ebo(0),
+			vao(0),
+			vertexCount(GLsizei(range.indexCount)),
+			meshBuffer(&meshBuffer),
+			range(range) {}
+
 	OpenGLVertexBuffer::~OpenGLVertexBuffer() {
+		if(meshBuffer != nullptr) {
+			meshBuffer->release(range);
+		}
 		if(vertexBuffer != 0) {
 			glDeleteBuffers(1, &vertexBuffer);
 		}
 		if(ebo != 0) {
 			glDeleteBuffers(1, &ebo);
 		}
+		if(instanceBuffer != 0) {
+			glDeleteBuffers(1, &instanceBuffer);
+		}
 		if(vao != 0) {
-			glDeleteVertexArrays(1, &vao);
+			OpenGLStateCache::get().deleteVertexArray(vao);
 		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------
 
 	void OpenGLVertexBuffer::draw() {
-		// draw mesh
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+		if(meshBuffer != nullptr) {
+			return meshBuffer->draw(range);
+		}
+
+		// draw mesh. The vertex array object is left bound and holds the index buffer binding.
+		OpenGLStateCache::get().bindVertexArray(vao);
 		glDrawElements(GL_TRIANGLES, vertexCount, GL_UNSIGNED_INT, nullptr);
-		glBindVertexArray(0);
+	}
+
+	void OpenGLVertexBuffer::drawInstanced(const std::vector<glm::mat4>& modelMatrices) {
+		if(meshBuffer != nullptr) {
+			return meshBuffer->drawInstanced(range, modelMatrices.data(), modelMatrices.size());
+		}
+
+		OpenGLStateCache::get().bindVertexArray(vao);
+
+		if(instanceBuffer == 0) {
+			// the per-instance attributes are recorded in the vertex array object
+			glGenBuffers(1, &instanceBuffer);
+			glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+			for(GLuint column = 0; column < 4; column++) {
+				glEnableVertexAttribArray(INSTANCE_MODEL_ATTRIBUTE + column);
+				glVertexAttribPointer(INSTANCE_MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+									  (void*) (sizeof(glm::vec4) * column));
+				glVertexAttribDivisor(INSTANCE_MODEL_ATTRIBUTE + column, 1);
+			}
+		} else {
+			glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		}
+
+		// orphan the previous contents, the buffer may still be in use by a previous draw
+		auto size = GLsizeiptr(modelMatrices.size() * sizeof(glm::mat4));
+		instanceBufferSize = std::max(instanceBufferSize, size);
+		glBufferData(GL_ARRAY_BUFFER, instanceBufferSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, modelMatrices.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glDrawElementsInstanced(GL_TRIANGLES, vertexCount, GL_UNSIGNED_INT, nullptr,
+								GLsizei(modelMatrices.size()));
 	}
 
 }
\ No newline at end of file
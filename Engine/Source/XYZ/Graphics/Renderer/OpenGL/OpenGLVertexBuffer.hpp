@@ -5,6 +5,7 @@
 #pragma once
 
 #include "XYZ/Graphics/Renderer/VertexBuffer.hpp"
+#include "XYZ/Graphics/Renderer/OpenGL/OpenGLMeshBuffer.hpp"
 #include <GL/glew.h>
 
 namespace XYZ::Graphics::Renderer::OpenGL {
@@ -28,6 +29,33 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		GLsizei vertexCount;
 
+		/**
+		 * The per-instance model matrix buffer. Created on the first instanced draw.
+		 */
+		GLuint instanceBuffer = 0;
+
+		/**
+		 * The size of <tt>instanceBuffer</tt>, in bytes
+		 */
+		GLsizeiptr instanceBufferSize = 0;
+
+		/**
+		 * The mesh buffer the mesh lives in, or null if the mesh has its own buffers
+		 */
+		OpenGLMeshBuffer* meshBuffer = nullptr;
+
+		/**
+		 * The range of the mesh in <tt>meshBuffer</tt>
+		 */
+		OpenGLMeshBuffer::Range range;
+
+	public:
+		/**
+		 * The first vertex attribute location of the per-instance model matrix. A
+		 * matrix uses four consecutive locations, one per column.
+		 */
+		static constexpr GLuint INSTANCE_MODEL_ATTRIBUTE = 5;
+
 	public:
 		/**
 		 * Creates a new OpenGL compiled mesh object
@@ -39,6 +67,14 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		OpenGLVertexBuffer(GLuint ebo, GLuint vertexBuffer, GLuint vao,
 						   GLsizei vertexCount);
 
+		/**
+		 * Creates a new OpenGL compiled mesh object that lives in a mesh buffer
+		 *
+		 * @param meshBuffer the mesh buffer
+		 * @param range the range of the mesh in the mesh buffer
+		 */
+		OpenGLVertexBuffer(OpenGLMeshBuffer& meshBuffer, const OpenGLMeshBuffer::Range& range);
+
 		/**
 		 * Relases the OpenGL mesh buffers
 		 */
@@ -50,6 +86,13 @@ namespace XYZ::Graphics::Renderer::OpenGL {
 		 */
 		void draw() final override;
 
+		/**
+		 * Draws several instances of a mesh with a single draw call
+		 *
+		 * @param modelMatrices the model matrix of every instance
+		 */
+		void drawInstanced(const std::vector<glm::mat4>& modelMatrices) final override;
+
 	};
 
 }
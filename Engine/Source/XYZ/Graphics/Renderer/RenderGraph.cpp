@@ -0,0 +1,265 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace XYZ::Graphics::Renderer {
+
+	bool RenderTargetDescription::operator==(const RenderTargetDescription& other) const {
+		return format == other.format && scale == other.scale;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, PassID pass) : graph(graph), pass(pass) {
+
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(ResourceID resource) {
+		graph.passes[pass].reads.push_back(resource);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(ResourceID resource) {
+		graph.passes[pass].writes.push_back(resource);
+		return *this;
+	}
+
+	RenderGraph::PassID RenderGraph::PassBuilder::getID() const {
+		return pass;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::clear() {
+		resources.clear();
+		passes.clear();
+		order.clear();
+		physicalTargets.clear();
+	}
+
+	void RenderGraph::setSize(unsigned int width, unsigned int height) {
+		RenderGraph::width = width;
+		RenderGraph::height = height;
+	}
+
+	RenderGraph::ResourceID RenderGraph::createTarget(std::string name, const RenderTargetDescription& description) {
+		resources.push_back(Resource{std::move(name), description, false, INVALID});
+		return ResourceID(resources.size() - 1);
+	}
+
+	RenderGraph::ResourceID RenderGraph::importTarget(std::string name) {
+		resources.push_back(Resource{std::move(name), RenderTargetDescription{RenderTargetFormat::RGBA8}, true, INVALID});
+		return ResourceID(resources.size() - 1);
+	}
+
+	RenderGraph::PassBuilder RenderGraph::addPass(std::string name, Executor executor) {
+		passes.push_back(Pass{std::move(name), std::move(executor), {}, {}, false});
+		return PassBuilder(*this, PassID(passes.size() - 1));
+	}
+
+	void RenderGraph::compile() {
+		cull();
+		sort();
+		alias();
+	}
+
+	void RenderGraph::execute() const {
+		for(auto pass : order) {
+			passes[pass].executor();
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int RenderGraph::getWidth() const {
+		return width;
+	}
+
+	unsigned int RenderGraph::getHeight() const {
+		return height;
+	}
+
+	std::size_t RenderGraph::getPhysicalTargetCount() const {
+		return physicalTargets.size();
+	}
+
+	const RenderTargetDescription& RenderGraph::getPhysicalTargetDescription(std::uint32_t index) const {
+		return physicalTargets[index];
+	}
+
+	std::uint32_t RenderGraph::getPhysicalTarget(ResourceID resource) const {
+		return resources[resource].physical;
+	}
+
+	unsigned int RenderGraph::getTargetWidth(const RenderTargetDescription& description) const {
+		return std::max(1u, (unsigned int) (float(width) * description.scale));
+	}
+
+	unsigned int RenderGraph::getTargetHeight(const RenderTargetDescription& description) const {
+		return std::max(1u, (unsigned int) (float(height) * description.scale));
+	}
+
+	bool RenderGraph::isCulled(PassID pass) const {
+		return passes[pass].culled;
+	}
+
+	const std::vector<RenderGraph::PassID>& RenderGraph::getOrder() const {
+		return order;
+	}
+
+	const std::string& RenderGraph::getPassName(PassID pass) const {
+		return passes[pass].name;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::cull() {
+		// start from the passes that write to a imported target and walk back
+		// through the writers of everything they read
+		std::vector<PassID> live;
+		for(PassID i = 0; i < passes.size(); i++) {
+			auto& pass = passes[i];
+			pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(), [this](ResourceID resource) {
+				return resources[resource].imported;
+			});
+			if(!pass.culled) {
+				live.push_back(i);
+			}
+		}
+
+		while(!live.empty()) {
+			auto reader = live.back();
+			live.pop_back();
+
+			for(auto resource : passes[reader].reads) {
+				for(PassID writer = 0; writer < passes.size(); writer++) {
+					auto& pass = passes[writer];
+					if(!pass.culled || std::find(pass.writes.begin(), pass.writes.end(), resource) == pass.writes.end()) {
+						continue;
+					}
+					pass.culled = false;
+					live.push_back(writer);
+				}
+			}
+		}
+	}
+
+	void RenderGraph::sort() {
+		// a pass depends on the writers of every target it reads and on the
+		// previous writers of every target it writes
+		std::vector<std::vector<PassID>> dependents(passes.size());
+		std::vector<std::size_t> dependencies(passes.size(), 0);
+
+		auto writes = [this](PassID pass, ResourceID resource) {
+			const auto& writes = passes[pass].writes;
+			return std::find(writes.begin(), writes.end(), resource) != writes.end();
+		};
+
+		for(PassID pass = 0; pass < passes.size(); pass++) {
+			if(passes[pass].culled) {
+				continue;
+			}
+
+			for(PassID other = 0; other < passes.size(); other++) {
+				if(other == pass || passes[other].culled) {
+					continue;
+				}
+
+				bool dependsOn = std::any_of(passes[pass].reads.begin(), passes[pass].reads.end(),
+											 [&](ResourceID resource) { return writes(other, resource); });
+				if(!dependsOn && other < pass) {
+					dependsOn = std::any_of(passes[pass].writes.begin(), passes[pass].writes.end(),
+											[&](ResourceID resource) { return writes(other, resource); });
+				}
+
+				if(dependsOn) {
+					dependents[other].push_back(pass);
+					dependencies[pass]++;
+				}
+			}
+		}
+
+		// always pick the first ready pass in declaration order, so that
+		// independent passes run in the order they were declared
+		order.clear();
+		std::vector<bool> scheduled(passes.size(), false);
+		for(;;) {
+			PassID next = INVALID;
+			for(PassID pass = 0; pass < passes.size(); pass++) {
+				if(!passes[pass].culled && !scheduled[pass] && dependencies[pass] == 0) {
+					next = pass;
+					break;
+				}
+			}
+			if(next == INVALID) {
+				break;
+			}
+
+			scheduled[next] = true;
+			order.push_back(next);
+			for(auto dependent : dependents[next]) {
+				dependencies[dependent]--;
+			}
+		}
+
+		auto live = std::count_if(passes.begin(), passes.end(), [](const Pass& pass) { return !pass.culled; });
+		if(order.size() != std::size_t(live)) {
+			throw std::logic_error("The render graph passes have a cyclic dependency");
+		}
+	}
+
+	void RenderGraph::alias() {
+		// the lifetime of a target spans from the first to the last pass that uses it
+		std::vector<std::uint32_t> firstUse(resources.size(), INVALID);
+		std::vector<std::uint32_t> lastUse(resources.size(), 0);
+
+		for(std::uint32_t position = 0; position < order.size(); position++) {
+			const auto& pass = passes[order[position]];
+			for(const auto* list : {&pass.reads, &pass.writes}) {
+				for(auto resource : *list) {
+					firstUse[resource] = std::min(firstUse[resource], position);
+					lastUse[resource] = std::max(lastUse[resource], position);
+				}
+			}
+		}
+
+		std::vector<ResourceID> transients;
+		for(ResourceID resource = 0; resource < resources.size(); resource++) {
+			resources[resource].physical = INVALID;
+			if(!resources[resource].imported && firstUse[resource] != INVALID) {
+				transients.push_back(resource);
+			}
+		}
+		std::stable_sort(transients.begin(), transients.end(), [&](ResourceID a, ResourceID b) {
+			return firstUse[a] < firstUse[b];
+		});
+
+		// reuse the first compatible physical target that is no longer in use
+		physicalTargets.clear();
+		std::vector<std::uint32_t> physicalLastUse;
+		for(auto resource : transients) {
+			auto& target = resources[resource];
+
+			std::uint32_t physical = 0;
+			for(; physical < physicalTargets.size(); physical++) {
+				if(physicalTargets[physical] == target.description && physicalLastUse[physical] < firstUse[resource]) {
+					break;
+				}
+			}
+
+			if(physical == physicalTargets.size()) {
+				physicalTargets.push_back(target.description);
+				physicalLastUse.push_back(0);
+			}
+
+			target.physical = physical;
+			physicalLastUse[physical] = lastUse[resource];
+		}
+	}
+
+}
@@ -0,0 +1,382 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * The pixel format of a render graph target
+	 */
+	enum class RenderTargetFormat : std::uint8_t {
+		/**
+		 * 8-bit normalized RGBA color
+		 */
+		RGBA8,
+
+		/**
+		 * 16-bit floating point RGBA color
+		 */
+		RGBA16F,
+
+		/**
+		 * 8-bit normalized single channel
+		 */
+		R8,
+
+		/**
+		 * 16-bit normalized RG color
+		 */
+		RG16,
+
+		/**
+		 * 24-bit depth
+		 */
+		DEPTH24
+	};
+
+	/**
+	 * Describes a render graph target. Targets with equal descriptions are
+	 * interchangeable and can share memory.
+	 */
+	struct RenderTargetDescription {
+		/**
+		 * The target pixel format
+		 */
+		RenderTargetFormat format;
+
+		/**
+		 * The target size, relative to the render graph size
+		 */
+		float scale = 1.0f;
+
+		/**
+		 * @param other the description to compare to
+		 *
+		 * @return true if both descriptions are equal
+		 */
+		bool operator==(const RenderTargetDescription& other) const;
+	};
+
+	/**
+	 * A render graph declares the passes of a frame together with the targets
+	 * each pass reads and writes, and derives from them everything that used to
+	 * be hard-wired in the rendering technique:
+	 *
+	 * <ul>
+	 *  <li>passes that do not contribute to a imported target (e.g. the screen)
+	 *  are culled;</li>
+	 *  <li>the remaining passes are ordered so that every target is written before
+	 *  it is read, keeping the declaration order whenever possible;</li>
+	 *  <li>transient targets are assigned to physical targets so that targets whose
+	 *  lifetimes do not overlap share the same memory.</li>
+	 * </ul>
+	 *
+	 * The graph itself does not allocate anything: after <tt>compile</tt>, the
+	 * backend allocates one target per physical target description and looks up
+	 * the physical target of every transient target with <tt>getPhysicalTarget</tt>.
+	 *
+	 * Passes declared after a compilation are only considered by the next one.
+	 */
+	class RenderGraph {
+	public:
+		/**
+		 * Identifies a target of the graph
+		 */
+		using ResourceID = std::uint32_t;
+
+		/**
+		 * Identifies a pass of the graph
+		 */
+		using PassID = std::uint32_t;
+
+		/**
+		 * The function that renders a pass
+		 */
+		using Executor = std::function<void()>;
+
+		/**
+		 * A invalid resource or physical target index
+		 */
+		static constexpr std::uint32_t INVALID = 0xFFFFFFFF;
+
+		/**
+		 * A helper used to declare the targets a pass reads and writes
+		 */
+		class PassBuilder {
+		private:
+			/**
+			 * The graph the pass belongs to
+			 */
+			RenderGraph& graph;
+
+			/**
+			 * The pass being declared
+			 */
+			PassID pass;
+
+		public:
+			/**
+			 * Creates a new pass builder
+			 *
+			 * @param graph the graph the pass belongs to
+			 * @param pass the pass being declared
+			 */
+			PassBuilder(RenderGraph& graph, PassID pass);
+
+		public:
+			/**
+			 * Declares that the pass reads a target
+			 *
+			 * @param resource the target read by the pass
+			 *
+			 * @return *this
+			 */
+			PassBuilder& read(ResourceID resource);
+
+			/**
+			 * Declares that the pass writes a target
+			 *
+			 * @param resource the target written by the pass
+			 *
+			 * @return *this
+			 */
+			PassBuilder& write(ResourceID resource);
+
+			/**
+			 * @return the pass id
+			 */
+			PassID getID() const;
+		};
+
+	private:
+		/**
+		 * A target declared on the graph
+		 */
+		struct Resource {
+			/**
+			 * The target name, used for debugging
+			 */
+			std::string name;
+
+			/**
+			 * The target description. Unused by imported targets.
+			 */
+			RenderTargetDescription description;
+
+			/**
+			 * If true, the target is owned outside of the graph and is never aliased
+			 */
+			bool imported;
+
+			/**
+			 * The physical target assigned by <tt>compile</tt> or <tt>INVALID</tt> if the
+			 * target is imported or is not used by any pass that survived culling
+			 */
+			std::uint32_t physical;
+		};
+
+		/**
+		 * A pass declared on the graph
+		 */
+		struct Pass {
+			/**
+			 * The pass name, used for debugging
+			 */
+			std::string name;
+
+			/**
+			 * The function that renders the pass
+			 */
+			Executor executor;
+
+			/**
+			 * The targets read by the pass
+			 */
+			std::vector<ResourceID> reads;
+
+			/**
+			 * The targets written by the pass
+			 */
+			std::vector<ResourceID> writes;
+
+			/**
+			 * If true, the pass does not contribute to any imported target
+			 */
+			bool culled;
+		};
+
+	private:
+		/**
+		 * The declared targets
+		 */
+		std::vector<Resource> resources;
+
+		/**
+		 * The declared passes
+		 */
+		std::vector<Pass> passes;
+
+		/**
+		 * The passes that survived culling, in execution order
+		 */
+		std::vector<PassID> order;
+
+		/**
+		 * The description of every physical target
+		 */
+		std::vector<RenderTargetDescription> physicalTargets;
+
+		/**
+		 * The graph size, in pixels
+		 */
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+	public:
+		/**
+		 * Removes every target and pass from the graph
+		 */
+		void clear();
+
+		/**
+		 * Sets the graph size. Target sizes are relative to it.
+		 *
+		 * @param width the graph width, in pixels
+		 * @param height the graph height, in pixels
+		 */
+		void setSize(unsigned int width, unsigned int height);
+
+		/**
+		 * Declares a transient target, which only lives while it is used by the
+		 * passes of a frame and may share memory with other transient targets
+		 *
+		 * @param name the target name
+		 * @param description the target description
+		 *
+		 * @return the target id
+		 */
+		ResourceID createTarget(std::string name, const RenderTargetDescription& description);
+
+		/**
+		 * Declares a target owned outside of the graph. Passes writing imported
+		 * targets are never culled.
+		 *
+		 * @param name the target name
+		 *
+		 * @return the target id
+		 */
+		ResourceID importTarget(std::string name);
+
+		/**
+		 * Declares a pass
+		 *
+		 * @param name the pass name
+		 * @param executor the function that renders the pass
+		 *
+		 * @return a builder used to declare the targets the pass reads and writes
+		 */
+		PassBuilder addPass(std::string name, Executor executor);
+
+		/**
+		 * Culls, orders and assigns physical targets to the declared passes.
+		 *
+		 * @throws std::logic_error if the passes have a cyclic dependency
+		 */
+		void compile();
+
+		/**
+		 * Executes the passes that survived culling, in order
+		 */
+		void execute() const;
+
+	public:
+		/**
+		 * @return the graph width, in pixels
+		 */
+		unsigned int getWidth() const;
+
+		/**
+		 * @return the graph height, in pixels
+		 */
+		unsigned int getHeight() const;
+
+		/**
+		 * @return the number of physical targets needed by the compiled graph
+		 */
+		std::size_t getPhysicalTargetCount() const;
+
+		/**
+		 * @param index the physical target index
+		 *
+		 * @return the description of a physical target
+		 */
+		const RenderTargetDescription& getPhysicalTargetDescription(std::uint32_t index) const;
+
+		/**
+		 * @param resource the target id
+		 *
+		 * @return the physical target assigned to a transient target or <tt>INVALID</tt>
+		 * if the target is not used by the compiled graph
+		 */
+		std::uint32_t getPhysicalTarget(ResourceID resource) const;
+
+		/**
+		 * @param description the target description
+		 *
+		 * @return the width of a target, in pixels
+		 */
+		unsigned int getTargetWidth(const RenderTargetDescription& description) const;
+
+		/**
+		 * @param description the target description
+		 *
+		 * @return the height of a target, in pixels
+		 */
+		unsigned int getTargetHeight(const RenderTargetDescription& description) const;
+
+		/**
+		 * @param pass the pass id
+		 *
+		 * @return true if the pass was culled by the last compilation
+		 */
+		bool isCulled(PassID pass) const;
+
+		/**
+		 * @return the passes that survived culling, in execution order
+		 */
+		const std::vector<PassID>& getOrder() const;
+
+		/**
+		 * @param pass the pass id
+		 *
+		 * @return the pass name
+		 */
+		const std::string& getPassName(PassID pass) const;
+
+	private:
+		/**
+		 * Marks every pass that does not contribute to a imported target as culled
+		 */
+		void cull();
+
+		/**
+		 * Orders the passes that survived culling
+		 */
+		void sort();
+
+		/**
+		 * Computes the lifetime of every transient target and assigns physical
+		 * targets to them
+		 */
+		void alias();
+
+	};
+
+}
@@ -0,0 +1,219 @@
+//
+// Created by Rogiel Sulzbach on 8/14/17.
+//
+
+#include "RenderQueue.hpp"
+
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace XYZ::Graphics::Renderer {
+
+	void RenderQueue::clear() {
+		items.clear();
+		sorted.clear();
+		shaders.clear();
+	}
+
+	void RenderQueue::push(RenderPass pass, Shader::ShaderProgram& shader, Model::Model& model,
+						   const glm::mat4& modelMatrix, float depth, const Model::LevelOfDetail& levelOfDetail,
+						   Shader::ShaderProgram* instancedShader) {
+		// a frame uses only a handful of shader programs, a linear search is faster than any map
+		auto found = std::find(shaders.begin(), shaders.end(), &shader);
+		auto shaderIndex = std::uint32_t(found - shaders.begin());
+		if(found == shaders.end()) {
+			shaders.push_back(&shader);
+		}
+
+		// shadow passes have no material, only the depth matters
+		std::size_t material = 0;
+		if(pass != RenderPass::SHADOW) {
+			material = model.getMaterialHash();
+		}
+
+		// draws of the same geometry are sorted next to each other so they can be instanced
+		auto geometry = std::hash<const void*>()(model.getInstancingKey());
+
+		auto key = makeKey(pass, shaderIndex, material, geometry, depth);
+		sorted.push_back(SortEntry{key, std::uint32_t(items.size())});
+		items.push_back(DrawItem{key, pass, &shader, instancedShader, &model, modelMatrix, levelOfDetail});
+	}
+
+	void RenderQueue::sort() {
+		radixSort();
+	}
+
+	void RenderQueue::record(CommandBuffer& commandBuffer) {
+		statistics = Statistics();
+
+		Shader::ShaderProgram* currentShader = nullptr;
+		Model::Model* currentMaterial = nullptr;
+
+		for(std::size_t i = 0; i < sorted.size();) {
+			auto& item = items[sorted[i].index];
+
+			// find the run of items that can be drawn with a single instanced draw
+			// or, if they do not share the same geometry, a single multi-draw
+			std::size_t count = 1;
+			bool sameGeometry = true;
+			if(item.instancedShader != nullptr && item.model->getInstancingKey() != nullptr) {
+				while(i + count < sorted.size() && canBatch(item, items[sorted[i + count].index])) {
+					auto& next = items[sorted[i + count].index];
+					sameGeometry = sameGeometry && next.model->getInstancingKey() == item.model->getInstancingKey();
+					count++;
+				}
+			}
+
+			auto shader = count > 1 ? item.instancedShader : item.shader;
+			if(shader != currentShader) {
+				commandBuffer.bindProgram(*shader);
+				currentShader = shader;
+				currentMaterial = nullptr;
+				statistics.shaderChanges++;
+			}
+
+			if(count == 1) {
+				commandBuffer.setUniform("model", item.modelMatrix);
+				if(item.pass == RenderPass::GEOMETRY) {
+					commandBuffer.setUniform("inversedTransposedModel", glm::transpose(glm::inverse(item.modelMatrix)));
+				}
+			}
+
+			if(item.pass == RenderPass::GEOMETRY) {
+				if(currentMaterial == nullptr || !currentMaterial->hasSameMaterial(*item.model)) {
+					commandBuffer.setMaterial(*item.model, item.levelOfDetail);
+					currentMaterial = item.model;
+					statistics.materialChanges++;
+				}
+			}
+
+			if(count == 1) {
+				commandBuffer.draw(*item.model, item.levelOfDetail);
+			} else if(sameGeometry) {
+				instanceMatrices.clear();
+				for(std::size_t j = 0; j < count; j++) {
+					instanceMatrices.push_back(items[sorted[i + j].index].modelMatrix);
+				}
+				commandBuffer.drawInstanced(*item.model, item.levelOfDetail, instanceMatrices);
+
+				statistics.instancedDrawCalls++;
+				statistics.instances += count;
+			} else {
+				instanceMatrices.clear();
+				batchModels.clear();
+				for(std::size_t j = 0; j < count; j++) {
+					auto& batched = items[sorted[i + j].index];
+					instanceMatrices.push_back(batched.modelMatrix);
+					batchModels.push_back(batched.model);
+				}
+				commandBuffer.drawMulti(batchModels, item.levelOfDetail, instanceMatrices);
+
+				statistics.multiDrawCalls++;
+				statistics.multiDrawItems += count;
+			}
+			statistics.drawCalls++;
+
+			i += count;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::size_t RenderQueue::size() const {
+		return items.size();
+	}
+
+	bool RenderQueue::empty() const {
+		return items.empty();
+	}
+
+	const RenderQueue::Statistics& RenderQueue::getStatistics() const {
+		return statistics;
+	}
+
+	std::uint64_t RenderQueue::computeHash() const {
+		// FNV-1a over the fields that affect what is drawn
+		std::uint64_t hash = 14695981039346656037ull;
+		auto combine = [&hash](const void* data, std::size_t size) {
+			const auto* bytes = static_cast<const unsigned char*>(data);
+			for(std::size_t i = 0; i < size; i++) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+
+		for(const auto& item : items) {
+			combine(&item.pass, sizeof(item.pass));
+			combine(&item.shader, sizeof(item.shader));
+			combine(&item.model, sizeof(item.model));
+			combine(&item.modelMatrix[0][0], sizeof(item.modelMatrix));
+		}
+		return hash;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::uint64_t RenderQueue::makeKey(RenderPass pass, std::uint32_t shader, std::size_t material,
+									  std::size_t geometry, float depth) {
+		// fold the material hash into 16 bits and the geometry hash into 8 bits
+		auto materialBits = std::uint64_t(material);
+		materialBits = (materialBits ^ (materialBits >> 16) ^ (materialBits >> 32) ^ (materialBits >> 48)) & 0xFFFF;
+
+		auto geometryBits = std::uint64_t(geometry);
+		geometryBits = (geometryBits ^ (geometryBits >> 8) ^ (geometryBits >> 16) ^ (geometryBits >> 24) ^
+						(geometryBits >> 32)) & 0xFF;
+
+		auto depthBits = std::uint64_t(glm::clamp(depth, 0.0f, 1.0f) * float(0xFFFFFF));
+
+		return (std::uint64_t(pass) & 0xF) << 60 |
+			   (std::uint64_t(shader) & 0xFFF) << 48 |
+			   materialBits << 32 |
+			   geometryBits << 24 |
+			   depthBits;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::radixSort() {
+		// least significant digit radix sort, one byte per pass. Passes where every
+		// key has the same byte are skipped, which is common for the pass and shader
+		// bytes.
+		scratch.resize(sorted.size());
+
+		for(unsigned int shift = 0; shift < 64; shift += 8) {
+			std::size_t histogram[256] = {0};
+			for(const auto& entry : sorted) {
+				histogram[(entry.key >> shift) & 0xFF]++;
+			}
+
+			if(sorted.empty() || histogram[(sorted.front().key >> shift) & 0xFF] == sorted.size()) {
+				continue;
+			}
+
+			std::size_t offset = 0;
+			for(auto& count : histogram) {
+				auto bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for(const auto& entry : sorted) {
+				scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+			}
+			sorted.swap(scratch);
+		}
+	}
+
+	bool RenderQueue::canBatch(const DrawItem& first, const DrawItem& item) {
+		if(item.pass != first.pass || item.shader != first.shader || item.instancedShader != first.instancedShader) {
+			return false;
+		}
+		if(item.model->getInstancingKey() == nullptr) {
+			return false;
+		}
+		return item.pass == RenderPass::SHADOW || first.model->hasSameMaterial(*item.model);
+	}
+
+}
@@ -0,0 +1,293 @@
+//
+// Created by Rogiel Sulzbach on 8/14/17.
+//
+
+#pragma once
+
+#include "CommandBuffer.hpp"
+
+#include "XYZ/Graphics/Model/Model.hpp"
+#include "XYZ/Graphics/Shader/ShaderProgram.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * The pass a draw item is rendered on. The pass is stored in the most
+	 * significant bits of the sort key, so all items of a pass are submitted
+	 * together.
+	 */
+	enum class RenderPass : std::uint8_t {
+		/**
+		 * Opaque geometry rendered into the geometry buffer
+		 */
+		GEOMETRY = 0,
+
+		/**
+		 * Depth-only geometry rendered into a shadow map
+		 */
+		SHADOW = 1
+	};
+
+	/**
+	 * A render queue collects the draws of a frame and records them in a order
+	 * that minimizes the number of state changes.
+	 *
+	 * Every draw item is tagged with a 64-bit sort key that contains, from the
+	 * most significant to the least significant bits:
+	 *
+	 * <pre>
+	 *  63      60 59        48 47          32 31      24 23                  0
+	 * +----------+------------+--------------+----------+---------------------+
+	 * |   pass   |   shader   |   material   | geometry |        depth        |
+	 * +----------+------------+--------------+----------+---------------------+
+	 * </pre>
+	 *
+	 * Sorting the keys groups draws by pass, then by shader program, then by
+	 * material, then by geometry and finally orders them front-to-back so that
+	 * early depth testing can reject hidden fragments. During recording, shader
+	 * programs and materials are only bound when they differ from the previous draw.
+	 *
+	 * Consecutive draws that share shader and material are merged when the items
+	 * were pushed with a instanced shader variant and their model supports
+	 * instancing: into a single instanced draw if they also share the same
+	 * geometry, and into a single multi-draw otherwise.
+	 */
+	class RenderQueue {
+	public:
+		/**
+		 * A single draw submitted to the queue
+		 */
+		struct DrawItem {
+			/**
+			 * The draw item sort key
+			 */
+			std::uint64_t key;
+
+			/**
+			 * The pass the item is rendered on
+			 */
+			RenderPass pass;
+
+			/**
+			 * The shader program used to render the item
+			 */
+			Shader::ShaderProgram* shader;
+
+			/**
+			 * The instanced variant of <tt>shader</tt> or <tt>nullptr</tt> if the item
+			 * must not be instanced
+			 */
+			Shader::ShaderProgram* instancedShader;
+
+			/**
+			 * The model to be rendered
+			 */
+			Model::Model* model;
+
+			/**
+			 * The model world matrix
+			 */
+			glm::mat4 modelMatrix;
+
+			/**
+			 * The model level of detail
+			 */
+			Model::LevelOfDetail levelOfDetail;
+		};
+
+		/**
+		 * A set of counters collected by the last recording
+		 */
+		struct Statistics {
+			/**
+			 * The number of draw calls issued
+			 */
+			unsigned int drawCalls = 0;
+
+			/**
+			 * The number of shader programs activated
+			 */
+			unsigned int shaderChanges = 0;
+
+			/**
+			 * The number of times material uniforms and textures were bound
+			 */
+			unsigned int materialChanges = 0;
+
+			/**
+			 * The number of instanced draw calls issued. Included in <tt>drawCalls</tt>.
+			 */
+			unsigned int instancedDrawCalls = 0;
+
+			/**
+			 * The number of draw items rendered by instanced draw calls
+			 */
+			unsigned int instances = 0;
+
+			/**
+			 * The number of multi-draw calls issued. Included in <tt>drawCalls</tt>.
+			 */
+			unsigned int multiDrawCalls = 0;
+
+			/**
+			 * The number of draw items rendered by multi-draw calls
+			 */
+			unsigned int multiDrawItems = 0;
+		};
+
+	private:
+		/**
+		 * The draw items in submission order
+		 */
+		std::vector<DrawItem> items;
+
+		/**
+		 * A (key, item index) pair sorted by the radix sort
+		 */
+		struct SortEntry {
+			std::uint64_t key;
+			std::uint32_t index;
+		};
+
+		/**
+		 * The sorted item entries
+		 */
+		std::vector<SortEntry> sorted;
+
+		/**
+		 * A scratch buffer used by the radix sort
+		 */
+		std::vector<SortEntry> scratch;
+
+		/**
+		 * The shader programs used in the current frame. The position of a shader
+		 * in this list is used as its sort key component.
+		 */
+		std::vector<Shader::ShaderProgram*> shaders;
+
+		/**
+		 * The model matrices of the instanced draw or multi-draw being recorded
+		 */
+		std::vector<glm::mat4> instanceMatrices;
+
+		/**
+		 * The models of the multi-draw being recorded
+		 */
+		std::vector<Model::Model*> batchModels;
+
+		/**
+		 * The statistics of the last recording
+		 */
+		Statistics statistics;
+
+	public:
+		/**
+		 * Removes all draw items from the queue. Allocated memory is kept for
+		 * the next frame.
+		 */
+		void clear();
+
+		/**
+		 * Adds a new draw item to the queue
+		 *
+		 * @param pass the pass the model is rendered on
+		 * @param shader the shader program used to render the model
+		 * @param model the model to be rendered
+		 * @param modelMatrix the model world matrix
+		 * @param depth the normalized [0, 1] distance between the camera and the model
+		 * @param levelOfDetail the model level of detail
+		 * @param instancedShader the instanced variant of <tt>shader</tt>. If <tt>nullptr</tt>,
+		 * the item is never instanced.
+		 */
+		void push(RenderPass pass, Shader::ShaderProgram& shader, Model::Model& model,
+				  const glm::mat4& modelMatrix, float depth, const Model::LevelOfDetail& levelOfDetail,
+				  Shader::ShaderProgram* instancedShader = nullptr);
+
+		/**
+		 * Sorts the draw items by their sort key
+		 */
+		void sort();
+
+		/**
+		 * Records all draw items in sorted order into a command buffer. Does not
+		 * call the graphics API and can be called from any thread.
+		 *
+		 * The "model" uniform is set for every item. For items in the geometry pass,
+		 * the "inversedTransposedModel" uniform and the material are set as well,
+		 * skipping the material when it matches the previous draw.
+		 *
+		 * Instanced draws and multi-draws are recorded with the instanced shader
+		 * variant, which reads the model matrix from a per-instance vertex attribute
+		 * instead. The caller must record the per-frame uniforms on both shader
+		 * variants. All items of a draw use the level of detail of the first item.
+		 *
+		 * @param commandBuffer the command buffer to record into
+		 */
+		void record(CommandBuffer& commandBuffer);
+
+	public:
+		/**
+		 * @return the number of draw items in the queue
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @return true if the queue has no draw items
+		 */
+		bool empty() const;
+
+		/**
+		 * @return the statistics of the last recording
+		 */
+		const Statistics& getStatistics() const;
+
+		/**
+		 * Computes a hash of the draw items, in the order they were pushed. The
+		 * hash changes whenever a item is added or removed or a model, shader or
+		 * model matrix changes, which allows renderers to detect when anything
+		 * derived from the queue must be rendered again.
+		 *
+		 * @return the hash of the draw items
+		 */
+		std::uint64_t computeHash() const;
+
+	public:
+		/**
+		 * Creates a new sort key
+		 *
+		 * @param pass the draw pass
+		 * @param shader the shader index
+		 * @param material the material hash
+		 * @param geometry the geometry hash
+		 * @param depth the normalized [0, 1] depth
+		 *
+		 * @return the sort key
+		 */
+		static std::uint64_t makeKey(RenderPass pass, std::uint32_t shader, std::size_t material,
+									 std::size_t geometry, float depth);
+
+	private:
+		/**
+		 * Radix sorts the entries in <tt>sorted</tt> by key
+		 */
+		void radixSort();
+
+		/**
+		 * Checks if two sorted draw items can be rendered by the same instanced
+		 * draw or multi-draw
+		 *
+		 * @param first the first item of the draw
+		 * @param item the item to check
+		 *
+		 * @return true if <tt>item</tt> can be drawn together with <tt>first</tt>
+		 */
+		static bool canBatch(const DrawItem& first, const DrawItem& item);
+
+	};
+
+}
@@ -0,0 +1,199 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "ShadowAtlas.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace XYZ::Graphics::Renderer {
+
+	bool ShadowAtlas::Tile::operator==(const Tile& other) const {
+		return x == other.x && y == other.y && size == other.size;
+	}
+
+	bool ShadowAtlas::Tile::operator!=(const Tile& other) const {
+		return !(*this == other);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	ShadowAtlas::ShadowAtlas(unsigned int size, unsigned int maxTileSize, unsigned int minTileSize) :
+			size(size),
+			maxTileSize(std::min(maxTileSize, size)),
+			minTileSize(std::max(1u, std::min(minTileSize, std::min(maxTileSize, size)))) {
+		clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void ShadowAtlas::update(std::vector<Request> requests) {
+		// the most important lights are the first to be given a tile
+		std::stable_sort(requests.begin(), requests.end(), [](const Request& a, const Request& b) {
+			return a.importance > b.importance;
+		});
+
+		std::map<Key, unsigned int> tileSizes;
+		for(const auto& request : requests) {
+			tileSizes.emplace(request.key, getTileSize(request.importance));
+		}
+
+		// release the tiles that are not requested anymore or that are larger than requested
+		for(auto it = tiles.begin(); it != tiles.end();) {
+			auto found = tileSizes.find(it->first);
+			if(found == tileSizes.end() || it->second.size > found->second) {
+				release(it->second);
+				it = tiles.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		for(const auto& request : requests) {
+			auto tileSize = tileSizes[request.key];
+			auto current = tiles.find(request.key);
+			if(current != tiles.end() && current->second.size == tileSize) {
+				continue;
+			}
+
+			// fall back to smaller tiles if the atlas is full. A light that already
+			// has a smaller tile keeps it, so that it is not reallocated every frame.
+			for(auto candidate = tileSize; candidate >= minTileSize; candidate /= 2) {
+				if(current != tiles.end() && candidate <= current->second.size) {
+					break;
+				}
+
+				Tile tile;
+				if(!allocate(candidate, tile)) {
+					continue;
+				}
+
+				if(current != tiles.end()) {
+					release(current->second);
+					current->second = tile;
+				} else {
+					tiles.emplace(request.key, tile);
+				}
+				break;
+			}
+		}
+	}
+
+	void ShadowAtlas::clear() {
+		tiles.clear();
+		freeTiles.assign(getLevel(minTileSize) + 1, {});
+		freeTiles[0].emplace(0, 0);
+	}
+
+	const ShadowAtlas::Tile* ShadowAtlas::getTile(Key key) const {
+		auto found = tiles.find(key);
+		if(found == tiles.end()) {
+			return nullptr;
+		}
+		return &found->second;
+	}
+
+	std::size_t ShadowAtlas::getTileCount() const {
+		return tiles.size();
+	}
+
+	unsigned int ShadowAtlas::getSize() const {
+		return size;
+	}
+
+	unsigned int ShadowAtlas::getTileSize(float importance) const {
+		// the smallest power of two that covers the light on the screen
+		auto tileSize = maxTileSize;
+		while(tileSize > minTileSize && float(tileSize / 2) >= importance * float(maxTileSize)) {
+			tileSize /= 2;
+		}
+		return tileSize;
+	}
+
+	float ShadowAtlas::computeImportance(const glm::vec3& position, float radius, const glm::vec3& cameraPosition,
+										 float fieldOfView) {
+		auto distance = glm::length(position - cameraPosition);
+		if(!std::isfinite(radius) || distance <= radius) {
+			return 1.0f;
+		}
+		return glm::clamp(radius / (distance * std::tan(fieldOfView * 0.5f)), 0.0f, 1.0f);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::size_t ShadowAtlas::getLevel(unsigned int tileSize) const {
+		std::size_t level = 0;
+		while((size >> level) > tileSize) {
+			level++;
+		}
+		return level;
+	}
+
+	bool ShadowAtlas::allocate(unsigned int tileSize, Tile& tile) {
+		auto level = getLevel(tileSize);
+
+		// find the smallest free tile that is at least as large as requested
+		auto parent = level;
+		while(freeTiles[parent].empty()) {
+			if(parent == 0) {
+				return false;
+			}
+			parent--;
+		}
+
+		// and split it until it has the requested size
+		for(; parent < level; parent++) {
+			auto origin = *freeTiles[parent].begin();
+			freeTiles[parent].erase(freeTiles[parent].begin());
+
+			auto half = size >> (parent + 1);
+			for(unsigned int y = 0; y < 2; y++) {
+				for(unsigned int x = 0; x < 2; x++) {
+					freeTiles[parent + 1].emplace(origin.first + x * half, origin.second + y * half);
+				}
+			}
+		}
+
+		auto origin = *freeTiles[level].begin();
+		freeTiles[level].erase(freeTiles[level].begin());
+
+		tile = Tile{origin.first, origin.second, tileSize};
+		return true;
+	}
+
+	void ShadowAtlas::release(const Tile& tile) {
+		auto level = getLevel(tile.size);
+		auto x = tile.x;
+		auto y = tile.y;
+
+		// merge the tile with its siblings for as long as all of them are free
+		for(; level > 0; level--) {
+			auto parentSize = size >> (level - 1);
+			auto parentX = x - x % parentSize;
+			auto parentY = y - y % parentSize;
+			auto half = parentSize / 2;
+
+			auto& free = freeTiles[level];
+			bool siblingsFree = true;
+			for(unsigned int i = 0; i < 4 && siblingsFree; i++) {
+				auto sibling = std::make_pair(parentX + (i % 2) * half, parentY + (i / 2) * half);
+				siblingsFree = (sibling.first == x && sibling.second == y) || free.count(sibling) != 0;
+			}
+			if(!siblingsFree) {
+				break;
+			}
+
+			for(unsigned int i = 0; i < 4; i++) {
+				free.erase(std::make_pair(parentX + (i % 2) * half, parentY + (i / 2) * half));
+			}
+			x = parentX;
+			y = parentY;
+		}
+
+		freeTiles[level].emplace(x, y);
+	}
+
+}
@@ -0,0 +1,193 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * Allocates the shadow maps of every shadow casting light from a single
+	 * square texture.
+	 *
+	 * The atlas is a quadtree: every tile is a power of two and is split in four
+	 * to make room for smaller tiles, and four free siblings are merged back
+	 * when released. Tiles are sized by the importance of their light on the
+	 * screen, the most important lights are allocated first and lights that do
+	 * not fit get a smaller tile or, if not even the smallest tile fits, no
+	 * tile at all.
+	 *
+	 * A light keeps its tile across frames for as long as its requested size does
+	 * not change, so the contents of the tile can be cached by the renderer.
+	 */
+	class ShadowAtlas {
+	public:
+		/**
+		 * Identifies the owner of a tile, usually a light
+		 */
+		using Key = const void*;
+
+		/**
+		 * A square region of the atlas, in pixels
+		 */
+		struct Tile {
+			unsigned int x = 0;
+			unsigned int y = 0;
+			unsigned int size = 0;
+
+			/**
+			 * @param other the tile to compare to
+			 *
+			 * @return true if both tiles cover the same region
+			 */
+			bool operator==(const Tile& other) const;
+
+			/**
+			 * @param other the tile to compare to
+			 *
+			 * @return true if the tiles cover different regions
+			 */
+			bool operator!=(const Tile& other) const;
+		};
+
+		/**
+		 * A request for a tile
+		 */
+		struct Request {
+			/**
+			 * The tile owner
+			 */
+			Key key;
+
+			/**
+			 * The importance of the owner on the screen, in [0, 1]. See <tt>computeImportance</tt>.
+			 */
+			float importance;
+		};
+
+	private:
+		/**
+		 * The atlas size, in pixels
+		 */
+		unsigned int size;
+
+		/**
+		 * The size of the tile given to a light that covers the whole screen
+		 */
+		unsigned int maxTileSize;
+
+		/**
+		 * The size of the smallest tile
+		 */
+		unsigned int minTileSize;
+
+		/**
+		 * The origin of every free tile, indexed by level. The tiles of level
+		 * <tt>n</tt> have <tt>size >> n</tt> pixels.
+		 */
+		std::vector<std::set<std::pair<unsigned int, unsigned int>>> freeTiles;
+
+		/**
+		 * The tile allocated to every owner
+		 */
+		std::map<Key, Tile> tiles;
+
+	public:
+		/**
+		 * Creates a new shadow atlas. Every size must be a power of two.
+		 *
+		 * @param size the atlas size, in pixels
+		 * @param maxTileSize the size of the largest tile
+		 * @param minTileSize the size of the smallest tile
+		 */
+		ShadowAtlas(unsigned int size, unsigned int maxTileSize, unsigned int minTileSize);
+
+	public:
+		/**
+		 * Assigns a tile to every request. Tiles of owners that are not requested
+		 * anymore are released and owners whose requested size changed are given
+		 * a new tile.
+		 *
+		 * @param requests the tile requests of the frame
+		 */
+		void update(std::vector<Request> requests);
+
+		/**
+		 * Releases every tile
+		 */
+		void clear();
+
+		/**
+		 * @param key the tile owner
+		 *
+		 * @return the tile allocated to <tt>key</tt> or null if it has no tile
+		 */
+		const Tile* getTile(Key key) const;
+
+		/**
+		 * @return the number of allocated tiles
+		 */
+		std::size_t getTileCount() const;
+
+		/**
+		 * @return the atlas size, in pixels
+		 */
+		unsigned int getSize() const;
+
+		/**
+		 * @param importance the importance of the light on the screen, in [0, 1]
+		 *
+		 * @return the size of the tile requested by a light
+		 */
+		unsigned int getTileSize(float importance) const;
+
+		/**
+		 * Estimates the fraction of the screen height covered by the influence
+		 * sphere of a light
+		 *
+		 * @param position the light position
+		 * @param radius the light influence radius
+		 * @param cameraPosition the camera position
+		 * @param fieldOfView the camera vertical field of view, in radians
+		 *
+		 * @return the light importance, in [0, 1]
+		 */
+		static float computeImportance(const glm::vec3& position, float radius, const glm::vec3& cameraPosition,
+									   float fieldOfView);
+
+	private:
+		/**
+		 * @param tileSize the tile size, in pixels
+		 *
+		 * @return the level of the tiles with <tt>tileSize</tt> pixels
+		 */
+		std::size_t getLevel(unsigned int tileSize) const;
+
+		/**
+		 * Allocates a tile, splitting a larger free tile if needed
+		 *
+		 * @param tileSize the tile size, in pixels
+		 * @param tile the allocated tile
+		 *
+		 * @return true if the tile was allocated
+		 */
+		bool allocate(unsigned int tileSize, Tile& tile);
+
+		/**
+		 * Releases a tile, merging it with its free siblings
+		 *
+		 * @param tile the tile to release
+		 */
+		void release(const Tile& tile);
+
+	};
+
+}
@@ -0,0 +1,153 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "ShadowCascades.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace XYZ::Graphics::Renderer {
+
+	ShadowCascades::ShadowCascades(unsigned int resolution) : resolution(resolution) {
+
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void ShadowCascades::update(const glm::mat4& view, float fieldOfView, float aspectRatio, float zNear, float zFar,
+								const glm::vec3& lightDirection) {
+		zNear = std::max(zNear, 0.01f);
+		auto farDistance = std::max(std::min(zFar, shadowDistance), zNear);
+
+		auto inverseView = glm::inverse(view);
+		auto tanHalfFieldOfView = std::tan(fieldOfView * 0.5f);
+
+		// the light view is centered on the world origin and only depends on the
+		// light direction, so that snapping to its texels is stable
+		auto direction = glm::normalize(lightDirection);
+		auto up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		auto lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+		auto nearDistance = zNear;
+		for(unsigned int i = 0; i < cascadeCount; i++) {
+			auto& cascade = cascades[i];
+			cascade.nearDistance = nearDistance;
+			cascade.farDistance = computeSplit(splitScheme, splitLambda, zNear, farDistance, i, cascadeCount);
+
+			// the corners of the slice, in world space
+			std::array<glm::vec3, 8> corners;
+			auto center = glm::vec3(0.0f);
+			for(unsigned int j = 0; j < 8; j++) {
+				auto distance = j < 4 ? cascade.nearDistance : cascade.farDistance;
+				auto halfHeight = distance * tanHalfFieldOfView;
+				auto halfWidth = halfHeight * aspectRatio;
+
+				corners[j] = glm::vec3(inverseView * glm::vec4(
+						(j & 1) != 0 ? halfWidth : -halfWidth,
+						(j & 2) != 0 ? halfHeight : -halfHeight,
+						-distance, 1.0f
+				));
+				center += corners[j] / 8.0f;
+			}
+
+			// the center lies on the view axis, so the radius does not change as the
+			// camera rotates. Rounding it up absorbs the floating point noise.
+			auto radius = 0.0f;
+			for(const auto& corner : corners) {
+				radius = std::max(radius, glm::length(corner - center));
+			}
+			radius = std::ceil(radius * 16.0f) / 16.0f;
+
+			// move the projection in whole texels only
+			auto texelSize = 2.0f * radius / float(resolution);
+			auto lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+			lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+			lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+			auto projection = glm::ortho(
+					lightCenter.x - radius, lightCenter.x + radius,
+					lightCenter.y - radius, lightCenter.y + radius,
+					-lightCenter.z - radius - casterDistance, -lightCenter.z + radius
+			);
+
+			cascade.lightSpaceMatrix = projection * lightView;
+			cascade.center = center;
+			cascade.radius = radius;
+			cascade.texelSize = texelSize;
+
+			nearDistance = cascade.farDistance;
+		}
+	}
+
+	float ShadowCascades::computeSplit(CascadeSplitScheme scheme, float lambda, float zNear, float zFar,
+									   unsigned int index, unsigned int count) {
+		auto ratio = float(index + 1) / float(count);
+		auto uniform = zNear + (zFar - zNear) * ratio;
+		auto logarithmic = zNear * std::pow(zFar / zNear, ratio);
+
+		switch(scheme) {
+			case CascadeSplitScheme::UNIFORM:
+				return uniform;
+			case CascadeSplitScheme::LOGARITHMIC:
+				return logarithmic;
+			case CascadeSplitScheme::PRACTICAL:
+				break;
+		}
+		return glm::mix(uniform, logarithmic, lambda);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const ShadowCascades::Cascade& ShadowCascades::getCascade(unsigned int index) const {
+		return cascades[index];
+	}
+
+	unsigned int ShadowCascades::getCascadeCount() const {
+		return cascadeCount;
+	}
+
+	void ShadowCascades::setCascadeCount(unsigned int cascadeCount) {
+		ShadowCascades::cascadeCount = glm::clamp(cascadeCount, 1u, MAX_CASCADES);
+	}
+
+	unsigned int ShadowCascades::getResolution() const {
+		return resolution;
+	}
+
+	CascadeSplitScheme ShadowCascades::getSplitScheme() const {
+		return splitScheme;
+	}
+
+	void ShadowCascades::setSplitScheme(CascadeSplitScheme splitScheme) {
+		ShadowCascades::splitScheme = splitScheme;
+	}
+
+	float ShadowCascades::getSplitLambda() const {
+		return splitLambda;
+	}
+
+	void ShadowCascades::setSplitLambda(float splitLambda) {
+		ShadowCascades::splitLambda = glm::clamp(splitLambda, 0.0f, 1.0f);
+	}
+
+	float ShadowCascades::getShadowDistance() const {
+		return shadowDistance;
+	}
+
+	void ShadowCascades::setShadowDistance(float shadowDistance) {
+		ShadowCascades::shadowDistance = shadowDistance;
+	}
+
+	float ShadowCascades::getCasterDistance() const {
+		return casterDistance;
+	}
+
+	void ShadowCascades::setCasterDistance(float casterDistance) {
+		ShadowCascades::casterDistance = casterDistance;
+	}
+
+}
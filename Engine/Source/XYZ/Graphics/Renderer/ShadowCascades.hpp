@@ -0,0 +1,229 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * How the view frustum is split between the shadow cascades
+	 */
+	enum class CascadeSplitScheme : std::uint8_t {
+		/**
+		 * Every cascade covers the same depth range. Wastes resolution far away
+		 * and lacks it close to the camera.
+		 */
+		UNIFORM,
+
+		/**
+		 * Every cascade covers the same ratio of depth, matching the perspective
+		 * aliasing. Close cascades get very thin.
+		 */
+		LOGARITHMIC,
+
+		/**
+		 * A blend of the uniform and logarithmic splits, controlled by the
+		 * split lambda
+		 */
+		PRACTICAL
+	};
+
+	/**
+	 * Computes the cascades of a directional light shadow map.
+	 *
+	 * The camera frustum, up to the shadow distance, is split in depth and every
+	 * slice is covered by a orthographic light projection. Each projection is
+	 * fitted to the bounding sphere of its slice, whose size does not change as
+	 * the camera rotates, and its origin is snapped to whole shadow map texels,
+	 * so that the shadows do not shimmer when the camera moves.
+	 */
+	class ShadowCascades {
+	public:
+		/**
+		 * The maximum number of cascades
+		 */
+		static constexpr unsigned int MAX_CASCADES = 4;
+
+		/**
+		 * A cascade of the shadow map
+		 */
+		struct Cascade {
+			/**
+			 * The view distance the cascade starts at
+			 */
+			float nearDistance = 0.0f;
+
+			/**
+			 * The view distance the cascade ends at
+			 */
+			float farDistance = 0.0f;
+
+			/**
+			 * The light view-projection matrix
+			 */
+			glm::mat4 lightSpaceMatrix;
+
+			/**
+			 * The center of the bounding sphere of the cascade slice, in world space
+			 */
+			glm::vec3 center;
+
+			/**
+			 * The radius of the bounding sphere of the cascade slice
+			 */
+			float radius = 0.0f;
+
+			/**
+			 * The size of a shadow map texel, in world units
+			 */
+			float texelSize = 0.0f;
+		};
+
+	private:
+		/**
+		 * The number of cascades in use
+		 */
+		unsigned int cascadeCount = MAX_CASCADES;
+
+		/**
+		 * The size of the shadow map of every cascade, in pixels
+		 */
+		unsigned int resolution;
+
+		/**
+		 * How the view frustum is split
+		 */
+		CascadeSplitScheme splitScheme = CascadeSplitScheme::PRACTICAL;
+
+		/**
+		 * The weight of the logarithmic split on the practical split scheme, in [0, 1]
+		 */
+		float splitLambda = 0.75f;
+
+		/**
+		 * The view distance after which nothing is shadowed
+		 */
+		float shadowDistance = 150.0f;
+
+		/**
+		 * How far towards the light, past the cascade slice, casters are rendered
+		 */
+		float casterDistance = 250.0f;
+
+		/**
+		 * The cascades computed by the last update
+		 */
+		std::array<Cascade, MAX_CASCADES> cascades;
+
+	public:
+		/**
+		 * Creates a new set of shadow cascades
+		 *
+		 * @param resolution the size of the shadow map of every cascade, in pixels
+		 */
+		explicit ShadowCascades(unsigned int resolution = 2048);
+
+	public:
+		/**
+		 * Computes the cascades of a camera
+		 *
+		 * @param view the camera view matrix
+		 * @param fieldOfView the camera vertical field of view, in radians
+		 * @param aspectRatio the camera aspect ratio
+		 * @param zNear the camera near plane
+		 * @param zFar the camera far plane
+		 * @param lightDirection the light direction
+		 */
+		void update(const glm::mat4& view, float fieldOfView, float aspectRatio, float zNear, float zFar,
+					const glm::vec3& lightDirection);
+
+		/**
+		 * Computes where a cascade ends
+		 *
+		 * @param scheme the split scheme
+		 * @param lambda the weight of the logarithmic split on the practical split scheme
+		 * @param zNear the distance the first cascade starts at
+		 * @param zFar the distance the last cascade ends at
+		 * @param index the cascade index
+		 * @param count the number of cascades
+		 *
+		 * @return the view distance the cascade ends at
+		 */
+		static float computeSplit(CascadeSplitScheme scheme, float lambda, float zNear, float zFar,
+								  unsigned int index, unsigned int count);
+
+	public:
+		/**
+		 * @param index the cascade index
+		 *
+		 * @return a cascade computed by the last update
+		 */
+		const Cascade& getCascade(unsigned int index) const;
+
+		/**
+		 * @return the number of cascades in use
+		 */
+		unsigned int getCascadeCount() const;
+
+		/**
+		 * @param cascadeCount the number of cascades in use, in [1, MAX_CASCADES]
+		 */
+		void setCascadeCount(unsigned int cascadeCount);
+
+		/**
+		 * @return the size of the shadow map of every cascade, in pixels
+		 */
+		unsigned int getResolution() const;
+
+		/**
+		 * @return how the view frustum is split
+		 */
+		CascadeSplitScheme getSplitScheme() const;
+
+		/**
+		 * @param splitScheme how the view frustum is split
+		 */
+		void setSplitScheme(CascadeSplitScheme splitScheme);
+
+		/**
+		 * @return the weight of the logarithmic split on the practical split scheme
+		 */
+		float getSplitLambda() const;
+
+		/**
+		 * @param splitLambda the weight of the logarithmic split on the practical
+		 * split scheme, in [0, 1]
+		 */
+		void setSplitLambda(float splitLambda);
+
+		/**
+		 * @return the view distance after which nothing is shadowed
+		 */
+		float getShadowDistance() const;
+
+		/**
+		 * @param shadowDistance the view distance after which nothing is shadowed
+		 */
+		void setShadowDistance(float shadowDistance);
+
+		/**
+		 * @return how far towards the light, past the cascade slice, casters are rendered
+		 */
+		float getCasterDistance() const;
+
+		/**
+		 * @param casterDistance how far towards the light, past the cascade slice,
+		 * casters are rendered
+		 */
+		void setCasterDistance(float casterDistance);
+
+	};
+
+}
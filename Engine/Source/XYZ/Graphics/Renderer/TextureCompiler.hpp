@@ -22,10 +22,13 @@ namespace XYZ::Graphics::Renderer {
 	class TextureCompiler {
 	public:
 		/**
-         * Compiles a vertex shader
-         *
-         * @return the compiled vertex shader
-         */
+		 * Compiles a texture image. The texture may be uploaded asynchronously,
+		 * in which case it is not sampled until <tt>Texture::isReady</tt> returns true.
+		 *
+		 * @param textureImage the texture image
+		 *
+		 * @return the compiled texture
+		 */
 		virtual Texture::Texture::Ptr compileTexture(
 				const Texture::TextureImage& textureImage) = 0;
 	};
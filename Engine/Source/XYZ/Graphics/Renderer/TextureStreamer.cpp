@@ -0,0 +1,228 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "TextureStreamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace XYZ::Graphics::Renderer {
+
+	TextureStreamer::TextureStreamer(std::size_t memoryBudget, std::size_t uploadBudget) :
+			memoryBudget(memoryBudget), uploadBudget(uploadBudget) {}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int TextureStreamer::add(Key key, unsigned int width, unsigned int height, unsigned int bytesPerTexel) {
+		remove(key);
+
+		Texture texture;
+		texture.width = std::max(1u, width);
+		texture.height = std::max(1u, height);
+		texture.bytesPerTexel = bytesPerTexel;
+		texture.levelCount = getLevelCount(texture.width, texture.height);
+
+		texture.tailLevel = 0;
+		while(texture.tailLevel + 1 < texture.levelCount &&
+			  std::max(texture.width >> texture.tailLevel, texture.height >> texture.tailLevel) > MIN_RESIDENT_SIZE) {
+			texture.tailLevel++;
+		}
+
+		texture.residentLevel = texture.tailLevel;
+		texture.previousLevel = texture.tailLevel;
+		texture.wantedLevel = texture.tailLevel;
+		for(auto level = texture.tailLevel; level < texture.levelCount; level++) {
+			statistics.residentBytes += getLevelSize(texture, level);
+		}
+
+		textures.emplace(key, texture);
+		statistics.textureCount = textures.size();
+		return texture.tailLevel;
+	}
+
+	void TextureStreamer::remove(Key key) {
+		auto found = textures.find(key);
+		if(found == textures.end()) {
+			return;
+		}
+
+		const auto& texture = found->second;
+		for(auto level = texture.residentLevel; level < texture.levelCount; level++) {
+			statistics.residentBytes -= getLevelSize(texture, level);
+		}
+
+		textures.erase(found);
+		statistics.textureCount = textures.size();
+	}
+
+	bool TextureStreamer::contains(Key key) const {
+		return textures.count(key) != 0;
+	}
+
+	void TextureStreamer::request(Key key, float footprint) {
+		auto found = textures.find(key);
+		if(found != textures.end()) {
+			found->second.footprint = std::min(found->second.footprint, footprint);
+		}
+	}
+
+	void TextureStreamer::update(std::vector<Change>& changes) {
+		frame++;
+		statistics.uploadedBytes = 0;
+		statistics.evictedBytes = 0;
+
+		// the wanted level is the one whose texels are as large as a pixel. Textures
+		// that were not requested only need the levels that are always resident.
+		for(auto& entry : textures) {
+			auto& texture = entry.second;
+			texture.previousLevel = texture.residentLevel;
+			texture.wantedLevel = texture.tailLevel;
+
+			if(std::isfinite(texture.footprint)) {
+				auto size = float(std::max(texture.width, texture.height));
+				auto level = std::floor(std::log2(std::max(1.0f, size * texture.footprint)));
+				texture.wantedLevel = std::min(unsigned(level), texture.tailLevel);
+				texture.lastRequestFrame = frame;
+			}
+			texture.footprint = std::numeric_limits<float>::infinity();
+		}
+
+		auto evict = [this](Texture& texture) {
+			auto size = getLevelSize(texture, texture.residentLevel);
+			texture.residentLevel++;
+			statistics.residentBytes -= size;
+			statistics.evictedBytes += size;
+		};
+
+		// over budget, evict the levels finer than needed, least recently used first
+		if(statistics.residentBytes > memoryBudget) {
+			std::vector<Texture*> unneeded;
+			for(auto& entry : textures) {
+				if(entry.second.residentLevel < entry.second.wantedLevel) {
+					unneeded.push_back(&entry.second);
+				}
+			}
+
+			std::sort(unneeded.begin(), unneeded.end(), [](const Texture* a, const Texture* b) {
+				if(a->lastRequestFrame != b->lastRequestFrame) {
+					return a->lastRequestFrame < b->lastRequestFrame;
+				}
+				return getLevelSize(*a, a->residentLevel) > getLevelSize(*b, b->residentLevel);
+			});
+
+			for(auto* texture : unneeded) {
+				while(statistics.residentBytes > memoryBudget && texture->residentLevel < texture->wantedLevel) {
+					evict(*texture);
+				}
+				if(statistics.residentBytes <= memoryBudget) {
+					break;
+				}
+			}
+		}
+
+		// stream the missing levels in, smallest first, so that every texture gets
+		// sharper one level at a time instead of a few textures getting every level
+		auto isLargerUpload = [](const Texture* a, const Texture* b) {
+			return getLevelSize(*a, a->residentLevel - 1) > getLevelSize(*b, b->residentLevel - 1);
+		};
+		std::priority_queue<Texture*, std::vector<Texture*>, decltype(isLargerUpload)> uploads(isLargerUpload);
+		for(auto& entry : textures) {
+			if(entry.second.residentLevel > entry.second.wantedLevel) {
+				uploads.push(&entry.second);
+			}
+		}
+
+		while(!uploads.empty()) {
+			auto* texture = uploads.top();
+			auto size = getLevelSize(*texture, texture->residentLevel - 1);
+			if((statistics.uploadedBytes != 0 && statistics.uploadedBytes + size > uploadBudget) ||
+			   statistics.residentBytes + size > memoryBudget) {
+				break;
+			}
+
+			uploads.pop();
+			texture->residentLevel--;
+			statistics.residentBytes += size;
+			statistics.uploadedBytes += size;
+			if(texture->residentLevel > texture->wantedLevel) {
+				uploads.push(texture);
+			}
+		}
+
+		// still over budget, the budget shrunk: drop the finest levels, largest first
+		if(statistics.residentBytes > memoryBudget) {
+			auto isSmallerEviction = [](const Texture* a, const Texture* b) {
+				return getLevelSize(*a, a->residentLevel) < getLevelSize(*b, b->residentLevel);
+			};
+			std::priority_queue<Texture*, std::vector<Texture*>, decltype(isSmallerEviction)> evictions(
+					isSmallerEviction);
+			for(auto& entry : textures) {
+				if(entry.second.residentLevel < entry.second.tailLevel) {
+					evictions.push(&entry.second);
+				}
+			}
+
+			while(statistics.residentBytes > memoryBudget && !evictions.empty()) {
+				auto* texture = evictions.top();
+				evictions.pop();
+				evict(*texture);
+				if(texture->residentLevel < texture->tailLevel) {
+					evictions.push(texture);
+				}
+			}
+		}
+
+		for(const auto& entry : textures) {
+			if(entry.second.residentLevel != entry.second.previousLevel) {
+				changes.push_back(Change{entry.first, entry.second.previousLevel, entry.second.residentLevel});
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::size_t TextureStreamer::getMemoryBudget() const {
+		return memoryBudget;
+	}
+
+	void TextureStreamer::setMemoryBudget(std::size_t memoryBudget) {
+		TextureStreamer::memoryBudget = memoryBudget;
+	}
+
+	std::size_t TextureStreamer::getUploadBudget() const {
+		return uploadBudget;
+	}
+
+	void TextureStreamer::setUploadBudget(std::size_t uploadBudget) {
+		TextureStreamer::uploadBudget = uploadBudget;
+	}
+
+	const TextureStreamer::Statistics& TextureStreamer::getStatistics() const {
+		return statistics;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	float TextureStreamer::computeFootprint(float texCoordDensity, float distance, float fieldOfView,
+											float screenHeight) {
+		// the world size covered by a pixel at the given distance
+		auto pixelSize = 2.0f * distance * std::tan(0.5f * fieldOfView) / std::max(1.0f, screenHeight);
+		return texCoordDensity * pixelSize;
+	}
+
+	unsigned int TextureStreamer::getLevelCount(unsigned int width, unsigned int height) {
+		unsigned int levelCount = 1;
+		for(auto size = std::max(width, height); size > 1; size >>= 1) {
+			levelCount++;
+		}
+		return levelCount;
+	}
+
+	std::size_t TextureStreamer::getLevelSize(const Texture& texture, unsigned int level) {
+		return std::size_t(std::max(1u, texture.width >> level)) * std::max(1u, texture.height >> level) *
+			   texture.bytesPerTexel;
+	}
+
+}
@@ -0,0 +1,284 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace XYZ::Graphics::Renderer {
+
+	/**
+	 * Decides which mip levels of every streamed texture are resident.
+	 *
+	 * Every frame the renderer requests the textures of the visible objects with
+	 * the texture coordinate footprint of a screen pixel on the object (see
+	 * <tt>computeFootprint</tt>). The finest requested level of every texture is
+	 * then streamed in coarse-to-fine, one level at a time, smallest levels first,
+	 * for as long as the per-frame upload budget allows. The coarsest levels of
+	 * every texture, up to <tt>MIN_RESIDENT_SIZE</tt> texels, are always resident
+	 * so a texture can be sampled as soon as it is added.
+	 *
+	 * Once the resident levels exceed the memory budget, the levels finer than
+	 * needed are evicted first, least recently requested textures first. If that
+	 * is not enough, the finest levels of every texture are evicted, largest
+	 * first, until the resident levels fit again.
+	 *
+	 * The streamer only decides which levels are resident, the renderer uploads
+	 * and releases them as reported by <tt>update</tt>.
+	 */
+	class TextureStreamer {
+	public:
+		/**
+		 * Identifies a streamed texture
+		 */
+		using Key = const void*;
+
+		/**
+		 * The largest size of the levels that are always resident, in texels
+		 */
+		static constexpr unsigned int MIN_RESIDENT_SIZE = 64;
+
+		/**
+		 * A change of the finest resident level of a texture
+		 */
+		struct Change {
+			/**
+			 * The texture
+			 */
+			Key key;
+
+			/**
+			 * The finest level resident before the update
+			 */
+			unsigned int previousLevel;
+
+			/**
+			 * The finest level resident after the update. If finer than
+			 * <tt>previousLevel</tt>, the levels in between must be uploaded,
+			 * otherwise they must be released.
+			 */
+			unsigned int residentLevel;
+		};
+
+		/**
+		 * The streaming counters
+		 */
+		struct Statistics {
+			/**
+			 * The number of streamed textures
+			 */
+			std::size_t textureCount = 0;
+
+			/**
+			 * The size of every resident level, in bytes
+			 */
+			std::size_t residentBytes = 0;
+
+			/**
+			 * The size of the levels uploaded by the last update, in bytes
+			 */
+			std::size_t uploadedBytes = 0;
+
+			/**
+			 * The size of the levels evicted by the last update, in bytes
+			 */
+			std::size_t evictedBytes = 0;
+		};
+
+	private:
+		/**
+		 * A streamed texture
+		 */
+		struct Texture {
+			/**
+			 * The size of the finest level, in texels
+			 */
+			unsigned int width;
+			unsigned int height;
+
+			/**
+			 * The size of a texel, in bytes
+			 */
+			unsigned int bytesPerTexel;
+
+			/**
+			 * The number of levels of the full mip chain
+			 */
+			unsigned int levelCount;
+
+			/**
+			 * The finest of the levels that are always resident
+			 */
+			unsigned int tailLevel;
+
+			/**
+			 * The finest resident level
+			 */
+			unsigned int residentLevel;
+
+			/**
+			 * The finest level resident before the current update
+			 */
+			unsigned int previousLevel;
+
+			/**
+			 * The finest level needed by the last update
+			 */
+			unsigned int wantedLevel;
+
+			/**
+			 * The smallest footprint requested since the last update
+			 */
+			float footprint = std::numeric_limits<float>::infinity();
+
+			/**
+			 * The last update the texture was requested on
+			 */
+			std::uint64_t lastRequestFrame = 0;
+		};
+
+	private:
+		/**
+		 * The maximum size of the resident levels, in bytes
+		 */
+		std::size_t memoryBudget;
+
+		/**
+		 * The maximum size of the levels uploaded by a single update, in bytes.
+		 * A single level larger than the budget is still uploaded, alone.
+		 */
+		std::size_t uploadBudget;
+
+		/**
+		 * Every streamed texture
+		 */
+		std::unordered_map<Key, Texture> textures;
+
+		/**
+		 * The number of updates so far
+		 */
+		std::uint64_t frame = 0;
+
+		/**
+		 * The counters of the last update
+		 */
+		Statistics statistics;
+
+	public:
+		/**
+		 * Creates a new texture streamer
+		 *
+		 * @param memoryBudget the maximum size of the resident levels, in bytes
+		 * @param uploadBudget the maximum size of the levels uploaded by a single update, in bytes
+		 */
+		TextureStreamer(std::size_t memoryBudget, std::size_t uploadBudget);
+
+	public:
+		/**
+		 * Starts streaming a texture. Only the levels up to <tt>MIN_RESIDENT_SIZE</tt>
+		 * texels are resident, the caller must upload them.
+		 *
+		 * @param key the texture
+		 * @param width the width of the finest level, in texels
+		 * @param height the height of the finest level, in texels
+		 * @param bytesPerTexel the size of a texel, in bytes
+		 *
+		 * @return the finest resident level
+		 */
+		unsigned int add(Key key, unsigned int width, unsigned int height, unsigned int bytesPerTexel);
+
+		/**
+		 * Stops streaming a texture
+		 *
+		 * @param key the texture
+		 */
+		void remove(Key key);
+
+		/**
+		 * @param key the texture
+		 *
+		 * @return true if the texture is streamed
+		 */
+		bool contains(Key key) const;
+
+		/**
+		 * Requests a texture for the next update. The finest level needed by every
+		 * request of a frame is streamed in.
+		 *
+		 * @param key the texture
+		 * @param footprint the texture coordinate footprint of a screen pixel, see <tt>computeFootprint</tt>
+		 */
+		void request(Key key, float footprint);
+
+		/**
+		 * Selects the levels needed by the requests since the last update and
+		 * decides the levels uploaded and evicted by this update
+		 *
+		 * @param changes the textures whose resident levels changed
+		 */
+		void update(std::vector<Change>& changes);
+
+	public:
+		/**
+		 * @return the maximum size of the resident levels, in bytes
+		 */
+		std::size_t getMemoryBudget() const;
+
+		/**
+		 * @param memoryBudget the maximum size of the resident levels, in bytes
+		 */
+		void setMemoryBudget(std::size_t memoryBudget);
+
+		/**
+		 * @return the maximum size of the levels uploaded by a single update, in bytes
+		 */
+		std::size_t getUploadBudget() const;
+
+		/**
+		 * @param uploadBudget the maximum size of the levels uploaded by a single update, in bytes
+		 */
+		void setUploadBudget(std::size_t uploadBudget);
+
+		/**
+		 * @return the counters of the last update
+		 */
+		const Statistics& getStatistics() const;
+
+	public:
+		/**
+		 * Computes the texture coordinate distance covered by a screen pixel on a
+		 * surface facing the camera
+		 *
+		 * @param texCoordDensity the texture coordinate distance per world unit on the surface
+		 * @param distance the distance from the camera to the surface
+		 * @param fieldOfView the camera vertical field of view, in radians
+		 * @param screenHeight the screen height, in pixels
+		 *
+		 * @return the texture coordinate footprint of a pixel
+		 */
+		static float computeFootprint(float texCoordDensity, float distance, float fieldOfView, float screenHeight);
+
+		/**
+		 * @param width the width of the finest level, in texels
+		 * @param height the height of the finest level, in texels
+		 *
+		 * @return the number of levels of the full mip chain
+		 */
+		static unsigned int getLevelCount(unsigned int width, unsigned int height);
+
+	private:
+		/**
+		 * @param texture the texture
+		 * @param level the level
+		 *
+		 * @return the size of a level, in bytes
+		 */
+		static std::size_t getLevelSize(const Texture& texture, unsigned int level);
+
+	};
+
+}
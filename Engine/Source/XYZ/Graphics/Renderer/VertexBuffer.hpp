@@ -6,6 +6,10 @@
 
 #include "XYZ/Resource/Resource.hpp"
 
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+
 namespace XYZ::Graphics::Renderer {
 
 	class VertexBuffer : public Resource::Resource<VertexBuffer> {
@@ -15,6 +19,14 @@ namespace XYZ::Graphics::Renderer {
 		 */
 		virtual void draw() = 0;
 
+		/**
+		 * Draws several instances of a mesh with a single draw call. The model
+		 * matrix of every instance is bound as a per-instance vertex attribute.
+		 *
+		 * @param modelMatrices the model matrix of every instance
+		 */
+		virtual void drawInstanced(const std::vector<glm::mat4>& modelMatrices) = 0;
+
 	};
 
 }
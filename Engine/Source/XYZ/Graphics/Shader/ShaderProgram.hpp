@@ -89,6 +89,14 @@ namespace XYZ::Graphics::Shader {
 		 */
         virtual void set(const std::string& name, glm::vec4 v) = 0;
 
+        /**
+		 * Sets a uvec3 uniform variable
+		 *
+		 * @param name the uniform name
+		 * @param v the uniform value
+		 */
+        virtual void set(const std::string& name, glm::uvec3 v) = 0;
+
         /**
 		 * Sets a mat2 uniform variable
 		 *
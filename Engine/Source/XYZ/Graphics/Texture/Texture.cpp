@@ -6,6 +6,10 @@
 
 namespace XYZ::Graphics::Texture {
 
+	bool Texture::isReady() const {
+		return true;
+	}
+
 	void Texture::setWrapMode(TextureWrap s, TextureWrap t) {
 		setWrapModeS(s);
 		setWrapModeT(t);
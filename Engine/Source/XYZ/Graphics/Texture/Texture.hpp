@@ -159,6 +159,17 @@ namespace XYZ::Graphics::Texture {
 		 */
 		virtual int getBytesPerChannel() const = 0;
 
+	public:
+		/**
+		 * Checks if the texture contents can be sampled. Renderers may upload
+		 * textures asynchronously, a texture that is not ready is not bound.
+		 *
+		 * The default implementation returns true.
+		 *
+		 * @return true if the texture contents were uploaded
+		 */
+		virtual bool isReady() const;
+
 	public:
 		/**
 		 * Checks if the texture can be resized
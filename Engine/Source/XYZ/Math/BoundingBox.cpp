@@ -0,0 +1,103 @@
+//
+// Created by Rogiel Sulzbach on 8/15/17.
+//
+
+#include "BoundingBox.hpp"
+
+#include <glm/glm.hpp>
+
+#include <limits>
+
+namespace XYZ::Math {
+
+	BoundingBox::BoundingBox() :
+			minimum(std::numeric_limits<float>::max()),
+			maximum(std::numeric_limits<float>::lowest()) {
+	}
+
+	BoundingBox::BoundingBox(const glm::vec3& minimum, const glm::vec3& maximum) :
+			minimum(minimum), maximum(maximum) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool BoundingBox::isEmpty() const {
+		return minimum.x > maximum.x || minimum.y > maximum.y || minimum.z > maximum.z;
+	}
+
+	bool BoundingBox::isInfinite() const {
+		return minimum == glm::vec3(std::numeric_limits<float>::lowest()) &&
+			   maximum == glm::vec3(std::numeric_limits<float>::max());
+	}
+
+	glm::vec3 BoundingBox::getCenter() const {
+		return (minimum + maximum) * 0.5f;
+	}
+
+	glm::vec3 BoundingBox::getHalfSize() const {
+		return (maximum - minimum) * 0.5f;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void BoundingBox::merge(const glm::vec3& point) {
+		minimum = glm::min(minimum, point);
+		maximum = glm::max(maximum, point);
+	}
+
+	void BoundingBox::merge(const BoundingBox& other) {
+		if(other.isEmpty()) {
+			return;
+		}
+		minimum = glm::min(minimum, other.minimum);
+		maximum = glm::max(maximum, other.maximum);
+	}
+
+	BoundingBox BoundingBox::transform(const glm::mat4& matrix) const {
+		if(isEmpty() || isInfinite()) {
+			return *this;
+		}
+
+		// Arvo's method: transform the center and project the half size onto the
+		// absolute value of the rotation-scale part of the matrix
+		auto center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+		auto halfSize = getHalfSize();
+
+		glm::vec3 extent(0.0f);
+		for(int column = 0; column < 3; column++) {
+			extent += glm::abs(glm::vec3(matrix[column])) * halfSize[column];
+		}
+
+		return BoundingBox(center - extent, center + extent);
+	}
+
+	bool BoundingBox::contains(const glm::vec3& point) const {
+		return point.x >= minimum.x && point.x <= maximum.x &&
+			   point.y >= minimum.y && point.y <= maximum.y &&
+			   point.z >= minimum.z && point.z <= maximum.z;
+	}
+
+	bool BoundingBox::intersects(const BoundingBox& other) const {
+		return minimum.x <= other.maximum.x && maximum.x >= other.minimum.x &&
+			   minimum.y <= other.maximum.y && maximum.y >= other.minimum.y &&
+			   minimum.z <= other.maximum.z && maximum.z >= other.minimum.z;
+	}
+
+	bool BoundingBox::intersects(const glm::vec3& center, float radius) const {
+		if(isEmpty()) {
+			return false;
+		}
+
+		// the distance from the center to the closest point of the box
+		auto offset = glm::clamp(center, minimum, maximum) - center;
+		return glm::dot(offset, offset) <= radius * radius;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	BoundingBox BoundingBox::infinite() {
+		return BoundingBox(glm::vec3(std::numeric_limits<float>::lowest()),
+						   glm::vec3(std::numeric_limits<float>::max()));
+	}
+
+}
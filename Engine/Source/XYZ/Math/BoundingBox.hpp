@@ -0,0 +1,122 @@
+//
+// Created by Rogiel Sulzbach on 8/15/17.
+//
+
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace XYZ::Math {
+
+	/**
+	 * A axis-aligned bounding box defined by its minimum and maximum corners.
+	 *
+	 * A default constructed bounding box is empty: merging any point or box into it
+	 * yields that point or box.
+	 */
+	class BoundingBox {
+	public:
+		/**
+		 * The bounding box minimum corner
+		 */
+		glm::vec3 minimum;
+
+		/**
+		 * The bounding box maximum corner
+		 */
+		glm::vec3 maximum;
+
+	public:
+		/**
+		 * Creates a new empty bounding box
+		 */
+		BoundingBox();
+
+		/**
+		 * Creates a new bounding box from its corners
+		 *
+		 * @param minimum the bounding box minimum corner
+		 * @param maximum the bounding box maximum corner
+		 */
+		BoundingBox(const glm::vec3& minimum, const glm::vec3& maximum);
+
+	public:
+		/**
+		 * @return true if the bounding box contains no point
+		 */
+		bool isEmpty() const;
+
+		/**
+		 * @return true if the bounding box covers the whole space
+		 */
+		bool isInfinite() const;
+
+		/**
+		 * @return the bounding box center point
+		 */
+		glm::vec3 getCenter() const;
+
+		/**
+		 * @return the bounding box half size on each axis
+		 */
+		glm::vec3 getHalfSize() const;
+
+	public:
+		/**
+		 * Grows the bounding box to contain <tt>point</tt>
+		 *
+		 * @param point the point to be contained
+		 */
+		void merge(const glm::vec3& point);
+
+		/**
+		 * Grows the bounding box to contain <tt>other</tt>
+		 *
+		 * @param other the bounding box to be contained
+		 */
+		void merge(const BoundingBox& other);
+
+		/**
+		 * Transforms the bounding box by <tt>matrix</tt>.
+		 *
+		 * The result is the axis-aligned box enclosing the transformed box.
+		 *
+		 * @param matrix the transformation matrix
+		 *
+		 * @return the transformed bounding box
+		 */
+		BoundingBox transform(const glm::mat4& matrix) const;
+
+		/**
+		 * @param point the point to test
+		 *
+		 * @return true if the point is inside the bounding box
+		 */
+		bool contains(const glm::vec3& point) const;
+
+		/**
+		 * @param other the bounding box to test
+		 *
+		 * @return true if both bounding boxes overlap
+		 */
+		bool intersects(const BoundingBox& other) const;
+
+		/**
+		 * @param center the sphere center
+		 * @param radius the sphere radius, may be infinite
+		 *
+		 * @return true if the bounding box overlaps the sphere
+		 */
+		bool intersects(const glm::vec3& center, float radius) const;
+
+	public:
+		/**
+		 * @return a bounding box that covers the whole space. Objects with
+		 * infinite bounds are never culled.
+		 */
+		static BoundingBox infinite();
+
+	};
+
+}
@@ -3,3 +3,81 @@
 //
 
 #include "Frustum.hpp"
+
+#include <glm/glm.hpp>
+
+namespace XYZ::Math {
+
+	Frustum::Frustum() {
+		planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	Frustum::Frustum(const glm::mat4& viewProjection) {
+		// Gribb & Hartmann plane extraction. GLM matrices are column-major, so
+		// row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i]).
+		auto row = [&viewProjection](int i) {
+			return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		};
+
+		planes[LEFT] = row(3) + row(0);
+		planes[RIGHT] = row(3) - row(0);
+		planes[BOTTOM] = row(3) + row(1);
+		planes[TOP] = row(3) - row(1);
+		planes[NEAR] = row(3) + row(2);
+		planes[FAR] = row(3) - row(2);
+
+		for(auto& plane : planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool Frustum::contains(const glm::vec3& point) const {
+		for(const auto& plane : planes) {
+			if(glm::dot(glm::vec3(plane), point) + plane.w < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::intersects(const BoundingBox& boundingBox) const {
+		if(boundingBox.isEmpty()) {
+			return false;
+		}
+		if(boundingBox.isInfinite()) {
+			return true;
+		}
+
+		auto center = boundingBox.getCenter();
+		auto halfSize = boundingBox.getHalfSize();
+
+		for(const auto& plane : planes) {
+			auto normal = glm::vec3(plane);
+
+			// the projected radius of the box onto the plane normal
+			auto radius = glm::dot(halfSize, glm::abs(normal));
+			if(glm::dot(normal, center) + plane.w < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::intersects(const glm::vec3& center, float radius) const {
+		for(const auto& plane : planes) {
+			if(glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const glm::vec4& Frustum::getPlane(Plane plane) const {
+		return planes[plane];
+	}
+
+}
@@ -4,9 +4,86 @@
 
 #pragma once
 
+#include "XYZ/Math/BoundingBox.hpp"
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <array>
+
 namespace XYZ::Math {
 
+	/**
+	 * A view frustum represented by its six clipping planes.
+	 *
+	 * Each plane is stored as (a, b, c, d) with the normal (a, b, c) pointing
+	 * inwards, so a point p is inside the plane when dot(normal, p) + d >= 0.
+	 */
 	class Frustum {
+	public:
+		/**
+		 * The frustum plane indices
+		 */
+		enum Plane {
+			LEFT = 0, RIGHT, BOTTOM, TOP, NEAR, FAR
+		};
+
+	private:
+		/**
+		 * The frustum clipping planes
+		 */
+		std::array<glm::vec4, 6> planes;
+
+	public:
+		/**
+		 * Creates a frustum that contains everything
+		 */
+		Frustum();
+
+		/**
+		 * Extracts the frustum planes from a view-projection matrix
+		 *
+		 * @param viewProjection the view-projection matrix
+		 */
+		explicit Frustum(const glm::mat4& viewProjection);
+
+	public:
+		/**
+		 * @param point the point to test
+		 *
+		 * @return true if the point is inside the frustum
+		 */
+		bool contains(const glm::vec3& point) const;
+
+		/**
+		 * Tests if a bounding box is at least partially inside the frustum.
+		 *
+		 * The test is conservative: boxes near the frustum corners may be reported
+		 * as intersecting even if they are outside.
+		 *
+		 * @param boundingBox the bounding box to test
+		 *
+		 * @return true if the bounding box may be visible
+		 */
+		bool intersects(const BoundingBox& boundingBox) const;
+
+		/**
+		 * Tests if a sphere is at least partially inside the frustum
+		 *
+		 * @param center the sphere center
+		 * @param radius the sphere radius
+		 *
+		 * @return true if the sphere may be visible
+		 */
+		bool intersects(const glm::vec3& center, float radius) const;
+
+	public:
+		/**
+		 * @param plane the plane index
+		 *
+		 * @return the normalized frustum plane
+		 */
+		const glm::vec4& getPlane(Plane plane) const;
 
 	};
 
@@ -0,0 +1,20 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "Transform.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace XYZ::Math {
+
+	glm::mat4 composeTransform(const glm::mat4& parent, const glm::vec3& position, const glm::vec3& rotation,
+							   const glm::vec3& scale) {
+		auto transform = glm::translate(parent, position);
+		transform = glm::rotate(transform, rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+		transform = glm::rotate(transform, rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+		transform = glm::rotate(transform, rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+		return glm::scale(transform, scale);
+	}
+
+}
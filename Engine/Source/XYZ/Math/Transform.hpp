@@ -0,0 +1,28 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace XYZ::Math {
+
+	/**
+	 * Composes the model matrix of a scene object.
+	 *
+	 * The object is scaled, rotated around the X, Y and Z axes (in this order) and
+	 * then translated, relative to its parent.
+	 *
+	 * @param parent the parent model matrix
+	 * @param position the position relative to the parent
+	 * @param rotation the rotation relative to the parent, in radians
+	 * @param scale the scale relative to the parent
+	 *
+	 * @return the model matrix
+	 */
+	glm::mat4 composeTransform(const glm::mat4& parent, const glm::vec3& position, const glm::vec3& rotation,
+							   const glm::vec3& scale);
+
+}
@@ -0,0 +1,421 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "HLODBuilder.hpp"
+
+#include "XYZ/Scene/Prefab/PrefabInstance.hpp"
+#include "XYZ/Math/Transform.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace XYZ::Scene {
+
+	/**
+	 * The number of pixels replicated around every atlas tile to avoid bleeding
+	 * between tiles when the atlas is filtered
+	 */
+	static constexpr int TILE_PADDING = 2;
+
+	/**
+	 * The gamma applied by the geometry shader to the diffuse textures
+	 */
+	static constexpr float GAMMA = 2.2f;
+
+	/**
+	 * A static model placed in the proxy coordinate space
+	 */
+	struct PlacedModel {
+		const Graphics::Model::StaticModel* model;
+		glm::mat4 transform;
+	};
+
+	/**
+	 * A vertex clustering cell, accumulates the vertices that collapse into it
+	 */
+	struct VertexCluster {
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 normal = glm::vec3(0.0f);
+		glm::vec2 texCoords = glm::vec2(0.0f);
+		glm::vec3 tangent = glm::vec3(0.0f);
+		unsigned int count = 0;
+	};
+
+	static bool isMergeable(const Graphics::Model::Model::Ptr& model) {
+		auto staticModel = dynamic_cast<const Graphics::Model::StaticModel*>(model.get());
+		return staticModel != nullptr && staticModel->getMesh() != nullptr;
+	}
+
+	static bool isMergeable(const Object& object, bool& hasModels) {
+		if(dynamic_cast<const HLODGroup*>(&object) != nullptr) {
+			return false;
+		}
+
+		if(const auto& model = object.getModel()) {
+			if(!isMergeable(model)) {
+				return false;
+			}
+			hasModels = true;
+		}
+
+		if(const auto* instance = dynamic_cast<const PrefabInstance*>(&object)) {
+			bool mergeable = true;
+			instance->visit(glm::mat4(1.0f), [&](const Graphics::Model::Model::Ptr& model, const glm::mat4&) {
+				mergeable = mergeable && isMergeable(model);
+				hasModels = true;
+			});
+			if(!mergeable) {
+				return false;
+			}
+		}
+
+		for(const auto& child : object.getChildren()) {
+			if(!isMergeable(*child, hasModels)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void collectModels(const Object& object, const glm::mat4& parentTransform,
+							  std::vector<PlacedModel>& models) {
+		auto transform = Math::composeTransform(parentTransform, object.getPosition(), object.getRotation(),
+												object.getScale());
+
+		if(const auto& model = object.getModel()) {
+			models.push_back({static_cast<const Graphics::Model::StaticModel*>(model.get()), transform});
+		}
+
+		if(const auto* instance = dynamic_cast<const PrefabInstance*>(&object)) {
+			instance->visit(transform, [&models](const Graphics::Model::Model::Ptr& model, const glm::mat4& modelMatrix) {
+				models.push_back({static_cast<const Graphics::Model::StaticModel*>(model.get()), modelMatrix});
+			});
+		}
+
+		for(const auto& child : object.getChildren()) {
+			collectModels(*child, transform, models);
+		}
+	}
+
+	/**
+	 * Averages the texels of <tt>image</tt> inside the given texture coordinates rectangle
+	 */
+	static glm::vec3 sampleImage(const Graphics::Texture::TextureImage& image, glm::vec2 minimum, glm::vec2 maximum) {
+		auto width = int(image.getWidth());
+		auto height = int(image.getHeight());
+		auto channels = image.isAlpha() ? 4 : 3;
+
+		auto x0 = std::min(int(minimum.x * width), width - 1);
+		auto y0 = std::min(int(minimum.y * height), height - 1);
+		auto x1 = std::max(x0 + 1, std::min(int(std::ceil(maximum.x * width)), width));
+		auto y1 = std::max(y0 + 1, std::min(int(std::ceil(maximum.y * height)), height));
+
+		const auto& raw = image.getRaw();
+		glm::vec3 sum(0.0f);
+		for(int y = y0; y < y1; y++) {
+			for(int x = x0; x < x1; x++) {
+				auto texel = reinterpret_cast<const unsigned char*>(&raw[(std::size_t(y) * width + x) * channels]);
+				sum += glm::vec3(texel[0], texel[1], texel[2]);
+			}
+		}
+		return sum / (255.0f * float((x1 - x0) * (y1 - y0)));
+	}
+
+	/**
+	 * Bakes a material texture and color into a atlas tile, reproducing the way the
+	 * geometry shader combines them
+	 */
+	static void bakeTile(std::vector<char>& atlas, unsigned int atlasSize, glm::uvec2 tile, unsigned int tileSize,
+						 const Graphics::Texture::TextureImage* image, const glm::vec3& color, bool gammaCorrected) {
+		if(image != nullptr) {
+			auto channels = std::size_t(image->isAlpha() ? 4 : 3);
+			if(image->getWidth() == 0 || image->getHeight() == 0 ||
+			   image->getRaw().size() < std::size_t(image->getWidth()) * image->getHeight() * channels) {
+				image = nullptr;
+			}
+		}
+
+		auto content = int(tileSize) - 2 * TILE_PADDING;
+		for(int y = 0; y < int(tileSize); y++) {
+			for(int x = 0; x < int(tileSize); x++) {
+				// the padding replicates the tile borders
+				glm::vec2 texel(
+						std::min(std::max(x - TILE_PADDING, 0), content - 1),
+						std::min(std::max(y - TILE_PADDING, 0), content - 1)
+				);
+
+				glm::vec3 value(0.0f);
+				if(image != nullptr) {
+					value = sampleImage(*image, texel / float(content), (texel + 1.0f) / float(content));
+				}
+
+				if(gammaCorrected) {
+					value = glm::pow(glm::pow(value, glm::vec3(GAMMA)) + color, glm::vec3(1.0f / GAMMA));
+				} else {
+					value += color;
+				}
+				value = glm::clamp(value, 0.0f, 1.0f);
+
+				auto offset = ((std::size_t(tile.y) * tileSize + y) * atlasSize + tile.x * tileSize + x) * 3;
+				atlas[offset + 0] = char(value.r * 255.0f + 0.5f);
+				atlas[offset + 1] = char(value.g * 255.0f + 0.5f);
+				atlas[offset + 2] = char(value.b * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	HLODBuilder::HLODBuilder(HLODBuilder::ImageResolver imageResolver, float cellSize, float distance) :
+			imageResolver(std::move(imageResolver)), cellSize(cellSize), distance(distance) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::vector<std::shared_ptr<HLODGroup>> HLODBuilder::build(Object& root,
+															   Graphics::Renderer::TextureCompiler& textureCompiler) {
+		// the children are moved while the groups are created: collect them first
+		std::map<std::pair<int, int>, std::vector<Object::Ptr>> cells;
+		for(const auto& child : root.getChildren()) {
+			if(!canMerge(*child)) {
+				continue;
+			}
+
+			std::vector<PlacedModel> models;
+			collectModels(*child, glm::mat4(1.0f), models);
+
+			Math::BoundingBox bounds;
+			for(const auto& placed : models) {
+				bounds.merge(placed.model->getBoundingBox().transform(placed.transform));
+			}
+
+			auto center = bounds.getCenter();
+			cells[{int(std::floor(center.x / cellSize)), int(std::floor(center.z / cellSize))}].push_back(child);
+		}
+
+		auto compileAtlas = [&textureCompiler](const Graphics::Texture::TextureImage& image) {
+			auto texture = textureCompiler.compileTexture(image);
+			texture->setMagnificationMinificationFilter(Graphics::Texture::TextureMagnification::LINEAR,
+														Graphics::Texture::TextureMinification::LINEAR_MIPMAP_LINEAR);
+			texture->generateMipmaps();
+			return texture;
+		};
+
+		std::vector<std::shared_ptr<HLODGroup>> groups;
+		for(const auto& cell : cells) {
+			const auto& objects = cell.second;
+			if(objects.size() < minimumGroupSize) {
+				continue;
+			}
+
+			std::vector<const Object*> members;
+			for(const auto& object : objects) {
+				members.push_back(object.get());
+			}
+			auto proxy = buildProxy(members);
+
+			auto model = std::make_shared<Graphics::Model::StaticModel>(
+					proxy.mesh,
+					compileAtlas(*proxy.diffuseAtlas),
+					compileAtlas(*proxy.specularAtlas),
+					proxy.shininess,
+					nullptr,
+					proxy.castShadows
+			);
+
+			auto group = makeObject<HLODGroup>(model, distance);
+			root.addChild(group);
+			for(const auto& object : objects) {
+				group->addChild(object);
+			}
+			groups.push_back(std::move(group));
+		}
+		return groups;
+	}
+
+	HLODProxy HLODBuilder::buildProxy(const std::vector<const Object*>& objects) const {
+		std::vector<PlacedModel> models;
+		for(const auto* object : objects) {
+			collectModels(*object, glm::mat4(1.0f), models);
+		}
+
+		// every distinct material gets a tile in the atlases
+		std::vector<const Graphics::Model::StaticModel*> materials;
+		std::vector<std::size_t> modelMaterials;
+		for(const auto& placed : models) {
+			auto found = std::find_if(materials.begin(), materials.end(), [&](const Graphics::Model::StaticModel* material) {
+				return material->hasSameMaterial(*placed.model);
+			});
+			if(found == materials.end()) {
+				found = materials.insert(materials.end(), placed.model);
+			}
+			modelMaterials.push_back(std::size_t(found - materials.begin()));
+		}
+
+		auto tilesPerRow = std::max(1u, (unsigned int) std::ceil(std::sqrt(float(materials.size()))));
+		auto atlasSize = tilesPerRow * tileSize;
+
+		std::vector<char> diffuseAtlas(std::size_t(atlasSize) * atlasSize * 3, 0);
+		std::vector<char> specularAtlas(std::size_t(atlasSize) * atlasSize * 3, 0);
+
+		auto resolve = [this](const Graphics::Texture::Texture::Ptr& texture) -> Graphics::Texture::TextureImage::Ptr {
+			if(texture == nullptr || !imageResolver) {
+				return nullptr;
+			}
+			return imageResolver(*texture);
+		};
+
+		for(std::size_t i = 0; i < materials.size(); i++) {
+			const auto& material = *materials[i];
+			glm::uvec2 tile(i % tilesPerRow, i / tilesPerRow);
+
+			auto diffuseImage = resolve(material.getDiffuseTexture());
+			bakeTile(diffuseAtlas, atlasSize, tile, tileSize, diffuseImage.get(), material.getDiffuseColor(), true);
+
+			auto specularImage = resolve(material.getSpecularTexture());
+			bakeTile(specularAtlas, atlasSize, tile, tileSize, specularImage.get(), material.getSpecularColor(), false);
+		}
+
+		// merge every mesh in the proxy space, one vertex per triangle corner
+		std::vector<Graphics::Mesh::Vertex> vertices;
+		std::vector<std::size_t> vertexTiles;
+		Math::BoundingBox bounds;
+
+		auto content = float(tileSize - 2 * TILE_PADDING);
+		for(std::size_t i = 0; i < models.size(); i++) {
+			const auto& transform = models[i].transform;
+			const auto& mesh = *models[i].model->getMesh();
+			auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+			auto material = modelMaterials[i];
+			auto tileOrigin = glm::vec2(material % tilesPerRow, material / tilesPerRow) * float(tileSize) +
+							  float(TILE_PADDING);
+
+			for(unsigned int triangle = 0; triangle < mesh.getTriangleCount(); triangle++) {
+				auto corners = mesh.getTriangle(triangle);
+
+				// move texture coordinates that repeat the texture into the [0, 1] range
+				auto offset = glm::floor(glm::min(glm::min(corners[0].texCoords, corners[1].texCoords),
+												  corners[2].texCoords));
+
+				for(const auto& corner : corners) {
+					auto texCoords = glm::clamp(corner.texCoords - offset, 0.0f, 1.0f);
+
+					Graphics::Mesh::Vertex vertex(
+							glm::vec3(transform * glm::vec4(corner.position, 1.0f)),
+							glm::normalize(normalMatrix * corner.normal),
+							(tileOrigin + texCoords * content) / float(atlasSize),
+							glm::vec3(transform * glm::vec4(corner.tangent, 0.0f))
+					);
+					bounds.merge(vertex.position);
+
+					vertices.push_back(vertex);
+					vertexTiles.push_back(material);
+				}
+			}
+		}
+
+		// simplify by vertex clustering: vertices of the same material that fall into
+		// the same grid cell are collapsed and the triangles that become degenerate
+		// are removed
+		auto extent = bounds.isEmpty() ? glm::vec3(0.0f) : bounds.getHalfSize() * 2.0f;
+		auto clusterSize = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) /
+						   float(std::max(simplificationResolution, 1u));
+
+		std::map<std::tuple<int, int, int, std::size_t>, Graphics::Mesh::Mesh::Index> clusterIndices;
+		std::vector<VertexCluster> clusters;
+		std::vector<Graphics::Mesh::Mesh::Index> indices;
+
+		for(std::size_t i = 0; i < vertices.size(); i += 3) {
+			Graphics::Mesh::Mesh::Index triangle[3];
+			for(std::size_t corner = 0; corner < 3; corner++) {
+				const auto& vertex = vertices[i + corner];
+				auto cell = glm::floor((vertex.position - bounds.minimum) / clusterSize);
+				auto key = std::make_tuple(int(cell.x), int(cell.y), int(cell.z), vertexTiles[i + corner]);
+
+				auto found = clusterIndices.find(key);
+				if(found == clusterIndices.end()) {
+					found = clusterIndices.emplace(key, Graphics::Mesh::Mesh::Index(clusters.size())).first;
+					clusters.emplace_back();
+				}
+
+				auto& cluster = clusters[found->second];
+				cluster.position += vertex.position;
+				cluster.normal += vertex.normal;
+				cluster.texCoords += vertex.texCoords;
+				cluster.tangent += vertex.tangent;
+				cluster.count++;
+
+				triangle[corner] = found->second;
+			}
+
+			if(triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2]) {
+				indices.insert(indices.end(), triangle, triangle + 3);
+			}
+		}
+
+		std::vector<Graphics::Mesh::Vertex> simplified;
+		simplified.reserve(clusters.size());
+		for(const auto& cluster : clusters) {
+			auto count = float(cluster.count);
+			auto normal = glm::length(cluster.normal) > 0.0f ? glm::normalize(cluster.normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+			auto tangent = cluster.tangent - normal * glm::dot(normal, cluster.tangent);
+			tangent = glm::length(tangent) > 0.0f ? glm::normalize(tangent) : glm::vec3(0.0f);
+
+			simplified.emplace_back(cluster.position / count, normal, cluster.texCoords / count, tangent);
+		}
+
+		HLODProxy proxy;
+		proxy.mesh = std::make_shared<Graphics::Mesh::Mesh>(std::move(indices), std::move(simplified));
+		proxy.diffuseAtlas = std::make_shared<Graphics::Texture::TextureImage>(atlasSize, atlasSize,
+																				std::move(diffuseAtlas), false);
+		proxy.specularAtlas = std::make_shared<Graphics::Texture::TextureImage>(atlasSize, atlasSize,
+																				 std::move(specularAtlas), false);
+
+		proxy.shininess = 0.0f;
+		proxy.castShadows = false;
+		for(const auto& placed : models) {
+			proxy.shininess += placed.model->getShininess() / float(models.size());
+			proxy.castShadows = proxy.castShadows || placed.model->shouldCastShadows();
+		}
+		return proxy;
+	}
+
+	bool HLODBuilder::canMerge(const Object& object) {
+		bool hasModels = false;
+		return isMergeable(object, hasModels) && hasModels;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int HLODBuilder::getTileSize() const {
+		return tileSize;
+	}
+
+	void HLODBuilder::setTileSize(unsigned int tileSize) {
+		HLODBuilder::tileSize = std::max(tileSize, unsigned(2 * TILE_PADDING + 1));
+	}
+
+	unsigned int HLODBuilder::getSimplificationResolution() const {
+		return simplificationResolution;
+	}
+
+	void HLODBuilder::setSimplificationResolution(unsigned int simplificationResolution) {
+		HLODBuilder::simplificationResolution = simplificationResolution;
+	}
+
+	std::size_t HLODBuilder::getMinimumGroupSize() const {
+		return minimumGroupSize;
+	}
+
+	void HLODBuilder::setMinimumGroupSize(std::size_t minimumGroupSize) {
+		HLODBuilder::minimumGroupSize = minimumGroupSize;
+	}
+
+}
@@ -0,0 +1,185 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/HLOD/HLODGroup.hpp"
+
+#include "XYZ/Graphics/Model/StaticModel.hpp"
+#include "XYZ/Graphics/Texture/TextureImage.hpp"
+#include "XYZ/Graphics/Renderer/TextureCompiler.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace XYZ::Scene {
+
+	/**
+	 * The CPU side of a HLOD proxy: a single mesh and its texture atlases
+	 */
+	struct HLODProxy {
+		/**
+		 * The merged and simplified mesh, with the texture coordinates remapped to
+		 * the atlases
+		 */
+		Graphics::Mesh::Mesh::Ptr mesh;
+
+		/**
+		 * The diffuse atlas. Every tile bakes the source texture and the diffuse color.
+		 */
+		Graphics::Texture::TextureImage::Ptr diffuseAtlas;
+
+		/**
+		 * The specular atlas. Every tile bakes the source texture and the specular color.
+		 */
+		Graphics::Texture::TextureImage::Ptr specularAtlas;
+
+		/**
+		 * The average shininess of the merged materials
+		 */
+		float shininess;
+
+		/**
+		 * Whether any of the merged models casts shadows
+		 */
+		bool castShadows;
+	};
+
+	/**
+	 * Generates hierarchical level of detail (HLOD) proxies for static objects.
+	 *
+	 * The builder groups the children of a object by the cell of a uniform grid on
+	 * the XZ plane they fall into. The meshes of each group are merged into a single
+	 * mesh, simplified by vertex clustering and textured with a atlas that has a
+	 * tile for every distinct material. The group children are then moved under a
+	 * <tt>HLODGroup</tt> that renders the proxy when seen from far away.
+	 *
+	 * Only objects whose whole hierarchy is made of <tt>StaticModel</tt>s with a
+	 * mesh (or of prefab instances of them) are grouped. Normal maps are not baked
+	 * into the proxy. Texture coordinates that repeat a texture more than once
+	 * within a triangle are clamped to the tile.
+	 *
+	 * Building proxies is expensive and meant to be done by tools or at load time,
+	 * never per frame.
+	 */
+	class HLODBuilder {
+	public:
+		/**
+		 * Finds the image a compiled texture was created from. May return null if the
+		 * image is not available, in which case only the material color is baked.
+		 */
+		using ImageResolver = std::function<Graphics::Texture::TextureImage::Ptr(const Graphics::Texture::Texture&)>;
+
+	private:
+		/**
+		 * The texture image resolver
+		 */
+		ImageResolver imageResolver;
+
+		/**
+		 * The size of the grid cells used to group objects
+		 */
+		float cellSize;
+
+		/**
+		 * The distance from which the proxies are rendered
+		 */
+		float distance;
+
+		/**
+		 * The size of a material tile in the atlases, in pixels
+		 */
+		unsigned int tileSize = 64;
+
+		/**
+		 * The number of vertex clustering cells along the longest side of a group
+		 */
+		unsigned int simplificationResolution = 32;
+
+		/**
+		 * The minimum number of objects in a cell for a group to be created
+		 */
+		std::size_t minimumGroupSize = 2;
+
+	public:
+		/**
+		 * Creates a new HLOD builder
+		 *
+		 * @param imageResolver the texture image resolver
+		 * @param cellSize the size of the grid cells used to group objects
+		 * @param distance the distance from which the proxies are rendered
+		 */
+		explicit HLODBuilder(ImageResolver imageResolver, float cellSize = 64.0f, float distance = 100.0f);
+
+	public:
+		/**
+		 * Groups the children of <tt>root</tt> and builds a proxy for every group.
+		 *
+		 * The grouped children are moved under a new <tt>HLODGroup</tt> child of
+		 * <tt>root</tt>, their world transforms are not changed.
+		 *
+		 * @param root the object whose children are grouped
+		 * @param textureCompiler the compiler used to compile the proxy atlases
+		 *
+		 * @return the groups that were created
+		 */
+		std::vector<std::shared_ptr<HLODGroup>> build(Object& root, Graphics::Renderer::TextureCompiler& textureCompiler);
+
+		/**
+		 * Builds the proxy of a set of objects. The proxy is in the coordinate space
+		 * of the objects parent.
+		 *
+		 * This method does not touch the renderer and can be used by offline tools.
+		 *
+		 * @param objects the objects merged in the proxy. Every object must be
+		 * accepted by <tt>canMerge</tt>.
+		 *
+		 * @return the proxy
+		 */
+		HLODProxy buildProxy(const std::vector<const Object*>& objects) const;
+
+		/**
+		 * @param object the object to be checked
+		 *
+		 * @return true if the object hierarchy can be merged into a proxy
+		 */
+		static bool canMerge(const Object& object);
+
+	public:
+		/**
+		 * @return the size of a material tile in the atlases, in pixels
+		 */
+		unsigned int getTileSize() const;
+
+		/**
+		 * @param tileSize the size of a material tile in the atlases, in pixels
+		 */
+		void setTileSize(unsigned int tileSize);
+
+		/**
+		 * @return the number of vertex clustering cells along the longest side of a group
+		 */
+		unsigned int getSimplificationResolution() const;
+
+		/**
+		 * @param simplificationResolution the number of vertex clustering cells along
+		 * the longest side of a group
+		 */
+		void setSimplificationResolution(unsigned int simplificationResolution);
+
+		/**
+		 * @return the minimum number of objects in a cell for a group to be created
+		 */
+		std::size_t getMinimumGroupSize() const;
+
+		/**
+		 * @param minimumGroupSize the minimum number of objects in a cell for a group
+		 * to be created
+		 */
+		void setMinimumGroupSize(std::size_t minimumGroupSize);
+
+	};
+
+}
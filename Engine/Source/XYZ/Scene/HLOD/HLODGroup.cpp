@@ -0,0 +1,49 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "HLODGroup.hpp"
+
+#include <glm/glm.hpp>
+
+namespace XYZ::Scene {
+
+	HLODGroup::HLODGroup(Graphics::Model::Model::Ptr proxy, float distance) :
+			proxy(std::move(proxy)), distance(distance) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const Graphics::Model::Model::Ptr& HLODGroup::getProxy() const {
+		return proxy;
+	}
+
+	void HLODGroup::setProxy(const Graphics::Model::Model::Ptr& proxy) {
+		HLODGroup::proxy = proxy;
+	}
+
+	float HLODGroup::getDistance() const {
+		return distance;
+	}
+
+	void HLODGroup::setDistance(float distance) {
+		HLODGroup::distance = distance;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool HLODGroup::shouldUseProxy(const glm::mat4& modelMatrix, const glm::vec3& viewPosition) const {
+		if(proxy == nullptr) {
+			return false;
+		}
+
+		auto bounds = proxy->getBoundingBox().transform(modelMatrix);
+		if(bounds.isEmpty() || bounds.isInfinite()) {
+			return false;
+		}
+
+		auto offset = bounds.getCenter() - viewPosition;
+		return glm::dot(offset, offset) > distance * distance;
+	}
+
+}
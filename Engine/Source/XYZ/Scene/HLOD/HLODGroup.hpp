@@ -0,0 +1,78 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Object.hpp"
+
+#include <glm/mat4x4.hpp>
+
+namespace XYZ::Scene {
+
+	/**
+	 * A group of spatially close objects that is rendered as a single proxy model
+	 * when seen from far away.
+	 *
+	 * The detailed objects are regular children of the group. Once the distance
+	 * between the camera and the center of the proxy exceeds the group distance,
+	 * renderers draw the proxy instead of the group children.
+	 *
+	 * Groups and their proxies are usually generated by <tt>HLODBuilder</tt>.
+	 */
+	class HLODGroup : public Object {
+	private:
+		/**
+		 * The model that replaces the group children when seen from far away
+		 */
+		Graphics::Model::Model::Ptr proxy;
+
+		/**
+		 * The distance from which the proxy is rendered instead of the children
+		 */
+		float distance;
+
+	public:
+		/**
+		 * Creates a new HLOD group
+		 *
+		 * @param proxy the model that replaces the group children when seen from far away
+		 * @param distance the distance from which the proxy is rendered instead of the children
+		 */
+		explicit HLODGroup(Graphics::Model::Model::Ptr proxy = nullptr, float distance = 100.0f);
+
+	public:
+		/**
+		 * @return the model that replaces the group children when seen from far away
+		 */
+		const Graphics::Model::Model::Ptr& getProxy() const;
+
+		/**
+		 * @param proxy the model that replaces the group children when seen from far away
+		 */
+		void setProxy(const Graphics::Model::Model::Ptr& proxy);
+
+		/**
+		 * @return the distance from which the proxy is rendered instead of the children
+		 */
+		float getDistance() const;
+
+		/**
+		 * @param distance the distance from which the proxy is rendered instead of the children
+		 */
+		void setDistance(float distance);
+
+	public:
+		/**
+		 * Checks if the proxy should be rendered instead of the group children
+		 *
+		 * @param modelMatrix the group model matrix
+		 * @param viewPosition the camera position
+		 *
+		 * @return true if the group has a proxy and is farther than its distance
+		 */
+		bool shouldUseProxy(const glm::mat4& modelMatrix, const glm::vec3& viewPosition) const;
+
+	};
+
+}
@@ -6,6 +6,9 @@
 
 #include "XYZ/Graphics/Renderer/Framebuffer.hpp"
 
+#include <cmath>
+#include <limits>
+
 namespace XYZ::Scene::Light {
 
 	Light::Light() {
@@ -68,6 +71,20 @@ namespace XYZ::Scene::Light {
 		return 0;
 	}
 
+	float Light::computeAttenuationRadius(float constant, float linear, float quadratic, const glm::vec3& diffuse) {
+		// solve constant + linear * d + quadratic * d^2 = 256 * MaxChannel for d: past
+		// that distance the light contributes less than 1/256 of its brightness
+		float MaxChannel = fmax(fmax(diffuse.x, diffuse.y), diffuse.z);
+		if(quadratic == 0.0f) {
+			if(linear == 0.0f) {
+				return std::numeric_limits<float>::infinity();
+			}
+			return fmax(0.0f, (256 * MaxChannel - constant) / linear);
+		}
+		return (-linear + sqrtf(linear * linear - 4 * quadratic * (constant - 256 * MaxChannel))) /
+			   (2 * quadratic);
+	}
+
 	bool Light::hasShadows() const {
 		return shadows;
 	}
@@ -64,6 +64,21 @@ namespace XYZ::Scene::Light {
 	public:
 		virtual float getInfluenceRadius() const;
 
+	protected:
+		/**
+		 * Computes the distance past which an attenuated light contributes less
+		 * than 1/256 of its brightness
+		 *
+		 * @param constant the constant attenuation term
+		 * @param linear the linear attenuation term
+		 * @param quadratic the quadratic attenuation term
+		 * @param diffuse the light diffuse color
+		 *
+		 * @return the influence radius, or infinity if the light is not attenuated
+		 */
+		static float computeAttenuationRadius(float constant, float linear, float quadratic,
+											  const glm::vec3& diffuse);
+
     };
 
 }
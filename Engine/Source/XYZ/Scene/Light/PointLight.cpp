@@ -39,8 +39,6 @@ namespace XYZ::Scene::Light {
 	// -----------------------------------------------------------------------------------------------------------------
 
 	float PointLight::getInfluenceRadius() const {
-		float MaxChannel = fmax(fmax(getDiffuse().x, getDiffuse().y), getDiffuse().z);
-		return (-linear + sqrtf(linear * linear - 4 * quadratic * (quadratic - 256 * MaxChannel * constant))) /
-			   (2 * quadratic);
+		return computeAttenuationRadius(constant, linear, quadratic, getDiffuse());
 	}
 }
\ No newline at end of file
@@ -60,4 +60,10 @@ namespace XYZ::Scene::Light {
 		return LightType::SPOT;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------------
+
+	float SpotLight::getInfluenceRadius() const {
+		return computeAttenuationRadius(constant, linear, quadratic, getDiffuse());
+	}
+
 }
\ No newline at end of file
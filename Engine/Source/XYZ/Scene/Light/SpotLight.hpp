@@ -50,6 +50,9 @@ namespace XYZ::Scene::Light {
 		 */
 		virtual LightType getLightType() const final override;
 
+	public:
+		float getInfluenceRadius() const override;
+
 	};
 
 }
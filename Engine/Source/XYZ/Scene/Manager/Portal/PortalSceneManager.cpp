@@ -0,0 +1,319 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "PortalSceneManager.hpp"
+
+#include "XYZ/Scene/Light/Light.hpp"
+#include "XYZ/Scene/Prefab/PrefabInstance.hpp"
+#include "XYZ/Math/Frustum.hpp"
+#include "XYZ/Math/Transform.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace XYZ::Scene::Manager::Portal {
+
+	static glm::mat4 computeWorldTransform(const Object& object) {
+		glm::mat4 parentTransform(1.0f);
+		if(auto parent = object.getParent()) {
+			parentTransform = computeWorldTransform(*parent);
+		}
+		return Math::composeTransform(parentTransform, object.getPosition(), object.getRotation(), object.getScale());
+	}
+
+	static void computeBounds(const Object& object, const glm::mat4& transform, Math::BoundingBox& bounds) {
+		if(const auto& model = object.getModel()) {
+			bounds.merge(model->getBoundingBox().transform(transform));
+		}
+
+		if(const auto* instance = dynamic_cast<const PrefabInstance*>(&object)) {
+			if(!instance->isExpanded()) {
+				bounds.merge(instance->getBoundingBox().transform(transform));
+			}
+		}
+
+		for(const auto& child : object.getChildren()) {
+			computeBounds(*child, Math::composeTransform(transform, child->getPosition(), child->getRotation(),
+														 child->getScale()), bounds);
+		}
+	}
+
+	/**
+	 * Clips a convex polygon by a plane, keeping the part in front of the plane
+	 */
+	static std::vector<glm::vec3> clip(const std::vector<glm::vec3>& polygon, const glm::vec4& plane) {
+		std::vector<glm::vec3> clipped;
+		for(std::size_t i = 0; i < polygon.size(); i++) {
+			const auto& current = polygon[i];
+			const auto& next = polygon[(i + 1) % polygon.size()];
+
+			auto currentDistance = glm::dot(glm::vec3(plane), current) + plane.w;
+			auto nextDistance = glm::dot(glm::vec3(plane), next) + plane.w;
+
+			if(currentDistance >= 0.0f) {
+				clipped.push_back(current);
+			}
+			if((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+				auto t = currentDistance / (currentDistance - nextDistance);
+				clipped.push_back(current + (next - current) * t);
+			}
+		}
+		return clipped;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	PortalSceneManager::CellIndex PortalSceneManager::addCell(const Math::BoundingBox& bounds) {
+		cells.push_back({bounds, {}});
+		return cells.size() - 1;
+	}
+
+	std::size_t PortalSceneManager::addPortal(CellIndex first, CellIndex second,
+											  const std::array<glm::vec3, 4>& vertices) {
+		auto index = portals.size();
+		portals.push_back({{first, second}, vertices});
+		cells.at(first).portals.push_back(index);
+		cells.at(second).portals.push_back(index);
+		return index;
+	}
+
+	void PortalSceneManager::addObject(CellIndex cell, const Object& object) {
+		objectCells[&object] = cell;
+	}
+
+	void PortalSceneManager::removeObject(const Object& object) {
+		objectCells.erase(&object);
+	}
+
+	void PortalSceneManager::generate(const std::vector<std::shared_ptr<Object>>& objects, float tolerance) {
+		auto first = cells.size();
+		for(const auto& object : objects) {
+			Math::BoundingBox bounds;
+			computeBounds(*object, computeWorldTransform(*object), bounds);
+			if(bounds.isEmpty() || bounds.isInfinite()) {
+				continue;
+			}
+			addObject(addCell(bounds), *object);
+		}
+
+		for(auto i = first; i < cells.size(); i++) {
+			for(auto j = i + 1; j < cells.size(); j++) {
+				// the region where both cells meet
+				auto minimum = glm::max(cells[i].bounds.minimum, cells[j].bounds.minimum) - tolerance;
+				auto maximum = glm::min(cells[i].bounds.maximum, cells[j].bounds.maximum) + tolerance;
+				auto size = maximum - minimum;
+				if(size.x <= 0.0f || size.y <= 0.0f || size.z <= 0.0f) {
+					continue;
+				}
+
+				// the portal is perpendicular to the thinnest axis of the region and
+				// must span a area: cells that only touch on a edge are not connected
+				int axis = 0;
+				for(int k = 1; k < 3; k++) {
+					if(size[k] < size[axis]) {
+						axis = k;
+					}
+				}
+				auto u = (axis + 1) % 3;
+				auto v = (axis + 2) % 3;
+				if(size[u] <= 4.0f * tolerance || size[v] <= 4.0f * tolerance) {
+					continue;
+				}
+
+				auto center = (minimum + maximum) * 0.5f;
+				std::array<glm::vec3, 4> vertices;
+				for(int k = 0; k < 4; k++) {
+					vertices[k] = center;
+					vertices[k][u] = (k == 0 || k == 3) ? minimum[u] : maximum[u];
+					vertices[k][v] = (k < 2) ? minimum[v] : maximum[v];
+				}
+				addPortal(i, j, vertices);
+			}
+		}
+	}
+
+	void PortalSceneManager::clear() {
+		cells.clear();
+		portals.clear();
+		objectCells.clear();
+		visibleCells.clear();
+		visibleCellCount = 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void PortalSceneManager::update(const glm::mat4& viewProjection, const glm::vec3& viewPosition) {
+		Math::Frustum frustum(viewProjection);
+
+		PortalSceneManager::viewPosition = viewPosition;
+		farPlane = frustum.getPlane(Math::Frustum::FAR);
+
+		std::vector<glm::vec4> planes;
+		for(int plane = Math::Frustum::LEFT; plane <= Math::Frustum::FAR; plane++) {
+			planes.push_back(frustum.getPlane(Math::Frustum::Plane(plane)));
+		}
+
+		visibleCells.assign(cells.size(), 0);
+		std::vector<char> path(cells.size(), 0);
+
+		bool inside = false;
+		for(CellIndex cell = 0; cell < cells.size(); cell++) {
+			if(cells[cell].bounds.contains(viewPosition)) {
+				traverse(cell, planes, 0, path);
+				inside = true;
+			}
+		}
+
+		if(!inside) {
+			for(CellIndex cell = 0; cell < cells.size(); cell++) {
+				visibleCells[cell] = char(frustum.intersects(cells[cell].bounds));
+			}
+		}
+
+		visibleCellCount = std::size_t(std::count(visibleCells.begin(), visibleCells.end(), 1));
+	}
+
+	bool PortalSceneManager::isVisible(const Object& object) const {
+		auto found = objectCells.find(&object);
+		if(found == objectCells.end()) {
+			return true;
+		}
+		return isCellVisible(found->second);
+	}
+
+	bool PortalSceneManager::isVisible(const Light::Light& light) const {
+		if(light.getLightType() == Light::LightType::DIRECTIONAL) {
+			return true;
+		}
+
+		auto cell = findCell(light.getPosition());
+		if(cell == NO_CELL || isCellVisible(cell)) {
+			return true;
+		}
+
+		// the light also reaches the cells next to its own through the portals
+		for(auto portal : cells[cell].portals) {
+			const auto& connected = portals[portal].cells;
+			if(isCellVisible(connected[0] == cell ? connected[1] : connected[0])) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	PortalSceneManager::CellIndex PortalSceneManager::findCell(const glm::vec3& point) const {
+		for(CellIndex cell = 0; cell < cells.size(); cell++) {
+			if(cells[cell].bounds.contains(point)) {
+				return cell;
+			}
+		}
+		return NO_CELL;
+	}
+
+	bool PortalSceneManager::isCellVisible(CellIndex cell) const {
+		// cells added after the last update are visible until the next one
+		if(cell >= visibleCells.size()) {
+			return true;
+		}
+		return visibleCells[cell] != 0;
+	}
+
+	std::size_t PortalSceneManager::getVisibleCellCount() const {
+		return visibleCellCount;
+	}
+
+	const std::vector<PortalSceneManager::Cell>& PortalSceneManager::getCells() const {
+		return cells;
+	}
+
+	const std::vector<PortalSceneManager::Portal>& PortalSceneManager::getPortals() const {
+		return portals;
+	}
+
+	unsigned int PortalSceneManager::getMaximumDepth() const {
+		return maximumDepth;
+	}
+
+	void PortalSceneManager::setMaximumDepth(unsigned int maximumDepth) {
+		PortalSceneManager::maximumDepth = maximumDepth;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void PortalSceneManager::traverse(CellIndex cell, const std::vector<glm::vec4>& planes, unsigned int depth,
+									  std::vector<char>& path) {
+		visibleCells[cell] = 1;
+		if(depth >= maximumDepth) {
+			return;
+		}
+
+		path[cell] = 1;
+		for(auto portalIndex : cells[cell].portals) {
+			const auto& portal = portals[portalIndex];
+			auto next = portal.cells[0] == cell ? portal.cells[1] : portal.cells[0];
+			if(path[next]) {
+				continue;
+			}
+
+			// the part of the portal that can be seen through the current frustum
+			std::vector<glm::vec3> polygon(portal.vertices.begin(), portal.vertices.end());
+			for(const auto& plane : planes) {
+				polygon = clip(polygon, plane);
+				if(polygon.size() < 3) {
+					break;
+				}
+			}
+			if(polygon.size() < 3) {
+				continue;
+			}
+
+			glm::vec3 center(0.0f);
+			for(const auto& vertex : polygon) {
+				center += vertex;
+			}
+			center /= float(polygon.size());
+
+			auto portalNormal = glm::cross(portal.vertices[1] - portal.vertices[0],
+										   portal.vertices[2] - portal.vertices[0]);
+			portalNormal = glm::normalize(portalNormal);
+			if(glm::dot(portalNormal, center - viewPosition) < 0.0f) {
+				portalNormal = -portalNormal;
+			}
+
+			// when the camera stands on the portal the frustum cannot be narrowed
+			if(glm::dot(portalNormal, center - viewPosition) < 1e-3f) {
+				traverse(next, planes, depth + 1, path);
+				continue;
+			}
+
+			// narrow the frustum to the visible part of the portal: one plane through
+			// the view position for every edge, the portal plane and the far plane
+			std::vector<glm::vec4> narrowed;
+			for(std::size_t i = 0; i < polygon.size(); i++) {
+				const auto& a = polygon[i];
+				const auto& b = polygon[(i + 1) % polygon.size()];
+
+				auto normal = glm::cross(a - viewPosition, b - viewPosition);
+				auto length = glm::length(normal);
+				if(length < 1e-6f) {
+					continue;
+				}
+				normal /= length;
+				if(glm::dot(normal, center - viewPosition) < 0.0f) {
+					normal = -normal;
+				}
+				narrowed.emplace_back(normal, -glm::dot(normal, viewPosition));
+			}
+			narrowed.emplace_back(portalNormal, -glm::dot(portalNormal, center));
+			narrowed.push_back(farPlane);
+
+			traverse(next, narrowed, depth + 1, path);
+		}
+		path[cell] = 0;
+	}
+
+}
@@ -0,0 +1,230 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Manager/SceneManager.hpp"
+#include "XYZ/Scene/Object.hpp"
+#include "XYZ/Math/BoundingBox.hpp"
+
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace XYZ::Scene::Manager::Portal {
+
+	/**
+	 * A scene manager for interior levels made of cells connected by portals.
+	 *
+	 * Every frame the cells are traversed starting at the cell that contains the
+	 * camera. A neighbour cell is only visited if its portal is inside the current
+	 * view frustum, in which case the frustum is narrowed to the part of the portal
+	 * that can be seen before the traversal continues. Objects and lights assigned
+	 * to cells that are not reached are skipped by the renderer.
+	 *
+	 * Objects that are not assigned to any cell are always visible. If the camera
+	 * is not inside any cell, every cell that intersects the view frustum is visible.
+	 */
+	class PortalSceneManager : public SceneManager {
+	public:
+		/**
+		 * The index of a cell
+		 */
+		using CellIndex = std::size_t;
+
+		/**
+		 * A invalid cell index
+		 */
+		static constexpr CellIndex NO_CELL = std::numeric_limits<CellIndex>::max();
+
+		/**
+		 * A convex region of the level
+		 */
+		struct Cell {
+			/**
+			 * The cell bounds in world space
+			 */
+			Math::BoundingBox bounds;
+
+			/**
+			 * The indices of the portals that connect this cell to its neighbours
+			 */
+			std::vector<std::size_t> portals;
+		};
+
+		/**
+		 * A opening between two cells
+		 */
+		struct Portal {
+			/**
+			 * The two cells connected by the portal
+			 */
+			std::array<CellIndex, 2> cells;
+
+			/**
+			 * The portal quad vertices in world space, in winding order
+			 */
+			std::array<glm::vec3, 4> vertices;
+		};
+
+	private:
+		/**
+		 * The level cells
+		 */
+		std::vector<Cell> cells;
+
+		/**
+		 * The portals between the cells
+		 */
+		std::vector<Portal> portals;
+
+		/**
+		 * The cell each object was assigned to
+		 */
+		std::unordered_map<const Object*, CellIndex> objectCells;
+
+		/**
+		 * The maximum number of portals traversed from the camera cell
+		 */
+		unsigned int maximumDepth = 32;
+
+	private:
+		/**
+		 * Whether each cell was reached by the last traversal
+		 */
+		std::vector<char> visibleCells;
+
+		/**
+		 * The number of cells reached by the last traversal
+		 */
+		std::size_t visibleCellCount = 0;
+
+		/**
+		 * The view position given to the last <tt>update</tt> call
+		 */
+		glm::vec3 viewPosition = glm::vec3(0.0f);
+
+		/**
+		 * The far plane of the view given to the last <tt>update</tt> call
+		 */
+		glm::vec4 farPlane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+	public:
+		/**
+		 * Adds a new cell
+		 *
+		 * @param bounds the cell bounds in world space
+		 *
+		 * @return the new cell index
+		 */
+		CellIndex addCell(const Math::BoundingBox& bounds);
+
+		/**
+		 * Connects two cells with a portal
+		 *
+		 * @param first the first cell
+		 * @param second the second cell
+		 * @param vertices the portal quad vertices in world space, in winding order
+		 *
+		 * @return the new portal index
+		 */
+		std::size_t addPortal(CellIndex first, CellIndex second, const std::array<glm::vec3, 4>& vertices);
+
+		/**
+		 * Assigns a object, and all of its children, to a cell.
+		 *
+		 * The object is only referenced by its address: it must be removed with
+		 * <tt>removeObject</tt> before being destroyed.
+		 *
+		 * @param cell the cell index
+		 * @param object the object to be assigned
+		 */
+		void addObject(CellIndex cell, const Object& object);
+
+		/**
+		 * Removes a object from its cell. The object becomes always visible.
+		 *
+		 * @param object the object to be removed
+		 */
+		void removeObject(const Object& object);
+
+		/**
+		 * Generates one cell for each object, with the object world bounds, and
+		 * creates a portal between every pair of cells whose bounds touch over a
+		 * area. This is enough for levels made of segments placed side by side.
+		 *
+		 * @param objects the objects that become cells
+		 * @param tolerance the maximum gap between two cells that are connected
+		 */
+		void generate(const std::vector<std::shared_ptr<Object>>& objects, float tolerance = 0.01f);
+
+		/**
+		 * Removes every cell, portal and object assignment
+		 */
+		void clear();
+
+	public:
+		void update(const glm::mat4& viewProjection, const glm::vec3& viewPosition) final;
+		bool isVisible(const Object& object) const final;
+		bool isVisible(const Light::Light& light) const final;
+
+	public:
+		/**
+		 * @param point a point in world space
+		 *
+		 * @return the first cell that contains <tt>point</tt> or <tt>NO_CELL</tt>
+		 */
+		CellIndex findCell(const glm::vec3& point) const;
+
+		/**
+		 * @param cell the cell index
+		 *
+		 * @return true if the cell was reached by the last traversal
+		 */
+		bool isCellVisible(CellIndex cell) const;
+
+		/**
+		 * @return the number of cells reached by the last traversal
+		 */
+		std::size_t getVisibleCellCount() const;
+
+		/**
+		 * @return the level cells
+		 */
+		const std::vector<Cell>& getCells() const;
+
+		/**
+		 * @return the portals between the cells
+		 */
+		const std::vector<Portal>& getPortals() const;
+
+		/**
+		 * @return the maximum number of portals traversed from the camera cell
+		 */
+		unsigned int getMaximumDepth() const;
+
+		/**
+		 * @param maximumDepth the maximum number of portals traversed from the camera cell
+		 */
+		void setMaximumDepth(unsigned int maximumDepth);
+
+	private:
+		/**
+		 * Marks a cell as visible and visits the neighbours whose portals are
+		 * inside the frustum
+		 *
+		 * @param cell the cell to be visited
+		 * @param planes the frustum the cell is seen through
+		 * @param depth the number of portals traversed so far
+		 * @param path whether each cell is part of the current traversal path
+		 */
+		void traverse(CellIndex cell, const std::vector<glm::vec4>& planes, unsigned int depth, std::vector<char>& path);
+
+	};
+
+}
@@ -3,3 +3,9 @@
 //
 
 #include "SceneManager.hpp"
+
+namespace XYZ::Scene::Manager {
+
+    SceneManager::~SceneManager() = default;
+
+}
@@ -4,11 +4,62 @@
 
 #pragma once
 
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace XYZ::Scene {
+    class Object;
+}
+
+namespace XYZ::Scene::Light {
+    class Light;
+}
+
 namespace XYZ::Scene::Manager {
 
+    /**
+     * A scene manager knows how the scene is spatially organized and tells the
+     * renderers which objects and lights can possibly be seen from a view, so
+     * that the rest of the scene is skipped before any per-object culling.
+     */
     class SceneManager {
+    public:
+        /**
+         * Virtual destructor.
+         */
+        virtual ~SceneManager();
+
+    public:
+        /**
+         * Computes the visibility from a view. Must be called from the render
+         * thread once per frame, before any visibility query.
+         *
+         * @param viewProjection the view-projection matrix
+         * @param viewPosition the view position
+         */
+        virtual void update(const glm::mat4& viewProjection, const glm::vec3& viewPosition) = 0;
+
+        /**
+         * Checks if a object and its children may be visible from the view given to
+         * the last <tt>update</tt> call. Can be called concurrently from multiple
+         * threads.
+         *
+         * @param object the object to be checked
+         *
+         * @return false if the object and all of its children can be skipped
+         */
+        virtual bool isVisible(const Object& object) const = 0;
+
+        /**
+         * Checks if a light may affect the view given to the last <tt>update</tt>
+         * call. Can be called concurrently from multiple threads.
+         *
+         * @param light the light to be checked
+         *
+         * @return false if the light can be skipped
+         */
+        virtual bool isVisible(const Light::Light& light) const = 0;
 
     };
 
 }
-
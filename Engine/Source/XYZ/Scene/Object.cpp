@@ -18,11 +18,10 @@ namespace XYZ::Scene {
     }
 
     void Object::setParent(const std::shared_ptr<Object> &parent) {
-        if(auto p = Object::parent.lock()) {
-            p->removeChild(shared_from_this());
-        }
         if(parent == nullptr) {
-            Object::parent.reset();
+            if(auto p = Object::parent.lock()) {
+                p->detachChild(*this);
+            }
             return;
         }
         parent->addChild(shared_from_this());
@@ -33,29 +32,51 @@ namespace XYZ::Scene {
     }
 
     void Object::addChild(const std::shared_ptr<Object> &child) {
-        auto found = std::find(children.begin(), children.end(), child);
-        if(found != children.end()) {
+        auto currentParent = child->parent.lock();
+        if(currentParent.get() == this) {
             return;
         }
-        child->parent = shared_from_this();
-        children.push_back(child);
+
+        // keep the child alive while it is moved between parents
+        auto keep = child;
+        if(currentParent != nullptr) {
+            currentParent->detachChild(*keep);
+        }
+
+        keep->parent = shared_from_this();
+        keep->childIndex = children.size();
+        children.push_back(std::move(keep));
     }
 
     void Object::removeChild(const std::shared_ptr<Object> &child) {
-        auto found = std::find(children.begin(), children.end(), child);
-        if(found == children.end()) {
+        if(child->parent.lock().get() != this) {
             return;
         }
-        children.erase(found);
-        child->parent.reset();
+        detachChild(*child);
     }
 
     std::shared_ptr<Object> Object::createChild() {
-        auto child = std::make_shared<Object>();
+        auto child = makeObject<Object>();
         addChild(child);
         return child;
     }
 
+    void Object::detachChild(Object &child) {
+        auto index = child.childIndex;
+
+        // the child may be referenced only by this list: keep it alive until it
+        // has been completely detached
+        auto removed = std::move(children[index]);
+        if(index + 1 != children.size()) {
+            children[index] = std::move(children.back());
+            children[index]->childIndex = index;
+        }
+        children.pop_back();
+
+        removed->parent.reset();
+        removed->childIndex = 0;
+    }
+
     // -----------------------------------------------------------------------------------------------------------------
 
     Object::Position Object::getPosition() const {
@@ -166,4 +187,12 @@ namespace XYZ::Scene {
         Object::model = model;
     }
 
+    bool Object::isStatic() const {
+        return staticObject;
+    }
+
+    void Object::setStatic(bool isStatic) {
+        staticObject = isStatic;
+    }
+
 }
\ No newline at end of file
@@ -5,12 +5,18 @@
 #pragma once
 
 #include "XYZ/Graphics/Model/Model.hpp"
+#include "XYZ/Utility/MemoryPool.hpp"
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+namespace XYZ::Scene::Serialization {
+    class SceneReader;
+}
+
 namespace XYZ::Scene {
 
     class Object : public std::enable_shared_from_this<Object> {
@@ -26,6 +32,12 @@ namespace XYZ::Scene {
         std::weak_ptr<Object> parent;
         std::vector<std::shared_ptr<Object>> children;
 
+        /**
+         * The index of this object in its parent children list. Allows children to
+         * be removed and reparented in constant time.
+         */
+        std::size_t childIndex = 0;
+
     public:
         Position position = Scale(0.0f);
         Rotation rotation = Scale(0.0f);
@@ -34,6 +46,15 @@ namespace XYZ::Scene {
     private:
         Graphics::Model::Model::Ptr model;
 
+        /**
+         * If true, the object is not expected to move. Renderers may cache what
+         * is derived from static objects, such as their shadows.
+         */
+        bool staticObject = false;
+
+    private:
+        friend class Serialization::SceneReader;
+
     public:
         Object();
         virtual ~Object();
@@ -42,11 +63,30 @@ namespace XYZ::Scene {
         std::shared_ptr<Object> getParent() const;
         void setParent(const std::shared_ptr<Object> &parent);
 
+        /**
+         * The object children. Removing a child moves the last child into its
+         * place, so the order of the children is not preserved.
+         */
         const std::vector<std::shared_ptr<Object>> &getChildren() const;
+
+        /**
+         * Adds a child, removing it from its current parent. Runs in constant time.
+         */
         void addChild(const std::shared_ptr<Object> &child);
+
+        /**
+         * Removes a child. Runs in constant time.
+         */
         void removeChild(const std::shared_ptr<Object> &child);
+
         std::shared_ptr<Object> createChild();
 
+    private:
+        /**
+         * Removes a child that is known to belong to this object
+         */
+        void detachChild(Object &child);
+
     public:
         Position getPosition() const;
         void setPosition(Position position);
@@ -92,7 +132,36 @@ namespace XYZ::Scene {
         const Graphics::Model::Model::Ptr& getModel() const;
         void setModel(const Graphics::Model::Model::Ptr& model);
 
+    public:
+        /**
+         * @return true if the object is not expected to move
+         */
+        bool isStatic() const;
+
+        /**
+         * Marks the object as static. A static object can still be moved, but
+         * doing so invalidates everything the renderer cached from it. Applies
+         * to the object model only, children have their own flag.
+         */
+        void setStatic(bool isStatic);
+
     };
 
+    /**
+     * Creates a new scene object. Objects, lights and cameras should be created with
+     * this function: the object and its reference count are allocated together from
+     * the shared memory pools instead of the system allocator.
+     *
+     * @tparam T the object type
+     * @param args the object constructor arguments
+     *
+     * @return the new object
+     */
+    template<typename T = Object, typename... Args>
+    std::shared_ptr<T> makeObject(Args&&... args) {
+        static_assert(std::is_base_of<Object, T>::value, "T must be a scene object");
+        return std::allocate_shared<T>(Utility::PoolAllocator<T>(), std::forward<Args>(args)...);
+    }
+
 }
 
@@ -0,0 +1,50 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "Prefab.hpp"
+
+#include "XYZ/Math/Transform.hpp"
+
+namespace XYZ::Scene {
+
+	Prefab::Prefab(const Object& root) {
+		// flatten the hierarchy in breadth-first order: every parent is stored
+		// before its children
+		std::vector<const Object*> queue;
+		queue.push_back(&root);
+		nodes.push_back({NO_PARENT, root.getModel(), Object::Position(0.0f), Object::Rotation(0.0f),
+						 Object::Scale(1.0f), glm::mat4(1.0f)});
+
+		for(std::size_t i = 0; i < queue.size(); i++) {
+			for(const auto& child : queue[i]->getChildren()) {
+				Node node = {i, child->getModel(), child->getPosition(), child->getRotation(), child->getScale()};
+				node.transform = Math::composeTransform(nodes[i].transform, node.position, node.rotation, node.scale);
+
+				queue.push_back(child.get());
+				nodes.push_back(std::move(node));
+			}
+		}
+
+		for(const auto& node : nodes) {
+			if(node.model != nullptr) {
+				boundingBox.merge(node.model->getBoundingBox().transform(node.transform));
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const std::vector<Prefab::Node>& Prefab::getNodes() const {
+		return nodes;
+	}
+
+	std::size_t Prefab::getNodeCount() const {
+		return nodes.size();
+	}
+
+	const Math::BoundingBox& Prefab::getBoundingBox() const {
+		return boundingBox;
+	}
+
+}
@@ -0,0 +1,113 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Object.hpp"
+#include "XYZ/Math/BoundingBox.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace XYZ::Scene {
+
+	/**
+	 * A prefab is a immutable object hierarchy that can be placed in a scene any
+	 * number of times through <tt>PrefabInstance</tt> objects.
+	 *
+	 * The hierarchy is stored as a flat list of nodes in breadth-first order: every
+	 * node comes after its parent and the first node is the hierarchy root. The
+	 * models are shared by every instance of the prefab, only the instance transform
+	 * and its overrides are stored per instance.
+	 */
+	class Prefab {
+	public:
+		using Ptr = std::shared_ptr<const Prefab>;
+
+		/**
+		 * The parent index of the root node
+		 */
+		static constexpr std::size_t NO_PARENT = std::numeric_limits<std::size_t>::max();
+
+		/**
+		 * A single object of the prefab hierarchy
+		 */
+		struct Node {
+			/**
+			 * The index of the parent node or <tt>NO_PARENT</tt> for the root node
+			 */
+			std::size_t parent;
+
+			/**
+			 * The node model. May be null.
+			 */
+			Graphics::Model::Model::Ptr model;
+
+			/**
+			 * The node position relative to its parent
+			 */
+			Object::Position position;
+
+			/**
+			 * The node rotation relative to its parent
+			 */
+			Object::Rotation rotation;
+
+			/**
+			 * The node scale relative to its parent
+			 */
+			Object::Scale scale;
+
+			/**
+			 * The node model matrix relative to the prefab root
+			 */
+			glm::mat4 transform;
+		};
+
+	private:
+		/**
+		 * The prefab nodes, in breadth-first order
+		 */
+		std::vector<Node> nodes;
+
+		/**
+		 * The bounding box of every node model, relative to the prefab root
+		 */
+		Math::BoundingBox boundingBox;
+
+	public:
+		/**
+		 * Creates a new prefab by copying a object hierarchy.
+		 *
+		 * The models are shared with the source objects, but the hierarchy itself
+		 * is copied: changing the source objects afterwards does not affect the
+		 * prefab. The transform of <tt>root</tt> is ignored, instances are placed
+		 * by their own transform.
+		 *
+		 * @param root the root of the object hierarchy
+		 */
+		explicit Prefab(const Object& root);
+
+	public:
+		/**
+		 * @return the prefab nodes, in breadth-first order
+		 */
+		const std::vector<Node>& getNodes() const;
+
+		/**
+		 * @return the number of nodes in the prefab
+		 */
+		std::size_t getNodeCount() const;
+
+		/**
+		 * @return the bounding box of every node model, relative to the prefab root
+		 */
+		const Math::BoundingBox& getBoundingBox() const;
+
+	};
+
+}
@@ -0,0 +1,126 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "PrefabInstance.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace XYZ::Scene {
+
+	PrefabInstance::PrefabInstance(Prefab::Ptr prefab) :
+			prefab(std::move(prefab)), boundingBox(PrefabInstance::prefab->getBoundingBox()) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const Prefab::Ptr& PrefabInstance::getPrefab() const {
+		return prefab;
+	}
+
+	static bool compareOverride(const PrefabInstance::Override& override, std::size_t node) {
+		return override.node < node;
+	}
+
+	const Graphics::Model::Model::Ptr& PrefabInstance::getNodeModel(std::size_t node) const {
+		if(expanded) {
+			throw std::logic_error("The prefab instance was already expanded");
+		}
+
+		auto found = std::lower_bound(overrides.begin(), overrides.end(), node, compareOverride);
+		if(found != overrides.end() && found->node == node) {
+			return found->model;
+		}
+		return prefab->getNodes().at(node).model;
+	}
+
+	void PrefabInstance::setNodeModel(std::size_t node, const Graphics::Model::Model::Ptr& model) {
+		if(expanded) {
+			throw std::logic_error("The prefab instance was already expanded");
+		}
+		if(node >= prefab->getNodeCount()) {
+			throw std::out_of_range("Invalid prefab node index");
+		}
+
+		auto found = std::lower_bound(overrides.begin(), overrides.end(), node, compareOverride);
+		if(found != overrides.end() && found->node == node) {
+			found->model = model;
+		} else {
+			overrides.insert(found, {node, model});
+		}
+		updateBoundingBox();
+	}
+
+	void PrefabInstance::resetNodeModel(std::size_t node) {
+		if(expanded) {
+			throw std::logic_error("The prefab instance was already expanded");
+		}
+
+		auto found = std::lower_bound(overrides.begin(), overrides.end(), node, compareOverride);
+		if(found != overrides.end() && found->node == node) {
+			overrides.erase(found);
+			updateBoundingBox();
+		}
+	}
+
+	const std::vector<PrefabInstance::Override>& PrefabInstance::getOverrides() const {
+		return overrides;
+	}
+
+	const Math::BoundingBox& PrefabInstance::getBoundingBox() const {
+		return boundingBox;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	bool PrefabInstance::isExpanded() const {
+		return expanded;
+	}
+
+	void PrefabInstance::expand() {
+		if(expanded) {
+			return;
+		}
+
+		const auto& nodes = prefab->getNodes();
+		std::vector<Object::Ptr> objects;
+		objects.reserve(nodes.size());
+
+		for(std::size_t i = 0; i < nodes.size(); i++) {
+			const auto& node = nodes[i];
+
+			auto object = makeObject<Object>();
+			object->setPosition(node.position);
+			object->setRotation(node.rotation);
+			object->setScale(node.scale);
+			object->setModel(getNodeModel(i));
+
+			if(node.parent == Prefab::NO_PARENT) {
+				addChild(object);
+			} else {
+				objects[node.parent]->addChild(object);
+			}
+			objects.push_back(std::move(object));
+		}
+
+		overrides.clear();
+		boundingBox = prefab->getBoundingBox();
+		expanded = true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void PrefabInstance::updateBoundingBox() {
+		if(overrides.empty()) {
+			boundingBox = prefab->getBoundingBox();
+			return;
+		}
+
+		boundingBox = Math::BoundingBox();
+		visit(glm::mat4(1.0f), [this](const Graphics::Model::Model::Ptr& model, const glm::mat4& modelMatrix) {
+			boundingBox.merge(model->getBoundingBox().transform(modelMatrix));
+		});
+	}
+
+}
@@ -0,0 +1,179 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Object.hpp"
+#include "XYZ/Scene/Prefab/Prefab.hpp"
+
+#include <vector>
+
+namespace XYZ::Scene {
+
+	/**
+	 * A object that places a prefab in the scene.
+	 *
+	 * A instance only stores its own transform, a reference to the prefab and a
+	 * table of per-instance model overrides: placing a prefab a thousand times does
+	 * not copy its hierarchy a thousand times. Renderers walk the prefab nodes
+	 * directly through <tt>visit</tt>.
+	 *
+	 * The prefab hierarchy is only turned into real child objects when
+	 * <tt>expand</tt> is called, for instance when a editor needs to change a single
+	 * part of the instance.
+	 */
+	class PrefabInstance : public Object {
+	public:
+		/**
+		 * Replaces the model of a single prefab node in a instance
+		 */
+		struct Override {
+			/**
+			 * The index of the overridden node
+			 */
+			std::size_t node;
+
+			/**
+			 * The model used instead of the node model. A null model hides the node.
+			 */
+			Graphics::Model::Model::Ptr model;
+		};
+
+	private:
+		/**
+		 * The instantiated prefab
+		 */
+		Prefab::Ptr prefab;
+
+		/**
+		 * The instance overrides, sorted by node index
+		 */
+		std::vector<Override> overrides;
+
+		/**
+		 * The bounding box of the instance nodes, relative to the instance. Equal to
+		 * the prefab bounding box unless there are overrides.
+		 */
+		Math::BoundingBox boundingBox;
+
+		/**
+		 * Whether the prefab hierarchy was already turned into child objects
+		 */
+		bool expanded = false;
+
+	public:
+		/**
+		 * Creates a new prefab instance
+		 *
+		 * @param prefab the prefab to be instantiated
+		 */
+		explicit PrefabInstance(Prefab::Ptr prefab);
+
+	public:
+		/**
+		 * @return the instantiated prefab
+		 */
+		const Prefab::Ptr& getPrefab() const;
+
+		/**
+		 * @param node the node index
+		 *
+		 * @return the model of <tt>node</tt> in this instance, taking the overrides
+		 * into account
+		 *
+		 * @throws std::logic_error if the instance is expanded. The nodes are then
+		 * regular child objects and their models must be read from them.
+		 */
+		const Graphics::Model::Model::Ptr& getNodeModel(std::size_t node) const;
+
+		/**
+		 * Overrides the model of a node in this instance only
+		 *
+		 * @param node the node index
+		 * @param model the model to use instead of the prefab model. A null model
+		 * hides the node.
+		 *
+		 * @throws std::out_of_range if <tt>node</tt> is not a node of the prefab
+		 * @throws std::logic_error if the instance is expanded. The model must then
+		 * be set on the corresponding child object.
+		 */
+		void setNodeModel(std::size_t node, const Graphics::Model::Model::Ptr& model);
+
+		/**
+		 * Removes the override of a node, if any
+		 *
+		 * @param node the node index
+		 *
+		 * @throws std::logic_error if the instance is expanded
+		 */
+		void resetNodeModel(std::size_t node);
+
+		/**
+		 * @return the instance overrides, sorted by node index
+		 */
+		const std::vector<Override>& getOverrides() const;
+
+		/**
+		 * @return the bounding box of the instance nodes, relative to the instance
+		 */
+		const Math::BoundingBox& getBoundingBox() const;
+
+	public:
+		/**
+		 * @return true if the prefab hierarchy was already turned into child objects
+		 */
+		bool isExpanded() const;
+
+		/**
+		 * Turns the prefab hierarchy into child objects of this instance. The prefab
+		 * root becomes a single child with a identity transform. Does nothing if the
+		 * instance is already expanded.
+		 *
+		 * After expansion the instance behaves like a regular object: the children
+		 * can be changed freely and <tt>visit</tt> no longer visits any node. The
+		 * models are still shared with the prefab.
+		 *
+		 * This method must not be called while the scene is being rendered.
+		 */
+		void expand();
+
+		/**
+		 * Calls <tt>visitor(model, modelMatrix)</tt> for every node of the instance
+		 * that has a model. Does nothing if the instance is expanded.
+		 *
+		 * This method does not change the instance and can be called concurrently.
+		 *
+		 * @param modelMatrix the instance model matrix
+		 * @param visitor the node visitor
+		 */
+		template<typename Visitor>
+		void visit(const glm::mat4& modelMatrix, Visitor&& visitor) const {
+			if(expanded) {
+				return;
+			}
+
+			const auto& nodes = prefab->getNodes();
+			auto override = overrides.begin();
+			for(std::size_t i = 0; i < nodes.size(); i++) {
+				const auto* model = &nodes[i].model;
+				if(override != overrides.end() && override->node == i) {
+					model = &override->model;
+					++override;
+				}
+
+				if(*model != nullptr) {
+					visitor(*model, modelMatrix * nodes[i].transform);
+				}
+			}
+		}
+
+	private:
+		/**
+		 * Recomputes the instance bounding box after the overrides change
+		 */
+		void updateBoundingBox();
+
+	};
+
+}
@@ -10,7 +10,7 @@ namespace XYZ::Scene {
 
     Scene::Scene() :
             lights(),
-            camera(std::make_shared<Camera>()) {
+            camera(makeObject<Camera>()) {
     }
 
     const std::shared_ptr<Object> &Scene::getRootObject() const {
@@ -45,4 +45,12 @@ namespace XYZ::Scene {
         Scene::camera = camera;
     }
 
+    const std::shared_ptr<Manager::SceneManager> &Scene::getSceneManager() const {
+        return sceneManager;
+    }
+
+    void Scene::setSceneManager(const std::shared_ptr<Manager::SceneManager> &sceneManager) {
+        Scene::sceneManager = sceneManager;
+    }
+
 }
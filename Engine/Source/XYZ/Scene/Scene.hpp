@@ -7,6 +7,7 @@
 #include "XYZ/Scene/Object.hpp"
 #include "XYZ/Scene/Light/Light.hpp"
 #include "XYZ/Scene/Camera.hpp"
+#include "XYZ/Scene/Manager/SceneManager.hpp"
 
 #include <vector>
 
@@ -18,6 +19,12 @@ namespace XYZ::Scene {
 		std::vector<std::shared_ptr<Light::Light>> lights;
 		std::shared_ptr<Camera> camera;
 
+		/**
+		 * The scene manager used by renderers to skip the parts of the scene that
+		 * cannot be seen. May be null.
+		 */
+		std::shared_ptr<Manager::SceneManager> sceneManager;
+
 	public:
 		Scene();
 
@@ -32,6 +39,9 @@ namespace XYZ::Scene {
 		const std::shared_ptr<Camera>& getCamera() const;
 		void setCamera(const std::shared_ptr<Camera>& camera);
 
+		const std::shared_ptr<Manager::SceneManager>& getSceneManager() const;
+		void setSceneManager(const std::shared_ptr<Manager::SceneManager>& sceneManager);
+
 
 	};
 
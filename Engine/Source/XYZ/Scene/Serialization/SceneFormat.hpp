@@ -0,0 +1,159 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Exception.hpp"
+
+#include <cstdint>
+
+namespace XYZ::Scene::Serialization {
+
+	XYZ_DECL_ROOT_EXCEPTION(SceneSerializationException);
+
+	/**
+	 * The on-disk layout of a binary scene file.
+	 *
+	 * A scene file is made of a header followed by four tightly packed arrays:
+	 *
+	 *     SceneFileHeader
+	 *     SceneFileObject[objectCount]
+	 *     SceneFileLight[lightCount]
+	 *     SceneFileModel[modelCount]
+	 *     char strings[stringTableSize]
+	 *
+	 * Every record is made only of 4 byte fields, so the arrays are naturally aligned
+	 * and can be read in place from a memory mapped file. Values are stored in the
+	 * host byte order, which is little-endian on every supported platform.
+	 *
+	 * Objects are stored in breadth-first order, so that a object parent always
+	 * comes before it. The first object is the scene root object.
+	 */
+	namespace SceneFile {
+
+		/**
+		 * The scene file magic number: "XYZS"
+		 */
+		constexpr std::uint32_t MAGIC = 0x535A5958;
+
+		/**
+		 * The current scene file version
+		 */
+		constexpr std::uint32_t VERSION = 1;
+
+		/**
+		 * The index used to indicate a missing reference
+		 */
+		constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+		/**
+		 * The light flag set when the light casts shadows
+		 */
+		constexpr std::uint32_t LIGHT_SHADOWS = 1 << 0;
+
+	}
+
+	struct SceneFileHeader {
+		/**
+		 * The file magic number. Must be <tt>SceneFile::MAGIC</tt>.
+		 */
+		std::uint32_t magic;
+
+		/**
+		 * The file format version
+		 */
+		std::uint32_t version;
+
+		/**
+		 * The number of objects in the hierarchy, including the root object
+		 */
+		std::uint32_t objectCount;
+
+		/**
+		 * The number of lights
+		 */
+		std::uint32_t lightCount;
+
+		/**
+		 * The number of distinct models referenced by the objects
+		 */
+		std::uint32_t modelCount;
+
+		/**
+		 * The size of the string table, in bytes
+		 */
+		std::uint32_t stringTableSize;
+	};
+
+	struct SceneFileObject {
+		/**
+		 * The parent object index or <tt>SceneFile::NONE</tt> for the root object
+		 */
+		std::uint32_t parent;
+
+		/**
+		 * The model index or <tt>SceneFile::NONE</tt> if the object has no model
+		 */
+		std::uint32_t model;
+
+		float position[3];
+		float rotation[3];
+		float scale[3];
+	};
+
+	struct SceneFileLight {
+		/**
+		 * The light type, as a <tt>Light::LightType</tt> value
+		 */
+		std::uint32_t type;
+
+		/**
+		 * The light flags
+		 */
+		std::uint32_t flags;
+
+		float position[3];
+		float ambient[3];
+		float diffuse[3];
+		float specular[3];
+
+		/**
+		 * The light direction. Unused for point lights.
+		 */
+		float direction[3];
+
+		/**
+		 * The attenuation factors. Unused for directional lights.
+		 */
+		float constant;
+		float linear;
+		float quadratic;
+
+		/**
+		 * The spot cut-off angles, in degrees. Only used for spot lights.
+		 */
+		float cutOff;
+		float outerCutOff;
+
+		float shadowOcclusionStrength;
+	};
+
+	struct SceneFileModel {
+		/**
+		 * The offset of the model name in the string table
+		 */
+		std::uint32_t nameOffset;
+
+		/**
+		 * The model name length, in bytes
+		 */
+		std::uint32_t nameLength;
+	};
+
+	static_assert(sizeof(SceneFileHeader) == 24, "Unexpected scene header size");
+	static_assert(sizeof(SceneFileObject) == 44, "Unexpected scene object size");
+	static_assert(sizeof(SceneFileLight) == 92, "Unexpected scene light size");
+	static_assert(sizeof(SceneFileModel) == 8, "Unexpected scene model size");
+
+}
@@ -0,0 +1,200 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "SceneReader.hpp"
+
+#include "XYZ/Scene/Light/PointLight.hpp"
+#include "XYZ/Scene/Light/SpotLight.hpp"
+#include "XYZ/Scene/Light/DirectionalLight.hpp"
+
+#include "XYZ/Utility/MappedFile.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace XYZ::Scene::Serialization {
+
+	static glm::vec3 toVector(const float* values) {
+		return glm::vec3(values[0], values[1], values[2]);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	SceneReader::SceneReader(SceneReader::ModelResolver modelResolver) : modelResolver(std::move(modelResolver)) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void SceneReader::read(Scene& scene, const std::string& path) const {
+		Utility::MappedFile file(path);
+		read(scene, file.getData(), file.getSize());
+	}
+
+	void SceneReader::read(Scene& scene, Resource::Locator::ResourceStream& stream) const {
+		std::vector<std::uint32_t> buffer;
+		std::size_t size = 0;
+
+		std::uint8_t chunk[64 * 1024];
+		while(stream.hasData()) {
+			auto count = stream.read(chunk, sizeof(chunk));
+			if(count <= 0) {
+				break;
+			}
+
+			// the buffer is made of words to keep the records aligned
+			buffer.resize((size + std::size_t(count) + 3) / 4);
+			std::copy(chunk, chunk + count, reinterpret_cast<std::uint8_t*>(buffer.data()) + size);
+			size += std::size_t(count);
+		}
+
+		read(scene, buffer.data(), size);
+	}
+
+	void SceneReader::read(Scene& scene, const void* data, std::size_t size) const {
+		if(reinterpret_cast<std::uintptr_t>(data) % alignof(SceneFileHeader) != 0) {
+			throw SceneSerializationException("The scene data is not aligned");
+		}
+		if(size < sizeof(SceneFileHeader)) {
+			throw SceneSerializationException("The scene file is truncated");
+		}
+
+		auto bytes = static_cast<const std::uint8_t*>(data);
+		const auto& header = *reinterpret_cast<const SceneFileHeader*>(bytes);
+		if(header.magic != SceneFile::MAGIC) {
+			throw SceneSerializationException("Not a scene file");
+		}
+		if(header.version != SceneFile::VERSION) {
+			throw SceneSerializationException("Unsupported scene file version " + std::to_string(header.version));
+		}
+		if(header.objectCount == 0) {
+			throw SceneSerializationException("The scene file has no root object");
+		}
+
+		auto expectedSize = sizeof(SceneFileHeader) +
+							sizeof(SceneFileObject) * std::size_t(header.objectCount) +
+							sizeof(SceneFileLight) * std::size_t(header.lightCount) +
+							sizeof(SceneFileModel) * std::size_t(header.modelCount) +
+							std::size_t(header.stringTableSize);
+		if(size < expectedSize) {
+			throw SceneSerializationException("The scene file is truncated");
+		}
+
+		auto objectRecords = reinterpret_cast<const SceneFileObject*>(bytes + sizeof(SceneFileHeader));
+		auto lightRecords = reinterpret_cast<const SceneFileLight*>(objectRecords + header.objectCount);
+		auto modelRecords = reinterpret_cast<const SceneFileModel*>(lightRecords + header.lightCount);
+		auto strings = reinterpret_cast<const char*>(modelRecords + header.modelCount);
+
+		// resolve every model once, objects share the resolved pointers
+		std::vector<Graphics::Model::Model::Ptr> models(header.modelCount);
+		for(std::uint32_t i = 0; i < header.modelCount; i++) {
+			const auto& record = modelRecords[i];
+			if(std::size_t(record.nameOffset) + record.nameLength > header.stringTableSize) {
+				throw SceneSerializationException("Invalid model name in scene file");
+			}
+			models[i] = modelResolver(std::string(strings + record.nameOffset, record.nameLength));
+		}
+
+		// count the children of every object so that the children lists are
+		// allocated only once
+		std::vector<std::uint32_t> childCounts(header.objectCount, 0);
+		for(std::uint32_t i = 0; i < header.objectCount; i++) {
+			const auto& record = objectRecords[i];
+			if(record.model != SceneFile::NONE && record.model >= header.modelCount) {
+				throw SceneSerializationException("Invalid object model in scene file");
+			}
+
+			// the root object has no parent
+			if(i == 0) {
+				continue;
+			}
+			if(record.parent >= i) {
+				throw SceneSerializationException("Invalid object parent in scene file");
+			}
+			childCounts[record.parent]++;
+		}
+
+		std::vector<std::shared_ptr<Object>> objects;
+		objects.reserve(header.objectCount);
+
+		for(std::uint32_t i = 0; i < header.objectCount; i++) {
+			const auto& record = objectRecords[i];
+
+			auto object = makeObject<Object>();
+			object->position = toVector(record.position);
+			object->rotation = toVector(record.rotation);
+			object->scale = toVector(record.scale);
+			if(record.model != SceneFile::NONE) {
+				object->model = models[record.model];
+			}
+			object->children.reserve(childCounts[i]);
+
+			// the hierarchy is freshly built: there is no need to check for
+			// duplicated children like addChild does
+			if(i != 0) {
+				auto& parent = objects[record.parent];
+				object->parent = parent;
+				object->childIndex = parent->children.size();
+				parent->children.push_back(object);
+			}
+			objects.push_back(std::move(object));
+		}
+
+		std::vector<std::shared_ptr<Light::Light>> lights;
+		lights.reserve(header.lightCount);
+
+		for(std::uint32_t i = 0; i < header.lightCount; i++) {
+			const auto& record = lightRecords[i];
+
+			std::shared_ptr<Light::Light> light;
+			switch(Light::LightType(record.type)) {
+				case Light::LightType::DIRECTIONAL: {
+					auto directionalLight = makeObject<Light::DirectionalLight>();
+					directionalLight->setDirection(toVector(record.direction));
+					light = std::move(directionalLight);
+					break;
+				}
+
+				case Light::LightType::POINT: {
+					auto pointLight = makeObject<Light::PointLight>();
+					pointLight->setConstant(record.constant);
+					pointLight->setLinear(record.linear);
+					pointLight->setQuadratic(record.quadratic);
+					light = std::move(pointLight);
+					break;
+				}
+
+				case Light::LightType::SPOT: {
+					auto spotLight = makeObject<Light::SpotLight>();
+					spotLight->setDirection(toVector(record.direction));
+					spotLight->setConstant(record.constant);
+					spotLight->setLinear(record.linear);
+					spotLight->setQuadratic(record.quadratic);
+					spotLight->setCutOff(record.cutOff);
+					spotLight->setOuterCutOff(record.outerCutOff);
+					light = std::move(spotLight);
+					break;
+				}
+
+				default:
+					throw SceneSerializationException("Invalid light type in scene file");
+			}
+
+			light->position = toVector(record.position);
+			light->setAmbient(toVector(record.ambient));
+			light->setDiffuse(toVector(record.diffuse));
+			light->setSpecular(toVector(record.specular));
+			light->setShadows((record.flags & SceneFile::LIGHT_SHADOWS) != 0);
+			light->setShadowOcclusionStrength(record.shadowOcclusionStrength);
+			lights.push_back(std::move(light));
+		}
+
+		// only touch the scene once the whole file has been validated
+		scene.setRootObject(objects.front());
+		for(const auto& light : lights) {
+			scene.addLight(light);
+		}
+	}
+
+}
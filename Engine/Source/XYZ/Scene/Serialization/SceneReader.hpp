@@ -0,0 +1,88 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Scene.hpp"
+#include "XYZ/Scene/Serialization/SceneFormat.hpp"
+
+#include "XYZ/Resource/Locator/ResourceStream.hpp"
+
+#include <functional>
+#include <string>
+
+namespace XYZ::Scene::Serialization {
+
+	/**
+	 * Reads a scene in the binary scene format described in <tt>SceneFormat.hpp</tt>.
+	 *
+	 * The file is parsed in place: records are read directly from the mapped file
+	 * memory. Objects and lights are allocated from the shared object pools and
+	 * every object children list is reserved up-front, so loading a scene does not
+	 * go through the system allocator once per object.
+	 */
+	class SceneReader {
+	public:
+		/**
+		 * A function that returns the model saved with the given name. It may return
+		 * <tt>nullptr</tt>, in which case the objects referencing the model are loaded
+		 * without one.
+		 */
+		using ModelResolver = std::function<Graphics::Model::Model::Ptr(const std::string& name)>;
+
+	private:
+		/**
+		 * The model resolver
+		 */
+		ModelResolver modelResolver;
+
+	public:
+		/**
+		 * Creates a new scene reader
+		 *
+		 * @param modelResolver the function used to resolve the scene models. It is
+		 * called once per distinct model in the file.
+		 */
+		explicit SceneReader(ModelResolver modelResolver);
+
+	public:
+		/**
+		 * Reads a scene from a file. The file is memory mapped.
+		 *
+		 * The scene root object is replaced and the loaded lights are added to the
+		 * scene existing lights.
+		 *
+		 * @param scene the scene to read into
+		 * @param path the path of the file to read
+		 *
+		 * @throws SceneSerializationException if the file is not a valid scene file
+		 * @throws Utility::MappedFileException if the file cannot be mapped
+		 */
+		void read(Scene& scene, const std::string& path) const;
+
+		/**
+		 * Reads a scene from a resource stream. The whole stream is read into memory
+		 * before being parsed.
+		 *
+		 * @param scene the scene to read into
+		 * @param stream the stream to read from
+		 *
+		 * @throws SceneSerializationException if the stream is not a valid scene file
+		 */
+		void read(Scene& scene, Resource::Locator::ResourceStream& stream) const;
+
+		/**
+		 * Reads a scene from memory
+		 *
+		 * @param scene the scene to read into
+		 * @param data the scene file contents. Must be aligned to 4 bytes.
+		 * @param size the scene file size, in bytes
+		 *
+		 * @throws SceneSerializationException if the data is not a valid scene file
+		 */
+		void read(Scene& scene, const void* data, std::size_t size) const;
+
+	};
+
+}
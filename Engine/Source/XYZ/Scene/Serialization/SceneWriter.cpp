@@ -0,0 +1,190 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "SceneWriter.hpp"
+
+#include "XYZ/Scene/Light/PointLight.hpp"
+#include "XYZ/Scene/Light/SpotLight.hpp"
+#include "XYZ/Scene/Light/DirectionalLight.hpp"
+#include "XYZ/Scene/Prefab/PrefabInstance.hpp"
+
+#include <fstream>
+#include <unordered_map>
+
+namespace XYZ::Scene::Serialization {
+
+	static void copy(float* destination, const glm::vec3& vector) {
+		destination[0] = vector.x;
+		destination[1] = vector.y;
+		destination[2] = vector.z;
+	}
+
+	template<typename T>
+	static void writeArray(std::ostream& stream, const std::vector<T>& array) {
+		if(array.empty()) {
+			return;
+		}
+		stream.write(reinterpret_cast<const char*>(array.data()), std::streamsize(sizeof(T) * array.size()));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	SceneWriter::SceneWriter(SceneWriter::ModelNamer modelNamer) : modelNamer(std::move(modelNamer)) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void SceneWriter::write(const Scene& scene, std::ostream& stream) const {
+		if(scene.getRootObject() == nullptr) {
+			throw SceneSerializationException("The scene has no root object");
+		}
+
+		std::vector<SceneFileObject> objects;
+		std::vector<SceneFileLight> lights;
+		std::vector<SceneFileModel> models;
+		std::string strings;
+
+		std::unordered_map<const Graphics::Model::Model*, std::uint32_t> modelIndices;
+		std::unordered_map<std::string, std::uint32_t> nameIndices;
+
+		auto getModelIndex = [&](const Graphics::Model::Model* model) -> std::uint32_t {
+			if(model == nullptr) {
+				return SceneFile::NONE;
+			}
+
+			auto found = modelIndices.find(model);
+			if(found != modelIndices.end()) {
+				return found->second;
+			}
+
+			auto name = modelNamer(*model);
+			auto index = SceneFile::NONE;
+			if(!name.empty()) {
+				// models with the same name are loaded only once
+				auto foundName = nameIndices.find(name);
+				if(foundName != nameIndices.end()) {
+					index = foundName->second;
+				} else {
+					index = std::uint32_t(models.size());
+					models.push_back({std::uint32_t(strings.size()), std::uint32_t(name.size())});
+					strings += name;
+					nameIndices.emplace(std::move(name), index);
+				}
+			}
+			modelIndices.emplace(model, index);
+			return index;
+		};
+
+		// flatten the hierarchy in breadth-first order: every parent is written
+		// before its children
+		std::vector<const Object*> queue;
+		queue.push_back(scene.getRootObject().get());
+		objects.push_back({SceneFile::NONE});
+
+		for(std::size_t i = 0; i < queue.size(); i++) {
+			const auto* object = queue[i];
+			if(object == nullptr) {
+				// the prefab nodes were already written by their instance
+				continue;
+			}
+
+			auto& record = objects[i];
+			record.model = getModelIndex(object->getModel().get());
+			copy(record.position, object->position);
+			copy(record.rotation, object->rotation);
+			copy(record.scale, object->scale);
+
+			// prefab instances that were not expanded are written as if they were: the
+			// prefab nodes become regular objects
+			auto instance = dynamic_cast<const PrefabInstance*>(object);
+			if(instance != nullptr && !instance->isExpanded()) {
+				auto first = std::uint32_t(objects.size());
+				const auto& nodes = instance->getPrefab()->getNodes();
+				for(std::size_t node = 0; node < nodes.size(); node++) {
+					SceneFileObject nodeRecord = {};
+					nodeRecord.parent = nodes[node].parent == Prefab::NO_PARENT ?
+										std::uint32_t(i) : first + std::uint32_t(nodes[node].parent);
+					nodeRecord.model = getModelIndex(instance->getNodeModel(node).get());
+					copy(nodeRecord.position, nodes[node].position);
+					copy(nodeRecord.rotation, nodes[node].rotation);
+					copy(nodeRecord.scale, nodes[node].scale);
+
+					queue.push_back(nullptr);
+					objects.push_back(nodeRecord);
+				}
+			}
+
+			for(const auto& child : object->getChildren()) {
+				queue.push_back(child.get());
+				objects.push_back({std::uint32_t(i)});
+			}
+		}
+
+		for(const auto& light : scene.getLights()) {
+			SceneFileLight record = {};
+			record.type = std::uint32_t(light->getLightType());
+			record.flags = light->hasShadows() ? SceneFile::LIGHT_SHADOWS : 0;
+			copy(record.position, light->position);
+			copy(record.ambient, light->getAmbient());
+			copy(record.diffuse, light->getDiffuse());
+			copy(record.specular, light->getSpecular());
+			record.shadowOcclusionStrength = light->getShadowOcclusionStrength();
+
+			switch(light->getLightType()) {
+				case Light::LightType::DIRECTIONAL: {
+					const auto& directionalLight = static_cast<const Light::DirectionalLight&>(*light);
+					copy(record.direction, directionalLight.getDirection());
+					break;
+				}
+
+				case Light::LightType::POINT: {
+					const auto& pointLight = static_cast<const Light::PointLight&>(*light);
+					record.constant = pointLight.getConstant();
+					record.linear = pointLight.getLinear();
+					record.quadratic = pointLight.getQuadratic();
+					break;
+				}
+
+				case Light::LightType::SPOT: {
+					const auto& spotLight = static_cast<const Light::SpotLight&>(*light);
+					copy(record.direction, spotLight.getDirection());
+					record.constant = spotLight.getConstant();
+					record.linear = spotLight.getLinear();
+					record.quadratic = spotLight.getQuadratic();
+					record.cutOff = spotLight.getCutOff();
+					record.outerCutOff = spotLight.getOuterCutOff();
+					break;
+				}
+			}
+			lights.push_back(record);
+		}
+
+		SceneFileHeader header = {};
+		header.magic = SceneFile::MAGIC;
+		header.version = SceneFile::VERSION;
+		header.objectCount = std::uint32_t(objects.size());
+		header.lightCount = std::uint32_t(lights.size());
+		header.modelCount = std::uint32_t(models.size());
+		header.stringTableSize = std::uint32_t(strings.size());
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writeArray(stream, objects);
+		writeArray(stream, lights);
+		writeArray(stream, models);
+		stream.write(strings.data(), std::streamsize(strings.size()));
+
+		if(!stream) {
+			throw SceneSerializationException("Unable to write the scene");
+		}
+	}
+
+	void SceneWriter::write(const Scene& scene, const std::string& path) const {
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if(!stream) {
+			throw SceneSerializationException("Unable to open " + path);
+		}
+		write(scene, stream);
+	}
+
+}
@@ -0,0 +1,69 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Scene.hpp"
+#include "XYZ/Scene/Serialization/SceneFormat.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace XYZ::Scene::Serialization {
+
+	/**
+	 * Writes a scene in the binary scene format described in <tt>SceneFormat.hpp</tt>.
+	 *
+	 * Models are not serialized. Instead, every model is written as a name that the
+	 * <tt>SceneReader</tt> resolves back to a model when loading the scene.
+	 */
+	class SceneWriter {
+	public:
+		/**
+		 * A function that returns the name a model should be saved as. If it returns a
+		 * empty string, the object is saved without a model.
+		 */
+		using ModelNamer = std::function<std::string(const Graphics::Model::Model& model)>;
+
+	private:
+		/**
+		 * The model namer
+		 */
+		ModelNamer modelNamer;
+
+	public:
+		/**
+		 * Creates a new scene writer
+		 *
+		 * @param modelNamer the function used to name the scene models
+		 */
+		explicit SceneWriter(ModelNamer modelNamer);
+
+	public:
+		/**
+		 * Writes a scene into a stream
+		 *
+		 * @param scene the scene to be written
+		 * @param stream the stream to write to. Must be opened in binary mode.
+		 *
+		 * @throws SceneSerializationException if the scene has no root object or if the
+		 * stream fails
+		 */
+		void write(const Scene& scene, std::ostream& stream) const;
+
+		/**
+		 * Writes a scene into a file
+		 *
+		 * @param scene the scene to be written
+		 * @param path the path of the file to write to
+		 *
+		 * @throws SceneSerializationException if the scene has no root object or if the
+		 * file cannot be written
+		 */
+		void write(const Scene& scene, const std::string& path) const;
+
+	};
+
+}
@@ -0,0 +1,232 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#include "WorldStreamer.hpp"
+
+#include "XYZ/Utility/MappedFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+
+namespace XYZ::Scene::Streaming {
+
+	WorldStreamer::WorldStreamer(Scene& scene, Utility::JobSystem& jobSystem,
+								 Serialization::SceneReader::ModelResolver modelResolver,
+								 WorldStreamer::CellLocator cellLocator, float cellSize, float loadRadius,
+								 std::size_t memoryBudget) :
+			scene(scene),
+			jobSystem(jobSystem),
+			reader(std::move(modelResolver)),
+			cellLocator(std::move(cellLocator)),
+			cellSize(cellSize),
+			loadRadius(loadRadius),
+			memoryBudget(memoryBudget) {
+	}
+
+	WorldStreamer::~WorldStreamer() {
+		for(auto& entry : cells) {
+			auto& cell = entry.second;
+			if(cell.loading.valid()) {
+				cell.loading.wait();
+			}
+			if(cell.attached) {
+				detach(cell);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void WorldStreamer::update() {
+		auto position = scene.getCamera()->getPosition();
+
+		// request every cell within the load radius that is not known yet
+		auto first = getCell(position - glm::vec3(loadRadius));
+		auto last = getCell(position + glm::vec3(loadRadius));
+		for(int x = first.first; x <= last.first; x++) {
+			for(int z = first.second; z <= last.second; z++) {
+				CellCoordinate coordinate(x, z);
+				if(getDistance(coordinate, position) > loadRadius || cells.count(coordinate) != 0) {
+					continue;
+				}
+
+				auto& cell = cells[coordinate];
+				auto path = cellLocator(coordinate);
+
+				// the map never moves its elements, so the job can safely write to the cell
+				cell.loading = jobSystem.schedule([&cell, path]() {
+					Utility::MappedFile file(path);
+					cell.data.resize((file.getSize() + 3) / 4);
+					if(file.getSize() != 0) {
+						std::memcpy(cell.data.data(), file.getData(), file.getSize());
+					}
+					cell.size = file.getSize();
+				});
+			}
+		}
+
+		// attach the cells that finished loading and are still wanted, detach the
+		// cells that left the load radius
+		std::exception_ptr error;
+		for(auto& entry : cells) {
+			auto& cell = entry.second;
+			if(!cell.loaded) {
+				if(cell.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+					continue;
+				}
+				try {
+					finishLoading(cell);
+				} catch(...) {
+					if(!error) {
+						error = std::current_exception();
+					}
+				}
+			}
+
+			bool inside = getDistance(entry.first, position) <= loadRadius;
+			if(inside && !cell.attached) {
+				attach(cell);
+			} else if(!inside && cell.attached) {
+				detach(cell);
+			}
+		}
+
+		// empty cells cost nothing to reload: forget them as soon as they are detached
+		for(auto iterator = cells.begin(); iterator != cells.end();) {
+			const auto& cell = iterator->second;
+			if(cell.loaded && !cell.attached && cell.root == nullptr && cell.lights.empty()) {
+				iterator = cells.erase(iterator);
+			} else {
+				++iterator;
+			}
+		}
+
+		// unload the farthest detached cells until the memory budget is met
+		while(memoryUsage > memoryBudget) {
+			auto farthest = cells.end();
+			float farthestDistance = -1.0f;
+			for(auto iterator = cells.begin(); iterator != cells.end(); ++iterator) {
+				if(!iterator->second.loaded || iterator->second.attached) {
+					continue;
+				}
+
+				float distance = getDistance(iterator->first, position);
+				if(distance > farthestDistance) {
+					farthest = iterator;
+					farthestDistance = distance;
+				}
+			}
+
+			// only attached cells are left, the budget is too small for the load radius
+			if(farthest == cells.end()) {
+				break;
+			}
+
+			memoryUsage -= farthest->second.size;
+			cells.erase(farthest);
+		}
+
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	float WorldStreamer::getCellSize() const {
+		return cellSize;
+	}
+
+	float WorldStreamer::getLoadRadius() const {
+		return loadRadius;
+	}
+
+	void WorldStreamer::setLoadRadius(float loadRadius) {
+		WorldStreamer::loadRadius = loadRadius;
+	}
+
+	std::size_t WorldStreamer::getMemoryBudget() const {
+		return memoryBudget;
+	}
+
+	void WorldStreamer::setMemoryBudget(std::size_t memoryBudget) {
+		WorldStreamer::memoryBudget = memoryBudget;
+	}
+
+	std::size_t WorldStreamer::getMemoryUsage() const {
+		return memoryUsage;
+	}
+
+	std::size_t WorldStreamer::getAttachedCellCount() const {
+		return std::size_t(std::count_if(cells.begin(), cells.end(), [](const auto& entry) {
+			return entry.second.attached;
+		}));
+	}
+
+	WorldStreamer::CellCoordinate WorldStreamer::getCell(const glm::vec3& position) const {
+		return CellCoordinate(int(std::floor(position.x / cellSize)), int(std::floor(position.z / cellSize)));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	float WorldStreamer::getDistance(const CellCoordinate& cell, const glm::vec3& position) const {
+		float minimumX = float(cell.first) * cellSize;
+		float minimumZ = float(cell.second) * cellSize;
+
+		float dx = std::max({minimumX - position.x, 0.0f, position.x - (minimumX + cellSize)});
+		float dz = std::max({minimumZ - position.z, 0.0f, position.z - (minimumZ + cellSize)});
+		return std::sqrt(dx * dx + dz * dz);
+	}
+
+	void WorldStreamer::finishLoading(Cell& cell) {
+		// a failed read or parse leaves the cell loaded but empty, it is not retried
+		// until it leaves the load radius
+		cell.loaded = true;
+		auto data = std::move(cell.data);
+
+		try {
+			cell.loading.get();
+		} catch(const Utility::MappedFileException&) {
+			// cells without a file are empty
+			cell.size = 0;
+			return;
+		}
+
+		Scene cellScene;
+		try {
+			reader.read(cellScene, data.data(), cell.size);
+		} catch(...) {
+			cell.size = 0;
+			throw;
+		}
+
+		cell.root = cellScene.getRootObject();
+		cell.lights = cellScene.getLights();
+		memoryUsage += cell.size;
+	}
+
+	void WorldStreamer::attach(Cell& cell) {
+		if(cell.root != nullptr) {
+			scene.getRootObject()->addChild(cell.root);
+		}
+		for(const auto& light : cell.lights) {
+			scene.addLight(light);
+		}
+		cell.attached = true;
+	}
+
+	void WorldStreamer::detach(Cell& cell) {
+		if(cell.root != nullptr) {
+			scene.getRootObject()->removeChild(cell.root);
+		}
+		for(const auto& light : cell.lights) {
+			scene.removeLight(light);
+		}
+		cell.attached = false;
+	}
+
+}
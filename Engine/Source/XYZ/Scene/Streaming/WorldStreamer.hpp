@@ -0,0 +1,268 @@
+//
+// Created by Rogiel Sulzbach on 8/17/17.
+//
+
+#pragma once
+
+#include "XYZ/Scene/Scene.hpp"
+#include "XYZ/Scene/Serialization/SceneReader.hpp"
+#include "XYZ/Utility/JobSystem.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace XYZ::Scene::Streaming {
+
+	/**
+	 * Streams a world split in a grid of cells around the scene camera.
+	 *
+	 * The world is divided in square cells on the XZ plane. Each cell is a scene
+	 * file (see <tt>Serialization::SceneReader</tt>) whose root object is attached to
+	 * the scene root object while the cell is within the load radius of the camera.
+	 *
+	 * Cell files are read on the job system. Once read, a cell is parsed and attached
+	 * to the scene by <tt>update</tt>, which must be called on the render thread
+	 * between frames, so that the renderer never observes a partially attached cell
+	 * and models are resolved on the thread that owns the renderer.
+	 *
+	 * Cells that move out of the load radius are detached immediately but kept in
+	 * memory, so that walking back to them is instant. Detached cells are unloaded,
+	 * farthest first, only once the memory used by all loaded cells exceeds the
+	 * memory budget.
+	 */
+	class WorldStreamer {
+	public:
+		/**
+		 * A cell coordinate in the world grid. Cell (x, z) covers the world area
+		 * from (x, z) * cellSize to (x + 1, z + 1) * cellSize.
+		 */
+		using CellCoordinate = std::pair<int, int>;
+
+		/**
+		 * A function that returns the path of the scene file of a cell. Cells whose
+		 * file does not exist are treated as empty.
+		 */
+		using CellLocator = std::function<std::string(const CellCoordinate& cell)>;
+
+	private:
+		/**
+		 * A world cell
+		 */
+		struct Cell {
+			/**
+			 * The cell file contents while the cell is waiting to be attached
+			 */
+			std::vector<std::uint32_t> data;
+
+			/**
+			 * The cell file size, in bytes
+			 */
+			std::size_t size = 0;
+
+			/**
+			 * A future that becomes ready once <tt>data</tt> has been read
+			 */
+			std::future<void> loading;
+
+			/**
+			 * The cell root object. <tt>nullptr</tt> if the cell is not loaded yet or
+			 * if the cell is empty.
+			 */
+			std::shared_ptr<Object> root;
+
+			/**
+			 * The cell lights
+			 */
+			std::vector<std::shared_ptr<Light::Light>> lights;
+
+			/**
+			 * A flag indicating if the cell has finished loading
+			 */
+			bool loaded = false;
+
+			/**
+			 * A flag indicating if the cell is attached to the scene
+			 */
+			bool attached = false;
+		};
+
+	private:
+		/**
+		 * The scene the cells are attached to
+		 */
+		Scene& scene;
+
+		/**
+		 * The job system the cell files are read on
+		 */
+		Utility::JobSystem& jobSystem;
+
+		/**
+		 * The reader used to parse the cell files
+		 */
+		Serialization::SceneReader reader;
+
+		/**
+		 * The cell file locator
+		 */
+		CellLocator cellLocator;
+
+		/**
+		 * The cell size, in world units
+		 */
+		float cellSize;
+
+		/**
+		 * The distance from the camera within which cells are loaded
+		 */
+		float loadRadius;
+
+		/**
+		 * The memory budget of the loaded cells, in bytes
+		 */
+		std::size_t memoryBudget;
+
+		/**
+		 * The memory currently used by the loaded cells, in bytes. Estimated as the
+		 * size of the cell files.
+		 */
+		std::size_t memoryUsage = 0;
+
+		/**
+		 * The known cells, loaded or loading
+		 */
+		std::map<CellCoordinate, Cell> cells;
+
+	public:
+		/**
+		 * Creates a new world streamer
+		 *
+		 * @param scene the scene to attach the cells to. It must have a root object.
+		 * @param jobSystem the job system to read the cell files on
+		 * @param modelResolver the function used to resolve the models of the cells.
+		 * It is called from <tt>update</tt>.
+		 * @param cellLocator the cell file locator
+		 * @param cellSize the cell size, in world units
+		 * @param loadRadius the distance from the camera within which cells are loaded
+		 * @param memoryBudget the memory budget of the loaded cells, in bytes
+		 */
+		WorldStreamer(Scene& scene, Utility::JobSystem& jobSystem,
+					  Serialization::SceneReader::ModelResolver modelResolver, CellLocator cellLocator,
+					  float cellSize, float loadRadius, std::size_t memoryBudget);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		WorldStreamer(const WorldStreamer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		WorldStreamer& operator=(const WorldStreamer& other) = delete;
+
+		/**
+		 * Waits for pending cell reads and detaches every cell from the scene
+		 */
+		~WorldStreamer();
+
+	public:
+		/**
+		 * Updates the streamed cells around the scene camera: requests the cells
+		 * that entered the load radius, attaches the cells that finished loading,
+		 * detaches the cells that left the load radius and unloads detached cells
+		 * while over the memory budget.
+		 *
+		 * Must be called between frames, from the thread that renders the scene.
+		 *
+		 * @throws Serialization::SceneSerializationException if a cell file is invalid.
+		 * The cell is treated as empty afterwards.
+		 */
+		void update();
+
+	public:
+		/**
+		 * @return the cell size, in world units
+		 */
+		float getCellSize() const;
+
+		/**
+		 * @return the distance from the camera within which cells are loaded
+		 */
+		float getLoadRadius() const;
+
+		/**
+		 * @param loadRadius the distance from the camera within which cells are loaded
+		 */
+		void setLoadRadius(float loadRadius);
+
+		/**
+		 * @return the memory budget of the loaded cells, in bytes
+		 */
+		std::size_t getMemoryBudget() const;
+
+		/**
+		 * @param memoryBudget the memory budget of the loaded cells, in bytes
+		 */
+		void setMemoryBudget(std::size_t memoryBudget);
+
+		/**
+		 * @return the memory currently used by the loaded cells, in bytes
+		 */
+		std::size_t getMemoryUsage() const;
+
+		/**
+		 * @return the number of cells attached to the scene
+		 */
+		std::size_t getAttachedCellCount() const;
+
+		/**
+		 * @param position a world position
+		 *
+		 * @return the cell that contains <tt>position</tt>
+		 */
+		CellCoordinate getCell(const glm::vec3& position) const;
+
+	private:
+		/**
+		 * @param cell the cell coordinate
+		 * @param position a world position
+		 *
+		 * @return the distance on the XZ plane from <tt>position</tt> to the cell area
+		 */
+		float getDistance(const CellCoordinate& cell, const glm::vec3& position) const;
+
+		/**
+		 * Parses the file of a cell that has finished reading
+		 *
+		 * @param cell the cell
+		 */
+		void finishLoading(Cell& cell);
+
+		/**
+		 * Attaches a loaded cell to the scene
+		 *
+		 * @param cell the cell
+		 */
+		void attach(Cell& cell);
+
+		/**
+		 * Detaches a cell from the scene
+		 *
+		 * @param cell the cell
+		 */
+		void detach(Cell& cell);
+
+	};
+
+}
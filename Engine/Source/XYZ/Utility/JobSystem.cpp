@@ -0,0 +1,85 @@
+//
+// Created by Rogiel Sulzbach on 8/15/17.
+//
+
+#include "JobSystem.hpp"
+
+namespace XYZ::Utility {
+
+	JobSystem::JobSystem(unsigned int workerCount) {
+		if(workerCount == 0) {
+			auto hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		workers.reserve(workerCount);
+		for(unsigned int i = 0; i < workerCount; i++) {
+			workers.emplace_back(&JobSystem::run, this);
+		}
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+
+		for(auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	std::future<void> JobSystem::schedule(Job job) {
+		std::packaged_task<void()> task(std::move(job));
+		auto future = task.get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(task));
+		}
+		condition.notify_one();
+
+		return future;
+	}
+
+	void JobSystem::wait(std::vector<std::future<void>>& futures) {
+		// wait for every job first, so that no job is still running when a
+		// exception is propagated to the caller
+		for(auto& future : futures) {
+			future.wait();
+		}
+		for(auto& future : futures) {
+			future.get();
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	unsigned int JobSystem::getWorkerCount() const {
+		return static_cast<unsigned int>(workers.size());
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void JobSystem::run() {
+		while(true) {
+			std::packaged_task<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+				if(jobs.empty()) {
+					return;
+				}
+
+				task = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			task();
+		}
+	}
+
+}
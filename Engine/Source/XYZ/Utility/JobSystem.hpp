@@ -0,0 +1,119 @@
+//
+// Created by Rogiel Sulzbach on 8/15/17.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace XYZ::Utility {
+
+	/**
+	 * A job system runs small units of work on a fixed pool of worker threads.
+	 *
+	 * Jobs are executed in FIFO order. A job must not block waiting for another job
+	 * scheduled on the same system, since every worker could end up waiting.
+	 */
+	class JobSystem {
+	public:
+		/**
+		 * A job function
+		 */
+		using Job = std::function<void()>;
+
+	private:
+		/**
+		 * The worker threads
+		 */
+		std::vector<std::thread> workers;
+
+		/**
+		 * The pending jobs
+		 */
+		std::deque<std::packaged_task<void()>> jobs;
+
+		/**
+		 * A mutex protecting the <tt>jobs</tt> queue
+		 */
+		std::mutex mutex;
+
+		/**
+		 * A condition variable used to wake workers when a job is scheduled
+		 */
+		std::condition_variable condition;
+
+		/**
+		 * A flag indicating that the workers should exit
+		 */
+		bool stopping = false;
+
+	public:
+		/**
+		 * Creates a new job system
+		 *
+		 * @param workerCount the number of worker threads. If zero, one worker is created
+		 * per hardware thread, minus one for the thread that schedules the jobs.
+		 */
+		explicit JobSystem(unsigned int workerCount = 0);
+
+		/**
+		 * Deleted copy constructor.
+		 *
+		 * @param other the instance to copy from
+		 */
+		JobSystem(const JobSystem& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 *
+		 * @param other the instance to copy from
+		 *
+		 * @return *this
+		 */
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		/**
+		 * Destroys the job system. Pending jobs are executed before the workers exit.
+		 */
+		~JobSystem();
+
+	public:
+		/**
+		 * Schedules a job to be executed on a worker thread
+		 *
+		 * @param job the job to be executed
+		 *
+		 * @return a future that becomes ready once the job has finished. Exceptions
+		 * thrown by the job are rethrown by <tt>future::get()</tt>.
+		 */
+		std::future<void> schedule(Job job);
+
+		/**
+		 * Waits for all futures in <tt>futures</tt>, rethrowing the first exception
+		 * thrown by any of the jobs
+		 *
+		 * @param futures the futures to wait for
+		 */
+		static void wait(std::vector<std::future<void>>& futures);
+
+	public:
+		/**
+		 * @return the number of worker threads
+		 */
+		unsigned int getWorkerCount() const;
+
+	private:
+		/**
+		 * The worker thread main loop
+		 */
+		void run();
+
+	};
+
+}
@@ -0,0 +1,76 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "MappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace XYZ::Utility {
+
+	MappedFile::MappedFile(const std::string& path) {
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if(fd < 0) {
+			throw MappedFileException("Unable to open " + path + ": " + std::strerror(errno));
+		}
+
+		struct stat status;
+		if(::fstat(fd, &status) != 0) {
+			int error = errno;
+			::close(fd);
+			throw MappedFileException("Unable to stat " + path + ": " + std::strerror(error));
+		}
+
+		size = static_cast<std::size_t>(status.st_size);
+		if(size == 0) {
+			::close(fd);
+			return;
+		}
+
+		void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		int error = errno;
+
+		// the mapping keeps its own reference to the file
+		::close(fd);
+
+		if(mapping == MAP_FAILED) {
+			throw MappedFileException("Unable to map " + path + ": " + std::strerror(error));
+		}
+		data = mapping;
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept :
+			data(std::exchange(other.data, nullptr)),
+			size(std::exchange(other.size, 0)) {
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		std::swap(data, other.data);
+		std::swap(size, other.size);
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		if(data != nullptr) {
+			::munmap(const_cast<void*>(data), size);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	const void* MappedFile::getData() const {
+		return data;
+	}
+
+	std::size_t MappedFile::getSize() const {
+		return size;
+	}
+
+}
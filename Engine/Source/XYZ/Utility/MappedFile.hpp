@@ -0,0 +1,68 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include "XYZ/Exception.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace XYZ::Utility {
+
+	XYZ_DECL_ROOT_EXCEPTION(MappedFileException);
+
+	/**
+	 * A read-only memory mapping of a whole file.
+	 *
+	 * The file contents are paged in by the operating system as they are accessed,
+	 * which avoids copying the file into a intermediate buffer before parsing it.
+	 */
+	class MappedFile {
+	private:
+		/**
+		 * The mapped file contents. <tt>nullptr</tt> for empty files.
+		 */
+		const void* data = nullptr;
+
+		/**
+		 * The mapped file size, in bytes
+		 */
+		std::size_t size = 0;
+
+	public:
+		/**
+		 * Maps a file
+		 *
+		 * @param path the path of the file to be mapped
+		 *
+		 * @throws MappedFileException if the file cannot be opened or mapped
+		 */
+		explicit MappedFile(const std::string& path);
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/**
+		 * Unmaps the file
+		 */
+		~MappedFile();
+
+	public:
+		/**
+		 * @return the mapped file contents
+		 */
+		const void* getData() const;
+
+		/**
+		 * @return the mapped file size, in bytes
+		 */
+		std::size_t getSize() const;
+
+	};
+
+}
@@ -0,0 +1,90 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#include "MemoryPool.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace XYZ::Utility {
+
+	MemoryPool::MemoryPool(std::size_t blockSize, std::size_t blocksPerSlab) :
+			blockSize((std::max(blockSize, sizeof(void*)) + GRANULARITY - 1) & ~(GRANULARITY - 1)),
+			blocksPerSlab(std::max(blocksPerSlab, std::size_t(1))) {
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void* MemoryPool::allocate() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(freeList == nullptr) {
+			grow(blocksPerSlab);
+		}
+
+		void* block = freeList;
+		freeList = *static_cast<void**>(block);
+		return block;
+	}
+
+	void MemoryPool::deallocate(void* block) {
+		if(block == nullptr) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		*static_cast<void**>(block) = freeList;
+		freeList = block;
+	}
+
+	void MemoryPool::reserve(std::size_t count) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		std::size_t available = 0;
+		for(void* block = freeList; block != nullptr && available < count; block = *static_cast<void**>(block)) {
+			available++;
+		}
+		if(available < count) {
+			grow(count - available);
+		}
+	}
+
+	std::size_t MemoryPool::getBlockSize() const {
+		return blockSize;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	MemoryPool* MemoryPool::forSize(std::size_t size, std::size_t alignment) {
+		if(size == 0 || size > MAX_BLOCK_SIZE || alignment > GRANULARITY) {
+			return nullptr;
+		}
+
+		// The pools are intentionally leaked: objects with static storage duration
+		// may still release their blocks after the pools would have been destroyed.
+		static auto pools = [] {
+			auto pools = new std::array<MemoryPool*, MAX_BLOCK_SIZE / GRANULARITY>();
+			for(std::size_t i = 0; i < pools->size(); i++) {
+				(*pools)[i] = new MemoryPool((i + 1) * GRANULARITY);
+			}
+			return pools;
+		}();
+
+		return (*pools)[(size - 1) / GRANULARITY];
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------
+
+	void MemoryPool::grow(std::size_t count) {
+		std::unique_ptr<unsigned char[]> slab(new unsigned char[blockSize * count]);
+
+		// link the new blocks in address order
+		for(std::size_t i = count; i > 0; i--) {
+			void* block = slab.get() + (i - 1) * blockSize;
+			*static_cast<void**>(block) = freeList;
+			freeList = block;
+		}
+		slabs.push_back(std::move(slab));
+	}
+
+}
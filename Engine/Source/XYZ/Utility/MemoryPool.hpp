@@ -0,0 +1,174 @@
+//
+// Created by Rogiel Sulzbach on 8/16/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace XYZ::Utility {
+
+	/**
+	 * A thread-safe pool of fixed size memory blocks.
+	 *
+	 * Blocks are carved from large slabs and recycled through a free list, so
+	 * allocating and releasing a block never touches the system allocator once the
+	 * pool has grown to its working size. Slabs are never released.
+	 */
+	class MemoryPool {
+	public:
+		/**
+		 * The block size granularity. Blocks are aligned to this value.
+		 */
+		static constexpr std::size_t GRANULARITY = 16;
+
+		/**
+		 * The largest block size served by the shared pools
+		 */
+		static constexpr std::size_t MAX_BLOCK_SIZE = 512;
+
+	private:
+		/**
+		 * The size of every block, in bytes
+		 */
+		std::size_t blockSize;
+
+		/**
+		 * The number of blocks allocated at once when the pool is exhausted
+		 */
+		std::size_t blocksPerSlab;
+
+		/**
+		 * The first free block. Each free block stores a pointer to the next one.
+		 */
+		void* freeList = nullptr;
+
+		/**
+		 * The slabs the blocks are carved from
+		 */
+		std::vector<std::unique_ptr<unsigned char[]>> slabs;
+
+		/**
+		 * A mutex protecting the free list and the slabs
+		 */
+		std::mutex mutex;
+
+	public:
+		/**
+		 * Creates a new memory pool
+		 *
+		 * @param blockSize the size of every block, in bytes. Rounded up to <tt>GRANULARITY</tt>.
+		 * @param blocksPerSlab the number of blocks allocated at once when the pool is exhausted
+		 */
+		explicit MemoryPool(std::size_t blockSize, std::size_t blocksPerSlab = 256);
+
+		MemoryPool(const MemoryPool& other) = delete;
+		MemoryPool& operator=(const MemoryPool& other) = delete;
+
+	public:
+		/**
+		 * Allocates a block
+		 *
+		 * @return a block of at least <tt>getBlockSize()</tt> bytes
+		 */
+		void* allocate();
+
+		/**
+		 * Returns a block to the pool
+		 *
+		 * @param block a block previously returned by <tt>allocate</tt> on this pool
+		 */
+		void deallocate(void* block);
+
+		/**
+		 * Makes sure at least <tt>count</tt> blocks can be allocated without growing the pool
+		 *
+		 * @param count the number of blocks to reserve
+		 */
+		void reserve(std::size_t count);
+
+		/**
+		 * @return the size of every block, in bytes
+		 */
+		std::size_t getBlockSize() const;
+
+	public:
+		/**
+		 * Gets the shared pool for a allocation size. Shared pools exist for every
+		 * multiple of <tt>GRANULARITY</tt> up to <tt>MAX_BLOCK_SIZE</tt>.
+		 *
+		 * @param size the allocation size, in bytes
+		 * @param alignment the allocation alignment, in bytes
+		 *
+		 * @return the shared pool or <tt>nullptr</tt> if the allocation cannot be
+		 * served by a pool
+		 */
+		static MemoryPool* forSize(std::size_t size, std::size_t alignment);
+
+	private:
+		/**
+		 * Allocates a new slab and adds its blocks to the free list. The mutex must
+		 * be held by the caller.
+		 *
+		 * @param count the number of blocks in the slab
+		 */
+		void grow(std::size_t count);
+
+	};
+
+	/**
+	 * A standard allocator that serves single object allocations from the shared
+	 * memory pools. Array allocations and large or over-aligned types fall back to
+	 * the global allocator.
+	 *
+	 * Meant to be used with <tt>std::allocate_shared</tt>, which allocates the
+	 * object and its control block with a single pooled allocation.
+	 */
+	template<typename T>
+	class PoolAllocator {
+	public:
+		using value_type = T;
+
+	public:
+		PoolAllocator() = default;
+
+		template<typename U>
+		PoolAllocator(const PoolAllocator<U>&) {
+		}
+
+	public:
+		T* allocate(std::size_t n) {
+			if(n == 1) {
+				if(auto pool = MemoryPool::forSize(sizeof(T), alignof(T))) {
+					return static_cast<T*>(pool->allocate());
+				}
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* pointer, std::size_t n) {
+			if(n == 1) {
+				if(auto pool = MemoryPool::forSize(sizeof(T), alignof(T))) {
+					pool->deallocate(pointer);
+					return;
+				}
+			}
+			::operator delete(pointer);
+		}
+
+		template<typename U>
+		bool operator==(const PoolAllocator<U>&) const {
+			return true;
+		}
+
+		template<typename U>
+		bool operator!=(const PoolAllocator<U>&) const {
+			return false;
+		}
+
+	};
+
+}
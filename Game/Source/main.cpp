@@ -27,6 +27,7 @@
 
 #include <thread>
 #include <queue>
+#include <map>
 
 using namespace XYZ;
 
@@ -98,9 +99,11 @@ public:
 };
 
 #include <XYZ/Scene/Manager/Simple/SimpleSceneManager.hpp>
+#include <XYZ/Scene/Manager/Portal/PortalSceneManager.hpp>
 #include <XYZ/Graphics/Window/GLFW/GLFWWindow.hpp>
 #include <XYZ/Audio/OpenAL/OpenALAudioBuffer.hpp>
 #include <XYZ/Graphics/Model/StaticModel.hpp>
+#include <XYZ/Scene/Prefab/PrefabInstance.hpp>
 #include <XYZ/Terrain/Manager/Quadtree/QuadtreeTerrainManager.hpp>
 
 //int main() {
@@ -120,6 +123,23 @@ public:
 //
 //}
 
+Graphics::Texture::Texture::Ptr loadTexture(const std::string& name, Engine& engine) {
+	// compile every texture only once so that objects loaded from the same files share
+	// their materials and can be instanced by the renderer
+	static std::map<std::string, Graphics::Texture::Texture::Ptr> textures;
+
+	auto& texture = textures[name];
+	if(!texture) {
+		texture = engine.getRenderer().getTextureCompiler().compileTexture(
+				*engine.getTextureImageManager().get(name)
+		);
+		texture->setMagnificationMinificationFilter(Graphics::Texture::TextureMagnification::LINEAR,
+													Graphics::Texture::TextureMinification::NEAREST_MIPMAP_LINEAR);
+		texture->generateMipmaps();
+	}
+	return texture;
+}
+
 std::shared_ptr<Scene::Object>
 loadObject(const std::string& name, Engine& engine, const std::shared_ptr<Scene::Object>& parent) {
 	auto object = parent->createChild();
@@ -128,26 +148,9 @@ loadObject(const std::string& name, Engine& engine, const std::shared_ptr<Scene:
 	);
 	object->setModel(model);
 
-	model->setDiffuseTexture(engine.getRenderer().getTextureCompiler().compileTexture(
-			*engine.getTextureImageManager().get("Objects/" + name + "/" + name + "_diffuse.png")
-	));
-	model->getDiffuseTexture()->setMagnificationMinificationFilter(Graphics::Texture::TextureMagnification::LINEAR,
-																   Graphics::Texture::TextureMinification::NEAREST_MIPMAP_LINEAR);
-	model->getDiffuseTexture()->generateMipmaps();
-
-	model->setSpecularTexture(engine.getRenderer().getTextureCompiler().compileTexture(
-			*engine.getTextureImageManager().get("Objects/" + name + "/" + name + "_specular.png")
-	));
-	model->getSpecularTexture()->setMagnificationMinificationFilter(Graphics::Texture::TextureMagnification::LINEAR,
-																	Graphics::Texture::TextureMinification::NEAREST_MIPMAP_LINEAR);
-	model->getSpecularTexture()->generateMipmaps();
-
-	model->setNormalMap(engine.getRenderer().getTextureCompiler().compileTexture(
-			*engine.getTextureImageManager().get("Objects/" + name + "/" + name + "_normal.png")
-	));
-	model->getNormalMap()->setMagnificationMinificationFilter(Graphics::Texture::TextureMagnification::LINEAR,
-															  Graphics::Texture::TextureMinification::NEAREST_MIPMAP_LINEAR);
-	model->getNormalMap()->generateMipmaps();
+	model->setDiffuseTexture(loadTexture("Objects/" + name + "/" + name + "_diffuse.png", engine));
+	model->setSpecularTexture(loadTexture("Objects/" + name + "/" + name + "_specular.png", engine));
+	model->setNormalMap(loadTexture("Objects/" + name + "/" + name + "_normal.png", engine));
 
 	model->setShininess(32.0f);
 	model->setCastShadows(true);
@@ -177,14 +180,14 @@ int main() {
 //	engine.getInputDeviceManager().getPrimaryKeyboard()->setDelegate(std::make_unique<MyKeyboardDelegate>());
 
 	auto& renderer = static_cast<Graphics::Renderer::OpenGL::OpenGLRenderer&>(engine.getRenderer());
-	Graphics::Renderer::OpenGL::OpenGLDeferredRendering rendering(renderer);
+	Graphics::Renderer::OpenGL::OpenGLDeferredRendering rendering(renderer, "ShaderCache");
 
 	// tell GLFW to capture our mouse
 	glfwSetInputMode(glfwGetCurrentContext(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
 	Scene::Scene scene;
 
-	auto superRoot = std::make_shared<Scene::Object>();
+	auto superRoot = Scene::makeObject<Scene::Object>();
 	scene.setRootObject(superRoot);
 
 //	root->scale.x = 1.0 / 180 * 2.0;
@@ -200,26 +203,39 @@ int main() {
 	auto thingy = loadObject("Thingy", engine, superRoot);
 	thingy->setScale(glm::vec3(3.0));
 
-	auto tunnel = superRoot->createChild();
-	for(int i = 0; i < 10; i++) {
-		auto segment = loadObject("Floor", engine, tunnel);
-		segment->position.x += 4.0 * i;
-//		segment->setShininess(0.001f);
-		static_cast<Graphics::Model::StaticModel*>(segment->getModel().get())->setCastShadows(false);
+	// the tunnel segment is built once and placed as a prefab
+	auto segmentPrototype = Scene::makeObject<Scene::Object>();
+	{
+		auto floor = loadObject("Floor", engine, segmentPrototype);
+//		floor->setShininess(0.001f);
+		auto floorModel = static_cast<Graphics::Model::StaticModel*>(floor->getModel().get());
+		floorModel->setCastShadows(false);
+
+		// the tunnel walls hide everything outside the tunnel
+		floorModel->setOccluderMesh(floorModel->getMesh());
 
-		auto track = loadObject("MainRail", engine, segment);
+		auto track = loadObject("MainRail", engine, floor);
 		static_cast<Graphics::Model::StaticModel*>(track->getModel().get())->setShininess(320.0f);
 
-		auto pipes = loadObject("Pipes", engine, segment);
+		auto pipes = loadObject("Pipes", engine, floor);
 
-		auto lamp = loadObject("Lamp", engine, segment);
-		auto topCables = loadObject("TopCables", engine, segment);
-		auto electricityRail = loadObject("ElectricityRail", engine, segment);
+		auto lamp = loadObject("Lamp", engine, floor);
+		auto topCables = loadObject("TopCables", engine, floor);
+		auto electricityRail = loadObject("ElectricityRail", engine, floor);
+	}
+	auto segmentPrefab = std::make_shared<const Scene::Prefab>(*segmentPrototype->getChildren().front());
+
+	auto tunnel = superRoot->createChild();
+	for(int i = 0; i < 10; i++) {
+		auto segment = Scene::makeObject<Scene::PrefabInstance>(segmentPrefab);
+		tunnel->addChild(segment);
+		segment->position.x += 4.0 * i;
+		segment->setStatic(true);
 
 		using glm::vec3;
 		float strength = 0.4f;
 
-		auto pointLight1 = std::make_shared<Scene::Light::PointLight>();
+		auto pointLight1 = Scene::makeObject<Scene::Light::PointLight>();
 		pointLight1->setPosition(vec3(segment->position.x, 1.8f, 1.7f));
 		pointLight1->setDiffuse(vec3(1.0f, 1.0f, 1.0f) * strength);
 		pointLight1->setSpecular(vec3(1.0f, 1.0f, 1.0f) * strength);
@@ -229,7 +245,7 @@ int main() {
 		pointLight1->setShadows(false);
 		scene.addLight(pointLight1);
 
-		auto pointLight2 = std::make_shared<Scene::Light::PointLight>();
+		auto pointLight2 = Scene::makeObject<Scene::Light::PointLight>();
 		pointLight2->setPosition(vec3(segment->position.x, 1.8f, -1.7f));
 		pointLight2->setDiffuse(vec3(1.0f, 1.0f, 1.0f) * strength);
 		pointLight2->setSpecular(vec3(1.0f, 1.0f, 1.0f) * strength);
@@ -240,14 +256,19 @@ int main() {
 		scene.addLight(pointLight2);
 	}
 
-	camera = std::make_shared<Scene::Camera>();
+	// every tunnel segment is a cell, connected to its neighbours by portals
+	auto portalSceneManager = std::make_shared<Scene::Manager::Portal::PortalSceneManager>();
+	portalSceneManager->generate(tunnel->getChildren());
+	scene.setSceneManager(portalSceneManager);
+
+	camera = Scene::makeObject<Scene::Camera>();
 	scene.setCamera(camera);
 	camera->setPosition(glm::vec3(0.0f, 2.0f, 0.0f));
 	camera->Yaw = 0.0;
 	camera->Pitch = -90.0;
 	camera->updateCameraVectors();
 
-//	auto pointLight1 = std::make_shared<Scene::Light::PointLight>();
+//	auto pointLight1 = Scene::makeObject<Scene::Light::PointLight>();
 //	pointLight1->setPosition(glm::vec3(0.0, 3.0, 0.0));
 //	pointLight1->setDiffuse(glm::vec3(1.0f, 1.0f, 1.0f) * 1.0f);
 //	pointLight1->setSpecular(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -257,7 +278,7 @@ int main() {
 //	pointLight1->setQuadratic(0.032f * 0.0f);
 //	scene.addLight(pointLight1);
 
-	auto spotLight = std::make_shared<Scene::Light::SpotLight>();
+	auto spotLight = Scene::makeObject<Scene::Light::SpotLight>();
 	spotLight->setDiffuse(glm::vec3(1.0f, 1.0f, 1.0f) * 2.0f);
 	spotLight->setSpecular(glm::vec3(1.0f, 1.0f, 1.0f) * 2.0f);
 	spotLight->setConstant(1.0f);
@@ -329,6 +350,7 @@ int main() {
 		auto terrainObject = superRoot->createChild();
 		terrainObject->setModel(model);
 		terrainObject->position = glm::vec3(topLeft.x, 0.0, topLeft.y);
+		terrainObject->setStatic(true);
 
 		std::cout << "Terrain was created. SN: [" << topLeft.y << ", " << bottomRight.y << "], WE: [" << topLeft.x
 				  << ", " << bottomRight.x
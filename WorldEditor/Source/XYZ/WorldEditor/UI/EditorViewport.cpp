@@ -7,6 +7,7 @@
 #include <XYZ/Engine.hpp>
 
 #include <XYZ/Graphics/Renderer/OpenGL/OpenGLRenderer.hpp>
+#include <XYZ/Graphics/Renderer/OpenGL/OpenGLStateCache.hpp>
 #include <XYZ/Graphics/Mesh/Obj/ObjMeshLoader.hpp>
 #include <XYZ/Scene/Light/PointLight.hpp>
 #include <XYZ/Scene/Light/SpotLight.hpp>
@@ -19,6 +20,7 @@
 
 #include <XYZ/Graphics/Renderer/OpenGL/OpenGLDeferredRendering.hpp>
 #include <XYZ/Graphics/Model/StaticModel.hpp>
+#include <XYZ/Scene/Prefab/PrefabInstance.hpp>
 #include <XYZ/Audio/OpenAL/OpenALAudioSystem.hpp>
 
 #include <XYZ/Audio/Loader/OggVorbis/OggVorbisClipLoader.hpp>
@@ -90,7 +92,7 @@ namespace XYZ::WorldEditor::UI {
 				std::make_unique<Graphics::Texture::Stbi::StbiTextureImageLoader>());
 
 		auto& renderer = static_cast<Graphics::Renderer::OpenGL::OpenGLRenderer&>(engine->getRenderer());
-		rendering = new Graphics::Renderer::OpenGL::OpenGLDeferredRendering(renderer);
+		rendering = new Graphics::Renderer::OpenGL::OpenGLDeferredRendering(renderer, "ShaderCache");
 
 //		GLint fbo = 0;
 //		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
@@ -98,28 +100,36 @@ namespace XYZ::WorldEditor::UI {
 //
 //		renderer.getDefaultFramebuffer().framebufferID = defaultFramebufferObject();
 //
-		auto root = std::make_shared<Scene::Object>();
+		auto root = Scene::makeObject<Scene::Object>();
 		scene.setRootObject(root);
 
 		auto rock = loadObject("Rock", *engine, root);
-		auto tunnel = root->createChild();
-		for(int i = 0; i < 2; i++) {
-			auto segment = loadObject("Floor", *engine, tunnel);
-			segment->position.x += 4.0 * i;
+		// the tunnel segment is built once and placed as a prefab
+		auto segmentPrototype = Scene::makeObject<Scene::Object>();
+		{
+			auto floor = loadObject("Floor", *engine, segmentPrototype);
 
-			auto track = loadObject("MainRail", *engine, segment);
+			auto track = loadObject("MainRail", *engine, floor);
 			static_cast<Graphics::Model::StaticModel*>(track->getModel().get())->setShininess(320.0f);
 
-			auto pipes = loadObject("Pipes", *engine, segment);
+			auto pipes = loadObject("Pipes", *engine, floor);
 
-			auto lamp = loadObject("Lamp", *engine, segment);
-			auto topCables = loadObject("TopCables", *engine, segment);
-			auto electricityRail = loadObject("ElectricityRail", *engine, segment);
+			auto lamp = loadObject("Lamp", *engine, floor);
+			auto topCables = loadObject("TopCables", *engine, floor);
+			auto electricityRail = loadObject("ElectricityRail", *engine, floor);
+		}
+		auto segmentPrefab = std::make_shared<const Scene::Prefab>(*segmentPrototype->getChildren().front());
+
+		auto tunnel = root->createChild();
+		for(int i = 0; i < 2; i++) {
+			auto segment = Scene::makeObject<Scene::PrefabInstance>(segmentPrefab);
+			tunnel->addChild(segment);
+			segment->position.x += 4.0 * i;
 
 			using glm::vec3;
 			float strength = 0.3f;
 
-			auto pointLight1 = std::make_shared<Scene::Light::PointLight>();
+			auto pointLight1 = Scene::makeObject<Scene::Light::PointLight>();
 			pointLight1->setPosition(vec3(segment->position.x, 1.88f, 1.88f));
 			pointLight1->setDiffuse(vec3(1.0f, 1.0f, 1.0f) * strength);
 			pointLight1->setSpecular(vec3(1.0f, 1.0f, 1.0f) * strength);
@@ -128,7 +138,7 @@ namespace XYZ::WorldEditor::UI {
 			pointLight1->setQuadratic(0.032f);
 			scene.addLight(pointLight1);
 
-			auto pointLight2 = std::make_shared<Scene::Light::PointLight>();
+			auto pointLight2 = Scene::makeObject<Scene::Light::PointLight>();
 			pointLight2->setPosition(vec3(segment->position.x, 1.88f, -1.88f));
 			pointLight2->setDiffuse(vec3(1.0f, 1.0f, 1.0f) * strength);
 			pointLight2->setSpecular(vec3(1.0f, 1.0f, 1.0f) * strength);
@@ -138,7 +148,7 @@ namespace XYZ::WorldEditor::UI {
 			scene.addLight(pointLight2);
 		}
 
-		auto camera = std::make_shared<Scene::Camera>();
+		auto camera = Scene::makeObject<Scene::Camera>();
 		scene.setCamera(camera);
 		camera->setPosition(glm::vec3(0.0f, 2.0f, 0.0f));
 		camera->Yaw = 0.0;
@@ -147,11 +157,16 @@ namespace XYZ::WorldEditor::UI {
 	}
 
 	void EditorViewport::resizeGL(int w, int h) {
+		// Qt rebinds the framebuffer, viewport and textures of the context
+		// behind the renderer's back
+		Graphics::Renderer::OpenGL::OpenGLStateCache::get().invalidate();
 		rendering->resize(w, h);
 		QOpenGLWidget::resizeGL(w, h);
 	}
 
 	void EditorViewport::paintGL() {
+		Graphics::Renderer::OpenGL::OpenGLStateCache::get().invalidate();
+
 		auto& renderer = static_cast<Graphics::Renderer::OpenGL::OpenGLRenderer&>(engine->getRenderer());
 		renderer.getDefaultFramebuffer().framebufferID = defaultFramebufferObject();
 
@@ -78,7 +78,7 @@ namespace XYZ::WorldEditor::UI {
 	}
 
 	void MainWindow::on_actionAddLightEntity_triggered() {
-		auto pointLight1 = std::make_shared<Scene::Light::PointLight>();
+		auto pointLight1 = Scene::makeObject<Scene::Light::PointLight>();
 		pointLight1->setPosition(glm::vec3(0.0, 0.0, 0.0));
 		pointLight1->setDiffuse(glm::vec3(1.0f, 1.0f, 1.0f));
 		pointLight1->setSpecular(glm::vec3(1.0f, 1.0f, 1.0f));